@@ -159,6 +159,7 @@ public:
                                     osmscout::RouteNodeRef &/*currentRouteNode*/,
                                     osmscout::RoutingService::OpenList &openList,
                                     osmscout::RoutingService::OpenMap &/*openMap*/,
+                                    osmscout::RoutingService::RNodePool &/*nodePool*/,
                                     const osmscout::RoutingService::ClosedSet &closedSet,
                                     const ClosedSet &closedRestrictedSet)
   {
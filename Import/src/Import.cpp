@@ -81,7 +81,7 @@ void DumpHelp(osmscout::ImportParameter& parameter)
   std::cout << " --processingQueueSize <number>       size of of the processing worker queues (default: " << parameter.GetProcessingQueueSize() << ")" << std::endl;
   std::cout << std::endl;
 
-  std::cout << " --numericIndexPageSize <number>      size of an numeric index page in bytes (default: " << parameter.GetNumericIndexPageSize() << ")" << std::endl;
+  std::cout << " --numericIndexPageSize <number>      deprecated and ignored, numeric indexes are written in static B+ tree layout" << std::endl;
 
   std::cout << " --rawCoordBlockSize <number>         number of raw coords resolved in block (default: " << parameter.GetRawCoordBlockSize() << ")" << std::endl;
 
@@ -93,8 +93,10 @@ void DumpHelp(osmscout::ImportParameter& parameter)
   std::cout << " --rawWayBlockSize <number>           number of raw ways resolved in block (default: " << parameter.GetRawWayBlockSize() << ")" << std::endl;
 
   std::cout << " --noSort                             do not sort objects" << std::endl;
-  std::cout << " --sortBlockSize <number>             size of one data block during sorting (default: " << parameter.GetSortBlockSize() << ")" << std::endl;
+  std::cout << " --sortMemoryLimit <MB>               memory used for sorting before sorted runs are written to disk (default: " << parameter.GetSortMemoryLimit()/(1024*1024) << ")" << std::endl;
+  std::cout << " --sortBlockSize <number>             deprecated and ignored, use --sortMemoryLimit" << std::endl;
 
+  std::cout << " --denseCoordData true|false          resolve nodes using a dense, memory maped coordinate file indexed by id (default: " << osmscout::BoolToString(parameter.GetDenseCoordData()) << ")" << std::endl;
   std::cout << " --coordDataMemoryMaped true|false    memory maped coord data file access (default: " << osmscout::BoolToString(parameter.GetCoordDataMemoryMaped()) << ")" << std::endl;
   std::cout << " --coordIndexCacheSize <number>       coord index cache size (default: " << parameter.GetCoordIndexCacheSize() << ")" << std::endl;
   std::cout << " --coordBlockSize <number>            number of coords resolved in block (default: " << parameter.GetCoordBlockSize() << ")" << std::endl;
@@ -109,6 +111,7 @@ void DumpHelp(osmscout::ImportParameter& parameter)
   std::cout << " --wayDataCacheSize <number>          way data cache size (default: " << parameter.GetWayDataCacheSize() << ")" << std::endl;
 
   std::cout << " --routeNodeBlockSize <number>        number of route nodes resolved in block (default: " << parameter.GetRouteNodeBlockSize() << ")" << std::endl;
+  std::cout << " --routerContractionHierarchy true|false generate contraction hierarchies for faster routing (default: " << osmscout::BoolToString(parameter.GetRouterContractionHierarchy()) << ")" << std::endl;
   std::cout << std::endl;
   std::cout << " --langOrder <#|lang1[,#|lang2]..>    language order when parsing lang[:language] and place_name[:language] tags" << std::endl
             << "                                      # is the default language (no :language) (default: #)" << std::endl;
@@ -117,6 +120,8 @@ void DumpHelp(osmscout::ImportParameter& parameter)
   std::cout << " --maxAdminLevel <number>             maximum admin level evaluated (default: " << parameter.GetMaxAdminLevel() << ")" << std::endl;
   std::cout << std::endl;
   std::cout << " --eco true|false                     do delete temporary fiels ASAP" << std::endl;
+  std::cout << " --parallelModules <number>           number of independent import steps executed in parallel (default: " << parameter.GetParallelModules() << ")" << std::endl;
+  std::cout << " --parallelModulesMemoryLimit <MB>    do not start further parallel steps above this resident memory, 0 for no limit (default: " << parameter.GetParallelModulesMemoryLimit()/(1024*1024) << ")" << std::endl;
   std::cout << " --delete-temporary-files true|false  deletes all temporary files after execution of the importer" << std::endl;
   std::cout << " --delete-debugging-files true|false  deletes all debugging files after execution of the importer" << std::endl;
   std::cout << " --delete-analysis-files true|false   deletes all analysis files after execution of the importer" << std::endl;
@@ -266,9 +271,6 @@ static void DumpParameter(const osmscout::ImportParameter& parameter,
   progress.Info(std::string("ProcessingQueueSize: ")+
                 std::to_string(parameter.GetProcessingQueueSize()));
 
-  progress.Info(std::string("NumericIndexPageSize: ")+
-                std::to_string(parameter.GetNumericIndexPageSize()));
-
   progress.Info(std::string("RawCoordBlockSize: ")+
                 std::to_string(parameter.GetRawCoordBlockSize()));
 
@@ -287,9 +289,11 @@ static void DumpParameter(const osmscout::ImportParameter& parameter,
 
   progress.Info(std::string("SortObjects: ")+
                 (parameter.GetSortObjects() ? "true" : "false"));
-  progress.Info(std::string("SortBlockSize: ")+
-                std::to_string(parameter.GetSortBlockSize()));
+  progress.Info(std::string("SortMemoryLimit: ")+
+                std::to_string(parameter.GetSortMemoryLimit()/(1024*1024))+" MB");
 
+  progress.Info(std::string("DenseCoordData: ")+
+                (parameter.GetDenseCoordData() ? "true" : "false"));
   progress.Info(std::string("CoordDataMemoryMaped: ")+
                 (parameter.GetCoordDataMemoryMaped() ? "true" : "false"));
   progress.Info(std::string("CoordIndexCacheSize: ")+
@@ -322,6 +326,8 @@ static void DumpParameter(const osmscout::ImportParameter& parameter,
 
   progress.Info(std::string("RouteNodeBlockSize: ")+
                 std::to_string(parameter.GetRouteNodeBlockSize()));
+  progress.Info(std::string("RouterContractionHierarchy: ")+
+                (parameter.GetRouterContractionHierarchy() ? "true" : "false"));
 
 
   progress.Info(std::string("MaxAdminLevel: ")+
@@ -329,6 +335,11 @@ static void DumpParameter(const osmscout::ImportParameter& parameter,
 
   progress.Info(std::string("Eco: ")+
                 (parameter.IsEco() ? "true" : "false"));
+
+  progress.Info(std::string("ParallelModules: ")+
+                std::to_string(parameter.GetParallelModules()));
+  progress.Info(std::string("ParallelModulesMemoryLimit: ")+
+                std::to_string(parameter.GetParallelModulesMemoryLimit()/(1024*1024))+" MB");
 }
 
 bool DumpDataSize(const osmscout::ImportParameter& parameter,
@@ -472,6 +483,32 @@ int main(int argc, char* argv[])
         parameterError=true;
       }
     }
+    else if (strcmp(argv[i],"--parallelModules")==0) {
+      size_t parallelModules;
+
+      if (osmscout::ParseSizeTArgument(argc,
+                                       argv,
+                                       i,
+                                       parallelModules)) {
+        parameter.SetParallelModules(parallelModules);
+      }
+      else {
+        parameterError=true;
+      }
+    }
+    else if (strcmp(argv[i],"--parallelModulesMemoryLimit")==0) {
+      size_t parallelModulesMemoryLimit;
+
+      if (osmscout::ParseSizeTArgument(argc,
+                                       argv,
+                                       i,
+                                       parallelModulesMemoryLimit)) {
+        parameter.SetParallelModulesMemoryLimit(parallelModulesMemoryLimit*1024*1024);
+      }
+      else {
+        parameterError=true;
+      }
+    }
     else if (strcmp(argv[i],"-d")==0) {
       progress.SetOutputDebug(true);
 
@@ -566,7 +603,7 @@ int main(int argc, char* argv[])
                                        argv,
                                        i,
                                        numericIndexPageSize)) {
-        parameter.SetNumericIndexPageSize(numericIndexPageSize);
+        std::cerr << "Option '--numericIndexPageSize' is deprecated and ignored, numeric indexes are written in static B+ tree layout" << std::endl;
       }
       else {
         parameterError=true;
@@ -663,6 +700,33 @@ int main(int argc, char* argv[])
                                        i,
                                        sortBlockSize)) {
         parameter.SetSortBlockSize(sortBlockSize);
+        std::cerr << "Option '--sortBlockSize' is deprecated and ignored, use '--sortMemoryLimit' instead" << std::endl;
+      }
+      else {
+        parameterError=true;
+      }
+    }
+    else if (strcmp(argv[i],"--sortMemoryLimit")==0) {
+      size_t sortMemoryLimit;
+
+      if (osmscout::ParseSizeTArgument(argc,
+                                       argv,
+                                       i,
+                                       sortMemoryLimit)) {
+        parameter.SetSortMemoryLimit(sortMemoryLimit*1024*1024);
+      }
+      else {
+        parameterError=true;
+      }
+    }
+    else if (strcmp(argv[i],"--denseCoordData")==0) {
+      bool denseCoordData;
+
+      if (osmscout::ParseBoolArgument(argc,
+                                      argv,
+                                      i,
+                                      denseCoordData)) {
+        parameter.SetDenseCoordData(denseCoordData);
       }
       else {
         parameterError=true;
@@ -798,6 +862,19 @@ int main(int argc, char* argv[])
         parameterError=true;
       }
     }
+    else if (strcmp(argv[i],"--routerContractionHierarchy")==0) {
+      bool routerContractionHierarchy;
+
+      if (osmscout::ParseBoolArgument(argc,
+                                      argv,
+                                      i,
+                                      routerContractionHierarchy)) {
+        parameter.SetRouterContractionHierarchy(routerContractionHierarchy);
+      }
+      else {
+        parameterError=true;
+      }
+    }
     else if (strcmp(argv[i],"--langOrder")==0) {
         std::vector<std::string> langOrder;
 
@@ -0,0 +1,165 @@
+/*
+  AreaAreaIndexParallel - a test program for libosmscout
+  Copyright (C) 2026  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <vector>
+
+#include <osmscout/AreaAreaIndex.h>
+#include <osmscout/Database.h>
+
+/**
+  Query the area index of the given database for the whole database and for
+  the cells of a grid over it, once with sequential and once with parallel
+  expansion of all index levels, and check that both return the same areas.
+  */
+
+std::vector<osmscout::DataBlockSpan> GetAreaSpans(const osmscout::AreaAreaIndex& index,
+                                                  const osmscout::TypeConfig& typeConfig,
+                                                  const osmscout::TypeInfoSet& types,
+                                                  const osmscout::GeoBox& boundingBox,
+                                                  bool& success)
+{
+  std::vector<osmscout::DataBlockSpan> spans;
+  osmscout::TypeInfoSet                loadedTypes;
+
+  success=index.GetAreasInArea(typeConfig,
+                               boundingBox,
+                               std::numeric_limits<size_t>::max(),
+                               types,
+                               spans,
+                               loadedTypes);
+
+  std::sort(spans.begin(),spans.end(),[](const osmscout::DataBlockSpan& a,
+                                         const osmscout::DataBlockSpan& b) {
+    return a.startOffset<b.startOffset ||
+           (a.startOffset==b.startOffset && a.count<b.count);
+  });
+
+  return spans;
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc!=2) {
+    std::cerr << "AreaAreaIndexParallel <database directory>" << std::endl;
+    return 1;
+  }
+
+  std::string                 databaseDirectory=argv[1];
+  osmscout::DatabaseParameter databaseParameter;
+  osmscout::DatabaseRef       database=std::make_shared<osmscout::Database>(databaseParameter);
+
+  if (!database->Open(databaseDirectory)) {
+    std::cerr << "ERROR: Cannot open database" << std::endl;
+    return 1;
+  }
+
+  osmscout::TypeConfigRef typeConfig=database->GetTypeConfig();
+  osmscout::TypeInfoSet   types;
+
+  for (const auto& type : typeConfig->GetTypes()) {
+    if (type->CanBeArea()) {
+      types.Set(type);
+    }
+  }
+
+  // Both indexes without cache, the parallel expansion bypasses the cache anyway
+  osmscout::AreaAreaIndex sequentialIndex(0);
+  osmscout::AreaAreaIndex parallelIndex(0);
+
+  if (!sequentialIndex.Open(databaseDirectory,true) ||
+      !parallelIndex.Open(databaseDirectory,true)) {
+    std::cerr << "ERROR: Cannot open area index" << std::endl;
+    return 1;
+  }
+
+  sequentialIndex.SetParallelCellThreshold(std::numeric_limits<size_t>::max());
+  parallelIndex.SetParallelCellThreshold(1);
+
+  osmscout::GeoBox boundingBox;
+
+  if (!database->GetBoundingBox(boundingBox)) {
+    std::cerr << "ERROR: Cannot get bounding box" << std::endl;
+    return 1;
+  }
+
+  std::vector<osmscout::GeoBox> boxes;
+  size_t                        gridSize=4;
+
+  boxes.push_back(boundingBox);
+
+  for (size_t y=0; y<gridSize; y++) {
+    for (size_t x=0; x<gridSize; x++) {
+      boxes.emplace_back(osmscout::GeoCoord(boundingBox.GetMinLat()+boundingBox.GetHeight()*y/gridSize,
+                                            boundingBox.GetMinLon()+boundingBox.GetWidth()*x/gridSize),
+                         osmscout::GeoCoord(boundingBox.GetMinLat()+boundingBox.GetHeight()*(y+1)/gridSize,
+                                            boundingBox.GetMinLon()+boundingBox.GetWidth()*(x+1)/gridSize));
+    }
+  }
+
+  size_t errorCount=0;
+  size_t areaCount=0;
+
+  for (size_t b=0; b<boxes.size(); b++) {
+    bool sequentialSuccess;
+    bool parallelSuccess;
+    auto sequentialSpans=GetAreaSpans(sequentialIndex,
+                                      *typeConfig,
+                                      types,
+                                      boxes[b],
+                                      sequentialSuccess);
+    auto parallelSpans=GetAreaSpans(parallelIndex,
+                                    *typeConfig,
+                                    types,
+                                    boxes[b],
+                                    parallelSuccess);
+
+    if (!sequentialSuccess ||
+        !parallelSuccess) {
+      std::cerr << "ERROR: Cannot query area index for box " << b << std::endl;
+      errorCount++;
+      continue;
+    }
+
+    if (sequentialSpans!=parallelSpans) {
+      std::cerr << "ERROR: Box " << b << " has " << sequentialSpans.size() << " spans in sequential and "
+                << parallelSpans.size() << " spans in parallel expansion" << std::endl;
+      errorCount++;
+    }
+
+    for (const auto& span : sequentialSpans) {
+      areaCount+=span.count;
+    }
+  }
+
+  if (areaCount==0) {
+    std::cerr << "ERROR: No areas found" << std::endl;
+    errorCount++;
+  }
+
+  std::cout << "Boxes: " << boxes.size() << ", areas: " << areaCount << std::endl;
+
+  sequentialIndex.Close();
+  parallelIndex.Close();
+  database->Close();
+
+  return errorCount==0 ? 0 : 1;
+}
@@ -0,0 +1,262 @@
+/*
+  CacheEvictionPerformance - a test program for libosmscout
+  Copyright (C) 2026  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <cstdlib>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <unordered_map>
+
+#include <osmscout/util/Cache.h>
+#include <osmscout/util/CmdLineParsing.h>
+#include <osmscout/util/StopClock.h>
+
+/**
+  Compare osmscout::Cache with a classic LRU cache (std::list order list plus
+  std::unordered_map, the former implementation of osmscout::Cache) regarding
+  * hit throughput
+  * miss (and insert) throughput
+  * hit rate for a hot working set after a large sequential scan
+*/
+
+using Value = std::shared_ptr<size_t>;
+
+/**
+  Reference LRU cache
+  */
+class LRUCache
+{
+private:
+  using Entry = std::pair<osmscout::Id,Value>;
+  using OrderList = std::list<Entry>;
+
+  size_t                                              maxSize;
+  OrderList                                           order;
+  std::unordered_map<osmscout::Id,OrderList::iterator> map;
+
+public:
+  explicit LRUCache(size_t maxSize)
+  : maxSize(maxSize)
+  {
+    map.reserve(maxSize);
+  }
+
+  bool GetEntry(osmscout::Id key, Value& value)
+  {
+    auto iter=map.find(key);
+
+    if (iter==map.end()) {
+      return false;
+    }
+
+    order.splice(order.begin(),order,iter->second);
+    value=iter->second->second;
+
+    return true;
+  }
+
+  void SetEntry(osmscout::Id key, const Value& value)
+  {
+    auto iter=map.find(key);
+
+    if (iter!=map.end()) {
+      order.splice(order.begin(),order,iter->second);
+      iter->second->second=value;
+      return;
+    }
+
+    order.emplace_front(key,value);
+    map[key]=order.begin();
+
+    if (order.size()>maxSize) {
+      map.erase(order.back().first);
+      order.pop_back();
+    }
+  }
+};
+
+/**
+  Adapter for osmscout::Cache with the same interface as LRUCache
+  */
+class ClockCache
+{
+private:
+  using Cache = osmscout::Cache<osmscout::Id,Value>;
+
+  Cache cache;
+
+public:
+  explicit ClockCache(size_t maxSize)
+  : cache(maxSize)
+  {
+  }
+
+  bool GetEntry(osmscout::Id key, Value& value)
+  {
+    Cache::CacheRef ref;
+
+    if (!cache.GetEntry(key,ref)) {
+      return false;
+    }
+
+    value=ref->value;
+
+    return true;
+  }
+
+  void SetEntry(osmscout::Id key, const Value& value)
+  {
+    cache.SetEntry(Cache::CacheEntry(key,value));
+  }
+};
+
+struct Result
+{
+  double hitTime;
+  double missTime;
+  size_t hotHitsAfterScan;
+};
+
+/**
+  Lookup the key, insert it into the cache in case of a cache miss
+  */
+template<class C>
+bool Access(C& cache, osmscout::Id key, const Value& value)
+{
+  Value cached;
+
+  if (cache.GetEntry(key,cached)) {
+    return true;
+  }
+
+  cache.SetEntry(key,value);
+
+  return false;
+}
+
+template<class C>
+Result Measure(size_t cacheSize)
+{
+  Result result{};
+  Value  value=std::make_shared<size_t>(0);
+
+  {
+    C cache(cacheSize);
+
+    osmscout::StopClock missTimer;
+
+    // Every access is a miss and an insert
+    for (size_t i=0; i<10*cacheSize; i++) {
+      Access(cache,i,value);
+    }
+
+    missTimer.Stop();
+    result.missTime=missTimer.GetMilliseconds();
+
+    osmscout::StopClock hitTimer;
+
+    // Every access is a hit
+    for (size_t t=0; t<10; t++) {
+      for (size_t i=9*cacheSize; i<10*cacheSize; i++) {
+        Access(cache,i,value);
+      }
+    }
+
+    hitTimer.Stop();
+    result.hitTime=hitTimer.GetMilliseconds();
+  }
+
+  {
+    C      cache(cacheSize);
+    size_t hotSize=cacheSize/2;
+
+    // Build up hot working set
+    for (size_t t=0; t<10; t++) {
+      for (size_t i=0; i<hotSize; i++) {
+        Access(cache,i,value);
+      }
+    }
+
+    // One large scan over keys never accessed again
+    for (size_t i=0; i<cacheSize; i++) {
+      Access(cache,cacheSize+i,value);
+    }
+
+    for (size_t i=0; i<hotSize; i++) {
+      if (Access(cache,i,value)) {
+        result.hotHitsAfterScan++;
+      }
+    }
+  }
+
+  return result;
+}
+
+int main(int argc, char* argv[])
+{
+  using namespace std::string_literals;
+  size_t cacheSize=1000000;
+  bool help=false;
+  osmscout::CmdLineParser argParser("CacheEvictionPerformance", argc, argv);
+
+  argParser.AddOption(osmscout::CmdLineFlag([&](const bool& value) {
+              help=value;
+            }),
+            std::vector<std::string>{"h","help"},
+            "Display help",
+            true);
+
+  argParser.AddOption(osmscout::CmdLineSizeTOption([&](const size_t& value) {
+                  cacheSize=value;
+                }),
+                "size",
+                "Cache size used for the test, default: "s + std::to_string(cacheSize));
+
+  osmscout::CmdLineParseResult argResult=argParser.Parse();
+  if (argResult.HasError()) {
+    std::cerr << "ERROR: " << argResult.GetErrorDescription() << std::endl;
+    std::cout << argParser.GetHelp() << std::endl;
+    return 1;
+  }
+  if (help){
+    std::cout << argParser.GetHelp() << std::endl;
+    return 0;
+  }
+
+  if (cacheSize<2) {
+    std::cerr << "ERROR: Cache size must be at least 2" << std::endl;
+    return 1;
+  }
+
+  Result lru=Measure<LRUCache>(cacheSize);
+  Result clock=Measure<ClockCache>(cacheSize);
+
+  std::cout << "Accesses per measurement: " << 10*cacheSize << std::endl;
+  std::cout << "LRU   - miss: " << lru.missTime << "ms, hit: " << lru.hitTime << "ms, hot set hits after scan: " << lru.hotHitsAfterScan << "/" << cacheSize/2 << std::endl;
+  std::cout << "CLOCK - miss: " << clock.missTime << "ms, hit: " << clock.hitTime << "ms, hot set hits after scan: " << clock.hotHitsAfterScan << "/" << cacheSize/2 << std::endl;
+
+  // The hot working set must survive a scan better than with LRU
+  if (clock.hotHitsAfterScan<lru.hotHitsAfterScan ||
+      clock.hotHitsAfterScan==0) {
+    std::cerr << "ERROR: Hot working set was flushed by scan" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
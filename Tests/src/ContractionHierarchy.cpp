@@ -0,0 +1,289 @@
+/*
+  ContractionHierarchy - a test program for libosmscout
+  Copyright (C) 2026  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <filesystem>
+#include <iostream>
+#include <map>
+#include <vector>
+
+#include <osmscout/Database.h>
+
+#include <osmscout/routing/SimpleRoutingService.h>
+
+#include <osmscout/util/CmdLineParsing.h>
+#include <osmscout/util/Geometry.h>
+#include <osmscout/util/StopClock.h>
+
+#include <osmscoutimport/GenContractionHierarchy.h>
+#include <osmscoutimport/ImportParameter.h>
+
+/**
+  Generate the contraction hierarchy for cars for a copy of the given
+  database and compare routes calculated using the hierarchy with routes
+  calculated by the A* search of the router.
+  */
+
+void GetCarSpeedTable(std::map<std::string,double>& map)
+{
+  map["highway_motorway"]=110.0;
+  map["highway_motorway_trunk"]=100.0;
+  map["highway_motorway_primary"]=70.0;
+  map["highway_motorway_link"]=60.0;
+  map["highway_motorway_junction"]=60.0;
+  map["highway_trunk"]=100.0;
+  map["highway_trunk_link"]=60.0;
+  map["highway_primary"]=70.0;
+  map["highway_primary_link"]=60.0;
+  map["highway_secondary"]=60.0;
+  map["highway_secondary_link"]=50.0;
+  map["highway_tertiary"]=55.0;
+  map["highway_tertiary_link"]=55.0;
+  map["highway_unclassified"]=50.0;
+  map["highway_road"]=50.0;
+  map["highway_residential"]=20.0;
+  map["highway_roundabout"]=40.0;
+  map["highway_living_street"]=10.0;
+  map["highway_service"]=30.0;
+}
+
+double GetRouteLength(osmscout::SimpleRoutingService& router,
+                      const osmscout::RoutingResult& result)
+{
+  auto   pointsResult=router.TransformRouteDataToPoints(result.GetRoute());
+  double length=0.0;
+
+  if (!pointsResult.Success()) {
+    return -1.0;
+  }
+
+  const auto& points=pointsResult.GetPoints()->points;
+
+  for (size_t i=1; i<points.size(); i++) {
+    length+=osmscout::GetEllipsoidalDistance(points[i-1].GetCoord(),
+                                             points[i].GetCoord()).As<osmscout::Meter>();
+  }
+
+  return length;
+}
+
+int main(int argc, char* argv[])
+{
+  std::string databaseDirectory;
+  size_t      gridSize=6;
+  bool        help=false;
+  osmscout::CmdLineParser argParser("ContractionHierarchy", argc, argv);
+
+  argParser.AddOption(osmscout::CmdLineFlag([&](const bool& value) {
+              help=value;
+            }),
+            std::vector<std::string>{"h","help"},
+            "Display help",
+            true);
+
+  argParser.AddOption(osmscout::CmdLineSizeTOption([&](const size_t& value) {
+                  gridSize=value;
+                }),
+                "grid",
+                "Number of route positions per dimension, default: "+std::to_string(gridSize));
+
+  argParser.AddPositional(osmscout::CmdLineStringOption([&](const std::string& value) {
+                            databaseDirectory=value;
+                          }),
+                          "DATABASE",
+                          "Directory of the database to use");
+
+  osmscout::CmdLineParseResult argResult=argParser.Parse();
+  if (argResult.HasError()) {
+    std::cerr << "ERROR: " << argResult.GetErrorDescription() << std::endl;
+    std::cout << argParser.GetHelp() << std::endl;
+    return 1;
+  }
+  if (help){
+    std::cout << argParser.GetHelp() << std::endl;
+    return 0;
+  }
+
+  // Work on a copy, so that we do not modify the test data
+
+  std::filesystem::path directory=std::filesystem::temp_directory_path()/"osmscout-contraction-hierarchy";
+
+  try {
+    std::filesystem::remove_all(directory);
+    std::filesystem::copy(databaseDirectory,directory);
+  }
+  catch (const std::filesystem::filesystem_error& e) {
+    std::cerr << "ERROR: Cannot copy database: " << e.what() << std::endl;
+    return 1;
+  }
+
+  osmscout::ImportParameter                 importParameter;
+  osmscout::ConsoleProgress                 progress;
+  osmscout::ContractionHierarchyGenerator   generator;
+
+  importParameter.SetDestinationDirectory(directory.string());
+  importParameter.ClearRouter();
+  importParameter.AddRouter(osmscout::ImportParameter::Router(osmscout::vehicleCar,
+                                                              osmscout::RoutingService::DEFAULT_FILENAME_BASE));
+  importParameter.SetRouterContractionHierarchy(true);
+
+  if (!generator.Import(osmscout::TypeConfigRef(),
+                        importParameter,
+                        progress)) {
+    std::cerr << "ERROR: Cannot generate contraction hierarchy" << std::endl;
+    return 1;
+  }
+
+  osmscout::DatabaseParameter databaseParameter;
+  osmscout::DatabaseRef       database=std::make_shared<osmscout::Database>(databaseParameter);
+
+  if (!database->Open(directory.string())) {
+    std::cerr << "ERROR: Cannot open database" << std::endl;
+    return 1;
+  }
+
+  osmscout::RouterParameter hierarchyParameter;
+
+  hierarchyParameter.SetContractionHierarchy(true);
+
+  osmscout::SimpleRoutingService hierarchyRouter(database,
+                                                 hierarchyParameter,
+                                                 osmscout::RoutingService::DEFAULT_FILENAME_BASE);
+  osmscout::SimpleRoutingService aStarRouter(database,
+                                             osmscout::RouterParameter(),
+                                             osmscout::RoutingService::DEFAULT_FILENAME_BASE);
+
+  if (!hierarchyRouter.Open() ||
+      !aStarRouter.Open()) {
+    std::cerr << "ERROR: Cannot open router" << std::endl;
+    return 1;
+  }
+
+  auto                         profile=std::make_shared<osmscout::ShortestPathRoutingProfile>(database->GetTypeConfig());
+  std::map<std::string,double> speedMap;
+
+  GetCarSpeedTable(speedMap);
+  profile->ParametrizeForCar(*database->GetTypeConfig(),speedMap,160.0);
+
+  if (!hierarchyRouter.PrepareContractionHierarchy(profile)) {
+    std::cerr << "ERROR: Cannot prepare contraction hierarchy" << std::endl;
+    return 1;
+  }
+
+  if (aStarRouter.PrepareContractionHierarchy(profile)) {
+    std::cerr << "ERROR: Contraction hierarchy loaded, though disabled" << std::endl;
+    return 1;
+  }
+
+  // Route positions on a regular grid over the database
+
+  osmscout::GeoBox                     boundingBox;
+  std::vector<osmscout::RoutePosition> positions;
+
+  if (!database->GetBoundingBox(boundingBox)) {
+    std::cerr << "ERROR: Cannot get bounding box" << std::endl;
+    return 1;
+  }
+
+  for (size_t y=0; y<gridSize; y++) {
+    for (size_t x=0; x<gridSize; x++) {
+      osmscout::GeoCoord coord(boundingBox.GetMinLat()+boundingBox.GetHeight()*(y+0.5)/gridSize,
+                               boundingBox.GetMinLon()+boundingBox.GetWidth()*(x+0.5)/gridSize);
+      auto               result=aStarRouter.GetClosestRoutableNode(coord,
+                                                                   *profile,
+                                                                   osmscout::Kilometers(1));
+
+      if (result.IsValid()) {
+        positions.push_back(result.GetRoutePosition());
+      }
+    }
+  }
+
+  osmscout::RoutingParameter parameter;
+  double                     hierarchyTime=0.0;
+  double                     aStarTime=0.0;
+  size_t                     routeCount=0;
+  size_t                     errorCount=0;
+
+  for (size_t s=0; s<positions.size(); s++) {
+    for (size_t t=0; t<positions.size(); t++) {
+      if (s==t) {
+        continue;
+      }
+
+      osmscout::StopClock hierarchyClock;
+      auto                hierarchyResult=hierarchyRouter.CalculateRoute(*profile,
+                                                                         positions[s],
+                                                                         positions[t],
+                                                                         parameter);
+
+      hierarchyClock.Stop();
+
+      osmscout::StopClock aStarClock;
+      auto                aStarResult=aStarRouter.CalculateRoute(*profile,
+                                                                 positions[s],
+                                                                 positions[t],
+                                                                 parameter);
+
+      aStarClock.Stop();
+
+      hierarchyTime+=hierarchyClock.GetMilliseconds();
+      aStarTime+=aStarClock.GetMilliseconds();
+
+      if (hierarchyResult.Success()!=aStarResult.Success()) {
+        std::cerr << "ERROR: Route " << s << " => " << t << " found by only one router" << std::endl;
+        errorCount++;
+        continue;
+      }
+
+      if (!aStarResult.Success()) {
+        continue;
+      }
+
+      double hierarchyLength=GetRouteLength(hierarchyRouter,hierarchyResult);
+      double aStarLength=GetRouteLength(aStarRouter,aStarResult);
+
+      routeCount++;
+
+      if (std::abs(hierarchyLength-aStarLength)>1.0+aStarLength*0.001) {
+        std::cerr << "ERROR: Route " << s << " => " << t << " has different length: "
+                  << hierarchyLength << "m <=> " << aStarLength << "m" << std::endl;
+        errorCount++;
+      }
+    }
+  }
+
+  hierarchyRouter.Close();
+  aStarRouter.Close();
+  database->Close();
+
+  std::filesystem::remove_all(directory);
+
+  std::cout << "Routes: " << routeCount << std::endl;
+  std::cout << "Contraction hierarchy - " << hierarchyTime << "ms" << std::endl;
+  std::cout << "A*                    - " << aStarTime << "ms" << std::endl;
+
+  if (routeCount==0) {
+    std::cerr << "ERROR: No routes found" << std::endl;
+    return 1;
+  }
+
+  return errorCount==0 ? 0 : 1;
+}
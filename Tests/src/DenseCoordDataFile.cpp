@@ -0,0 +1,108 @@
+/*
+  DenseCoordDataFile - a test program for libosmscout
+  Copyright (C) 2026  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <osmscout/util/File.h>
+
+#include <osmscoutimport/DenseCoordDataFile.h>
+
+#include <TestMain.h>
+
+static osmscout::Point GetTestPoint(osmscout::OSMId id)
+{
+  return osmscout::Point((uint8_t)(1+id%200),
+                         osmscout::GeoCoord(50.0+id*0.00001,
+                                            7.0+id*0.00002));
+}
+
+static void RequireEqual(const osmscout::Point& point,
+                         const osmscout::Point& expected)
+{
+  REQUIRE(point.GetSerial()==expected.GetSerial());
+  REQUIRE(point.GetCoord().GetDisplayText()==expected.GetCoord().GetDisplayText());
+}
+
+TEST_CASE("Write and resolve dense coordinates")
+{
+  std::vector<osmscout::OSMId> writtenIds={100,101,102,110,5000,5001,1000000};
+
+  osmscout::DenseCoordDataFileWriter writer;
+
+  writer.Open(".");
+
+  for (const auto id : writtenIds) {
+    writer.Write(id,GetTestPoint(id));
+  }
+
+  // Overwriting an entry with the same id
+  writer.Write(5000,GetTestPoint(5001));
+  writer.Close();
+
+  osmscout::DenseCoordDataFile file;
+
+  REQUIRE(file.Open(".",false));
+
+  std::vector<osmscout::OSMId> ids={1000000,100,99,101,103,5000,110,1000001,102,5001,-5};
+  std::vector<osmscout::Point> points;
+
+  REQUIRE(file.Get(ids,points));
+  REQUIRE(points.size()==ids.size());
+
+  RequireEqual(points[0],GetTestPoint(1000000));
+  RequireEqual(points[1],GetTestPoint(100));
+  REQUIRE(!osmscout::DenseCoordDataFile::IsResolved(points[2]));
+  RequireEqual(points[3],GetTestPoint(101));
+  REQUIRE(!osmscout::DenseCoordDataFile::IsResolved(points[4]));
+  RequireEqual(points[5],GetTestPoint(5001));
+  RequireEqual(points[6],GetTestPoint(110));
+  REQUIRE(!osmscout::DenseCoordDataFile::IsResolved(points[7]));
+  RequireEqual(points[8],GetTestPoint(102));
+  RequireEqual(points[9],GetTestPoint(5001));
+  REQUIRE(!osmscout::DenseCoordDataFile::IsResolved(points[10]));
+
+  REQUIRE(file.Close());
+
+  // Memory mapped files are read without locking
+  osmscout::DenseCoordDataFile mappedFile;
+  std::vector<osmscout::Point> mappedPoints;
+
+  REQUIRE(mappedFile.Open(".",true));
+  REQUIRE(mappedFile.Get(ids,mappedPoints));
+  REQUIRE(mappedPoints.size()==points.size());
+
+  for (size_t i=0; i<points.size(); i++) {
+    RequireEqual(mappedPoints[i],points[i]);
+  }
+
+  REQUIRE(mappedFile.Close());
+  REQUIRE(osmscout::RemoveFile(file.GetFilename()));
+}
+
+TEST_CASE("Ids have to be written in increasing order")
+{
+  osmscout::DenseCoordDataFileWriter writer;
+
+  writer.Open(".");
+  writer.Write(100,GetTestPoint(100));
+
+  REQUIRE_THROWS_AS(writer.Write(99,GetTestPoint(99)),osmscout::IOException);
+
+  writer.CloseFailsafe();
+
+  REQUIRE(osmscout::RemoveFile(writer.GetFilename()));
+}
@@ -0,0 +1,221 @@
+/*
+  ImportModuleOrder - a test program for libosmscout
+  Copyright (C) 2026  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <chrono>
+#include <mutex>
+#include <thread>
+
+#include <osmscoutimport/Import.h>
+
+#include <TestMain.h>
+
+using namespace osmscout;
+
+namespace {
+
+  ImportModuleDescription MakeDescription(const std::string& name,
+                                          const std::list<std::string>& requiredFiles,
+                                          const std::list<std::string>& providedFiles)
+  {
+    ImportModuleDescription description;
+
+    description.SetName(name);
+
+    for (const auto& file : requiredFiles) {
+      description.AddRequiredFile(file);
+    }
+
+    for (const auto& file : providedFiles) {
+      description.AddProvidedFile(file);
+    }
+
+    return description;
+  }
+
+  /**
+   * Modules 1 and 2 only depend on module 0, modules 0 and 3 have no required
+   * files and thus are barriers, modules 4 and 5 are independent of each other
+   */
+  std::vector<ImportModuleDescription> GetDescriptions()
+  {
+    return {
+      MakeDescription("Preprocess",{},{"raw.dat"}),
+      MakeDescription("Nodes",{"raw.dat"},{"nodes.dat"}),
+      MakeDescription("Ways",{"raw.dat"},{"ways.dat"}),
+      MakeDescription("Barrier",{},{"barrier.dat"}),
+      MakeDescription("NodeIndex",{"nodes.dat"},{"nodes.idx"}),
+      MakeDescription("WayIndex",{"ways.dat"},{"ways.idx"})
+    };
+  }
+
+  /**
+   * Start and end of the execution of each module, as position in the sequence of
+   * all start and end events
+   */
+  struct Execution
+  {
+    size_t start=0;
+    size_t end=0;
+  };
+
+  std::vector<Execution> Execute(const std::vector<std::set<size_t>>& dependencies,
+                                 std::vector<bool>& finishedModules,
+                                 size_t threadCount)
+  {
+    std::mutex             mutex;
+    size_t                 eventCount=0;
+    std::vector<Execution> executions(dependencies.size());
+
+    bool success=Importer::ExecuteModulesInDependencyOrder(dependencies,
+                                                           finishedModules,
+                                                           threadCount,
+                                                           []() {
+                                                             return true;
+                                                           },
+                                                           [&](size_t index) {
+                                                             {
+                                                               std::scoped_lock<std::mutex> lock(mutex);
+
+                                                               executions[index].start=++eventCount;
+                                                             }
+
+                                                             // Give other workers the chance to start further modules
+                                                             std::this_thread::sleep_for(std::chrono::milliseconds(20));
+
+                                                             std::scoped_lock<std::mutex> lock(mutex);
+
+                                                             executions[index].end=++eventCount;
+
+                                                             return true;
+                                                           },
+                                                           [](size_t /*index*/) {
+                                                             return true;
+                                                           });
+
+    REQUIRE(success);
+
+    return executions;
+  }
+}
+
+TEST_CASE("Modules depend on the modules providing their required files")
+{
+  std::vector<std::set<size_t>> dependencies;
+
+  Importer::GetModuleDependencies(GetDescriptions(),
+                                  dependencies);
+
+  REQUIRE(dependencies.size()==6);
+  REQUIRE(dependencies[0].empty());
+  REQUIRE(dependencies[1]==std::set<size_t>{0});
+  REQUIRE(dependencies[2]==std::set<size_t>{0});
+  REQUIRE(dependencies[3]==std::set<size_t>{0,1,2});
+}
+
+TEST_CASE("Modules without required files are a barrier in both directions")
+{
+  std::vector<std::set<size_t>> dependencies;
+
+  Importer::GetModuleDependencies(GetDescriptions(),
+                                  dependencies);
+
+  // Module 0 has no required files, too
+  REQUIRE(dependencies[4]==std::set<size_t>{0,1,3});
+  REQUIRE(dependencies[5]==std::set<size_t>{0,2,3});
+}
+
+TEST_CASE("Parallel execution respects the dependencies")
+{
+  std::vector<std::set<size_t>> dependencies;
+
+  Importer::GetModuleDependencies(GetDescriptions(),
+                                  dependencies);
+
+  std::vector<bool>      finishedModules(dependencies.size(),false);
+  std::vector<Execution> executions=Execute(dependencies,
+                                            finishedModules,
+                                            4);
+
+  for (size_t i=0; i<dependencies.size(); i++) {
+    REQUIRE(finishedModules[i]);
+    REQUIRE(executions[i].start>0);
+
+    for (auto dependency : dependencies[i]) {
+      REQUIRE(executions[dependency].end<executions[i].start);
+    }
+  }
+
+  // Independent modules run in parallel
+  REQUIRE(executions[2].start<executions[1].end);
+  REQUIRE(executions[5].start<executions[4].end);
+}
+
+TEST_CASE("Modules already finished are skipped")
+{
+  std::vector<std::set<size_t>> dependencies;
+
+  Importer::GetModuleDependencies(GetDescriptions(),
+                                  dependencies);
+
+  std::vector<bool> finishedModules(dependencies.size(),false);
+
+  finishedModules[0]=true;
+  finishedModules[3]=true;
+
+  std::vector<Execution> executions=Execute(dependencies,
+                                            finishedModules,
+                                            2);
+
+  REQUIRE(executions[0].start==0);
+  REQUIRE(executions[3].start==0);
+  REQUIRE(executions[1].start>0);
+  REQUIRE(executions[4].start>executions[1].end);
+}
+
+TEST_CASE("No further modules are started after a failure")
+{
+  std::vector<std::set<size_t>> dependencies;
+
+  Importer::GetModuleDependencies(GetDescriptions(),
+                                  dependencies);
+
+  std::vector<bool>   finishedModules(dependencies.size(),false);
+  std::vector<size_t> executedModules;
+  std::mutex          mutex;
+
+  bool success=Importer::ExecuteModulesInDependencyOrder(dependencies,
+                                                         finishedModules,
+                                                         2,
+                                                         []() {
+                                                           return true;
+                                                         },
+                                                         [&](size_t index) {
+                                                           std::scoped_lock<std::mutex> lock(mutex);
+
+                                                           executedModules.push_back(index);
+
+                                                           return index!=0;
+                                                         },
+                                                         [](size_t /*index*/) {
+                                                           return true;
+                                                         });
+
+  REQUIRE(!success);
+  REQUIRE(executedModules==std::vector<size_t>{0});
+}
@@ -0,0 +1,409 @@
+/*
+  LabelRegistry - a test program for libosmscout
+  Copyright (C) 2026  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <osmscoutmap/LabelLayouter.h>
+#include <osmscoutmap/LabelRegistry.h>
+#include <osmscoutmap/MapParameter.h>
+
+#include <TestMain.h>
+
+using namespace osmscout;
+
+namespace osmscout {
+
+  /**
+   * One glyph of 10x10 pixel per character, the glyph is the index of the character
+   */
+  template<>
+  std::vector<Glyph<int>> Label<int,int>::ToGlyphs() const
+  {
+    std::vector<Glyph<int>> glyphs(text.length());
+
+    for (size_t i=0; i<glyphs.size(); i++) {
+      glyphs[i].glyph=int(i);
+      glyphs[i].position=Vertex2D(10.0*i,0.0);
+    }
+
+    return glyphs;
+  }
+}
+
+namespace {
+
+  /**
+   * Text layouter with a fixed size of 10x10 pixel per character
+   */
+  class TestTextLayouter
+  {
+  public:
+    using LabelType=Label<int,int>;
+
+    std::shared_ptr<LabelType> Layout(const Projection& /*projection*/,
+                                      const MapParameter& /*parameter*/,
+                                      const std::string& text,
+                                      double fontSize,
+                                      double /*objectWidth*/,
+                                      bool /*enableWrapping*/,
+                                      bool /*contourLabel*/)
+    {
+      auto label=std::make_shared<LabelType>();
+
+      label->text=text;
+      label->fontSize=fontSize;
+      label->width=10.0*text.length();
+      label->height=10.0;
+
+      return label;
+    }
+
+    DoubleRectangle GlyphBoundingBox(const int& /*glyph*/) const
+    {
+      return DoubleRectangle(0,0,10,10);
+    }
+  };
+
+  using TestLabelLayouter=LabelLayouter<int,int,TestTextLayouter>;
+
+  constexpr size_t tileSize=256;
+
+  /**
+   * Renders the labels of one tile
+   */
+  class TestTile
+  {
+  public:
+    MercatorProjection projection;
+    TestTextLayouter   textLayouter;
+    TestLabelLayouter  layouter{&textLayouter};
+
+    explicit TestTile(const GeoCoord& center)
+    {
+      projection.Set(center,
+                     Magnification(Magnification::magClose),
+                     96.0,
+                     tileSize,
+                     tileSize);
+
+      layouter.SetViewport(DoubleRectangle(0,0,tileSize,tileSize));
+      layouter.SetLayoutOverlap(10);
+    }
+
+    void Register(const MapParameter& parameter,
+                  const GeoCoord& coord,
+                  const std::string& text,
+                  size_t priority,
+                  FileOffset offset)
+    {
+      LabelData data;
+      double    x;
+      double    y;
+
+      data.type=LabelData::Text;
+      data.priority=priority;
+      data.fontSize=1.0;
+      data.text=text;
+      data.object=ObjectFileRef(offset,refNode);
+
+      projection.GeoToPixel(coord,x,y);
+
+      layouter.RegisterLabel(projection,
+                             parameter,
+                             Vertex2D(x,y),
+                             data);
+    }
+
+    /**
+     * Register a horizontal contour label along the given coordinates
+     */
+    void RegisterContour(const MapParameter& parameter,
+                         const GeoCoord& from,
+                         const GeoCoord& to,
+                         const std::string& text,
+                         size_t priority,
+                         FileOffset offset)
+    {
+      PathLabelData data;
+      LabelPath     path;
+      double        x;
+      double        y;
+
+      data.priority=priority;
+      data.text=text;
+      data.height=1.0;
+      data.contourLabelOffset=0.0;
+      data.contourLabelSpace=20.0;
+      data.object=ObjectFileRef(offset,refWay);
+
+      projection.GeoToPixel(from,x,y);
+      path.AddPoint(x,y);
+      projection.GeoToPixel(to,x,y);
+      path.AddPoint(x,y);
+
+      layouter.RegisterContourLabel(projection,
+                                    parameter,
+                                    data,
+                                    path);
+    }
+
+    const TestLabelLayouter::LabelInstanceType* Find(FileOffset offset) const
+    {
+      for (const auto& label : layouter.Labels()) {
+        if (label.object==ObjectFileRef(offset,refNode)) {
+          return &label;
+        }
+      }
+
+      return nullptr;
+    }
+  };
+
+  GeoCoord GetNeighbourCenter(const TestTile& tile)
+  {
+    GeoCoord center;
+
+    tile.projection.PixelToGeo(tileSize+tileSize/2,tileSize/2,center);
+
+    return center;
+  }
+}
+
+TEST_CASE("Registry keeps the first decision")
+{
+  LabelRegistry registry;
+  ObjectFileRef object(100,refNode);
+  Magnification magnification(Magnification::magClose);
+
+  REQUIRE_FALSE(registry.Get(object,magnification).has_value());
+
+  LabelRegistry::Placement placement;
+
+  placement.placed=true;
+  placement.origin=GeoCoord(50.0,7.0);
+  placement.visibleElements=1;
+
+  REQUIRE(registry.Commit(object,magnification,placement).placed);
+
+  LabelRegistry::Placement rejected;
+
+  REQUIRE(registry.Commit(object,magnification,rejected).placed);
+
+  auto registered=registry.Get(object,magnification);
+
+  REQUIRE(registered.has_value());
+  REQUIRE(registered->placed);
+  REQUIRE(registered->origin==GeoCoord(50.0,7.0));
+
+  REQUIRE_FALSE(registry.Get(object,Magnification(Magnification::magCloser)).has_value());
+  REQUIRE_FALSE(registry.Get(ObjectFileRef(100,refWay),magnification).has_value());
+}
+
+TEST_CASE("Registry keeps the decisions for the labels of an object apart")
+{
+  LabelRegistry registry;
+  ObjectFileRef object(100,refWay);
+  Magnification magnification(Magnification::magClose);
+
+  LabelRegistry::Placement placement;
+
+  placement.placed=true;
+
+  REQUIRE(registry.Commit(object,magnification,placement,0).placed);
+  REQUIRE_FALSE(registry.Commit(object,magnification,LabelRegistry::Placement(),1).placed);
+
+  REQUIRE(registry.Get(object,magnification,0)->placed);
+  REQUIRE_FALSE(registry.Get(object,magnification,1)->placed);
+  REQUIRE_FALSE(registry.Get(object,magnification,2).has_value());
+}
+
+TEST_CASE("Registry drops the least recently used decision if it gets too large")
+{
+  LabelRegistry registry(10);
+  Magnification magnification(Magnification::magClose);
+
+  for (FileOffset offset=0; offset<10; offset++) {
+    registry.Commit(ObjectFileRef(offset,refNode),magnification,LabelRegistry::Placement());
+  }
+
+  REQUIRE(registry.GetSize()==10);
+
+  // Use the oldest decision again, so the second oldest gets dropped
+  REQUIRE(registry.Get(ObjectFileRef(0,refNode),magnification).has_value());
+
+  registry.Commit(ObjectFileRef(10,refNode),magnification,LabelRegistry::Placement());
+
+  REQUIRE(registry.GetSize()==10);
+  REQUIRE(registry.Get(ObjectFileRef(0,refNode),magnification).has_value());
+  REQUIRE_FALSE(registry.Get(ObjectFileRef(1,refNode),magnification).has_value());
+  REQUIRE(registry.Get(ObjectFileRef(2,refNode),magnification).has_value());
+  REQUIRE(registry.Get(ObjectFileRef(10,refNode),magnification).has_value());
+
+  registry.Clear();
+
+  REQUIRE(registry.GetSize()==0);
+}
+
+TEST_CASE("Label crossing the tile border is placed in both tiles")
+{
+  MapParameter parameter;
+
+  parameter.SetLabelRegistry(std::make_shared<LabelRegistry>());
+
+  TestTile left(GeoCoord(50.0,7.0));
+  TestTile right(GetNeighbourCenter(left));
+
+  GeoCoord borderLabel;
+  GeoCoord blockingLabel;
+
+  // the label crosses the tile border
+  left.projection.PixelToGeo(tileSize-6,tileSize/2,borderLabel);
+  // the label is in the right tile only and collides with the border label
+  right.projection.PixelToGeo(40,tileSize/2,blockingLabel);
+
+  left.Register(parameter,borderLabel,"border",10,1);
+  left.layouter.Layout(left.projection,parameter);
+
+  REQUIRE(left.Find(1)!=nullptr);
+
+  right.Register(parameter,borderLabel,"border",10,1);
+  right.Register(parameter,blockingLabel,"blocking",5,2);
+  right.layouter.Layout(right.projection,parameter);
+
+  const auto* label=right.Find(1);
+
+  REQUIRE(label!=nullptr);
+  REQUIRE(right.Find(2)==nullptr);
+
+  double x;
+  double y;
+
+  right.projection.GeoToPixel(borderLabel,x,y);
+
+  REQUIRE(std::abs(label->elements.front().x-(x-30.0))<0.01);
+  REQUIRE(std::abs(label->elements.front().y-(y-5.0))<0.01);
+}
+
+TEST_CASE("Label rejected in one tile is dropped in the neighbour tile")
+{
+  MapParameter parameter;
+
+  parameter.SetLabelRegistry(std::make_shared<LabelRegistry>());
+
+  TestTile left(GeoCoord(50.0,7.0));
+  TestTile right(GetNeighbourCenter(left));
+
+  GeoCoord borderLabel;
+  GeoCoord blockingLabel;
+
+  left.projection.PixelToGeo(tileSize-6,tileSize/2,borderLabel);
+  left.projection.PixelToGeo(tileSize-60,tileSize/2,blockingLabel);
+
+  left.Register(parameter,borderLabel,"border",10,1);
+  left.Register(parameter,blockingLabel,"blocking",5,2);
+  left.layouter.Layout(left.projection,parameter);
+
+  REQUIRE(left.Find(1)==nullptr);
+  REQUIRE(left.Find(2)!=nullptr);
+
+  right.Register(parameter,borderLabel,"border",10,1);
+  right.layouter.Layout(right.projection,parameter);
+
+  REQUIRE(right.Find(1)==nullptr);
+}
+
+TEST_CASE("Contour label crossing the tile border is placed in both tiles")
+{
+  MapParameter parameter;
+
+  parameter.SetLabelRegistry(std::make_shared<LabelRegistry>());
+
+  TestTile left(GeoCoord(50.0,7.0));
+  TestTile right(GetNeighbourCenter(left));
+
+  GeoCoord pathFrom;
+  GeoCoord pathTo;
+  GeoCoord blockingLabel;
+
+  // the path holds a single label, crossing the tile border
+  left.projection.PixelToGeo(tileSize-56,tileSize/2,pathFrom);
+  left.projection.PixelToGeo(tileSize+76,tileSize/2,pathTo);
+  // the label is in the right tile only and collides with the contour label
+  right.projection.PixelToGeo(10,tileSize/2,blockingLabel);
+
+  left.RegisterContour(parameter,pathFrom,pathTo,"road",10,1);
+  left.layouter.Layout(left.projection,parameter);
+
+  REQUIRE(left.layouter.ContourLabels().size()==1);
+
+  right.RegisterContour(parameter,pathFrom,pathTo,"road",10,1);
+  right.Register(parameter,blockingLabel,"blocking",5,2);
+  right.layouter.Layout(right.projection,parameter);
+
+  REQUIRE(right.layouter.ContourLabels().size()==1);
+  REQUIRE(right.Find(2)==nullptr);
+}
+
+TEST_CASE("Label replaced by the registered decision does not occupy its own place")
+{
+  MapParameter parameter;
+
+  parameter.SetLabelRegistry(std::make_shared<LabelRegistry>());
+
+  TestTile tile(GeoCoord(50.0,7.0));
+
+  GeoCoord first;
+  GeoCoord second;
+
+  tile.projection.PixelToGeo(tileSize/2,tileSize/4,first);
+  tile.projection.PixelToGeo(tileSize/2,3*tileSize/4,second);
+
+  // Both labels of the object are decided in the same layout. The decision for
+  // the second one loses against the decision for the first one, it is moved.
+  tile.Register(parameter,first,"first",1,1);
+  tile.Register(parameter,second,"second",2,1);
+  // The label is placed, if the second label did not mark its original place
+  tile.Register(parameter,second,"third",3,3);
+  tile.layouter.Layout(tile.projection,parameter);
+
+  REQUIRE(tile.Find(3)!=nullptr);
+}
+
+TEST_CASE("Without registry tiles decide independently")
+{
+  MapParameter parameter;
+
+  TestTile left(GeoCoord(50.0,7.0));
+  TestTile right(GetNeighbourCenter(left));
+
+  GeoCoord borderLabel;
+  GeoCoord blockingLabel;
+
+  left.projection.PixelToGeo(tileSize-6,tileSize/2,borderLabel);
+  right.projection.PixelToGeo(40,tileSize/2,blockingLabel);
+
+  left.Register(parameter,borderLabel,"border",10,1);
+  left.layouter.Layout(left.projection,parameter);
+
+  right.Register(parameter,borderLabel,"border",10,1);
+  right.Register(parameter,blockingLabel,"blocking",5,2);
+  right.layouter.Layout(right.projection,parameter);
+
+  REQUIRE(left.Find(1)!=nullptr);
+  REQUIRE(right.Find(1)==nullptr);
+  REQUIRE(right.Find(2)!=nullptr);
+}
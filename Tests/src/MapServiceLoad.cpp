@@ -0,0 +1,248 @@
+/*
+  MapServiceLoad - a test program for libosmscout
+  Copyright (C) 2026  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <atomic>
+#include <iostream>
+#include <list>
+#include <thread>
+#include <vector>
+
+#include <osmscout/Database.h>
+
+#include <osmscoutmap/MapService.h>
+#include <osmscoutmap/StyleConfig.h>
+
+#include <osmscout/util/Breaker.h>
+#include <osmscout/util/CmdLineParsing.h>
+#include <osmscout/util/StopClock.h>
+
+/**
+  Load the tiles covering the given database by multiple clients of the same
+  MapService at the same time and compare the loaded data with the data
+  loaded by a single client of another MapService. Every second client uses
+  its own breaker, so its loads cannot be shared with the loads of the other
+  clients and run for the same tiles in parallel.
+  */
+
+struct TileDataSize
+{
+  size_t nodes;
+  size_t ways;
+  size_t areas;
+  size_t routes;
+  size_t optimizedWays;
+  size_t optimizedAreas;
+
+  bool operator==(const TileDataSize& other) const
+  {
+    return nodes==other.nodes &&
+           ways==other.ways &&
+           areas==other.areas &&
+           routes==other.routes &&
+           optimizedWays==other.optimizedWays &&
+           optimizedAreas==other.optimizedAreas;
+  }
+};
+
+std::vector<TileDataSize> GetTileDataSizes(const std::list<osmscout::TileRef>& tiles)
+{
+  std::vector<TileDataSize> sizes;
+
+  for (const auto& tile : tiles) {
+    sizes.push_back(TileDataSize{tile->GetNodeData().GetDataSize(),
+                                 tile->GetWayData().GetDataSize(),
+                                 tile->GetAreaData().GetDataSize(),
+                                 tile->GetRouteData().GetDataSize(),
+                                 tile->GetOptimizedWayData().GetDataSize(),
+                                 tile->GetOptimizedAreaData().GetDataSize()});
+  }
+
+  return sizes;
+}
+
+int main(int argc, char* argv[])
+{
+  std::string databaseDirectory;
+  std::string styleSheet;
+  size_t      clientCount=4;
+  size_t      level=15;
+  bool        help=false;
+  osmscout::CmdLineParser argParser("MapServiceLoad", argc, argv);
+
+  argParser.AddOption(osmscout::CmdLineFlag([&](const bool& value) {
+              help=value;
+            }),
+            std::vector<std::string>{"h","help"},
+            "Display help",
+            true);
+
+  argParser.AddOption(osmscout::CmdLineSizeTOption([&](const size_t& value) {
+                  clientCount=value;
+                }),
+                "clients",
+                "Number of concurrent clients, default: "+std::to_string(clientCount));
+
+  argParser.AddOption(osmscout::CmdLineSizeTOption([&](const size_t& value) {
+                  level=value;
+                }),
+                "level",
+                "Magnification level of the tiles, default: "+std::to_string(level));
+
+  argParser.AddPositional(osmscout::CmdLineStringOption([&](const std::string& value) {
+                            databaseDirectory=value;
+                          }),
+                          "DATABASE",
+                          "Directory of the database to use");
+
+  argParser.AddPositional(osmscout::CmdLineStringOption([&](const std::string& value) {
+                            styleSheet=value;
+                          }),
+                          "STYLESHEET",
+                          "Style config file");
+
+  osmscout::CmdLineParseResult argResult=argParser.Parse();
+  if (argResult.HasError()) {
+    std::cerr << "ERROR: " << argResult.GetErrorDescription() << std::endl;
+    std::cout << argParser.GetHelp() << std::endl;
+    return 1;
+  }
+  if (help){
+    std::cout << argParser.GetHelp() << std::endl;
+    return 0;
+  }
+
+  osmscout::DatabaseParameter databaseParameter;
+  osmscout::DatabaseRef       database=std::make_shared<osmscout::Database>(databaseParameter);
+
+  if (!database->Open(databaseDirectory)) {
+    std::cerr << "ERROR: Cannot open database" << std::endl;
+    return 1;
+  }
+
+  osmscout::StyleConfigRef styleConfig=std::make_shared<osmscout::StyleConfig>(database->GetTypeConfig());
+
+  if (!styleConfig->Load(styleSheet)) {
+    std::cerr << "ERROR: Cannot open style config" << std::endl;
+    return 1;
+  }
+
+  osmscout::GeoBox boundingBox;
+
+  if (!database->GetBoundingBox(boundingBox)) {
+    std::cerr << "ERROR: Cannot get bounding box" << std::endl;
+    return 1;
+  }
+
+  osmscout::Magnification       magnification{osmscout::MagnificationLevel(level)};
+  osmscout::AreaSearchParameter searchParameter;
+
+  // Reference data, loaded by a single client
+
+  osmscout::MapService          referenceService(database);
+  std::list<osmscout::TileRef>  referenceTiles;
+  osmscout::StopClock           referenceClock;
+
+  referenceService.LookupTiles(magnification,
+                               boundingBox,
+                               referenceTiles);
+
+  if (!referenceService.LoadMissingTileData(searchParameter,
+                                            *styleConfig,
+                                            referenceTiles)) {
+    std::cerr << "ERROR: Cannot load tiles" << std::endl;
+    return 1;
+  }
+
+  referenceClock.Stop();
+
+  // The same tiles, loaded by multiple clients at the same time
+
+  osmscout::MapService                      service(database);
+  std::vector<std::list<osmscout::TileRef>> clientTiles(clientCount);
+  std::vector<std::thread>                  clients;
+  std::atomic<size_t>                       errorCount(0);
+  osmscout::StopClock                       clientClock;
+
+  for (size_t c=0; c<clientCount; c++) {
+    clients.emplace_back([&,c]() {
+      osmscout::AreaSearchParameter clientParameter(searchParameter);
+
+      if (c%2==1) {
+        clientParameter.SetBreaker(std::make_shared<osmscout::ThreadedBreaker>());
+      }
+
+      service.LookupTiles(magnification,
+                          boundingBox,
+                          clientTiles[c]);
+
+      if (!service.LoadMissingTileData(clientParameter,
+                                       *styleConfig,
+                                       clientTiles[c])) {
+        errorCount++;
+      }
+    });
+  }
+
+  for (auto& client : clients) {
+    client.join();
+  }
+
+  clientClock.Stop();
+
+  if (errorCount>0) {
+    std::cerr << "ERROR: Cannot load tiles by concurrent clients" << std::endl;
+    return 1;
+  }
+
+  std::vector<TileDataSize> referenceSizes=GetTileDataSizes(referenceTiles);
+
+  for (size_t c=0; c<clientCount; c++) {
+    for (const auto& tile : clientTiles[c]) {
+      if (!tile->IsComplete()) {
+        std::cerr << "ERROR: Tile " << tile->GetKey().GetDisplayText() << " of client " << c << " is not complete" << std::endl;
+        errorCount++;
+      }
+    }
+
+    // Objects loaded twice for the same tile would show up as a different size
+    if (GetTileDataSizes(clientTiles[c])!=referenceSizes) {
+      std::cerr << "ERROR: Tiles of client " << c << " differ from reference" << std::endl;
+      errorCount++;
+    }
+  }
+
+  size_t objectCount=0;
+
+  for (const auto& size : referenceSizes) {
+    objectCount+=size.nodes+size.ways+size.areas+size.routes+size.optimizedWays+size.optimizedAreas;
+  }
+
+  std::cout << "Tiles: " << referenceTiles.size() << ", objects: " << objectCount << std::endl;
+  std::cout << "Single client - " << referenceClock.GetMilliseconds() << "ms" << std::endl;
+  std::cout << clientCount << " clients     - " << clientClock.GetMilliseconds() << "ms" << std::endl;
+
+  database->Close();
+
+  if (objectCount==0) {
+    std::cerr << "ERROR: No objects loaded" << std::endl;
+    return 1;
+  }
+
+  return errorCount==0 ? 0 : 1;
+}
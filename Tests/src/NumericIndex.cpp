@@ -0,0 +1,190 @@
+/*
+  NumericIndex - a test program for libosmscout
+  Copyright (C) 2026  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <map>
+
+#include <osmscout/NumericIndex.h>
+
+#include <osmscout/util/File.h>
+#include <osmscout/util/FileWriter.h>
+
+#include <osmscoutimport/GenNumericIndex.h>
+
+#include <TestMain.h>
+
+namespace {
+
+  const char* const dataFilename="numericindex.dat";
+  const char* const indexFilename="numericindex.idx";
+
+  /**
+   * Minimal data type as expected by NumericIndexGenerator
+   */
+  class TestData
+  {
+  private:
+    osmscout::OSMId id=0;
+
+  public:
+    osmscout::OSMId GetId() const
+    {
+      return id;
+    }
+
+    void Read(const osmscout::TypeConfig& /*typeConfig*/,
+              osmscout::FileScanner& scanner)
+    {
+      id=scanner.ReadInt64Number();
+    }
+  };
+
+  /**
+   * Write a data file with the given ids and return the file offset
+   * of each id
+   */
+  std::map<osmscout::OSMId,osmscout::FileOffset> WriteDataFile(const std::vector<osmscout::OSMId>& ids)
+  {
+    std::map<osmscout::OSMId,osmscout::FileOffset> offsets;
+    osmscout::FileWriter                           writer;
+
+    writer.Open(dataFilename);
+    writer.Write((uint32_t)ids.size());
+
+    for (const auto id : ids) {
+      offsets[id]=writer.GetPos();
+      // variable length numbers, so that offsets are not evenly spaced
+      writer.WriteNumber((int64_t)id);
+    }
+
+    writer.Close();
+
+    return offsets;
+  }
+
+  void GenerateIndex()
+  {
+    osmscout::NumericIndexGenerator<osmscout::OSMId,TestData> generator("Generating index",
+                                                                        dataFilename,
+                                                                        indexFilename);
+    osmscout::ImportParameter                                 parameter;
+    osmscout::SilentProgress                                  progress;
+
+    parameter.SetDestinationDirectory(".");
+
+    REQUIRE(generator.Import(std::make_shared<osmscout::TypeConfig>(),
+                             parameter,
+                             progress));
+  }
+
+  void RemoveFiles()
+  {
+    REQUIRE(osmscout::RemoveFile(dataFilename));
+    REQUIRE(osmscout::RemoveFile(indexFilename));
+  }
+
+  std::vector<osmscout::OSMId> GetTestIds(size_t count)
+  {
+    std::vector<osmscout::OSMId> ids;
+
+    ids.reserve(count);
+
+    // negative and positive ids with gaps
+    for (size_t i=0; i<count; i++) {
+      ids.push_back((osmscout::OSMId)(i*3)-(osmscout::OSMId)count);
+    }
+
+    return ids;
+  }
+
+  void CheckIndex(const std::vector<osmscout::OSMId>& ids,
+                  const std::map<osmscout::OSMId,osmscout::FileOffset>& expectedOffsets,
+                  size_t cacheSize,
+                  bool memoryMapped)
+  {
+    osmscout::NumericIndex<osmscout::OSMId> index(indexFilename,
+                                                  cacheSize);
+
+    REQUIRE(index.Open(".",memoryMapped));
+
+    for (const auto id : ids) {
+      osmscout::FileOffset offset;
+
+      REQUIRE(index.GetOffset(id,offset));
+      REQUIRE(offset==expectedOffsets.at(id));
+
+      // the gaps between ids are not found
+      REQUIRE_FALSE(index.GetOffset(id+1,offset));
+    }
+
+    osmscout::FileOffset offset;
+
+    REQUIRE_FALSE(index.GetOffset(ids.front()-1,offset));
+    REQUIRE_FALSE(index.GetOffset(ids.back()+1,offset));
+
+    // Batched lookup in unsorted order, including unknown ids
+    std::vector<osmscout::OSMId>      batch(ids.rbegin(),ids.rend());
+    std::vector<osmscout::FileOffset> offsets;
+
+    batch.push_back(ids.back()+2);
+
+    REQUIRE(index.GetOffsets(batch.begin(),batch.end(),batch.size(),offsets));
+    REQUIRE(offsets.size()==ids.size());
+
+    for (size_t i=0; i<offsets.size(); i++) {
+      REQUIRE(offsets[i]==expectedOffsets.at(batch[i]));
+    }
+
+    REQUIRE(index.Close());
+  }
+}
+
+TEST_CASE("Write and read index with a single entry")
+{
+  std::vector<osmscout::OSMId> ids={42};
+  auto                         offsets=WriteDataFile(ids);
+
+  GenerateIndex();
+
+  CheckIndex(ids,offsets,1000,false);
+
+  RemoveFiles();
+}
+
+TEST_CASE("Write and read index with multiple levels")
+{
+  // 8 keys per block, so 2000 entries result in four levels
+  std::vector<osmscout::OSMId> ids=GetTestIds(2000);
+  auto                         offsets=WriteDataFile(ids);
+
+  GenerateIndex();
+
+  SECTION("Inner levels cached") {
+    CheckIndex(ids,offsets,1000,false);
+  }
+
+  SECTION("Inner levels cached, memory mapped") {
+    CheckIndex(ids,offsets,1000,true);
+  }
+
+  SECTION("Inner levels read on demand") {
+    CheckIndex(ids,offsets,0,false);
+  }
+
+  RemoveFiles();
+}
@@ -0,0 +1,89 @@
+/*
+  ObjectArena - a test program for libosmscout
+  Copyright (C) 2026  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <cstdint>
+
+#include <osmscout/Way.h>
+
+#include <osmscout/util/ObjectArena.h>
+
+#include <TestMain.h>
+
+TEST_CASE("Allocations are aligned and reuse the current chunk")
+{
+  osmscout::ObjectArena arena(1024);
+
+  void* a=arena.Allocate(1,1);
+  void* b=arena.Allocate(8,8);
+  void* c=arena.Allocate(3,1);
+  void* d=arena.Allocate(16,alignof(std::max_align_t));
+
+  REQUIRE(reinterpret_cast<uintptr_t>(b)%8==0);
+  REQUIRE(reinterpret_cast<uintptr_t>(d)%alignof(std::max_align_t)==0);
+  REQUIRE(static_cast<char*>(b)>=static_cast<char*>(a)+1);
+  REQUIRE(static_cast<char*>(c)==static_cast<char*>(b)+8);
+  REQUIRE(arena.GetMemory()==1024);
+}
+
+TEST_CASE("Chunks are added on demand")
+{
+  osmscout::ObjectArena arena(1024);
+
+  for (size_t i=0; i<10; i++) {
+    arena.Allocate(250,8);
+  }
+
+  REQUIRE(arena.GetMemory()==3*1024);
+
+  // Large allocations get a chunk of their own
+  arena.Allocate(4096,8);
+
+  REQUIRE(arena.GetMemory()==3*1024+4096);
+}
+
+TEST_CASE("Objects keep the arena alive")
+{
+  auto arena=std::make_shared<osmscout::ObjectArena>();
+
+  osmscout::WayRef way=osmscout::MakeShared<osmscout::Way>(arena);
+
+  REQUIRE(arena.use_count()==2);
+  REQUIRE(arena->GetMemory()==osmscout::ObjectArena::defaultChunkSize);
+
+  way->nodes.resize(100);
+
+  std::weak_ptr<osmscout::ObjectArena> weakArena=arena;
+
+  arena.reset();
+
+  REQUIRE(!weakArena.expired());
+  REQUIRE(way->nodes.size()==100);
+
+  way.reset();
+
+  REQUIRE(weakArena.expired());
+}
+
+TEST_CASE("Objects are created on the heap without arena")
+{
+  osmscout::WayRef way=osmscout::MakeShared<osmscout::Way>(nullptr);
+
+  REQUIRE(way);
+  REQUIRE(way->nodes.empty());
+}
@@ -0,0 +1,290 @@
+/*
+  Reachability - a test program for libosmscout
+  Copyright (C) 2026  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <vector>
+
+#include <osmscout/Database.h>
+
+#include <osmscout/routing/SimpleRoutingService.h>
+
+#include <osmscout/util/CmdLineParsing.h>
+#include <osmscout/util/StopClock.h>
+
+/**
+  Calculate the route nodes reachable from positions on a regular grid over
+  the given database, one by one and as a batch, and check the results and
+  the isochrones derived from them.
+  */
+
+void GetCarSpeedTable(std::map<std::string,double>& map)
+{
+  map["highway_motorway"]=110.0;
+  map["highway_motorway_trunk"]=100.0;
+  map["highway_motorway_primary"]=70.0;
+  map["highway_motorway_link"]=60.0;
+  map["highway_motorway_junction"]=60.0;
+  map["highway_trunk"]=100.0;
+  map["highway_trunk_link"]=60.0;
+  map["highway_primary"]=70.0;
+  map["highway_primary_link"]=60.0;
+  map["highway_secondary"]=60.0;
+  map["highway_secondary_link"]=50.0;
+  map["highway_tertiary"]=55.0;
+  map["highway_tertiary_link"]=55.0;
+  map["highway_unclassified"]=50.0;
+  map["highway_road"]=50.0;
+  map["highway_residential"]=20.0;
+  map["highway_roundabout"]=40.0;
+  map["highway_living_street"]=10.0;
+  map["highway_service"]=30.0;
+}
+
+bool HasSameNodes(const osmscout::ReachabilityResult& a,
+                  const osmscout::ReachabilityResult& b)
+{
+  if (a.GetNodes().size()!=b.GetNodes().size()) {
+    return false;
+  }
+
+  for (size_t i=0; i<a.GetNodes().size(); i++) {
+    if (a.GetNodes()[i].id!=b.GetNodes()[i].id ||
+        a.GetNodes()[i].cost!=b.GetNodes()[i].cost) {
+      return false;
+    }
+  }
+
+  return true;
+}
+
+int main(int argc, char* argv[])
+{
+  std::string databaseDirectory;
+  size_t      gridSize=4;
+  double      maxCost=2.0;
+  bool        help=false;
+  osmscout::CmdLineParser argParser("Reachability", argc, argv);
+
+  argParser.AddOption(osmscout::CmdLineFlag([&](const bool& value) {
+              help=value;
+            }),
+            std::vector<std::string>{"h","help"},
+            "Display help",
+            true);
+
+  argParser.AddOption(osmscout::CmdLineSizeTOption([&](const size_t& value) {
+                  gridSize=value;
+                }),
+                "grid",
+                "Number of centers per dimension, default: "+std::to_string(gridSize));
+
+  argParser.AddOption(osmscout::CmdLineDoubleOption([&](const double& value) {
+                  maxCost=value;
+                }),
+                "maxCost",
+                "Maximum route length in km, default: "+std::to_string(maxCost));
+
+  argParser.AddPositional(osmscout::CmdLineStringOption([&](const std::string& value) {
+                            databaseDirectory=value;
+                          }),
+                          "DATABASE",
+                          "Directory of the database to use");
+
+  osmscout::CmdLineParseResult argResult=argParser.Parse();
+  if (argResult.HasError()) {
+    std::cerr << "ERROR: " << argResult.GetErrorDescription() << std::endl;
+    std::cout << argParser.GetHelp() << std::endl;
+    return 1;
+  }
+  if (help){
+    std::cout << argParser.GetHelp() << std::endl;
+    return 0;
+  }
+
+  osmscout::DatabaseParameter databaseParameter;
+  osmscout::DatabaseRef       database=std::make_shared<osmscout::Database>(databaseParameter);
+
+  if (!database->Open(databaseDirectory)) {
+    std::cerr << "ERROR: Cannot open database" << std::endl;
+    return 1;
+  }
+
+  osmscout::SimpleRoutingService router(database,
+                                        osmscout::RouterParameter(),
+                                        osmscout::RoutingService::DEFAULT_FILENAME_BASE);
+
+  if (!router.Open()) {
+    std::cerr << "ERROR: Cannot open router" << std::endl;
+    return 1;
+  }
+
+  osmscout::ShortestPathRoutingProfile profile(database->GetTypeConfig());
+  std::map<std::string,double>         speedMap;
+
+  GetCarSpeedTable(speedMap);
+  profile.ParametrizeForCar(*database->GetTypeConfig(),speedMap,160.0);
+
+  // Centers on a regular grid over the database
+
+  osmscout::GeoBox                     boundingBox;
+  std::vector<osmscout::RoutePosition> centers;
+
+  if (!database->GetBoundingBox(boundingBox)) {
+    std::cerr << "ERROR: Cannot get bounding box" << std::endl;
+    return 1;
+  }
+
+  for (size_t y=0; y<gridSize; y++) {
+    for (size_t x=0; x<gridSize; x++) {
+      osmscout::GeoCoord coord(boundingBox.GetMinLat()+boundingBox.GetHeight()*(y+0.5)/gridSize,
+                               boundingBox.GetMinLon()+boundingBox.GetWidth()*(x+0.5)/gridSize);
+      auto               result=router.GetClosestRoutableNode(coord,
+                                                              profile,
+                                                              osmscout::Kilometers(1));
+
+      if (result.IsValid()) {
+        centers.push_back(result.GetRoutePosition());
+      }
+    }
+  }
+
+  if (centers.empty()) {
+    std::cerr << "ERROR: No centers found" << std::endl;
+    return 1;
+  }
+
+  osmscout::RoutingParameter parameter;
+  osmscout::StopClock        batchClock;
+  auto                       batchResults=router.CalculateReachability(profile,
+                                                                       centers,
+                                                                       maxCost,
+                                                                       parameter);
+
+  batchClock.Stop();
+
+  if (batchResults.size()!=centers.size()) {
+    std::cerr << "ERROR: Wrong number of results" << std::endl;
+    return 1;
+  }
+
+  double singleTime=0.0;
+  size_t nodeCount=0;
+  size_t errorCount=0;
+
+  for (size_t c=0; c<centers.size(); c++) {
+    osmscout::StopClock singleClock;
+    auto                result=router.CalculateReachability(profile,
+                                                            centers[c],
+                                                            maxCost,
+                                                            parameter);
+
+    singleClock.Stop();
+
+    singleTime+=singleClock.GetMilliseconds();
+
+    if (!result.Success() ||
+        !batchResults[c].Success()) {
+      std::cerr << "ERROR: Cannot calculate reachability for center " << c << std::endl;
+      errorCount++;
+      continue;
+    }
+
+    if (!HasSameNodes(result,batchResults[c])) {
+      std::cerr << "ERROR: Center " << c << " has different results in batch" << std::endl;
+      errorCount++;
+    }
+
+    const auto& nodes=result.GetNodes();
+
+    nodeCount+=nodes.size();
+
+    for (size_t i=1; i<nodes.size(); i++) {
+      if (nodes[i].cost>maxCost ||
+          nodes[i].cost<nodes[i-1].cost) {
+        std::cerr << "ERROR: Center " << c << " has node with unexpected cost " << nodes[i].cost << std::endl;
+        errorCount++;
+        break;
+      }
+    }
+
+    // The cost of a node does not depend on the maximum cost of the search
+    auto smallerResult=router.CalculateReachability(profile,
+                                                    centers[c],
+                                                    maxCost/2,
+                                                    parameter);
+    std::map<osmscout::DBId,double> costs;
+
+    for (const auto& node : nodes) {
+      costs.emplace(node.id,node.cost);
+    }
+
+    for (const auto& node : smallerResult.GetNodes()) {
+      auto entry=costs.find(node.id);
+
+      if (entry==costs.end() ||
+          std::abs(entry->second-node.cost)>1e-9) {
+        std::cerr << "ERROR: Center " << c << " has node " << node.id.id << " with different cost for smaller maximum cost" << std::endl;
+        errorCount++;
+        break;
+      }
+    }
+
+    auto isochrone=result.GetIsochrone(maxCost,
+                                       osmscout::Meters(50));
+
+    if (nodes.size()>1 &&
+        std::none_of(isochrone.GetRings().begin(),
+                     isochrone.GetRings().end(),
+                     [](const osmscout::Isochrone::Ring& ring) {
+                       return ring.outer;
+                     })) {
+      std::cerr << "ERROR: Center " << c << " has no isochrone" << std::endl;
+      errorCount++;
+    }
+
+    const auto& rings=isochrone.GetRings();
+
+    for (size_t r=0; r<rings.size(); r++) {
+      if (rings[r].outerRing>=rings.size() ||
+          !rings[rings[r].outerRing].outer ||
+          (rings[r].outer && rings[r].outerRing!=r)) {
+        std::cerr << "ERROR: Center " << c << " has isochrone ring " << r << " without outer ring" << std::endl;
+        errorCount++;
+        break;
+      }
+    }
+  }
+
+  router.Close();
+  database->Close();
+
+  std::cout << "Centers: " << centers.size() << ", nodes: " << nodeCount << std::endl;
+  std::cout << "Batch  - " << batchClock.GetMilliseconds() << "ms" << std::endl;
+  std::cout << "Single - " << singleTime << "ms" << std::endl;
+
+  if (nodeCount==0) {
+    std::cerr << "ERROR: No route nodes reached" << std::endl;
+    return 1;
+  }
+
+  return errorCount==0 ? 0 : 1;
+}
@@ -0,0 +1,250 @@
+/*
+  RoutingMatrix - a test program for libosmscout
+  Copyright (C) 2026  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <cmath>
+#include <iostream>
+#include <map>
+#include <vector>
+
+#include <osmscout/Database.h>
+
+#include <osmscout/routing/SimpleRoutingService.h>
+
+#include <osmscout/util/CmdLineParsing.h>
+#include <osmscout/util/Geometry.h>
+#include <osmscout/util/StopClock.h>
+
+/**
+  Calculate the distance matrix between positions on a regular grid over the
+  given database and compare it with routes calculated one by one.
+  */
+
+void GetCarSpeedTable(std::map<std::string,double>& map)
+{
+  map["highway_motorway"]=110.0;
+  map["highway_motorway_trunk"]=100.0;
+  map["highway_motorway_primary"]=70.0;
+  map["highway_motorway_link"]=60.0;
+  map["highway_motorway_junction"]=60.0;
+  map["highway_trunk"]=100.0;
+  map["highway_trunk_link"]=60.0;
+  map["highway_primary"]=70.0;
+  map["highway_primary_link"]=60.0;
+  map["highway_secondary"]=60.0;
+  map["highway_secondary_link"]=50.0;
+  map["highway_tertiary"]=55.0;
+  map["highway_tertiary_link"]=55.0;
+  map["highway_unclassified"]=50.0;
+  map["highway_road"]=50.0;
+  map["highway_residential"]=20.0;
+  map["highway_roundabout"]=40.0;
+  map["highway_living_street"]=10.0;
+  map["highway_service"]=30.0;
+}
+
+double GetRouteLength(osmscout::SimpleRoutingService& router,
+                      const osmscout::RoutingResult& result)
+{
+  auto   pointsResult=router.TransformRouteDataToPoints(result.GetRoute());
+  double length=0.0;
+
+  if (!pointsResult.Success()) {
+    return -1.0;
+  }
+
+  const auto& points=pointsResult.GetPoints()->points;
+
+  for (size_t i=1; i<points.size(); i++) {
+    length+=osmscout::GetEllipsoidalDistance(points[i-1].GetCoord(),
+                                             points[i].GetCoord()).As<osmscout::Meter>();
+  }
+
+  return length;
+}
+
+int main(int argc, char* argv[])
+{
+  std::string databaseDirectory;
+  size_t      gridSize=6;
+  bool        help=false;
+  osmscout::CmdLineParser argParser("RoutingMatrix", argc, argv);
+
+  argParser.AddOption(osmscout::CmdLineFlag([&](const bool& value) {
+              help=value;
+            }),
+            std::vector<std::string>{"h","help"},
+            "Display help",
+            true);
+
+  argParser.AddOption(osmscout::CmdLineSizeTOption([&](const size_t& value) {
+                  gridSize=value;
+                }),
+                "grid",
+                "Number of route positions per dimension, default: "+std::to_string(gridSize));
+
+  argParser.AddPositional(osmscout::CmdLineStringOption([&](const std::string& value) {
+                            databaseDirectory=value;
+                          }),
+                          "DATABASE",
+                          "Directory of the database to use");
+
+  osmscout::CmdLineParseResult argResult=argParser.Parse();
+  if (argResult.HasError()) {
+    std::cerr << "ERROR: " << argResult.GetErrorDescription() << std::endl;
+    std::cout << argParser.GetHelp() << std::endl;
+    return 1;
+  }
+  if (help){
+    std::cout << argParser.GetHelp() << std::endl;
+    return 0;
+  }
+
+  osmscout::DatabaseParameter databaseParameter;
+  osmscout::DatabaseRef       database=std::make_shared<osmscout::Database>(databaseParameter);
+
+  if (!database->Open(databaseDirectory)) {
+    std::cerr << "ERROR: Cannot open database" << std::endl;
+    return 1;
+  }
+
+  osmscout::SimpleRoutingService router(database,
+                                        osmscout::RouterParameter(),
+                                        osmscout::RoutingService::DEFAULT_FILENAME_BASE);
+
+  if (!router.Open()) {
+    std::cerr << "ERROR: Cannot open router" << std::endl;
+    return 1;
+  }
+
+  osmscout::ShortestPathRoutingProfile profile(database->GetTypeConfig());
+  std::map<std::string,double>         speedMap;
+
+  GetCarSpeedTable(speedMap);
+  profile.ParametrizeForCar(*database->GetTypeConfig(),speedMap,160.0);
+
+  // Route positions on a regular grid over the database
+
+  osmscout::GeoBox                     boundingBox;
+  std::vector<osmscout::RoutePosition> positions;
+
+  if (!database->GetBoundingBox(boundingBox)) {
+    std::cerr << "ERROR: Cannot get bounding box" << std::endl;
+    return 1;
+  }
+
+  for (size_t y=0; y<gridSize; y++) {
+    for (size_t x=0; x<gridSize; x++) {
+      osmscout::GeoCoord coord(boundingBox.GetMinLat()+boundingBox.GetHeight()*(y+0.5)/gridSize,
+                               boundingBox.GetMinLon()+boundingBox.GetWidth()*(x+0.5)/gridSize);
+      auto               result=router.GetClosestRoutableNode(coord,
+                                                              profile,
+                                                              osmscout::Kilometers(1));
+
+      if (result.IsValid()) {
+        positions.push_back(result.GetRoutePosition());
+      }
+    }
+  }
+
+  osmscout::RoutingParameter parameter;
+  osmscout::StopClock        matrixClock;
+  auto                       matrix=router.CalculateMatrix(profile,
+                                                           positions,
+                                                           positions,
+                                                           parameter);
+
+  matrixClock.Stop();
+
+  if (!matrix.Success() ||
+      matrix.GetSourceCount()!=positions.size() ||
+      matrix.GetTargetCount()!=positions.size()) {
+    std::cerr << "ERROR: Cannot calculate matrix" << std::endl;
+    return 1;
+  }
+
+  double routeTime=0.0;
+  size_t routeCount=0;
+  size_t errorCount=0;
+
+  for (size_t s=0; s<positions.size(); s++) {
+    if (!matrix.HasRoute(s,s) ||
+        matrix.GetCost(s,s)!=0.0) {
+      std::cerr << "ERROR: Route " << s << " => " << s << " is not empty" << std::endl;
+      errorCount++;
+    }
+
+    for (size_t t=0; t<positions.size(); t++) {
+      // Positions of different grid cells may snap to the same node
+      if (positions[s].GetDatabaseId()==positions[t].GetDatabaseId() &&
+          positions[s].GetObjectFileRef()==positions[t].GetObjectFileRef() &&
+          positions[s].GetNodeIndex()==positions[t].GetNodeIndex()) {
+        continue;
+      }
+
+      osmscout::StopClock routeClock;
+      auto                result=router.CalculateRoute(profile,
+                                                       positions[s],
+                                                       positions[t],
+                                                       parameter);
+
+      routeClock.Stop();
+
+      routeTime+=routeClock.GetMilliseconds();
+
+      if (!result.Success()) {
+        continue;
+      }
+
+      routeCount++;
+
+      if (!matrix.HasRoute(s,t)) {
+        std::cerr << "ERROR: Route " << s << " => " << t << " is missing in matrix" << std::endl;
+        errorCount++;
+        continue;
+      }
+
+      // The matrix search is exhaustive and also takes the way from the last
+      // route node to the target into account, so its routes may be shorter
+      // (but never longer, except for the difference between spherical and
+      // ellipsoidal distances)
+      double routeLength=GetRouteLength(router,result);
+      double matrixLength=matrix.GetDistance(s,t).As<osmscout::Meter>();
+
+      if (matrixLength>routeLength*1.01+1.0) {
+        std::cerr << "ERROR: Route " << s << " => " << t << " has different length: "
+                  << matrixLength << "m <=> " << routeLength << "m" << std::endl;
+        errorCount++;
+      }
+    }
+  }
+
+  router.Close();
+  database->Close();
+
+  std::cout << "Routes: " << routeCount << std::endl;
+  std::cout << "Matrix - " << matrixClock.GetMilliseconds() << "ms" << std::endl;
+  std::cout << "Routes - " << routeTime << "ms" << std::endl;
+
+  if (routeCount==0) {
+    std::cerr << "ERROR: No routes found" << std::endl;
+    return 1;
+  }
+
+  return errorCount==0 ? 0 : 1;
+}
@@ -0,0 +1,418 @@
+/*
+  RoutingSearchPerformance - a test program for libosmscout
+  Copyright (C) 2026  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <set>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <osmscout/routing/RoutingSearchSpace.h>
+
+#include <osmscout/util/CmdLineParsing.h>
+#include <osmscout/util/StopClock.h>
+
+/**
+  Compare the A* search data structures of the router (arena allocated nodes,
+  indexed d-ary heap, open addressing hash tables, recycled between searches)
+  with the former implementation (shared_ptr nodes, std::set as open list,
+  std::unordered_map and std::unordered_set) on a synthetic grid graph.
+
+  Both implementations must find routes with the same costs.
+  */
+
+/**
+  Grid graph with width*width nodes, each node connected to its (up to)
+  four neighbours. Edge costs are pseudo random, but at least 1.0 per step,
+  so the manhattan distance is an admissible estimate.
+  */
+class Grid
+{
+private:
+  size_t width;
+
+public:
+  explicit Grid(size_t width)
+  : width(width)
+  {
+  }
+
+  size_t GetNodeCount() const
+  {
+    return width*width;
+  }
+
+  osmscout::DBId GetId(size_t x, size_t y) const
+  {
+    return osmscout::DBId(0,y*width+x+1);
+  }
+
+  size_t GetX(const osmscout::DBId& id) const
+  {
+    return (id.id-1)%width;
+  }
+
+  size_t GetY(const osmscout::DBId& id) const
+  {
+    return (id.id-1)/width;
+  }
+
+  double GetCost(const osmscout::DBId& a, const osmscout::DBId& b) const
+  {
+    uint64_t hash=(std::min(a.id,b.id)*0x9E3779B97F4A7C15ULL) ^ std::max(a.id,b.id);
+
+    hash^=hash >> 29;
+    hash*=0xBF58476D1CE4E5B9ULL;
+    hash^=hash >> 32;
+
+    return 1.0+double(hash%1000)/250.0;
+  }
+
+  double GetEstimate(const osmscout::DBId& from, const osmscout::DBId& to) const
+  {
+    return std::abs(double(GetX(from))-double(GetX(to)))+
+           std::abs(double(GetY(from))-double(GetY(to)));
+  }
+
+  template<typename F>
+  void VisitNeighbours(const osmscout::DBId& id, F&& visit) const
+  {
+    size_t x=GetX(id);
+    size_t y=GetY(id);
+
+    if (x>0) {
+      visit(GetId(x-1,y));
+    }
+    if (x+1<width) {
+      visit(GetId(x+1,y));
+    }
+    if (y>0) {
+      visit(GetId(x,y-1));
+    }
+    if (y+1<width) {
+      visit(GetId(x,y+1));
+    }
+  }
+};
+
+struct Node
+{
+  osmscout::DBId id;
+  osmscout::DBId prev;
+  double         currentCost=0;
+  double         overallCost=0;
+  size_t         heapIndex=std::numeric_limits<size_t>::max();
+
+  Node() = default;
+
+  Node(const osmscout::DBId& id,
+       const osmscout::DBId& prev)
+  : id(id),
+    prev(prev)
+  {
+  }
+};
+
+struct NodeCostCompare
+{
+  bool operator()(const Node* a, const Node* b) const
+  {
+    if (a->overallCost==b->overallCost) {
+      return a->id<b->id;
+    }
+
+    return a->overallCost<b->overallCost;
+  }
+};
+
+/**
+  The former implementation
+  */
+class ClassicSearch
+{
+private:
+  using NodeRef = std::shared_ptr<Node>;
+
+  struct CostCompare
+  {
+    bool operator()(const NodeRef& a, const NodeRef& b) const
+    {
+      return NodeCostCompare()(a.get(),b.get());
+    }
+  };
+
+  using OpenList    = std::set<NodeRef,CostCompare>;
+  using OpenListRef = OpenList::iterator;
+
+public:
+  double Search(const Grid& grid,
+                const osmscout::DBId& start,
+                const osmscout::DBId& target,
+                size_t& nodeCount)
+  {
+    OpenList                                       openList;
+    std::unordered_map<osmscout::DBId,OpenListRef> openMap;
+    std::unordered_set<osmscout::DBId>             closedSet;
+
+    openMap.reserve(10000);
+    closedSet.reserve(300000);
+
+    NodeRef startNode=std::make_shared<Node>(start,osmscout::DBId());
+
+    startNode->overallCost=grid.GetEstimate(start,target);
+    openMap[start]=openList.insert(startNode).first;
+
+    while (!openList.empty()) {
+      NodeRef current=*openList.begin();
+
+      openMap.erase(current->id);
+      openList.erase(openList.begin());
+      closedSet.insert(current->id);
+      nodeCount++;
+
+      if (current->id==target) {
+        return current->currentCost;
+      }
+
+      grid.VisitNeighbours(current->id,[&](const osmscout::DBId& next) {
+        if (closedSet.find(next)!=closedSet.end()) {
+          return;
+        }
+
+        double currentCost=current->currentCost+grid.GetCost(current->id,next);
+        auto   openEntry=openMap.find(next);
+
+        if (openEntry!=openMap.end()) {
+          NodeRef node=*openEntry->second;
+
+          if (node->currentCost<=currentCost) {
+            return;
+          }
+
+          openList.erase(openEntry->second);
+          node->prev=current->id;
+          node->currentCost=currentCost;
+          node->overallCost=currentCost+grid.GetEstimate(next,target);
+          openEntry->second=openList.insert(node).first;
+        }
+        else {
+          NodeRef node=std::make_shared<Node>(next,current->id);
+
+          node->currentCost=currentCost;
+          node->overallCost=currentCost+grid.GetEstimate(next,target);
+          openMap[next]=openList.insert(node).first;
+        }
+      });
+    }
+
+    return -1.0;
+  }
+};
+
+/**
+  The current implementation
+  */
+class FlatSearch
+{
+private:
+  struct NodeKey
+  {
+    osmscout::DBId operator()(const Node* node) const
+    {
+      return node!=nullptr ? node->id : osmscout::DBId();
+    }
+  };
+
+  struct IdKey
+  {
+    const osmscout::DBId& operator()(const osmscout::DBId& id) const
+    {
+      return id;
+    }
+  };
+
+  osmscout::NodeArena<Node>                         nodePool;
+  osmscout::IndexedHeap<Node,NodeCostCompare>       openList;
+  osmscout::DBIdHashTable<Node*,NodeKey>            openMap;
+  osmscout::DBIdHashTable<osmscout::DBId,IdKey>     closedSet;
+
+public:
+  double Search(const Grid& grid,
+                const osmscout::DBId& start,
+                const osmscout::DBId& target,
+                size_t& nodeCount)
+  {
+    double result=-1.0;
+
+    openList.Reserve(10000);
+    openMap.Reserve(10000);
+    closedSet.Reserve(10000);
+
+    Node* startNode=nodePool.Create(start,osmscout::DBId());
+
+    startNode->overallCost=grid.GetEstimate(start,target);
+    openList.Push(startNode);
+    openMap.Insert(startNode);
+
+    while (!openList.Empty()) {
+      Node* current=openList.Top();
+
+      openMap.Erase(current->id);
+      openList.Pop();
+      closedSet.Insert(current->id);
+      nodeCount++;
+
+      if (current->id==target) {
+        result=current->currentCost;
+        break;
+      }
+
+      grid.VisitNeighbours(current->id,[&](const osmscout::DBId& next) {
+        if (closedSet.Find(next)!=nullptr) {
+          return;
+        }
+
+        double currentCost=current->currentCost+grid.GetCost(current->id,next);
+        Node** openEntry=openMap.Find(next);
+
+        if (openEntry!=nullptr) {
+          Node* node=*openEntry;
+
+          if (node->currentCost<=currentCost) {
+            return;
+          }
+
+          node->prev=current->id;
+          node->currentCost=currentCost;
+          node->overallCost=currentCost+grid.GetEstimate(next,target);
+          openList.Update(node);
+        }
+        else {
+          Node* node=nodePool.Create(next,current->id);
+
+          node->currentCost=currentCost;
+          node->overallCost=currentCost+grid.GetEstimate(next,target);
+          openList.Push(node);
+          openMap.Insert(node);
+        }
+      });
+    }
+
+    openList.Clear();
+    openMap.Clear();
+    closedSet.Clear();
+    nodePool.Clear();
+
+    return result;
+  }
+};
+
+int main(int argc, char* argv[])
+{
+  using namespace std::string_literals;
+  size_t width=500;
+  size_t queries=20;
+  bool   help=false;
+  osmscout::CmdLineParser argParser("RoutingSearchPerformance", argc, argv);
+
+  argParser.AddOption(osmscout::CmdLineFlag([&](const bool& value) {
+              help=value;
+            }),
+            std::vector<std::string>{"h","help"},
+            "Display help",
+            true);
+
+  argParser.AddOption(osmscout::CmdLineSizeTOption([&](const size_t& value) {
+                  width=value;
+                }),
+                "width",
+                "Width of the grid graph, default: "s + std::to_string(width));
+
+  argParser.AddOption(osmscout::CmdLineSizeTOption([&](const size_t& value) {
+                  queries=value;
+                }),
+                "queries",
+                "Number of searches, default: "s + std::to_string(queries));
+
+  osmscout::CmdLineParseResult argResult=argParser.Parse();
+  if (argResult.HasError()) {
+    std::cerr << "ERROR: " << argResult.GetErrorDescription() << std::endl;
+    std::cout << argParser.GetHelp() << std::endl;
+    return 1;
+  }
+  if (help){
+    std::cout << argParser.GetHelp() << std::endl;
+    return 0;
+  }
+
+  if (width<2) {
+    std::cerr << "ERROR: Grid width must be at least 2" << std::endl;
+    return 1;
+  }
+
+  Grid          grid(width);
+  ClassicSearch classic;
+  FlatSearch    flat;
+  double        classicTime=0.0;
+  double        flatTime=0.0;
+  size_t        classicNodes=0;
+  size_t        flatNodes=0;
+  uint64_t      random=4711;
+
+  for (size_t q=0; q<queries; q++) {
+    random=random*6364136223846793005ULL+1442695040888963407ULL;
+    osmscout::DBId start=grid.GetId((random >> 33)%width,(random >> 13)%width);
+    random=random*6364136223846793005ULL+1442695040888963407ULL;
+    osmscout::DBId target=grid.GetId((random >> 33)%width,(random >> 13)%width);
+
+    osmscout::StopClock classicTimer;
+    double              classicCost=classic.Search(grid,start,target,classicNodes);
+
+    classicTimer.Stop();
+    classicTime+=classicTimer.GetMilliseconds();
+
+    osmscout::StopClock flatTimer;
+    double              flatCost=flat.Search(grid,start,target,flatNodes);
+
+    flatTimer.Stop();
+    flatTime+=flatTimer.GetMilliseconds();
+
+    if (classicCost<0.0 ||
+        std::abs(classicCost-flatCost)>1e-9) {
+      std::cerr << "ERROR: Different costs for route " << start.id << " => " << target.id << ": "
+                << classicCost << " <=> " << flatCost << std::endl;
+      return 1;
+    }
+  }
+
+  std::cout << "Grid nodes: " << grid.GetNodeCount() << ", searches: " << queries << std::endl;
+  std::cout << "Classic - " << classicTime << "ms, nodes visited: " << classicNodes << std::endl;
+  std::cout << "Flat    - " << flatTime << "ms, nodes visited: " << flatNodes << std::endl;
+
+  if (classicNodes!=flatNodes) {
+    std::cerr << "ERROR: Different number of nodes visited" << std::endl;
+    return 1;
+  }
+
+  return 0;
+}
@@ -1,6 +1,7 @@
 #include <iostream>
 
 #include <osmscout/util/String.h>
+#include <osmscout/util/StringMatcher.h>
 
 #include <TestMain.h>
 
@@ -281,3 +282,28 @@ TEST_CASE("Local aware number to string")
   REQUIRE(osmscout::NumberToString(1002030, locale) == "1 002 030");
   REQUIRE(osmscout::NumberToString(-1002030, locale) == "-1 002 030");
 }
+
+TEST_CASE("Case insensitive string matching")
+{
+  auto matcher=osmscout::StringMatcherCIFactory().CreateMatcher("main");
+
+  REQUIRE(matcher->Match("MAIN") == osmscout::StringMatcher::match);
+  REQUIRE(matcher->Match("Main Street") == osmscout::StringMatcher::partialMatch);
+  REQUIRE(matcher->Match("Mainz") == osmscout::StringMatcher::partialMatch);
+  REQUIRE(matcher->Match("Berlin") == osmscout::StringMatcher::noMatch);
+
+  auto utf8Matcher=osmscout::StringMatcherCIFactory().CreateMatcher("straße");
+
+  REQUIRE(utf8Matcher->Match("STRASSE") == osmscout::StringMatcher::noMatch);
+  REQUIRE(utf8Matcher->Match("Hauptstraße") == osmscout::StringMatcher::partialMatch);
+}
+
+TEST_CASE("Transliterating string matching")
+{
+  auto matcher=osmscout::StringMatcherTransliterateFactory().CreateMatcher("Muller");
+
+  REQUIRE(matcher->Match("muller") == osmscout::StringMatcher::match);
+  REQUIRE(matcher->Match("Müller") == osmscout::StringMatcher::match);
+  REQUIRE(matcher->Match("Müllerstraße") == osmscout::StringMatcher::partialMatch);
+  REQUIRE(matcher->Match("Meier") == osmscout::StringMatcher::noMatch);
+}
@@ -0,0 +1,484 @@
+/*
+  StyleDecisionTable - a test program for libosmscout
+  Copyright (C) 2026  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <algorithm>
+#include <iostream>
+#include <list>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <osmscout/Area.h>
+#include <osmscout/Node.h>
+#include <osmscout/TypeConfig.h>
+#include <osmscout/Way.h>
+
+#include <osmscout/util/File.h>
+#include <osmscout/util/FileScanner.h>
+#include <osmscout/util/Projection.h>
+
+#include <osmscoutmap/StyleConfig.h>
+
+/**
+  Resolve the styles of all nodes, ways and areas of the given database for all
+  magnification levels using the precompiled style decisions of the StyleConfig
+  and compare them with the result of evaluating the style selectors one by one.
+  Additionally check the fallback of a StyleDecision with more conditions than
+  it can precompile.
+  */
+
+static const size_t maxLevel=20;
+
+/**
+ * Reference evaluation of the selectors, matching the selectors one by one and
+ * composing the styles of all matching selectors
+ */
+template<class S, class A>
+std::shared_ptr<S> GetReferenceStyle(const osmscout::StyleResolveContext& context,
+                                     const std::list<osmscout::StyleSelector<S,A>>& selectors,
+                                     const osmscout::FeatureValueBuffer& buffer,
+                                     double meterInPixel,
+                                     double meterInMM)
+{
+  bool               fastpath=false;
+  bool               composed=false;
+  std::shared_ptr<S> style;
+
+  for (const auto& selector : selectors) {
+    if (!selector.criteria.Matches(context,
+                                   buffer,
+                                   meterInPixel,
+                                   meterInMM)) {
+      continue;
+    }
+
+    if (!style) {
+      style=selector.style;
+      fastpath=true;
+
+      continue;
+    }
+
+    if (fastpath) {
+      style=std::make_shared<S>(*style);
+      fastpath=false;
+    }
+
+    style->CopyAttributes(*selector.style,
+                          selector.attributes);
+    composed=true;
+  }
+
+  if (composed &&
+      !style->IsVisible()) {
+    return nullptr;
+  }
+
+  return style;
+}
+
+template<class S, class A>
+std::vector<std::shared_ptr<S>> GetReferenceStyles(const osmscout::StyleResolveContext& context,
+                                                   const std::vector<std::list<osmscout::StyleSelector<S,A>>>& slots,
+                                                   const osmscout::FeatureValueBuffer& buffer,
+                                                   const osmscout::Projection& projection)
+{
+  std::vector<std::shared_ptr<S>> styles;
+
+  for (const auto& selectors : slots) {
+    std::shared_ptr<S> style=GetReferenceStyle(context,
+                                               selectors,
+                                               buffer,
+                                               projection.GetMeterInPixel(),
+                                               projection.GetMeterInMM());
+
+    if (style) {
+      styles.push_back(style);
+    }
+  }
+
+  return styles;
+}
+
+template<class S>
+bool IsSameStyle(const std::shared_ptr<S>& a,
+                 const std::shared_ptr<S>& b)
+{
+  return a==b ||
+         (a && b && *a==*b);
+}
+
+template<class S>
+bool AreSameStyles(const std::vector<std::shared_ptr<S>>& a,
+                   const std::vector<std::shared_ptr<S>>& b)
+{
+  return std::equal(a.begin(),a.end(),
+                    b.begin(),b.end(),
+                    IsSameStyle<S>);
+}
+
+class StyleComparison
+{
+private:
+  const osmscout::StyleConfig&         styleConfig;
+  const osmscout::StyleResolveContext& context;
+
+public:
+  size_t comparisonCount=0;
+  size_t errorCount=0;
+
+private:
+  void Check(bool same,
+             const std::string& kind,
+             const osmscout::FeatureValueBuffer& buffer,
+             const osmscout::Projection& projection)
+  {
+    comparisonCount++;
+
+    if (!same) {
+      std::cerr << "ERROR: " << kind << " style of type " << buffer.GetType()->GetName()
+                << " differs at level " << projection.GetMagnification().GetLevel() << std::endl;
+      errorCount++;
+    }
+  }
+
+public:
+  explicit StyleComparison(const osmscout::StyleConfig& styleConfig)
+  : styleConfig(styleConfig),
+    context(styleConfig.GetStyleResolveContext())
+  {
+    // no code
+  }
+
+  void CheckNode(const osmscout::FeatureValueBuffer& buffer,
+                 const osmscout::Projection& projection)
+  {
+    size_t                                       level=projection.GetMagnification().GetLevel();
+    std::vector<osmscout::TextStyleSelectorList> textSelectors;
+    std::vector<osmscout::TextStyleRef>          textStyles;
+
+    styleConfig.GetNodeTextStyleSelectors(level,
+                                          buffer.GetType(),
+                                          textSelectors);
+    styleConfig.GetNodeTextStyles(buffer,
+                                  projection,
+                                  textStyles);
+
+    Check(AreSameStyles(textStyles,
+                        GetReferenceStyles(context,
+                                           textSelectors,
+                                           buffer,
+                                           projection)),
+          "Node text",
+          buffer,
+          projection);
+  }
+
+  void CheckWay(const osmscout::FeatureValueBuffer& buffer,
+                const osmscout::Projection& projection)
+  {
+    size_t                                       level=projection.GetMagnification().GetLevel();
+    std::vector<osmscout::LineStyleSelectorList> lineSelectors;
+    std::vector<osmscout::LineStyleRef>          lineStyles;
+
+    styleConfig.GetWayLineStyleSelectors(level,
+                                         buffer.GetType(),
+                                         lineSelectors);
+    styleConfig.GetWayLineStyles(buffer,
+                                 projection,
+                                 lineStyles);
+
+    std::vector<osmscout::LineStyleRef> referenceStyles=GetReferenceStyles(context,
+                                                                           lineSelectors,
+                                                                           buffer,
+                                                                           projection);
+
+    // Same ordering as StyleConfig::GetWayLineStyles()
+    if (std::any_of(referenceStyles.begin(),
+                    referenceStyles.end(),
+                    [](const osmscout::LineStyleRef& style) {
+                      return style->GetOffsetRel()!=osmscout::OffsetRel::base;
+                    })) {
+      std::sort(referenceStyles.begin(),
+                referenceStyles.end(),
+                [](const osmscout::LineStyleRef& a, const osmscout::LineStyleRef& b) -> bool {
+                  return a->GetSlot()<b->GetSlot();
+                });
+    }
+
+    Check(AreSameStyles(lineStyles,
+                        referenceStyles),
+          "Way line",
+          buffer,
+          projection);
+  }
+
+  void CheckArea(const osmscout::FeatureValueBuffer& buffer,
+                 const osmscout::Projection& projection)
+  {
+    size_t                                         level=projection.GetMagnification().GetLevel();
+    osmscout::TypeInfoRef                          type=buffer.GetType();
+    std::list<osmscout::FillStyleSelector>         fillSelectors;
+    std::vector<osmscout::BorderStyleSelectorList> borderSelectors;
+    std::vector<osmscout::TextStyleSelectorList>   textSelectors;
+    std::vector<osmscout::BorderStyleRef>          borderStyles;
+    std::vector<osmscout::TextStyleRef>            textStyles;
+
+    styleConfig.GetAreaFillStyleSelectors(level,
+                                          type,
+                                          fillSelectors);
+    styleConfig.GetAreaBorderStyleSelectors(level,
+                                            type,
+                                            borderSelectors);
+    styleConfig.GetAreaTextStyleSelectors(level,
+                                          type,
+                                          textSelectors);
+
+    styleConfig.GetAreaBorderStyles(type,
+                                    buffer,
+                                    projection,
+                                    borderStyles);
+    styleConfig.GetAreaTextStyles(type,
+                                  buffer,
+                                  projection,
+                                  textStyles);
+
+    Check(IsSameStyle(styleConfig.GetAreaFillStyle(type,
+                                                   buffer,
+                                                   projection),
+                      GetReferenceStyle(context,
+                                        fillSelectors,
+                                        buffer,
+                                        projection.GetMeterInPixel(),
+                                        projection.GetMeterInMM())),
+          "Area fill",
+          buffer,
+          projection);
+    Check(AreSameStyles(borderStyles,
+                        GetReferenceStyles(context,
+                                           borderSelectors,
+                                           buffer,
+                                           projection)),
+          "Area border",
+          buffer,
+          projection);
+    Check(AreSameStyles(textStyles,
+                        GetReferenceStyles(context,
+                                           textSelectors,
+                                           buffer,
+                                           projection)),
+          "Area text",
+          buffer,
+          projection);
+  }
+};
+
+template<class T>
+std::vector<T> ReadObjects(const osmscout::TypeConfig& typeConfig,
+                           const std::string& filename)
+{
+  osmscout::FileScanner scanner;
+  std::vector<T>        objects;
+
+  scanner.Open(filename,osmscout::FileScanner::Sequential,true);
+
+  uint32_t dataCount=scanner.ReadUInt32();
+
+  objects.resize(dataCount);
+
+  for (auto& object : objects) {
+    object.Read(typeConfig,
+                scanner);
+  }
+
+  scanner.Close();
+
+  return objects;
+}
+
+/**
+ * Compare the styles of all objects of the database for all magnification levels
+ */
+size_t CheckDatabaseStyles(const std::string& databaseDirectory,
+                           const std::string& styleSheet)
+{
+  osmscout::TypeConfigRef typeConfig=std::make_shared<osmscout::TypeConfig>();
+
+  if (!typeConfig->LoadFromDataFile(databaseDirectory)) {
+    std::cerr << "ERROR: Cannot load type config" << std::endl;
+    return 1;
+  }
+
+  osmscout::StyleConfig styleConfig(typeConfig);
+
+  if (!styleConfig.Load(styleSheet)) {
+    std::cerr << "ERROR: Cannot load style sheet" << std::endl;
+    return 1;
+  }
+
+  std::vector<osmscout::Node> nodes;
+  std::vector<osmscout::Way>  ways;
+  std::vector<osmscout::Area> areas;
+
+  try {
+    nodes=ReadObjects<osmscout::Node>(*typeConfig,
+                                      osmscout::AppendFileToDir(databaseDirectory,"nodes.dat"));
+    ways=ReadObjects<osmscout::Way>(*typeConfig,
+                                    osmscout::AppendFileToDir(databaseDirectory,"ways.dat"));
+    areas=ReadObjects<osmscout::Area>(*typeConfig,
+                                      osmscout::AppendFileToDir(databaseDirectory,"areas.dat"));
+  }
+  catch (osmscout::IOException& e) {
+    std::cerr << "ERROR: " << e.GetDescription() << std::endl;
+    return 1;
+  }
+
+  StyleComparison comparison(styleConfig);
+
+  for (size_t level=0; level<=maxLevel; level++) {
+    osmscout::MercatorProjection projection;
+
+    projection.Set(osmscout::GeoCoord(50.0,14.5),
+                   osmscout::Magnification(osmscout::MagnificationLevel(level)),
+                   96.0,
+                   800,
+                   600);
+
+    for (const auto& node : nodes) {
+      if (!node.GetType()->GetIgnore()) {
+        comparison.CheckNode(node.GetFeatureValueBuffer(),
+                             projection);
+      }
+    }
+
+    for (const auto& way : ways) {
+      if (!way.GetType()->GetIgnore()) {
+        comparison.CheckWay(way.GetFeatureValueBuffer(),
+                            projection);
+      }
+    }
+
+    for (const auto& area : areas) {
+      for (const auto& ring : area.rings) {
+        if (!ring.GetType()->GetIgnore()) {
+          comparison.CheckArea(ring.GetFeatureValueBuffer(),
+                               projection);
+        }
+      }
+    }
+  }
+
+  std::cout << "Nodes: " << nodes.size() << ", ways: " << ways.size() << ", areas: " << areas.size()
+            << ", compared styles: " << comparison.comparisonCount << std::endl;
+
+  if (comparison.comparisonCount==0) {
+    std::cerr << "ERROR: No styles compared" << std::endl;
+    return 1;
+  }
+
+  return comparison.errorCount;
+}
+
+/**
+ * Compare a StyleDecision with the given number of selectors, each with its own size
+ * condition, with the reference evaluation for a range of sizes
+ */
+size_t CheckSizeConditions(size_t selectorCount)
+{
+  osmscout::TypeConfigRef         typeConfig=std::make_shared<osmscout::TypeConfig>();
+  osmscout::StyleResolveContext   context(typeConfig);
+  osmscout::FeatureValueBuffer    buffer;
+  osmscout::FillStyleSelectorList selectors;
+  size_t                          errorCount=0;
+  size_t                          invisibleCount=0;
+
+  buffer.SetType(typeConfig->typeInfoTileLand);
+
+  for (size_t i=0; i<selectorCount; i++) {
+    osmscout::StyleFilter      filter;
+    osmscout::SizeConditionRef condition=std::make_shared<osmscout::SizeCondition>();
+    osmscout::FillPartialStyle style;
+
+    condition->SetMinMM(static_cast<double>(i));
+    filter.SetSizeCondition(condition);
+
+    // The last selector hides the composed style
+    if (i==selectorCount-1) {
+      style.SetColorValue(osmscout::FillStyle::attrFillColor,
+                          osmscout::Color(0.0,0.0,0.0,0.0));
+    }
+    else {
+      style.SetColorValue(osmscout::FillStyle::attrFillColor,
+                          osmscout::Color(static_cast<double>(i)/selectorCount,0.0,0.0,1.0));
+    }
+
+    selectors.emplace_back(filter,
+                           style);
+  }
+
+  osmscout::StyleDecision<osmscout::FillStyle,osmscout::FillStyle::Attribute> decision;
+
+  decision.Compile(selectors);
+
+  for (double meterInMM=0.0; meterInMM<=selectorCount+1.0; meterInMM+=0.5) {
+    osmscout::FillStyleRef style=decision.GetStyle(context,
+                                                   buffer,
+                                                   0.0,
+                                                   meterInMM);
+    osmscout::FillStyleRef referenceStyle=GetReferenceStyle(context,
+                                                            selectors,
+                                                            buffer,
+                                                            0.0,
+                                                            meterInMM);
+
+    if (!referenceStyle) {
+      invisibleCount++;
+    }
+
+    if (!IsSameStyle(style,referenceStyle)) {
+      std::cerr << "ERROR: Style with " << selectorCount << " size conditions differs at " << meterInMM << "mm" << std::endl;
+      errorCount++;
+    }
+  }
+
+  if (invisibleCount==0) {
+    std::cerr << "ERROR: Style with " << selectorCount << " size conditions never got invisible" << std::endl;
+    errorCount++;
+  }
+
+  return errorCount;
+}
+
+int main(int argc, char* argv[])
+{
+  if (argc!=3) {
+    std::cerr << "StyleDecisionTable <database directory> <style sheet>" << std::endl;
+    return 1;
+  }
+
+  size_t errorCount=CheckDatabaseStyles(argv[1],
+                                        argv[2]);
+
+  // Precompiled decision
+  errorCount+=CheckSizeConditions(osmscout::StyleDecision<osmscout::FillStyle,osmscout::FillStyle::Attribute>::maxConditions);
+  // Fallback to evaluating the selectors one by one
+  errorCount+=CheckSizeConditions(osmscout::StyleDecision<osmscout::FillStyle,osmscout::FillStyle::Attribute>::maxConditions+3);
+
+  return errorCount==0 ? 0 : 1;
+}
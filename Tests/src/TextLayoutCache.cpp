@@ -0,0 +1,167 @@
+/*
+  TextLayoutCache - a test program for libosmscout
+  Copyright (C) 2026  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <osmscoutmap/TextLayoutCache.h>
+
+#include <TestMain.h>
+
+using TestTextLayoutCache=osmscout::TextLayoutCache<int,int>;
+
+static osmscout::TextLayoutKey GetKey(const std::string& text,
+                                      double fontSize)
+{
+  osmscout::TextLayoutKey key;
+
+  key.text=text;
+  key.fontName="sans-serif";
+  key.fontSize=fontSize;
+
+  return key;
+}
+
+static TestTextLayoutCache::LabelPtr GetLabel(const std::string& text)
+{
+  auto label=std::make_shared<TestTextLayoutCache::LabelType>();
+
+  label->text=text;
+  label->width=10.0*text.length();
+  label->height=10.0;
+
+  return label;
+}
+
+TEST_CASE("Return cached labels and count hits and misses")
+{
+  TestTextLayoutCache cache;
+
+  REQUIRE(cache.Get(GetKey("Main Street",12))==nullptr);
+
+  auto label=GetLabel("Main Street");
+
+  cache.Set(GetKey("Main Street",12),label);
+
+  REQUIRE(cache.Get(GetKey("Main Street",12))==label);
+  REQUIRE(cache.Get(GetKey("Main Street",14))==nullptr);
+
+  auto key=GetKey("Main Street",12);
+
+  key.proposedWidth=50;
+  key.enableWrapping=true;
+
+  REQUIRE(cache.Get(key)==nullptr);
+
+  REQUIRE(cache.GetHits()==1);
+  REQUIRE(cache.GetMisses()==3);
+  REQUIRE(cache.GetSize()==1);
+
+  cache.Clear();
+
+  REQUIRE(cache.Get(GetKey("Main Street",12))==nullptr);
+  REQUIRE(cache.GetHits()==0);
+  REQUIRE(cache.GetMisses()==1);
+}
+
+TEST_CASE("Cache size is limited")
+{
+  TestTextLayoutCache cache(10);
+
+  for (size_t i=0; i<100; i++) {
+    cache.Set(GetKey(std::to_string(i),12),GetLabel(std::to_string(i)));
+  }
+
+  REQUIRE(cache.GetSize()==10);
+  REQUIRE(cache.Get(GetKey("99",12))!=nullptr);
+}
+
+TEST_CASE("Cache is shared between threads")
+{
+  TestTextLayoutCache      cache(100);
+  std::vector<std::thread> threads;
+
+  for (size_t t=0; t<4; t++) {
+    threads.emplace_back([&cache]() {
+      for (size_t i=0; i<1000; i++) {
+        auto key=GetKey(std::to_string(i%50),12);
+
+        if (!cache.Get(key)) {
+          cache.Set(key,GetLabel(key.text));
+        }
+      }
+    });
+  }
+
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  REQUIRE(cache.GetSize()==50);
+  REQUIRE(cache.GetHits()+cache.GetMisses()==4000);
+  REQUIRE(cache.GetMisses()>=50);
+}
+
+TEST_CASE("Labels are cached per device properties")
+{
+  TestTextLayoutCache cache;
+  auto                key=GetKey("Main Street",12);
+
+  key.deviceType=1;
+  key.dpi=96.0;
+  key.fontOptions=42;
+
+  cache.Set(key,GetLabel("Main Street"));
+
+  REQUIRE(cache.Get(key)!=nullptr);
+
+  // Another device with the same properties
+  auto sameDeviceKey=GetKey("Main Street",12);
+
+  sameDeviceKey.deviceType=1;
+  sameDeviceKey.dpi=96.0;
+  sameDeviceKey.fontOptions=42;
+
+  REQUIRE(cache.Get(sameDeviceKey)!=nullptr);
+
+  auto otherDeviceKey=key;
+
+  otherDeviceKey.deviceType=2;
+
+  REQUIRE(cache.Get(otherDeviceKey)==nullptr);
+
+  auto otherFontOptionsKey=key;
+
+  otherFontOptionsKey.fontOptions=43;
+
+  REQUIRE(cache.Get(otherFontOptionsKey)==nullptr);
+
+  auto otherDpiKey=key;
+
+  otherDpiKey.dpi=192.0;
+
+  REQUIRE(cache.Get(otherDpiKey)==nullptr);
+
+  auto otherFontSizeKey=key;
+
+  otherFontSizeKey.fontSize=12.4;
+
+  REQUIRE(cache.Get(otherFontSizeKey)==nullptr);
+}
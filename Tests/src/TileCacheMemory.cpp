@@ -0,0 +1,198 @@
+/*
+  TileCacheMemory - a test program for libosmscout
+  Copyright (C) 2026  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <iostream>
+#include <list>
+
+#include <osmscout/Database.h>
+
+#include <osmscoutmap/MapService.h>
+#include <osmscoutmap/StyleConfig.h>
+
+#include <osmscout/util/CmdLineParsing.h>
+
+/**
+  Load the tiles covering the given database into the tile cache and check
+  that the memory budget of the cache is enforced.
+  */
+
+bool LoadTiles(osmscout::MapService& mapService,
+               const osmscout::StyleConfig& styleConfig,
+               const osmscout::GeoBox& boundingBox,
+               size_t level,
+               std::list<osmscout::TileRef>& tiles)
+{
+  osmscout::AreaSearchParameter parameter;
+
+  mapService.LookupTiles(osmscout::Magnification(osmscout::MagnificationLevel(level)),
+                         boundingBox,
+                         tiles);
+
+  return mapService.LoadMissingTileData(parameter,
+                                        styleConfig,
+                                        tiles);
+}
+
+int main(int argc, char* argv[])
+{
+  std::string databaseDirectory;
+  std::string styleSheet;
+  bool        help=false;
+  osmscout::CmdLineParser argParser("TileCacheMemory", argc, argv);
+
+  argParser.AddOption(osmscout::CmdLineFlag([&](const bool& value) {
+              help=value;
+            }),
+            std::vector<std::string>{"h","help"},
+            "Display help",
+            true);
+
+  argParser.AddPositional(osmscout::CmdLineStringOption([&](const std::string& value) {
+                            databaseDirectory=value;
+                          }),
+                          "DATABASE",
+                          "Directory of the database to use");
+
+  argParser.AddPositional(osmscout::CmdLineStringOption([&](const std::string& value) {
+                            styleSheet=value;
+                          }),
+                          "STYLESHEET",
+                          "Style config file");
+
+  osmscout::CmdLineParseResult argResult=argParser.Parse();
+  if (argResult.HasError()) {
+    std::cerr << "ERROR: " << argResult.GetErrorDescription() << std::endl;
+    std::cout << argParser.GetHelp() << std::endl;
+    return 1;
+  }
+  if (help){
+    std::cout << argParser.GetHelp() << std::endl;
+    return 0;
+  }
+
+  osmscout::DatabaseParameter databaseParameter;
+  osmscout::DatabaseRef       database=std::make_shared<osmscout::Database>(databaseParameter);
+
+  if (!database->Open(databaseDirectory)) {
+    std::cerr << "ERROR: Cannot open database" << std::endl;
+    return 1;
+  }
+
+  osmscout::StyleConfigRef styleConfig=std::make_shared<osmscout::StyleConfig>(database->GetTypeConfig());
+
+  if (!styleConfig->Load(styleSheet)) {
+    std::cerr << "ERROR: Cannot open style config" << std::endl;
+    return 1;
+  }
+
+  osmscout::GeoBox boundingBox;
+
+  if (!database->GetBoundingBox(boundingBox)) {
+    std::cerr << "ERROR: Cannot get bounding box" << std::endl;
+    return 1;
+  }
+
+  osmscout::MapService mapService(database);
+  size_t               errorCount=0;
+
+  mapService.SetCacheSize(10000);
+
+  // Fill the cache without a memory budget
+
+  for (size_t level=13; level<=15; level++) {
+    std::list<osmscout::TileRef> tiles;
+
+    if (!LoadTiles(mapService,
+                   *styleConfig,
+                   boundingBox,
+                   level,
+                   tiles)) {
+      std::cerr << "ERROR: Cannot load tiles" << std::endl;
+      return 1;
+    }
+  }
+
+  size_t tileCount=mapService.GetCurrentCacheSize();
+  size_t memory=mapService.GetCurrentCacheMemory();
+
+  std::cout << "Unlimited - tiles: " << tileCount << ", memory: " << memory << std::endl;
+
+  if (memory<tileCount*sizeof(osmscout::Tile)) {
+    std::cerr << "ERROR: Memory of cached tiles not accounted" << std::endl;
+    errorCount++;
+  }
+
+  // Half of the memory
+
+  size_t budget=memory/2;
+
+  mapService.SetCacheMemoryBudget(budget);
+
+  size_t budgetTileCount=mapService.GetCurrentCacheSize();
+  size_t budgetMemory=mapService.GetCurrentCacheMemory();
+
+  std::cout << "Budget " << budget << " - tiles: " << budgetTileCount << ", memory: " << budgetMemory << std::endl;
+
+  if (budgetMemory>budget) {
+    std::cerr << "ERROR: Memory budget exceeded" << std::endl;
+    errorCount++;
+  }
+
+  if (budgetTileCount==0 ||
+      budgetTileCount>=tileCount) {
+    std::cerr << "ERROR: Unexpected number of tiles evicted" << std::endl;
+    errorCount++;
+  }
+
+  // Tiles still in use must not be evicted, even if the budget is exceeded
+
+  std::list<osmscout::TileRef> usedTiles;
+
+  if (!LoadTiles(mapService,
+                 *styleConfig,
+                 boundingBox,
+                 14,
+                 usedTiles)) {
+    std::cerr << "ERROR: Cannot load tiles" << std::endl;
+    return 1;
+  }
+
+  mapService.SetCacheMemoryBudget(1);
+
+  std::cout << "Budget 1 - tiles: " << mapService.GetCurrentCacheSize() << ", memory: " << mapService.GetCurrentCacheMemory() << std::endl;
+
+  if (mapService.GetCurrentCacheSize()!=usedTiles.size()) {
+    std::cerr << "ERROR: Tiles in use were evicted or unused tiles were kept" << std::endl;
+    errorCount++;
+  }
+
+  mapService.DumpStatistics();
+
+  usedTiles.clear();
+  mapService.CleanupTileCache();
+
+  if (mapService.GetCurrentCacheSize()!=0) {
+    std::cerr << "ERROR: Unused tiles were kept" << std::endl;
+    errorCount++;
+  }
+
+  database->Close();
+
+  return errorCount==0 ? 0 : 1;
+}
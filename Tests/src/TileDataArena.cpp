@@ -0,0 +1,89 @@
+/*
+  TileDataArena - a test program for libosmscout
+  Copyright (C) 2026  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <osmscoutmap/DataTileCache.h>
+
+#include <osmscout/util/ObjectArena.h>
+
+#include <TestMain.h>
+
+using namespace osmscout;
+
+namespace {
+
+  std::vector<WayRef> MakeWays(const ObjectArenaRef& arena,
+                               size_t count)
+  {
+    std::vector<WayRef> ways;
+
+    for (size_t i=0; i<count; i++) {
+      ways.push_back(MakeShared<Way>(arena));
+    }
+
+    return ways;
+  }
+}
+
+TEST_CASE("Arena memory is counted in the tile data memory")
+{
+  TileWayData    data;
+  ObjectArenaRef arena=std::make_shared<ObjectArena>();
+
+  data.SetData(TypeInfoSet(),MakeWays(nullptr,10));
+
+  size_t heapMemory=data.GetMemory();
+
+  data.SetData(TypeInfoSet(),MakeWays(arena,10),arena);
+
+  REQUIRE(data.GetMemory()==heapMemory+arena->GetMemory());
+}
+
+TEST_CASE("Each load keeps its own arena")
+{
+  TileWayData    data;
+  ObjectArenaRef firstArena=std::make_shared<ObjectArena>();
+  ObjectArenaRef secondArena=std::make_shared<ObjectArena>();
+
+  data.SetData(TypeInfoSet(),MakeWays(firstArena,10),firstArena);
+
+  size_t firstMemory=data.GetMemory();
+
+  data.AddData(TypeInfoSet(),MakeWays(secondArena,10),secondArena);
+
+  REQUIRE(data.GetMemory()>=firstMemory+secondArena->GetMemory());
+  REQUIRE(firstArena.use_count()>1);
+  REQUIRE(secondArena.use_count()>1);
+}
+
+TEST_CASE("Arenas are released with the data")
+{
+  TileWayData                data;
+  ObjectArenaRef             arena=std::make_shared<ObjectArena>();
+  std::weak_ptr<ObjectArena> weakArena=arena;
+
+  data.SetData(TypeInfoSet(),MakeWays(arena,10),arena);
+  arena.reset();
+
+  REQUIRE(!weakArena.expired());
+
+  // Replacing the data releases the arena of the previous load
+  data.SetData(TypeInfoSet(),MakeWays(nullptr,10));
+
+  REQUIRE(weakArena.expired());
+}
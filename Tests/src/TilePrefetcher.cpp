@@ -0,0 +1,227 @@
+/*
+  TilePrefetcher - a test program for libosmscout
+  Copyright (C) 2026  Tim Teulings
+
+  This program is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation; either version 2 of the License, or
+  (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+  GNU General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with this program; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+*/
+
+#include <chrono>
+#include <iostream>
+#include <list>
+#include <thread>
+
+#include <osmscout/Database.h>
+
+#include <osmscoutmap/MapService.h>
+#include <osmscoutmap/StyleConfig.h>
+#include <osmscoutmap/TilePrefetcher.h>
+
+#include <osmscout/util/CmdLineParsing.h>
+
+/**
+  Pan the viewport over the given database with constant speed, while
+  prefetching tiles, and check that the tiles becoming visible were
+  prefetched.
+  */
+
+bool ShowViewport(osmscout::MapService& mapService,
+                  osmscout::TilePrefetcher& prefetcher,
+                  const osmscout::StyleConfig& styleConfig,
+                  const osmscout::MercatorProjection& projection,
+                  const osmscout::TilePrefetcher::Clock::time_point& time)
+{
+  osmscout::AreaSearchParameter parameter;
+  std::list<osmscout::TileRef>  tiles;
+
+  prefetcher.ViewportChanged(projection,time);
+
+  mapService.LookupTiles(projection,tiles);
+
+  if (!mapService.LoadMissingTileData(parameter,
+                                      styleConfig,
+                                      tiles)) {
+    return false;
+  }
+
+  // Give the prefetch some time, like the time between two frames
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+  return true;
+}
+
+int main(int argc, char* argv[])
+{
+  std::string databaseDirectory;
+  std::string styleSheet;
+  size_t      frameCount=20;
+  bool        help=false;
+  osmscout::CmdLineParser argParser("TilePrefetcher", argc, argv);
+
+  argParser.AddOption(osmscout::CmdLineFlag([&](const bool& value) {
+              help=value;
+            }),
+            std::vector<std::string>{"h","help"},
+            "Display help",
+            true);
+
+  argParser.AddOption(osmscout::CmdLineSizeTOption([&](const size_t& value) {
+                  frameCount=value;
+                }),
+                "frames",
+                "Number of viewports, default: "+std::to_string(frameCount));
+
+  argParser.AddPositional(osmscout::CmdLineStringOption([&](const std::string& value) {
+                            databaseDirectory=value;
+                          }),
+                          "DATABASE",
+                          "Directory of the database to use");
+
+  argParser.AddPositional(osmscout::CmdLineStringOption([&](const std::string& value) {
+                            styleSheet=value;
+                          }),
+                          "STYLESHEET",
+                          "Style config file");
+
+  osmscout::CmdLineParseResult argResult=argParser.Parse();
+  if (argResult.HasError()) {
+    std::cerr << "ERROR: " << argResult.GetErrorDescription() << std::endl;
+    std::cout << argParser.GetHelp() << std::endl;
+    return 1;
+  }
+  if (help){
+    std::cout << argParser.GetHelp() << std::endl;
+    return 0;
+  }
+
+  osmscout::DatabaseParameter databaseParameter;
+  osmscout::DatabaseRef       database=std::make_shared<osmscout::Database>(databaseParameter);
+
+  if (!database->Open(databaseDirectory)) {
+    std::cerr << "ERROR: Cannot open database" << std::endl;
+    return 1;
+  }
+
+  osmscout::StyleConfigRef styleConfig=std::make_shared<osmscout::StyleConfig>(database->GetTypeConfig());
+
+  if (!styleConfig->Load(styleSheet)) {
+    std::cerr << "ERROR: Cannot open style config" << std::endl;
+    return 1;
+  }
+
+  osmscout::GeoBox boundingBox;
+
+  if (!database->GetBoundingBox(boundingBox)) {
+    std::cerr << "ERROR: Cannot get bounding box" << std::endl;
+    return 1;
+  }
+
+  osmscout::MapServiceRef mapService=std::make_shared<osmscout::MapService>(database);
+
+  mapService->SetCacheSize(1000);
+
+  osmscout::TilePrefetcher prefetcher(mapService,styleConfig);
+
+  // Pan from west to east over the database, 100ms per viewport
+
+  osmscout::Magnification                     magnification{osmscout::MagnificationLevel(16)};
+  osmscout::TilePrefetcher::Clock::time_point time=osmscout::TilePrefetcher::Clock::now();
+  size_t                                      errorCount=0;
+
+  for (size_t frame=0; frame<frameCount; frame++) {
+    osmscout::MercatorProjection projection;
+    osmscout::GeoCoord           center(boundingBox.GetCenter().GetLat(),
+                                        boundingBox.GetMinLon()+boundingBox.GetWidth()*(frame+1)/(frameCount+2));
+
+    projection.Set(center,0.0,magnification,96.0,800,600);
+
+    if (!ShowViewport(*mapService,
+                      prefetcher,
+                      *styleConfig,
+                      projection,
+                      time)) {
+      std::cerr << "ERROR: Cannot load tiles" << std::endl;
+      return 1;
+    }
+
+    // The first viewports cannot be predicted
+    if (frame==1) {
+      prefetcher.ResetStatistics();
+    }
+
+    time+=std::chrono::milliseconds(100);
+  }
+
+  auto panStatistics=prefetcher.GetStatistics();
+
+  std::cout << "Panning - prefetches: " << panStatistics.prefetches
+            << ", tiles: " << panStatistics.prefetchedTiles
+            << ", cancelled: " << panStatistics.cancelledPrefetches
+            << ", hits: " << panStatistics.hits
+            << ", late hits: " << panStatistics.lateHits
+            << ", misses: " << panStatistics.misses
+            << ", hit rate: " << panStatistics.GetHitRate() << std::endl;
+
+  if (panStatistics.prefetches==0 ||
+      panStatistics.hits==0 ||
+      panStatistics.GetHitRate()<0.5) {
+    std::cerr << "ERROR: Tiles were not prefetched while panning" << std::endl;
+    errorCount++;
+  }
+
+  // Zoom in at the center of the database
+
+  prefetcher.Cancel();
+  prefetcher.ResetStatistics();
+
+  for (size_t level=12; level<=14; level++) {
+    osmscout::MercatorProjection projection;
+
+    projection.Set(boundingBox.GetCenter(),
+                   0.0,
+                   osmscout::Magnification(osmscout::MagnificationLevel(level)),
+                   96.0,
+                   800,
+                   600);
+
+    if (!ShowViewport(*mapService,
+                      prefetcher,
+                      *styleConfig,
+                      projection,
+                      time)) {
+      std::cerr << "ERROR: Cannot load tiles" << std::endl;
+      return 1;
+    }
+
+    time+=std::chrono::milliseconds(100);
+  }
+
+  auto zoomStatistics=prefetcher.GetStatistics();
+
+  std::cout << "Zooming - prefetches: " << zoomStatistics.prefetches
+            << ", tiles: " << zoomStatistics.prefetchedTiles
+            << ", hits: " << zoomStatistics.hits
+            << ", misses: " << zoomStatistics.misses << std::endl;
+
+  if (zoomStatistics.prefetches==0 ||
+      zoomStatistics.hits==0) {
+    std::cerr << "ERROR: Tiles were not prefetched while zooming" << std::endl;
+    errorCount++;
+  }
+
+  prefetcher.Cancel();
+  database->Close();
+
+  return errorCount==0 ? 0 : 1;
+}
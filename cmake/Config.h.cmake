@@ -346,6 +346,16 @@
 #cmakedefine HAVE_LIB_ZLIB 1
 #endif
 
+/* libzstd detected */
+#ifndef HAVE_LIB_ZSTD
+#cmakedefine HAVE_LIB_ZSTD 1
+#endif
+
+/* liblz4 detected */
+#ifndef HAVE_LIB_LZ4
+#cmakedefine HAVE_LIB_LZ4 1
+#endif
+
 /* iconv detected */
 #ifndef HAVE_ICONV
 #cmakedefine HAVE_ICONV 1
@@ -0,0 +1,22 @@
+# Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+# file Copyright.txt or https://cmake.org/licensing for details.
+
+#.rst:
+# FindLZ4
+# -------
+#
+# Find LZ4
+#
+# Find LZ4 headers and library
+#
+# ::
+#
+#   LZ4_FOUND             - True if liblz4 is found.
+#   LZ4_INCLUDE_DIRS      - Directory where liblz4 headers are located.
+#   LZ4_LIBRARIES         - LZ4 libraries to link against.
+
+find_path(LZ4_INCLUDE_DIRS lz4.h )
+find_library(LZ4_LIBRARIES lz4)
+
+INCLUDE(FindPackageHandleStandardArgs)
+FIND_PACKAGE_HANDLE_STANDARD_ARGS(LZ4 DEFAULT_MSG LZ4_INCLUDE_DIRS LZ4_LIBRARIES)
@@ -0,0 +1,22 @@
+# Distributed under the OSI-approved BSD 3-Clause License.  See accompanying
+# file Copyright.txt or https://cmake.org/licensing for details.
+
+#.rst:
+# FindZSTD
+# --------
+#
+# Find Zstandard
+#
+# Find Zstandard headers and library
+#
+# ::
+#
+#   ZSTD_FOUND             - True if libzstd is found.
+#   ZSTD_INCLUDE_DIRS      - Directory where libzstd headers are located.
+#   ZSTD_LIBRARIES         - Zstandard libraries to link against.
+
+find_path(ZSTD_INCLUDE_DIRS zstd.h )
+find_library(ZSTD_LIBRARIES zstd)
+
+INCLUDE(FindPackageHandleStandardArgs)
+FIND_PACKAGE_HANDLE_STANDARD_ARGS(ZSTD DEFAULT_MSG ZSTD_INCLUDE_DIRS ZSTD_LIBRARIES)
@@ -163,6 +163,8 @@ endif()
 find_package(ZLIB)
 find_package(iconv)
 find_package(LibLZMA)
+find_package(ZSTD)
+find_package(LZ4)
 find_package(PNG QUIET)
 find_package(Cairo QUIET)
 if(CAIRO_FOUND)
@@ -240,6 +242,8 @@ set(HAVE_LIB_MARISA ${MARISA_FOUND})
 set(HAVE_LIB_XML ${LIBXML2_FOUND})
 set(HAVE_LIB_PROTOBUF ${PROTOBUF_FOUND})
 set(HAVE_LIB_ZLIB ${ZLIB_FOUND})
+set(HAVE_LIB_ZSTD ${ZSTD_FOUND})
+set(HAVE_LIB_LZ4 ${LZ4_FOUND})
 set(HAVE_LIB_CAIRO ${CAIRO_FOUND})
 set(HAVE_LIB_AGG ${LIBAGG_FOUND})
 set(HAVE_LIB_FREETYPE ${FREETYPE_FOUND})
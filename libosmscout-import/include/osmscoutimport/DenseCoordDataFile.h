@@ -0,0 +1,221 @@
+#ifndef OSMSCOUT_IMPORT_DENSECOORDDATAFILE_H
+#define OSMSCOUT_IMPORT_DENSECOORDDATAFILE_H
+
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2026  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <osmscoutimport/ImportImportExport.h>
+
+#include <osmscout/CoordDataFile.h>
+#include <osmscout/OSMScoutTypes.h>
+#include <osmscout/Point.h>
+
+#include <osmscout/util/FileScanner.h>
+#include <osmscout/util/FileWriter.h>
+#include <osmscout/util/Logger.h>
+#include <osmscout/util/ObjectPool.h>
+
+#include <osmscout/system/Compiler.h>
+
+namespace osmscout {
+
+  /**
+   * Resolves the given node ids into points, unresolved nodes get a point with
+   * serial 0 (see DenseCoordDataFile::Get())
+   */
+  using NodeResolver = std::function<bool(const std::vector<OSMId>& ids,std::vector<Point>& points)>;
+
+  /**
+   * Dense node location store used during import as an alternative to the paged
+   * 'coord.dat' file.
+   *
+   * The file is a flat array indexed by OSM id (relative to the smallest id),
+   * each entry takes 8 bytes (serial and coordinate). Entries of unused ids are
+   * left as holes, so the file is sparse on file systems supporting it. An
+   * entry with serial 0 is unset.
+   */
+  class OSMSCOUT_IMPORT_API DenseCoordDataFile CLASS_FINAL
+  {
+  public:
+    static const char* const    DENSE_COORD_DAT;
+    static constexpr FileOffset headerSize=8+8;            //!< Id of the first entry and number of entries
+    static constexpr FileOffset entrySize=1+coordByteSize; //!< Serial and coordinate
+
+  private:
+    /**
+     * Pool of file streams to the data file, so that each reading thread
+     * uses its own stream, if the file is not memory mapped
+     */
+    class ScannerPool : public ObjectPool<FileScanner>
+    {
+    private:
+      std::string filename;
+
+    public:
+      ScannerPool()
+      : ObjectPool<FileScanner>(std::max((unsigned int)1,std::thread::hardware_concurrency()))
+      {
+        // no code
+      }
+
+      ~ScannerPool() override
+      {
+        Close();
+      }
+
+      void Open(const std::string& filename)
+      {
+        this->filename=filename;
+
+        ObjectPool<FileScanner>::Open();
+      }
+
+      FileScanner* MakeNew() noexcept override
+      {
+        auto* scanner=new FileScanner();
+
+        try {
+          scanner->Open(filename,
+                        FileScanner::FastRandom,
+                        false);
+        }
+        catch (const IOException& e) {
+          log.Error() << e.GetDescription();
+          delete scanner;
+          return nullptr;
+        }
+
+        return scanner;
+      }
+
+      void Destroy(FileScanner* scanner) noexcept override
+      {
+        scanner->CloseFailsafe();
+        delete scanner;
+      }
+
+      bool IsValid(FileScanner* scanner) noexcept override
+      {
+        return !scanner->HasError();
+      }
+    };
+
+    using ScannerRef = ObjectPool<FileScanner>::Ptr;
+
+  private:
+    std::string         datafilename; //!< complete filename for data file
+    FileScanner         scanner;      //!< File stream to the data file, memory mapped if requested
+    mutable ScannerPool scannerPool;  //!< File streams of the reading threads, if the file is not memory mapped
+    OSMId               minId=0;      //!< Id of the first entry
+    uint64_t            entryCount=0; //!< Number of entries (including unset entries)
+
+  private:
+    /**
+     * Read the points of the given ids using the given FileScanner or
+     * MemoryScanner.
+     *
+     * @throws IOException
+     */
+    template<typename Scanner>
+    void ReadPoints(Scanner& scanner,
+                    const std::vector<OSMId>& ids,
+                    std::vector<Point>& points) const
+    {
+      for (size_t i=0; i<ids.size(); i++) {
+        if (ids[i]<minId ||
+            (uint64_t)(ids[i]-minId)>=entryCount) {
+          points[i]=Point();
+          continue;
+        }
+
+        scanner.SetPos(headerSize+(uint64_t)(ids[i]-minId)*entrySize);
+
+        uint8_t serial=scanner.ReadUInt8();
+
+        if (serial==0) {
+          points[i]=Point();
+          continue;
+        }
+
+        points[i].Set(serial,
+                      scanner.ReadCoord());
+      }
+    }
+
+  public:
+    DenseCoordDataFile() = default;
+    ~DenseCoordDataFile();
+
+    bool Open(const std::string& path,
+              bool memoryMapedData);
+    bool Close();
+
+    inline std::string GetFilename() const
+    {
+      return datafilename;
+    }
+
+    bool Get(const std::vector<OSMId>& ids,
+             std::vector<Point>& points) const;
+
+    /**
+     * Return true, if the point has been resolved by Get()
+     */
+    static bool IsResolved(const Point& point)
+    {
+      return point.GetSerial()!=0;
+    }
+
+    static void GetPoints(const CoordDataFile::ResultMap& coordsMap,
+                          const std::vector<OSMId>& ids,
+                          std::vector<Point>& points);
+  };
+
+  /**
+   * Writes the dense node location store. Points have to be written in the
+   * order of increasing ids.
+   */
+  class OSMSCOUT_IMPORT_API DenseCoordDataFileWriter CLASS_FINAL
+  {
+  private:
+    FileWriter writer;
+    OSMId      minId=0;
+    uint64_t   entryCount=0;
+
+  public:
+    void Open(const std::string& path);
+    void Write(OSMId id,
+               const Point& point);
+    void Close();
+    void CloseFailsafe();
+
+    inline std::string GetFilename() const
+    {
+      return writer.GetFilename();
+    }
+  };
+}
+
+#endif
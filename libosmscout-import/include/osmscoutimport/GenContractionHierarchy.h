@@ -0,0 +1,93 @@
+#ifndef OSMSCOUT_IMPORT_GENCONTRACTIONHIERARCHY_H
+#define OSMSCOUT_IMPORT_GENCONTRACTIONHIERARCHY_H
+
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2026  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <vector>
+
+#include <osmscout/OSMScoutTypes.h>
+#include <osmscout/ObjectRef.h>
+
+#include <osmscout/util/Distance.h>
+
+#include <osmscoutimport/Import.h>
+#include <osmscoutimport/ImportImportExport.h>
+
+#include <osmscout/system/Compiler.h>
+
+namespace osmscout {
+
+  /**
+   * Generates a contraction hierarchy for each vehicle of each router (see
+   * ContractionHierarchy for a description of the format and its usage).
+   *
+   * The route nodes are ordered using the minimum degree heuristic on the
+   * undirected routing graph, costs are not taken into account, so the
+   * hierarchy can be used with every routing profile of the vehicle.
+   */
+  class OSMSCOUT_IMPORT_API ContractionHierarchyGenerator CLASS_FINAL : public ImportModule
+  {
+  private:
+    struct Arc
+    {
+      uint32_t      from;
+      uint32_t      to;
+      Id            toId;
+      ObjectFileRef object;
+      uint16_t      objectVariantIndex;
+      uint8_t       flags;
+      Distance      distance;
+    };
+
+  private:
+    bool ReadArcs(const std::string& filename,
+                  Vehicle vehicle,
+                  Progress& progress,
+                  std::vector<Id>& ids,
+                  std::vector<Arc>& arcs) const;
+
+    std::vector<uint32_t> CalculateRanks(const std::vector<Id>& ids,
+                                         const std::vector<Arc>& arcs,
+                                         Progress& progress,
+                                         std::vector<std::vector<uint32_t>>& upper) const;
+
+    bool WriteHierarchy(const std::string& filename,
+                        const std::vector<Id>& ids,
+                        const std::vector<Arc>& arcs,
+                        const std::vector<uint32_t>& ranks,
+                        const std::vector<std::vector<uint32_t>>& upper,
+                        Progress& progress) const;
+
+    bool GenerateHierarchy(const ImportParameter& parameter,
+                           const ImportParameter::Router& router,
+                           Vehicle vehicle,
+                           Progress& progress) const;
+
+  public:
+    void GetDescription(const ImportParameter& parameter,
+                        ImportModuleDescription& description) const override;
+
+    bool Import(const TypeConfigRef& typeConfig,
+                const ImportParameter& parameter,
+                Progress& progress) override;
+  };
+}
+
+#endif
@@ -20,8 +20,12 @@
   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
 */
 
+#include <algorithm>
+#include <array>
+#include <limits>
 #include <vector>
 
+#include <osmscout/NumericIndex.h>
 
 #include <osmscout/util/Cache.h>
 #include <osmscout/util/File.h>
@@ -47,6 +51,10 @@ namespace osmscout {
                   FileScanner& scanner,
                   T& data) const;
 
+    static void WriteKeyBlock(FileWriter& writer,
+                              const uint64_t* keys,
+                              size_t keyCount);
+
   public:
     NumericIndexGenerator(const std::string& description,
                           const std::string& datafile,
@@ -85,26 +93,43 @@ namespace osmscout {
               scanner);
   }
 
+  template <class N,class T>
+  void NumericIndexGenerator<N,T>::WriteKeyBlock(FileWriter& writer,
+                                                 const uint64_t* keys,
+                                                 size_t keyCount)
+  {
+    for (size_t i=0; i<NumericIndex<N>::blockKeyCount; i++) {
+      // Padding keys are never less or equal to a valid key
+      writer.Write(i<keyCount ? keys[i] : std::numeric_limits<uint64_t>::max());
+    }
+  }
+
+  /**
+   * Write the index in the static B+ tree layout (see NumericIndex):
+   * * Header (a page size of 0 marks the static layout, followed by the number of entries,
+   *   the number of levels and the offset of the level table)
+   * * The leaf level, each leaf block consists of 8 keys followed by the 8 file offsets
+   * * The inner levels, bottom up, each holding the first key of each block of the level below
+   * * The level table, top down, with file offset and number of keys of each level
+   */
   template <class N,class T>
   bool NumericIndexGenerator<N,T>::Import(const TypeConfigRef& typeConfig,
                                           const ImportParameter& parameter,
                                           Progress& progress)
   {
+    constexpr size_t blockKeyCount=NumericIndex<N>::blockKeyCount;
+
     FileScanner             scanner;
     FileWriter              writer;
 
     uint32_t                dataCount;
 
-    std::vector<N>          startingIds;
-    std::vector<FileOffset> pageStarts;
-
-    std::vector<uint32_t>   indexPageCounts;
+    std::vector<uint64_t>   blockKeys;       // First key of each block of the last written level
+    std::vector<FileOffset> levelOffsets;    // Offset of each level, bottom up
+    std::vector<uint64_t>   levelKeyCounts;  // Number of keys of each level, bottom up
 
     FileOffset              levelsOffset;
-    FileOffset              lastLevelPageStartOffset;
-
-    FileOffset              indexPageCountsOffset;
-    uint32_t                pageSize=(uint32_t)parameter.GetNumericIndexPageSize();
+    FileOffset              levelTableOffsetOffset;
 
     //
     // Writing index file
@@ -122,25 +147,27 @@ namespace osmscout {
 
       dataCount=scanner.ReadUInt32();
 
-      writer.WriteNumber(pageSize);       // Size of one index page in bytes
+      writer.WriteNumber((uint32_t)0);    // Page size of 0 marks the static layout
       writer.WriteNumber(dataCount);      // Number of entries in data file
 
       levelsOffset=writer.GetPos();
-      writer.Write((uint32_t)0);        // Number of levels
-
-      lastLevelPageStartOffset=writer.GetPos();
-      writer.WriteFileOffset((FileOffset)0);        // Write the starting position of the last page
+      writer.Write((uint32_t)0);          // Number of levels
 
-      indexPageCountsOffset=writer.GetPos();
-      writer.WriteFileOffset((FileOffset)0);        // Write the starting position of list of sizes of each index level
+      levelTableOffsetOffset=writer.GetPos();
+      writer.WriteFileOffset((FileOffset)0); // Write the starting position of the level table
 
-      writer.FlushCurrentBlockWithZeros(pageSize);
+      writer.FlushCurrentBlockWithZeros(blockKeyCount*sizeof(uint64_t));
 
       progress.Info(std::string("Writing level ")+std::to_string(1)+" ("+std::to_string(dataCount)+" entries)");
 
-      N          lastId=0;
-      FileOffset lastPos=0;
-      uint32_t   currentPageSize=0;
+      std::array<uint64_t,blockKeyCount>   keys;
+      std::array<FileOffset,blockKeyCount> offsets;
+      size_t                               keyCount=0;
+      N                                    lastId=0;
+
+      levelOffsets.push_back(writer.GetPos());
+      levelKeyCounts.push_back(dataCount);
+      blockKeys.reserve(dataCount/blockKeyCount+1);
 
       for (uint32_t d=0; d<dataCount; d++) {
         progress.SetProgress(d,dataCount);
@@ -159,145 +186,71 @@ namespace osmscout {
             progress.Error("Current id "+std::to_string(data.GetId())+" <= last id "+std::to_string(lastId));
           }
           assert(data.GetId()>lastId);
-          assert(readPos>lastPos);
         }
 
-        if (currentPageSize>0) {
-          std::array<char,10> b1;
-          std::array<char,10> b2;
-          N                   b1val=data.GetId()-lastId;
-          FileOffset          b2val=readPos-lastPos;
-          unsigned int        b1size;
-          unsigned int        b2size;
-
-
-          b1size=EncodeNumber(b1val,b1);
-          b2size=EncodeNumber(b2val,b2);
-
-          assert(b1size<=10);
-          assert(b2size<=10);
-
-          if (currentPageSize+b1size+b2size>pageSize) {
-            // Next entry does not fit, fill rest of index page with zeros
-            writer.FlushCurrentBlockWithZeros(pageSize);
+        keys[keyCount]=NumericIndex<N>::ToKey(data.GetId());
+        offsets[keyCount]=readPos;
 
-            currentPageSize=0;
-          }
-          else {
-            writer.Write(b1.data(),b1size);
-            writer.Write(b2.data(),b2size);
-
-            currentPageSize+=b1size+b2size;
-          }
+        if (keyCount==0) {
+          blockKeys.push_back(keys[0]);
         }
 
-        if (currentPageSize==0) {
-          FileOffset writePos=writer.GetPos();
+        keyCount++;
 
-          startingIds.push_back(data.GetId());
-          pageStarts.push_back(writePos);
+        if (keyCount==blockKeyCount || d+1==dataCount) {
+          WriteKeyBlock(writer,
+                        keys.data(),
+                        keyCount);
 
-          writer.WriteNumber(data.GetId());
-          writer.WriteNumber(readPos);
+          for (size_t i=0; i<blockKeyCount; i++) {
+            writer.WriteFileOffset(i<keyCount ? offsets[i] : 0);
+          }
 
-          writePos=writer.GetPos();
-          currentPageSize=writePos%pageSize;
+          keyCount=0;
         }
 
         lastId=data.GetId();
-        lastPos=readPos;
       }
 
-      writer.FlushCurrentBlockWithZeros(pageSize);
-      indexPageCounts.push_back((uint32_t)pageStarts.size());
+      while (blockKeys.size()>1) {
+        std::vector<uint64_t> levelKeys;
 
-      while (pageStarts.size()>1) {
-        std::vector<N>          si(startingIds);
-        std::vector<FileOffset> po(pageStarts);
+        std::swap(levelKeys,blockKeys);
 
-        startingIds.clear();
-        pageStarts.clear();
+        progress.Info(std::string("Writing level ")+std::to_string(levelOffsets.size()+1)+" ("+std::to_string(levelKeys.size())+" entries)");
 
-        progress.Info(std::string("Writing level ")+std::to_string(indexPageCounts.size()+1)+" ("+std::to_string(si.size())+" entries)");
+        levelOffsets.push_back(writer.GetPos());
+        levelKeyCounts.push_back(levelKeys.size());
 
-        size_t currentPageSize=0;
+        for (size_t i=0; i<levelKeys.size(); i+=blockKeyCount) {
+          blockKeys.push_back(levelKeys[i]);
 
-        for (size_t i=0; i<si.size(); i++) {
-          if (currentPageSize>0) {
-            std::array<char,10> b1;
-            std::array<char,10> b2;
-            N                   b1val=si[i]-si[i-1];
-            FileOffset          b2val=po[i]-po[i-1];
-            unsigned int        b1size;
-            unsigned int        b2size;
-
-            b1size=EncodeNumber(b1val,b1);
-            b2size=EncodeNumber(b2val,b2);
-
-            assert(b1size<=10);
-            assert(b2size<=10);
-
-            if (currentPageSize+b1size+b2size>pageSize) {
-              // Fill rest of first index page with zeros
-              writer.FlushCurrentBlockWithZeros(pageSize);
-
-              currentPageSize=0;
-            }
-            else {
-              writer.Write(b1.data(),b1size);
-              writer.Write(b2.data(),b2size);
-
-              currentPageSize+=b1size+b2size;
-            }
-          }
-
-          if (currentPageSize==0) {
-            FileOffset writePos;
-
-            writePos=writer.GetPos();
-
-            startingIds.push_back(si[i]);
-            pageStarts.push_back(writePos);
-
-            writer.WriteNumber(si[i]);
-            writer.WriteNumber(po[i]);
-
-            writePos=writer.GetPos();
-            currentPageSize=writePos%pageSize;
-          }
+          WriteKeyBlock(writer,
+                        &levelKeys[i],
+                        std::min(blockKeyCount,levelKeys.size()-i));
         }
-
-        writer.FlushCurrentBlockWithZeros(pageSize);
-        indexPageCounts.push_back((uint32_t)pageStarts.size());
       }
 
-      // If we have data to index, we should have at least one root level index page
+      // If we have data to index, we should have at least the leaf level
       if (dataCount>0) {
-        assert(pageStarts.size()==1);
+        FileOffset levelTableOffset=writer.GetPos();
 
-        FileOffset indexPageCountsPos;
+        for (size_t level=0; level<levelOffsets.size(); level++) {
+          size_t levelIndex=levelOffsets.size()-level-1;
 
-        indexPageCountsPos=writer.GetPos();
+          progress.Info(std::string("Key count for level ")+std::to_string(level)+" is "+std::to_string(levelKeyCounts[levelIndex]));
+          writer.WriteFileOffset(levelOffsets[levelIndex]);
+          writer.WriteNumber(levelKeyCounts[levelIndex]);
+        }
 
         writer.SetPos(levelsOffset);
-        writer.Write((uint32_t)indexPageCounts.size());
+        writer.Write((uint32_t)levelOffsets.size());
 
-        writer.SetPos(lastLevelPageStartOffset);
-        writer.WriteFileOffset(pageStarts[0]);
-
-        writer.SetPos(indexPageCountsOffset);
-        writer.WriteFileOffset(indexPageCountsPos);
-
-        writer.SetPos(indexPageCountsPos);
+        writer.SetPos(levelTableOffsetOffset);
+        writer.WriteFileOffset(levelTableOffset);
       }
 
-      progress.Info(std::string("Index for ")+std::to_string(dataCount)+" data elements will be stored in "+std::to_string(indexPageCounts.size())+ " levels");
-      for (size_t level=0; level<indexPageCounts.size(); level++) {
-        size_t levelIndex=indexPageCounts.size()-level-1;
-
-        progress.Info(std::string("Page count for level ")+std::to_string(level)+" is "+std::to_string(indexPageCounts[levelIndex]));
-        writer.WriteNumber(indexPageCounts[levelIndex]);
-      }
+      progress.Info(std::string("Index for ")+std::to_string(dataCount)+" data elements will be stored in "+std::to_string(levelOffsets.size())+ " levels");
 
       scanner.Close();
       writer.Close();
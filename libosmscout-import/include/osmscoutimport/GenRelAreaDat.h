@@ -33,6 +33,7 @@
 
 #include <osmscout/util/Geometry.h>
 
+#include <osmscoutimport/DenseCoordDataFile.h>
 #include <osmscoutimport/RawRelation.h>
 #include <osmscoutimport/RawRelIndexedDataFile.h>
 #include <osmscoutimport/RawWay.h>
@@ -211,7 +212,7 @@ namespace osmscout {
 
     bool ComposeAreaMembers(const TypeConfig& typeConfig,
                             Progress& progress,
-                            const CoordDataFile::ResultMap& coordMap,
+                            const NodeResolver& resolveNodes,
                             const IdRawWayMap& wayMap,
                             const std::string& name,
                             const RawRelation& rawRelation,
@@ -219,7 +220,7 @@ namespace osmscout {
 
     bool ComposeBoundaryMembers(const TypeConfig& typeConfig,
                                 Progress& progress,
-                                const CoordDataFile::ResultMap& coordMap,
+                                const NodeResolver& resolveNodes,
                                 const IdRawWayMap& wayMap,
                                 const std::map<OSMId,RawRelationRef>& relationMap,
                                 const Area& relation,
@@ -232,6 +233,7 @@ namespace osmscout {
                                   const ImportParameter& parameter,
                                   const TypeConfig& typeConfig,
                                   CoordDataFile& coordDataFile,
+                                  const DenseCoordDataFile& denseCoordDataFile,
                                   RawWayIndexedDataFile& wayDataFile,
                                   RawRelationIndexedDataFile& relDataFile,
                                   IdSet& resolvedRelations,
@@ -245,6 +247,7 @@ namespace osmscout {
                                     const TypeConfig& typeConfig,
                                     IdSet& wayAreaIndexBlacklist,
                                     CoordDataFile& coordDataFile,
+                                    const DenseCoordDataFile& denseCoordDataFile,
                                     RawWayIndexedDataFile& wayDataFile,
                                     RawRelationIndexedDataFile& relDataFile,
                                     RawRelation& rawRelation,
@@ -34,6 +34,7 @@
 
 #include <osmscout/routing/TurnRestriction.h>
 
+#include <osmscoutimport/DenseCoordDataFile.h>
 #include <osmscoutimport/Import.h>
 #include <osmscoutimport/RawWay.h>
 
@@ -67,7 +68,7 @@ namespace osmscout {
                    const TypeConfig& typeConfig,
                    FileWriter& writer,
                    uint32_t& writtenWayCount,
-                   const CoordDataFile::ResultMap& coordsMap,
+                   const std::vector<Point>& points,
                    const RawWay& rawWay);
 
   public:
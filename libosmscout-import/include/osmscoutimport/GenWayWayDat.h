@@ -24,6 +24,8 @@
 
 #include <map>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include <osmscout/Way.h>
 
@@ -35,6 +37,7 @@
 
 #include <osmscout/routing/TurnRestriction.h>
 
+#include <osmscoutimport/DenseCoordDataFile.h>
 #include <osmscoutimport/Import.h>
 #include <osmscoutimport/RawWay.h>
 
@@ -54,11 +57,13 @@ namespace osmscout {
       std::multimap<OSMId,TurnRestrictionRef> restrictions;
     };
 
-    using RouteMemberData = std::multimap<OSMId,OSMId>; // key is way id, values are route ids
+    using RouteMember = std::pair<OSMId,OSMId>; // way id and route id
+    using RouteMemberData = std::vector<RouteMember>; // sorted by way id and route id, without duplicates
     using WayList = std::list<RawWayRef>;
     using WayListPtr = WayList::iterator;
-    using WayListPtrList = std::list<WayListPtr>;
+    using WayListPtrList = std::vector<WayListPtr>;
     using WaysByNodeMap = std::unordered_map<OSMId, WayListPtrList>;
+    using WayBuffer = std::vector<std::pair<OSMId,WayRef>>; // Resolved ways of one type in write order
 
     bool ReadRouteMemberData(const ImportParameter& parameter,
                              const TypeConfig& typeConfig,
@@ -88,21 +93,33 @@ namespace osmscout {
                       OSMId wayId,
                       OSMId nodeId) const;
 
+    static bool HaveSameRoutes(const RouteMemberData& routeMembers,
+                               OSMId aWayId,
+                               OSMId bWayId);
+
     bool MergeWays(Progress& progress,
                    std::list<RawWayRef>& ways,
                    RestrictionData& restrictions,
-                   RouteMemberData& routeMembers);
+                   const RouteMemberData& routeMembers);
 
     bool SplitLongWays(Progress& progress,
                        std::list<RawWayRef>& ways,
-                       CoordDataFile::ResultMap& coordsMap);
+                       const NodeResolver& resolveNodes);
+
+    WayRef BuildWay(Progress& progress,
+                    const std::vector<Point>& points,
+                    const RawWay& rawWay);
+
+    bool BuildWays(Progress& progress,
+                   const std::list<RawWayRef>& rawWays,
+                   const NodeResolver& resolveNodes,
+                   WayBuffer& ways);
 
-    void WriteWay(Progress& progress,
-                  const TypeConfig& typeConfig,
+    void WriteWay(const TypeConfig& typeConfig,
                   FileWriter& writer,
                   uint32_t& writtenWayCount,
-                  const CoordDataFile::ResultMap& coordsMap,
-                  const RawWay& rawWay);
+                  OSMId wayId,
+                  const Way& way);
 
     bool HandleLowMemoryFallback(Progress& progress,
                                  const TypeConfig& typeConfig,
@@ -110,7 +127,7 @@ namespace osmscout {
                                  const TypeInfoSet& types,
                                  FileWriter& writer,
                                  uint32_t& writtenWayCount,
-                                 const CoordDataFile& coordDataFile);
+                                 const NodeResolver& resolveNodes);
 
   public:
     void GetDescription(const ImportParameter& parameter,
@@ -20,9 +20,12 @@
   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
 */
 
+#include <functional>
 #include <list>
 #include <mutex>
+#include <set>
 #include <string>
+#include <vector>
 
 #include <osmscoutimport/ImportFeatures.h>
 
@@ -61,10 +64,17 @@ namespace osmscout {
     void DumpTypeConfigData(const TypeConfig& typeConfig,
                             Progress& progress);
     bool CleanupTemporaries(size_t currentStep,
+                            const std::vector<bool>& finishedModules,
                             Progress& progress);
 
+    bool ExecuteModulesSequential(const TypeConfigRef& typeConfig,
+                                  ImportProgress& progress);
+    bool ExecuteModulesParallel(const TypeConfigRef& typeConfig,
+                                ImportProgress& progress,
+                                std::mutex& progressMutex);
     bool ExecuteModules(const TypeConfigRef& typeConfig,
-                        ImportProgress& progress);
+                        ImportProgress& progress,
+                        std::mutex& progressMutex);
   public:
     explicit Importer(const ImportParameter& parameter);
     virtual ~Importer() = default;
@@ -77,6 +87,15 @@ namespace osmscout {
     std::list<std::string> GetProvidedTemporaryFiles() const;
     std::list<std::string> GetProvidedAnalysisFiles() const;
     std::list<std::string> GetProvidedReportFiles() const;
+
+    static void GetModuleDependencies(const std::vector<ImportModuleDescription>& moduleDescriptions,
+                                      std::vector<std::set<size_t>>& dependencies);
+    static bool ExecuteModulesInDependencyOrder(const std::vector<std::set<size_t>>& dependencies,
+                                                std::vector<bool>& finishedModules,
+                                                size_t threadCount,
+                                                const std::function<bool()>& canStartModule,
+                                                const std::function<bool(size_t)>& executeModule,
+                                                const std::function<bool(size_t)>& finishedModule);
   };
 }
 
@@ -111,17 +111,20 @@ private:
   size_t                       endStep;                  //<! End step for import
   std::string                  boundingPolygonFile;      //<! Polygon file containing the bounding polygon of the current import
   bool                         eco;                      //<! Eco modus, deletes temporary files ASAP
+  size_t                       parallelModules;          //<! Maximum number of independent import modules executed in parallel
+  size_t                       parallelModulesMemoryLimit; //<! Do not start further parallel modules if resident memory exceeds this limit (in bytes, 0 means no limit)
   std::list<Router>            router;                   //<! Definition of router
 
   bool                         strictAreas;              //<! Assure that areas conform to "simple" definition
 
   bool                         sortObjects;              //<! Sort all objects
-  size_t                       sortBlockSize;            //<! Number of entries loaded in one sort iteration
+  size_t                       sortBlockSize;            //<! Number of entries loaded in one sort iteration (unused, sorting is limited by sortMemoryLimit)
+  size_t                       sortMemoryLimit;          //<! Memory used for sort entries before sorted runs are written to temporary files (in bytes)
   size_t                       sortTileMag;              //<! Zoom level for individual sorting cells
 
   size_t                       processingQueueSize;      //!< Size of the processing worker queues
 
-  size_t                       numericIndexPageSize;     //<! Size of an numeric index page in bytes
+  size_t                       numericIndexPageSize;     //<! Size of an numeric index page in bytes (unused, numeric indexes use the static layout)
 
   size_t                       rawCoordBlockSize;        //<! Number of raw coords loaded during import in one go
 
@@ -132,6 +135,7 @@ private:
   size_t                       rawWayIndexCacheSize;     //<! Size of the raw way index cache
   size_t                       rawWayBlockSize;          //<! Number of ways loaded during import until nodes get resolved
 
+  bool                         denseCoordData;           //<! Additionally store coordinates in a dense array indexed by node id and resolve way nodes from it
   bool                         coordDataMemoryMaped;     //<! Use memory mapping for coord data file access
   size_t                       coordIndexCacheSize;      //<! Size of the coord index cache
   size_t                       coordBlockSize;           //<! Maximum number of node ids we resolve in one go
@@ -172,6 +176,7 @@ private:
 
   size_t                       routeNodeBlockSize;       //<! Number of route nodes loaded during import until ways get resolved
   uint32_t                     routeNodeTileMag;         //<! Size of a routing tile
+  bool                         routerContractionHierarchy; //<! Generate contraction hierarchies for the router(s)
 
   AssumeLandStrategy           assumeLand;               //<! During sea/land detection,we either trust coastlines only or make some
   //<! assumptions which tiles are sea and which are land.
@@ -200,6 +205,8 @@ private:
   size_t GetStartStep() const;
   size_t GetEndStep() const;
   bool   IsEco() const;
+  size_t GetParallelModules() const;
+  size_t GetParallelModulesMemoryLimit() const;
 
   const std::list<Router>& GetRouter() const;
 
@@ -207,6 +214,7 @@ private:
 
   bool GetSortObjects() const;
   size_t GetSortBlockSize() const;
+  size_t GetSortMemoryLimit() const;
   size_t GetSortTileMag() const;
 
   size_t GetProcessingQueueSize() const;
@@ -222,6 +230,7 @@ private:
   size_t GetRawWayIndexCacheSize() const;
   size_t GetRawWayBlockSize() const;
 
+  bool GetDenseCoordData() const;
   bool GetCoordDataMemoryMaped() const;
   size_t GetCoordIndexCacheSize() const;
 
@@ -263,6 +272,7 @@ private:
 
   size_t GetRouteNodeBlockSize() const;
   uint32_t GetRouteNodeTileMag() const;
+  bool GetRouterContractionHierarchy() const;
 
   AssumeLandStrategy GetAssumeLand() const;
 
@@ -283,6 +293,8 @@ private:
   void SetStartStep(size_t startStep);
   void SetSteps(size_t startStep, size_t endStep);
   void SetEco(bool eco);
+  void SetParallelModules(size_t parallelModules);
+  void SetParallelModulesMemoryLimit(size_t parallelModulesMemoryLimit);
 
   void ClearRouter();
   void AddRouter(const Router& router);
@@ -291,6 +303,7 @@ private:
 
   void SetSortObjects(bool sortObjects);
   void SetSortBlockSize(size_t sortBlockSize);
+  void SetSortMemoryLimit(size_t sortMemoryLimit);
   void SetSortTileMag(size_t sortTileMag);
 
   void SetProcessingQueueSize(size_t processingQueueSize);
@@ -306,6 +319,7 @@ private:
   void SetRawWayIndexCacheSize(size_t wayIndexCacheSize);
   void SetRawWayBlockSize(size_t blockSize);
 
+  void SetDenseCoordData(bool denseCoordData);
   void SetCoordDataMemoryMaped(bool memoryMaped);
   void SetCoordIndexCacheSize(size_t coordIndexCacheSize);
 
@@ -347,6 +361,7 @@ private:
 
   void SetRouteNodeBlockSize(size_t blockSize);
   void SetRouteNodeTileMag(uint32_t routeNodeTileMag);
+  void SetRouterContractionHierarchy(bool routerContractionHierarchy);
 
   void SetAssumeLand(AssumeLandStrategy assumeLand);
 
@@ -44,12 +44,14 @@ public:
 
   virtual void StartModule(size_t currentStep, const ImportModuleDescription& moduleDescription);
   virtual void FinishedModule();
+  virtual void FinishedModule(size_t currentStep);
 };
 
 class OSMSCOUT_IMPORT_API StatImportProgress: public ImportProgress
 {
 private:
   struct ModuleStat {
+    size_t step;
     ImportModuleDescription description;
     std::chrono::steady_clock::duration duration;
     double vmUsage;
@@ -65,16 +67,21 @@ public:
 
   void StartModule(size_t currentStep, const ImportModuleDescription& moduleDescription) override;
   void FinishedModule() override;
+  void FinishedModule(size_t currentStep) override;
 
   bool DumpDotStats(const std::string &filename);
 
 private:
-  StopClock timer;
+  struct RunningModule {
+    StopClock timer;
+    ImportModuleDescription description;
+  };
+
+  std::map<size_t,RunningModule> runningModules; //!< Modules started but not yet finished, by step
   StopClock overAllTimer;
   MemoryMonitor monitor;
   double maxVMUsage=0.0;
   double maxResidentSet=0.0;
-  ImportModuleDescription currentModule;
   std::list<ModuleStat> moduleStats;
   std::string destinationDirectory;
   std::map<std::string, osmscout::FileOffset> fileSizes;
@@ -31,6 +31,8 @@
 
 #include <osmscoutimport/Preprocessor.h>
 
+#include <osmscout/util/WorkQueue.h>
+
 #if defined(OSMSCOUT_IMPORT_MESON_BUILD) || defined(OSMSCOUT_IMPORT_CMAKE_BUILD)
   #include <fileformat.pb.h>
   #include <osmformat.pb.h>
@@ -43,15 +45,23 @@
 
 namespace osmscout {
 
+  /**
+   * Preprocessor for *.osm.pbf files.
+   *
+   * The file is read by the calling thread, that hands the (still compressed) blobs
+   * to a pool of decoder threads. The decoders decompress the blobs, parse the contained
+   * primitive blocks and convert them to raw block data. The decoded blocks are passed to
+   * the callback in file order.
+   */
   class PreprocessPBF CLASS_FINAL : public Preprocessor
   {
+  private:
+    using DecodeQueue = WorkQueue<PreprocessorCallback::RawBlockDataRef>;
+
   private:
     char                             *buffer;
     google::protobuf::int32          bufferSize;
     PreprocessorCallback&            callback;
-    TagMap                           tagMap;
-    std::vector<OSMId>               nodes;
-    std::vector<RawRelation::Member> members;
 
   private:
     bool GetPos(FILE* file,
@@ -64,38 +74,52 @@ namespace osmscout {
                          OSMPBF::BlobHeader& blockHeader,
                          bool silent);
 
+    static bool ReadBlob(Progress& progress,
+                         FILE* file,
+                         const OSMPBF::BlobHeader& blockHeader,
+                         std::string& blobData);
+
+    static bool DecodeBlob(const OSMPBF::Blob& blob,
+                           std::string& data,
+                           std::string& error);
+
     bool ReadHeaderBlock(Progress& progress,
                          FILE* file,
                          const OSMPBF::BlobHeader& blockHeader,
                          OSMPBF::HeaderBlock& headerBlock);
 
-    bool ReadPrimitiveBlock(Progress& progress,
-                            FILE* file,
-                            const OSMPBF::BlobHeader& blockHeader,
-                            OSMPBF::PrimitiveBlock& primitiveBlock);
-
-    void ReadNodes(const TypeConfig& typeConfig,
-                   const OSMPBF::PrimitiveBlock& block,
-                   const OSMPBF::PrimitiveGroup &group,
-                   PreprocessorCallback::RawBlockData& data);
-
-    void ReadDenseNodes(const TypeConfig& typeConfig,
-                        const OSMPBF::PrimitiveBlock& block,
-                        const OSMPBF::PrimitiveGroup &group,
-                        PreprocessorCallback::RawBlockData& data);
-
-    void ReadWays(const TypeConfig& typeConfig,
-                  const OSMPBF::PrimitiveBlock& block,
-                  const OSMPBF::PrimitiveGroup &group,
-                  PreprocessorCallback::RawBlockData& data);
-
-    void ReadRelations(const TypeConfig& typeConfig,
-                       const OSMPBF::PrimitiveBlock& block,
-                       const OSMPBF::PrimitiveGroup &group,
-                       PreprocessorCallback::RawBlockData& data);
-
-    void ProcessBlock(const TypeConfigRef& typeConfig,
-                      std::unique_ptr<OSMPBF::PrimitiveBlock>&& block);
+    static void ReadNodes(const TypeConfig& typeConfig,
+                          const OSMPBF::PrimitiveBlock& block,
+                          const OSMPBF::PrimitiveGroup &group,
+                          PreprocessorCallback::RawBlockData& data);
+
+    static void ReadDenseNodes(const TypeConfig& typeConfig,
+                               const OSMPBF::PrimitiveBlock& block,
+                               const OSMPBF::PrimitiveGroup &group,
+                               PreprocessorCallback::RawBlockData& data);
+
+    static void ReadWays(const TypeConfig& typeConfig,
+                         const OSMPBF::PrimitiveBlock& block,
+                         const OSMPBF::PrimitiveGroup &group,
+                         PreprocessorCallback::RawBlockData& data);
+
+    static void ReadRelations(const TypeConfig& typeConfig,
+                              const OSMPBF::PrimitiveBlock& block,
+                              const OSMPBF::PrimitiveGroup &group,
+                              PreprocessorCallback::RawBlockData& data);
+
+    static PreprocessorCallback::RawBlockDataRef DecodeBlock(const TypeConfig& typeConfig,
+                                                             const std::string& filename,
+                                                             const std::string& blobData);
+
+    static void DecodeWorkerLoop(DecodeQueue& queue);
+
+    bool ReadDataBlocks(const TypeConfigRef& typeConfig,
+                        const ImportParameter& parameter,
+                        Progress& progress,
+                        const std::string& filename,
+                        FILE* file,
+                        FileOffset fileSize);
 
   public:
     explicit PreprocessPBF(PreprocessorCallback& callback);
@@ -20,16 +20,26 @@
   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
 */
 
+#include <algorithm>
+#include <future>
+#include <iterator>
 #include <list>
-#include <map>
 #include <memory>
+#include <queue>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include <osmscoutimport/Import.h>
 
 #include <osmscout/DataFile.h>
 #include <osmscout/ObjectRef.h>
 
+#include <osmscout/util/File.h>
+#include <osmscout/util/FileScanner.h>
 #include <osmscout/util/FileWriter.h>
+#include <osmscout/util/WorkQueue.h>
+
 #include <osmscout/system/Math.h>
 
 namespace osmscout {
@@ -38,40 +48,65 @@ namespace osmscout {
   class SortDataGenerator : public ImportModule
   {
   private:
+    /**
+     * Maximum number of runs merged at once. If there are more runs, they are
+     * first merged into intermediate runs, so the number of open files stays
+     * bounded.
+     */
+    static constexpr size_t maxMergeRunCount=64;
+
     struct Source
     {
       std::string filename;
       FileScanner scanner;
     };
 
-    struct CellEntry
+    /**
+     * Fixed size sort entry referencing an object in one of the sources.
+     * Entries are ordered by cell, by the hash of the top left coordinate
+     * and finally by their position in the sources.
+     */
+    struct SortEntry
     {
-      uint8_t    type;
-      Id         id;
-      Source     &source;
-      FileOffset fileOffset;
+      uint64_t   cellIndex;
       Id         sortId;
+      FileOffset fileOffset;
+      Id         id;
+      uint32_t   sourceIndex;
+      uint8_t    type;
 
-      CellEntry(uint8_t type,
-                Id id,
-                Source& source,
-                FileOffset fileOffset,
-                Id sortId)
-        : type(type),
-        id(id),
-        source(source),
-        fileOffset(fileOffset),
-        sortId(sortId)
+      bool operator<(const SortEntry& other) const
       {
-        // no code
-      }
+        if (cellIndex!=other.cellIndex) {
+          return cellIndex<other.cellIndex;
+        }
 
-      bool operator<(const CellEntry& other) const
-      {
-        return sortId<other.sortId;
+        if (sortId!=other.sortId) {
+          return sortId<other.sortId;
+        }
+
+        if (sourceIndex!=other.sourceIndex) {
+          return sourceIndex<other.sourceIndex;
+        }
+
+        return fileOffset<other.fileOffset;
       }
     };
 
+    /**
+     * Sorted run of entries stored in a temporary file. Entries are stored
+     * delta encoded as variable length numbers.
+     */
+    struct Run
+    {
+      std::string filename;
+      FileScanner scanner;
+      uint64_t    remaining=0;
+      SortEntry   current{};
+
+      bool ReadNext();
+    };
+
   public:
     class ProcessingFilter
     {
@@ -112,6 +147,43 @@ namespace osmscout {
                        N& data,
                        bool& save);
 
+    static void WriteEntry(FileWriter& writer,
+                           const SortEntry& entry,
+                           SortEntry& previous);
+
+    static void WriteRun(const std::string& filename,
+                         std::vector<SortEntry>& entries);
+
+    static void OpenRuns(const std::vector<std::string>& runFilenames,
+                         std::vector<std::unique_ptr<Run>>& runs);
+
+    static void MergeIntermediateRun(const std::vector<std::string>& runFilenames,
+                                     const std::string& filename);
+
+    bool CopyEntry(const TypeConfig& typeConfig,
+                   Progress& progress,
+                   std::vector<Source*>& sourceByIndex,
+                   const SortEntry& entry,
+                   FileWriter& dataWriter,
+                   FileWriter& mapWriter,
+                   uint32_t& dataCopiedCount);
+
+    bool ReadEntries(const TypeConfig& typeConfig,
+                     const ImportParameter& parameter,
+                     Progress& progress,
+                     std::vector<SortEntry>& entries,
+                     std::list<std::string>& runFilenames);
+
+    bool MergeRuns(const TypeConfig& typeConfig,
+                   const ImportParameter& parameter,
+                   Progress& progress,
+                   std::vector<Source*>& sourceByIndex,
+                   std::list<std::string>& runFilenames,
+                   uint32_t overallDataCount,
+                   FileWriter& dataWriter,
+                   FileWriter& mapWriter,
+                   uint32_t& dataCopiedCount);
+
     bool Renumber(const TypeConfig& typeConfig,
                   const ImportParameter& parameter,
                   Progress& progress);
@@ -202,217 +274,599 @@ namespace osmscout {
   }
 
   template <class N>
-  bool SortDataGenerator<N>::Renumber(const TypeConfig& typeConfig,
-                                      const ImportParameter& parameter,
-                                      Progress& progress)
+  bool SortDataGenerator<N>::Run::ReadNext()
   {
-    FileWriter dataWriter;
-    FileWriter mapWriter;
-    size_t     zoomLevel=Pow(2,parameter.GetSortTileMag());
-    size_t     cellCount=zoomLevel*zoomLevel;
-    size_t     maxIndex=cellCount-1;
+    if (remaining==0) {
+      return false;
+    }
 
-    progress.SetAction("Sorting data");
+    uint64_t cellDelta=scanner.ReadUInt64Number();
+    Id       sortId=scanner.ReadUInt64Number();
+
+    if (cellDelta==0) {
+      current.sortId+=sortId;
+    }
+    else {
+      current.cellIndex+=cellDelta;
+      current.sortId=sortId;
+    }
+
+    current.sourceIndex=scanner.ReadUInt32Number();
+    current.fileOffset=scanner.ReadUInt64Number();
+    current.id=scanner.ReadUInt64Number();
+    current.type=scanner.ReadUInt8();
+
+    remaining--;
+
+    return true;
+  }
+
+  /**
+   * Write the given entry delta encoded relative to the previous entry of the run.
+   *
+   * @throws IOException
+   */
+  template <class N>
+  void SortDataGenerator<N>::WriteEntry(FileWriter& writer,
+                                        const SortEntry& entry,
+                                        SortEntry& previous)
+  {
+    if (entry.cellIndex==previous.cellIndex) {
+      writer.WriteNumber((uint64_t)0);
+      writer.WriteNumber(entry.sortId-previous.sortId);
+    }
+    else {
+      writer.WriteNumber(entry.cellIndex-previous.cellIndex);
+      writer.WriteNumber(entry.sortId);
+    }
+
+    writer.WriteNumber(entry.sourceIndex);
+    writer.WriteNumber(entry.fileOffset);
+    writer.WriteNumber(entry.id);
+    writer.Write(entry.type);
+
+    previous=entry;
+  }
+
+  /**
+   * Sort the given entries and write them as a run to the given file.
+   */
+  template <class N>
+  void SortDataGenerator<N>::WriteRun(const std::string& filename,
+                                      std::vector<SortEntry>& entries)
+  {
+    FileWriter writer;
+
+    std::sort(entries.begin(),
+              entries.end());
 
     try {
-      uint32_t overallDataCount=0;
-      uint32_t dataCopiedCount=0;
-      size_t   minIndex=0;
+      SortEntry previous{};
 
-      for (auto& source : sources) {
-        std::string sourceFilename=AppendFileToDir(parameter.GetDestinationDirectory(),
-                                                   source.filename);
+      writer.Open(filename);
 
-        progress.Info("Scanning file '"+sourceFilename+"'");
+      writer.WriteNumber((uint64_t)entries.size());
 
-        source.scanner.Open(sourceFilename,
-                            FileScanner::Sequential,
-                            parameter.GetWayDataMemoryMaped());
+      for (const auto& entry : entries) {
+        WriteEntry(writer,
+                   entry,
+                   previous);
+      }
 
-        uint32_t dataCount=source.scanner.ReadUInt32();
+      writer.Close();
+    }
+    catch (const IOException&) {
+      writer.CloseFailsafe();
+      throw;
+    }
+  }
 
-        progress.Info(std::to_string(dataCount)+" entries in file '"+source.scanner.GetFilename()+"'");
+  /**
+   * Open the given runs and read their first entry. Empty runs are skipped.
+   *
+   * @throws IOException
+   */
+  template <class N>
+  void SortDataGenerator<N>::OpenRuns(const std::vector<std::string>& runFilenames,
+                                      std::vector<std::unique_ptr<Run>>& runs)
+  {
+    for (const auto& filename : runFilenames) {
+      runs.push_back(std::make_unique<Run>());
 
-        overallDataCount+=dataCount;
+      Run& run=*runs.back();
+
+      run.filename=filename;
+      run.scanner.Open(filename,
+                       FileScanner::Sequential,
+                       false);
+      run.remaining=run.scanner.ReadUInt64Number();
+
+      if (!run.ReadNext()) {
+        run.scanner.Close();
+        runs.pop_back();
       }
+    }
+  }
 
-      dataWriter.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
-                                      dataFilename));
+  /**
+   * Merge the given sorted runs into one new sorted run.
+   *
+   * @throws IOException
+   */
+  template <class N>
+  void SortDataGenerator<N>::MergeIntermediateRun(const std::vector<std::string>& runFilenames,
+                                                  const std::string& filename)
+  {
+    std::vector<std::unique_ptr<Run>> runs;
+    FileWriter                        writer;
+    // Min heap of the runs by their current entry
+    auto isGreater=[&runs](size_t a,
+                           size_t b) {
+      return runs[b]->current<runs[a]->current;
+    };
+    std::priority_queue<size_t,std::vector<size_t>,decltype(isGreater)> nextRuns(isGreater);
 
-      dataWriter.Write(overallDataCount);
+    try {
+      OpenRuns(runFilenames,
+               runs);
 
-      mapWriter.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
-                                     mapFilename));
+      uint64_t  entryCount=0;
+      SortEntry previous{};
 
-      mapWriter.Write(overallDataCount);
+      for (size_t index=0; index<runs.size(); index++) {
+        // The current entry has already been read
+        entryCount+=runs[index]->remaining+1;
+        nextRuns.push(index);
+      }
 
-      while (true) {
-        progress.Info("Reading objects in cell range "+std::to_string(minIndex)+ "-"+std::to_string(maxIndex));
+      writer.Open(filename);
 
-        size_t                                 currentEntries=0;
-        std::map<size_t,std::list<CellEntry> > dataByCellMap;
+      writer.WriteNumber(entryCount);
 
-        for (auto& source :sources) {
-          progress.Info("Reading objects from file '"+source.scanner.GetFilename()+"'");
+      while (!nextRuns.empty()) {
+        size_t index=nextRuns.top();
 
-          source.scanner.GotoBegin();
+        nextRuns.pop();
 
-          uint32_t dataCount=source.scanner.ReadUInt32();
-          uint32_t current=1;
+        WriteEntry(writer,
+                   runs[index]->current,
+                   previous);
 
-          while (current<=dataCount) {
-            N data;
+        if (runs[index]->ReadNext()) {
+          nextRuns.push(index);
+        }
+      }
 
-            progress.SetProgress(current,dataCount);
+      writer.Close();
+
+      for (auto& run : runs) {
+        run->scanner.Close();
+      }
+    }
+    catch (const IOException&) {
+      writer.CloseFailsafe();
+
+      for (auto& run : runs) {
+        run->scanner.CloseFailsafe();
+      }
 
-            uint8_t type=source.scanner.ReadUInt8();
-            Id      id=source.scanner.ReadUInt64();
+      throw;
+    }
+  }
 
-            data.Read(typeConfig,
-                      source.scanner);
+  template <class N>
+  bool SortDataGenerator<N>::CopyEntry(const TypeConfig& typeConfig,
+                                       Progress& progress,
+                                       std::vector<Source*>& sourceByIndex,
+                                       const SortEntry& entry,
+                                       FileWriter& dataWriter,
+                                       FileWriter& mapWriter,
+                                       uint32_t& dataCopiedCount)
+  {
+    Source& source=*sourceByIndex[entry.sourceIndex];
+    N       data;
 
-            GeoCoord coord;
+    source.scanner.SetPos(entry.fileOffset);
 
-            GetTopLeftCoordinate(data,
-                                 coord);
+    data.Read(typeConfig,
+              source.scanner);
 
-            size_t cellY=(size_t)((coord.GetLat()+90.0)/180.0*zoomLevel);
-            size_t cellX=(size_t)((coord.GetLon()+180.0)/360.0*zoomLevel);
-            size_t cellIndex=cellY*zoomLevel+cellX;
+    FileOffset fileOffset=dataWriter.GetPos();
+    bool       save=true;
 
-            if (cellIndex>=minIndex &&
-                cellIndex<=maxIndex) {
-              dataByCellMap[cellIndex].push_back(CellEntry(type,
-                                                           id,
-                                                           source,
-                                                           data.GetFileOffset(),
-                                                           coord.GetHash()));
-              currentEntries++;
-            }
+    if (!ExecuteFilter(progress,
+                       fileOffset,
+                       data,
+                       save)) {
+      return false;
+    }
 
-            // Reduce cell interval, deleting all already stored nodes beyond the new
-            // cell range end.
-            if (currentEntries>parameter.GetSortBlockSize() &&
-                dataByCellMap.size()>1) {
-              size_t                                                    count=0;
-              size_t                                                    cutLimit=parameter.GetSortBlockSize()*9/10;
-              typename std::map<size_t,std::list<CellEntry> >::iterator cutOff=dataByCellMap.end();
+    if (!save) {
+      return true;
+    }
 
-              for (typename std::map<size_t,std::list<CellEntry> >::iterator iter=dataByCellMap.begin();
-                   iter!=dataByCellMap.end();
-                   ++iter) {
-                if (count<=cutLimit &&
-                    count+iter->second.size()>cutLimit) {
-                  cutOff=iter;
-                  break;
-                }
+    data.Write(typeConfig,
+               dataWriter);
 
-                maxIndex=iter->first;
-                count+=iter->second.size();
-              }
+    mapWriter.Write(entry.id);
+    mapWriter.Write(entry.type);
+    mapWriter.WriteFileOffset(fileOffset);
 
-              assert(cutOff!=dataByCellMap.end());
+    dataCopiedCount++;
 
-              currentEntries=count;
-              dataByCellMap.erase(cutOff,dataByCellMap.end());
-            }
+    return true;
+  }
 
-            current++;
-          }
+  /**
+   * Read all sources in one pass and collect the sort entries. If the entries
+   * exceed the sort memory limit, runs are handed to worker threads, that sort
+   * them and write them to temporary files, while reading continues. If all
+   * entries fit into memory, no run is written and the entries are returned
+   * unsorted.
+   */
+  template <class N>
+  bool SortDataGenerator<N>::ReadEntries(const TypeConfig& typeConfig,
+                                         const ImportParameter& parameter,
+                                         Progress& progress,
+                                         std::vector<SortEntry>& entries,
+                                         std::list<std::string>& runFilenames)
+  {
+    size_t                       zoomLevel=Pow(2,parameter.GetSortTileMag());
+    size_t                       workerCount=std::max((unsigned int)1,std::thread::hardware_concurrency());
+    // The reader fills one buffer, one buffer may be queued and each worker sorts one buffer
+    size_t                       runSize=std::max(parameter.GetSortMemoryLimit()/sizeof(SortEntry)/(workerCount+2),
+                                                  (size_t)1024);
+    WorkQueue<void>              runQueue(0);
+    std::vector<std::thread>     workers;
+    std::list<std::future<void>> runResults;
+    bool                         success=true;
+
+    progress.Info("Using runs of up to "+std::to_string(runSize)+" entries sorted by "+std::to_string(workerCount)+" thread(s)");
+
+    for (size_t t=1; t<=workerCount; t++) {
+      workers.emplace_back([&runQueue]() {
+        std::packaged_task<void()> task;
+
+        while (runQueue.PopTask(task)) {
+          task();
         }
+      });
+    }
 
-        if (maxIndex<cellCount-1) {
-          progress.Info("Cell range was reduced to "+std::to_string(minIndex)+ "-"+std::to_string(maxIndex));
-        }
+    try {
+      uint32_t sourceIndex=0;
 
-        progress.Info(std::string("Copy renumbered data to '")+dataWriter.GetFilename()+"'");
+      for (auto& source : sources) {
+        progress.Info("Reading objects from file '"+source.scanner.GetFilename()+"'");
+
+        source.scanner.GotoBegin();
+
+        uint32_t dataCount=source.scanner.ReadUInt32();
+
+        for (uint32_t current=1; current<=dataCount; current++) {
+          N data;
 
-        size_t copyCount=0;
-        for (auto& cell : dataByCellMap) {
-          cell.second.sort();
+          progress.SetProgress(current,dataCount);
 
-          for (auto& entry : cell.second) {
-            progress.SetProgress(copyCount,currentEntries);
+          uint8_t type=source.scanner.ReadUInt8();
+          Id      id=source.scanner.ReadUInt64();
 
-            copyCount++;
+          data.Read(typeConfig,
+                    source.scanner);
 
-            N data;
+          GeoCoord coord;
 
-            entry.source.scanner.SetPos(entry.fileOffset);
+          GetTopLeftCoordinate(data,
+                               coord);
 
-            data.Read(typeConfig,
-                      entry.source.scanner);
+          size_t    cellY=(size_t)((coord.GetLat()+90.0)/180.0*zoomLevel);
+          size_t    cellX=(size_t)((coord.GetLon()+180.0)/360.0*zoomLevel);
+          SortEntry entry;
 
-            FileOffset fileOffset=dataWriter.GetPos();
-            bool       save=true;
+          entry.cellIndex=cellY*zoomLevel+cellX;
+          entry.sortId=coord.GetHash();
+          entry.fileOffset=data.GetFileOffset();
+          entry.id=id;
+          entry.sourceIndex=sourceIndex;
+          entry.type=type;
 
-            if (!ExecuteFilter(progress,
-                               fileOffset,
-                               data,
-                               save)) {
-              return false;
-            }
+          entries.push_back(entry);
 
-            if (!save) {
-              continue;
-            }
+          if (entries.size()>=runSize) {
+            std::string runFilename=AppendFileToDir(parameter.GetDestinationDirectory(),
+                                                    dataFilename+"."+std::to_string(runFilenames.size()+1)+".tmp");
+            auto        runEntries=std::make_shared<std::vector<SortEntry>>(std::move(entries));
 
-            data.Write(typeConfig,
-                       dataWriter);
+            std::packaged_task<void()> task([runFilename,runEntries]() {
+              WriteRun(runFilename,
+                       *runEntries);
+            });
 
-            mapWriter.Write(entry.id);
-            mapWriter.Write(entry.type);
-            mapWriter.WriteFileOffset(fileOffset);
+            runFilenames.push_back(runFilename);
+            runResults.push_back(task.get_future());
+            runQueue.PushTask(task);
 
-            dataCopiedCount++;
+            entries=std::vector<SortEntry>();
+            entries.reserve(runSize);
           }
         }
 
-        if (currentEntries==0) {
-          progress.Info("No more entries found");
-          break;
+        sourceIndex++;
+      }
+
+      if (!runFilenames.empty() &&
+          !entries.empty()) {
+        std::string runFilename=AppendFileToDir(parameter.GetDestinationDirectory(),
+                                                dataFilename+"."+std::to_string(runFilenames.size()+1)+".tmp");
+
+        WriteRun(runFilename,
+                 entries);
+
+        runFilenames.push_back(runFilename);
+
+        entries=std::vector<SortEntry>();
+      }
+
+      for (auto& result : runResults) {
+        result.get();
+      }
+    }
+    catch (const IOException& e) {
+      progress.Error(e.GetDescription());
+      success=false;
+    }
+
+    runQueue.Stop();
+
+    for (auto& thread : workers) {
+      thread.join();
+    }
+
+    if (!runFilenames.empty()) {
+      progress.Info(std::to_string(runFilenames.size())+" sorted run(s) written");
+    }
+
+    return success;
+  }
+
+  /**
+   * Merge the sorted runs and copy the referenced objects in the resulting order.
+   *
+   * If there are more than maxMergeRunCount runs, groups of runs are merged
+   * into intermediate runs first. Merged runs are deleted and intermediate
+   * runs are added to the given list, so the caller can delete all remaining
+   * runs.
+   */
+  template <class N>
+  bool SortDataGenerator<N>::MergeRuns(const TypeConfig& typeConfig,
+                                       const ImportParameter& parameter,
+                                       Progress& progress,
+                                       std::vector<Source*>& sourceByIndex,
+                                       std::list<std::string>& runFilenames,
+                                       uint32_t overallDataCount,
+                                       FileWriter& dataWriter,
+                                       FileWriter& mapWriter,
+                                       uint32_t& dataCopiedCount)
+  {
+    std::vector<std::unique_ptr<Run>> runs;
+    bool                              success=true;
+    // Min heap of the runs by their current entry
+    auto isGreater=[&runs](size_t a,
+                           size_t b) {
+      return runs[b]->current<runs[a]->current;
+    };
+    std::priority_queue<size_t,std::vector<size_t>,decltype(isGreater)> nextRuns(isGreater);
+
+    try {
+      size_t runNumber=runFilenames.size();
+
+      while (runFilenames.size()>maxMergeRunCount) {
+        std::vector<std::string> mergedRunFilenames;
+        std::string              runFilename=AppendFileToDir(parameter.GetDestinationDirectory(),
+                                                             dataFilename+"."+std::to_string(++runNumber)+".tmp");
+
+        mergedRunFilenames.assign(runFilenames.begin(),
+                                  std::next(runFilenames.begin(),maxMergeRunCount));
+
+        progress.Info("Merging "+std::to_string(mergedRunFilenames.size())+" sorted run(s) into intermediate run '"+runFilename+"'");
+
+        // All runs stay in the list until merged, so they get deleted, even if merging fails
+        runFilenames.push_back(runFilename);
+
+        MergeIntermediateRun(mergedRunFilenames,
+                             runFilename);
+
+        for (const auto& filename : mergedRunFilenames) {
+          runFilenames.pop_front();
+          RemoveFile(filename);
         }
+      }
+
+      progress.Info("Merging "+std::to_string(runFilenames.size())+" sorted run(s) into '"+dataWriter.GetFilename()+"'");
+
+      OpenRuns(std::vector<std::string>(runFilenames.begin(),runFilenames.end()),
+               runs);
+
+      for (size_t index=0; index<runs.size(); index++) {
+        nextRuns.push(index);
+      }
+
+      size_t copyCount=0;
 
-        if (maxIndex==cellCount-1) {
-          // We are finished
+      while (!nextRuns.empty()) {
+        size_t index=nextRuns.top();
+
+        nextRuns.pop();
+
+        progress.SetProgress(copyCount,(size_t)overallDataCount);
+
+        copyCount++;
+
+        if (!CopyEntry(typeConfig,
+                       progress,
+                       sourceByIndex,
+                       runs[index]->current,
+                       dataWriter,
+                       mapWriter,
+                       dataCopiedCount)) {
+          success=false;
           break;
         }
 
-        minIndex=maxIndex+1;
-        maxIndex=cellCount-1;
+        if (runs[index]->ReadNext()) {
+          nextRuns.push(index);
+        }
       }
 
-      assert(overallDataCount>=dataCopiedCount);
+      for (auto& run : runs) {
+        run->scanner.Close();
+      }
+    }
+    catch (const IOException& e) {
+      progress.Error(e.GetDescription());
+
+      for (auto& run : runs) {
+        run->scanner.CloseFailsafe();
+      }
+
+      return false;
+    }
+
+    return success;
+  }
+
+  /**
+   * Sort the objects of all sources by cell and coordinate using an external
+   * memory sort. The sources are read once, sorted runs are written in parallel
+   * if the entries do not fit into the sort memory limit and the runs are merged
+   * afterwards.
+   */
+  template <class N>
+  bool SortDataGenerator<N>::Renumber(const TypeConfig& typeConfig,
+                                      const ImportParameter& parameter,
+                                      Progress& progress)
+  {
+    FileWriter             dataWriter;
+    FileWriter             mapWriter;
+    std::vector<Source*>   sourceByIndex;
+    std::list<std::string> runFilenames;
+    bool                   success=true;
+
+    progress.SetAction("Sorting data");
+
+    try {
+      uint32_t overallDataCount=0;
+      uint32_t dataCopiedCount=0;
 
       for (auto& source : sources) {
-        source.scanner.Close();
+        std::string sourceFilename=AppendFileToDir(parameter.GetDestinationDirectory(),
+                                                   source.filename);
+
+        progress.Info("Scanning file '"+sourceFilename+"'");
+
+        source.scanner.Open(sourceFilename,
+                            FileScanner::Sequential,
+                            parameter.GetWayDataMemoryMaped());
+
+        uint32_t dataCount=source.scanner.ReadUInt32();
+
+        progress.Info(std::to_string(dataCount)+" entries in file '"+source.scanner.GetFilename()+"'");
+
+        overallDataCount+=dataCount;
+
+        sourceByIndex.push_back(&source);
       }
 
-      progress.Info(std::to_string(dataCopiedCount)+" of " +std::to_string(overallDataCount) + " object(s) written to file '"+dataWriter.GetFilename()+"'");
+      dataWriter.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
+                                      dataFilename));
 
-      dataWriter.SetPos(0);
-      dataWriter.Write(dataCopiedCount);
+      dataWriter.Write(overallDataCount);
 
-      mapWriter.SetPos(0);
-      mapWriter.Write(dataCopiedCount);
+      mapWriter.Open(AppendFileToDir(parameter.GetDestinationDirectory(),
+                                     mapFilename));
 
-      dataWriter.Close();
-      mapWriter.Close();
+      mapWriter.Write(overallDataCount);
+
+      std::vector<SortEntry> entries;
+
+      success=ReadEntries(typeConfig,
+                          parameter,
+                          progress,
+                          entries,
+                          runFilenames);
+
+      if (success &&
+          runFilenames.empty()) {
+        progress.Info(std::string("Copy renumbered data to '")+dataWriter.GetFilename()+"'");
+
+        std::sort(entries.begin(),
+                  entries.end());
+
+        for (size_t i=0; i<entries.size(); i++) {
+          progress.SetProgress(i,entries.size());
+
+          if (!CopyEntry(typeConfig,
+                         progress,
+                         sourceByIndex,
+                         entries[i],
+                         dataWriter,
+                         mapWriter,
+                         dataCopiedCount)) {
+            success=false;
+            break;
+          }
+        }
+      }
+      else if (success) {
+        success=MergeRuns(typeConfig,
+                          parameter,
+                          progress,
+                          sourceByIndex,
+                          runFilenames,
+                          overallDataCount,
+                          dataWriter,
+                          mapWriter,
+                          dataCopiedCount);
+      }
+
+      if (success) {
+        assert(overallDataCount>=dataCopiedCount);
+
+        for (auto& source : sources) {
+          source.scanner.Close();
+        }
+
+        progress.Info(std::to_string(dataCopiedCount)+" of " +std::to_string(overallDataCount) + " object(s) written to file '"+dataWriter.GetFilename()+"'");
+
+        dataWriter.SetPos(0);
+        dataWriter.Write(dataCopiedCount);
+
+        mapWriter.SetPos(0);
+        mapWriter.Write(dataCopiedCount);
+
+        dataWriter.Close();
+        mapWriter.Close();
+      }
     }
     catch (const IOException& e) {
       progress.Error(e.GetDescription());
+      success=false;
+    }
 
+    if (!success) {
       for (auto& source : sources) {
         source.scanner.CloseFailsafe();
       }
 
       dataWriter.CloseFailsafe();
       mapWriter.CloseFailsafe();
+    }
 
-      return false;
+    for (const auto& filename : runFilenames) {
+      RemoveFile(filename);
     }
 
-    return true;
+    return success;
   }
 
   template <class N>
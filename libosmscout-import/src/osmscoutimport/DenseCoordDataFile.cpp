@@ -0,0 +1,249 @@
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2026  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <osmscoutimport/DenseCoordDataFile.h>
+
+#include <algorithm>
+#include <array>
+
+#include <osmscout/system/Assert.h>
+
+#include <osmscout/util/File.h>
+#include <osmscout/util/Logger.h>
+#include <osmscout/util/MemoryScanner.h>
+
+namespace osmscout {
+
+  const char* const DenseCoordDataFile::DENSE_COORD_DAT="densecoord.dat";
+
+  /**
+   * Gaps of unset entries up to this size are filled with zeros instead
+   * of seeking (and leaving a hole in the file)
+   */
+  static const uint64_t maxFilledGapEntries=4096;
+
+  DenseCoordDataFile::~DenseCoordDataFile()
+  {
+    Close();
+  }
+
+  /**
+   * Open the file. Importers always map the file, since it is sparse and only
+   * the pages actually read take memory. Without memory mapping (or if mapping
+   * fails) each entry is read from a file stream of the reading thread.
+   */
+  bool DenseCoordDataFile::Open(const std::string& path,
+                                bool memoryMapedData)
+  {
+    datafilename=AppendFileToDir(path,DENSE_COORD_DAT);
+
+    try {
+      // Do not read ahead the complete (possibly huge) file
+      scanner.Open(datafilename,
+                   FileScanner::LowMemRandom,
+                   memoryMapedData);
+
+      minId=scanner.ReadInt64();
+      entryCount=scanner.ReadUInt64();
+
+      if (!MemoryScanner::CanScan(scanner)) {
+        scannerPool.Open(datafilename);
+      }
+    }
+    catch (const IOException& e) {
+      log.Error() << e.GetDescription();
+      scanner.CloseFailsafe();
+
+      return false;
+    }
+
+    return true;
+  }
+
+  bool DenseCoordDataFile::Close()
+  {
+    scannerPool.Close();
+
+    try {
+      if (scanner.IsOpen()) {
+        scanner.Close();
+      }
+    }
+    catch (const IOException& e) {
+      log.Error() << e.GetDescription();
+
+      return false;
+    }
+
+    return true;
+  }
+
+  /**
+   * Resolve the coordinates of the given ids. The points are written to the
+   * same index as the id. Points of ids without a coordinate have serial 0
+   * (see IsResolved()).
+   *
+   * If the file is memory mapped, the entries are read directly from the
+   * mapping without locking. Else each reading thread uses its own file stream.
+   *
+   * The method is thread-safe.
+   */
+  bool DenseCoordDataFile::Get(const std::vector<OSMId>& ids,
+                               std::vector<Point>& points) const
+  {
+    assert(scanner.IsOpen());
+
+    points.resize(ids.size());
+
+    try {
+      if (MemoryScanner::CanScan(scanner)) {
+        MemoryScanner memoryScanner(scanner,
+                                    0);
+
+        ReadPoints(memoryScanner,
+                   ids,
+                   points);
+      }
+      else {
+        ScannerRef pooledScanner=scannerPool.Borrow();
+
+        if (!pooledScanner) {
+          throw IOException(datafilename,"Cannot open file for reading");
+        }
+
+        ReadPoints(*pooledScanner,
+                   ids,
+                   points);
+      }
+    }
+    catch (const IOException& e) {
+      log.Error() << e.GetDescription();
+
+      return false;
+    }
+
+    return true;
+  }
+
+  /**
+   * Resolve the coordinates of the given ids using coordinates loaded from the
+   * paged coord data file, filling the points the same way as Get().
+   */
+  void DenseCoordDataFile::GetPoints(const CoordDataFile::ResultMap& coordsMap,
+                                     const std::vector<OSMId>& ids,
+                                     std::vector<Point>& points)
+  {
+    points.resize(ids.size());
+
+    for (size_t i=0; i<ids.size(); i++) {
+      auto coord=coordsMap.find(ids[i]);
+
+      if (coord==coordsMap.end()) {
+        points[i]=Point();
+      }
+      else {
+        points[i]=coord->second;
+      }
+    }
+  }
+
+  /**
+   * @throws IOException
+   */
+  void DenseCoordDataFileWriter::Open(const std::string& path)
+  {
+    minId=0;
+    entryCount=0;
+
+    writer.Open(AppendFileToDir(path,
+                                DenseCoordDataFile::DENSE_COORD_DAT));
+
+    writer.Write((int64_t)minId);
+    writer.Write(entryCount);
+  }
+
+  /**
+   * @throws IOException
+   */
+  void DenseCoordDataFileWriter::Write(OSMId id,
+                                       const Point& point)
+  {
+    assert(point.GetSerial()!=0);
+
+    if (entryCount==0) {
+      minId=id;
+    }
+
+    if (id<minId) {
+      throw IOException(writer.GetFilename(),"Cannot write coordinate","Ids are not written in increasing order");
+    }
+
+    uint64_t index=id-minId;
+
+    if (index<entryCount) {
+      // Overwrite an entry with the same id
+      writer.SetPos(DenseCoordDataFile::headerSize+index*DenseCoordDataFile::entrySize);
+      writer.Write(point.GetSerial());
+      writer.WriteCoord(point.GetCoord());
+      writer.SetPos(DenseCoordDataFile::headerSize+entryCount*DenseCoordDataFile::entrySize);
+
+      return;
+    }
+
+    uint64_t gap=index-entryCount;
+
+    if (gap<=maxFilledGapEntries) {
+      static const std::array<char,DenseCoordDataFile::entrySize*64> zeros{};
+
+      uint64_t gapBytes=gap*DenseCoordDataFile::entrySize;
+
+      while (gapBytes>0) {
+        size_t bytes=(size_t)std::min(gapBytes,(uint64_t)zeros.size());
+
+        writer.Write(zeros.data(),
+                     bytes);
+        gapBytes-=bytes;
+      }
+    }
+    else {
+      writer.SetPos(DenseCoordDataFile::headerSize+index*DenseCoordDataFile::entrySize);
+    }
+
+    writer.Write(point.GetSerial());
+    writer.WriteCoord(point.GetCoord());
+
+    entryCount=index+1;
+  }
+
+  /**
+   * @throws IOException
+   */
+  void DenseCoordDataFileWriter::Close()
+  {
+    writer.SetPos(0);
+    writer.Write((int64_t)minId);
+    writer.Write(entryCount);
+    writer.Close();
+  }
+
+  void DenseCoordDataFileWriter::CloseFailsafe()
+  {
+    writer.CloseFailsafe();
+  }
+}
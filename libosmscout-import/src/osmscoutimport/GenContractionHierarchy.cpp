@@ -0,0 +1,446 @@
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2026  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <osmscoutimport/GenContractionHierarchy.h>
+
+#include <algorithm>
+#include <functional>
+#include <iterator>
+#include <limits>
+#include <queue>
+
+#include <osmscout/routing/RouteNode.h>
+#include <osmscout/routing/RoutingService.h>
+
+#include <osmscout/util/File.h>
+#include <osmscout/util/FileScanner.h>
+#include <osmscout/util/FileWriter.h>
+
+#include <osmscout/system/Assert.h>
+#include <osmscout/system/Math.h>
+
+namespace osmscout {
+
+  static const uint32_t noRank=std::numeric_limits<uint32_t>::max();
+
+  static uint8_t GetUsableFlag(Vehicle vehicle)
+  {
+    switch (vehicle) {
+    case vehicleFoot:
+      return RouteNode::usableByFoot;
+    case vehicleBicycle:
+      return RouteNode::usableByBicycle;
+    case vehicleCar:
+      return RouteNode::usableByCar;
+    }
+
+    return 0;
+  }
+
+  void ContractionHierarchyGenerator::GetDescription(const ImportParameter& parameter,
+                                                     ImportModuleDescription& description) const
+  {
+    description.SetName("ContractionHierarchyGenerator");
+    description.SetDescription("Generate contraction hierarchies for the routing graph(s)");
+
+    for (const auto& router : parameter.GetRouter()) {
+      description.AddRequiredFile(router.GetDataFilename());
+
+      if (!parameter.GetRouterContractionHierarchy()) {
+        continue;
+      }
+
+      for (Vehicle vehicle : {vehicleFoot, vehicleBicycle, vehicleCar}) {
+        if ((router.GetVehicleMask() & vehicle)!=0) {
+          description.AddProvidedFile(RoutingService::GetContractionHierarchyFilename(router.GetFilenamebase(),
+                                                                                      vehicle));
+        }
+      }
+    }
+  }
+
+  /**
+   * Read all paths usable by the given vehicle from the route node data file.
+   * Paths with access restrictions are not part of the hierarchy.
+   */
+  bool ContractionHierarchyGenerator::ReadArcs(const std::string& filename,
+                                               Vehicle vehicle,
+                                               Progress& progress,
+                                               std::vector<Id>& ids,
+                                               std::vector<Arc>& arcs) const
+  {
+    FileScanner scanner;
+    uint8_t     usableFlag=GetUsableFlag(vehicle);
+
+    try {
+      scanner.Open(filename,
+                   FileScanner::Sequential,
+                   true);
+
+      scanner.ReadFileOffset(); // index file offset
+      uint32_t routeNodeCount=scanner.ReadUInt32();
+      scanner.ReadUInt32();     // tile magnification
+
+      ids.reserve(routeNodeCount);
+
+      for (uint32_t n=0; n<routeNodeCount; n++) {
+        progress.SetProgress(n,routeNodeCount);
+
+        RouteNode routeNode;
+
+        routeNode.Read(scanner);
+
+        for (const auto& path : routeNode.paths) {
+          if ((path.flags & usableFlag)==0 ||
+              path.IsRestricted(vehicle) ||
+              path.id==routeNode.GetId()) {
+            continue;
+          }
+
+          arcs.push_back(Arc{(uint32_t)ids.size(),
+                             0,
+                             path.id,
+                             routeNode.objects[path.objectIndex].object,
+                             routeNode.objects[path.objectIndex].objectVariantIndex,
+                             path.flags,
+                             path.distance});
+        }
+
+        ids.push_back(routeNode.GetId());
+      }
+
+      scanner.Close();
+    }
+    catch (const IOException& e) {
+      progress.Error(e.GetDescription());
+      scanner.CloseFailsafe();
+      return false;
+    }
+
+    // Resolve the target ids and drop all route nodes without usable paths
+
+    std::vector<std::pair<Id,uint32_t>> idIndex;
+
+    idIndex.reserve(ids.size());
+
+    for (uint32_t i=0; i<ids.size(); i++) {
+      idIndex.emplace_back(ids[i],i);
+    }
+
+    std::sort(idIndex.begin(),idIndex.end());
+
+    std::vector<uint32_t> used(ids.size(),noRank);
+    size_t                arcCount=0;
+
+    for (auto& arc : arcs) {
+      auto entry=std::lower_bound(idIndex.begin(),
+                                  idIndex.end(),
+                                  std::make_pair(arc.toId,(uint32_t)0));
+
+      if (entry==idIndex.end() ||
+          entry->first!=arc.toId) {
+        continue;
+      }
+
+      arc.to=entry->second;
+      used[arc.from]=0;
+      used[arc.to]=0;
+      arcs[arcCount++]=arc;
+    }
+
+    arcs.resize(arcCount);
+
+    uint32_t nodeCount=0;
+
+    for (uint32_t i=0; i<ids.size(); i++) {
+      if (used[i]!=noRank) {
+        used[i]=nodeCount;
+        ids[nodeCount]=ids[i];
+        nodeCount++;
+      }
+    }
+
+    ids.resize(nodeCount);
+
+    for (auto& arc : arcs) {
+      arc.from=used[arc.from];
+      arc.to=used[arc.to];
+    }
+
+    return true;
+  }
+
+  /**
+   * Calculate the contraction order using the minimum degree heuristic.
+   *
+   * Contracting a node connects all its remaining neighbours with each
+   * other. The remaining neighbours at the time of contraction are the
+   * higher ranked neighbours of the node in the hierarchy.
+   */
+  std::vector<uint32_t> ContractionHierarchyGenerator::CalculateRanks(const std::vector<Id>& ids,
+                                                                      const std::vector<Arc>& arcs,
+                                                                      Progress& progress,
+                                                                      std::vector<std::vector<uint32_t>>& upper) const
+  {
+    using QueueEntry = std::pair<size_t,uint32_t>;
+
+    std::vector<std::vector<uint32_t>> adjacency(ids.size());
+    std::vector<uint32_t>              ranks(ids.size(),noRank);
+    std::priority_queue<QueueEntry,
+                        std::vector<QueueEntry>,
+                        std::greater<>>  queue;
+    std::vector<uint32_t>              merged;
+    uint32_t                           nextRank=0;
+
+    for (const auto& arc : arcs) {
+      adjacency[arc.from].push_back(arc.to);
+      adjacency[arc.to].push_back(arc.from);
+    }
+
+    for (uint32_t n=0; n<adjacency.size(); n++) {
+      auto& neighbours=adjacency[n];
+
+      std::sort(neighbours.begin(),neighbours.end());
+      neighbours.erase(std::unique(neighbours.begin(),neighbours.end()),neighbours.end());
+
+      queue.emplace(neighbours.size(),n);
+    }
+
+    upper.resize(ids.size());
+
+    while (!queue.empty()) {
+      auto [degree,node]=queue.top();
+
+      queue.pop();
+
+      if (ranks[node]!=noRank ||
+          degree!=adjacency[node].size()) {
+        // Already contracted or outdated degree
+        continue;
+      }
+
+      progress.SetProgress(nextRank,static_cast<uint32_t>(ids.size()));
+
+      ranks[node]=nextRank++;
+      upper[node].swap(adjacency[node]);
+
+      const auto& neighbours=upper[node];
+
+      for (uint32_t neighbour : neighbours) {
+        auto& list=adjacency[neighbour];
+
+        merged.clear();
+        std::set_union(list.begin(),list.end(),
+                       neighbours.begin(),neighbours.end(),
+                       std::back_inserter(merged));
+
+        // Remove the contracted node and the neighbour itself
+        merged.erase(std::remove_if(merged.begin(),merged.end(),[node,neighbour](uint32_t n) {
+                       return n==node || n==neighbour;
+                     }),
+                     merged.end());
+
+        list.swap(merged);
+        queue.emplace(list.size(),neighbour);
+      }
+    }
+
+    return ranks;
+  }
+
+  bool ContractionHierarchyGenerator::WriteHierarchy(const std::string& filename,
+                                                     const std::vector<Id>& ids,
+                                                     const std::vector<Arc>& arcs,
+                                                     const std::vector<uint32_t>& ranks,
+                                                     const std::vector<std::vector<uint32_t>>& upper,
+                                                     Progress& progress) const
+  {
+    size_t                             nodeCount=ids.size();
+    std::vector<std::vector<uint32_t>> edges(nodeCount);
+    std::vector<uint32_t>              edgeOffsets(nodeCount+1,0);
+
+    for (size_t n=0; n<nodeCount; n++) {
+      auto& rankEdges=edges[ranks[n]];
+
+      rankEdges.reserve(upper[n].size());
+
+      for (uint32_t neighbour : upper[n]) {
+        rankEdges.push_back(ranks[neighbour]);
+      }
+
+      std::sort(rankEdges.begin(),rankEdges.end());
+    }
+
+    for (size_t rank=0; rank<nodeCount; rank++) {
+      edgeOffsets[rank+1]=edgeOffsets[rank]+(uint32_t)edges[rank].size();
+    }
+
+    // Assign each path to the edge between its route nodes
+
+    std::vector<std::pair<uint32_t,uint32_t>> arcEdges;
+
+    arcEdges.reserve(arcs.size());
+
+    for (uint32_t a=0; a<arcs.size(); a++) {
+      uint32_t    lower=std::min(ranks[arcs[a].from],ranks[arcs[a].to]);
+      uint32_t    higher=std::max(ranks[arcs[a].from],ranks[arcs[a].to]);
+      const auto& rankEdges=edges[lower];
+      auto        edge=std::lower_bound(rankEdges.begin(),rankEdges.end(),higher);
+
+      assert(edge!=rankEdges.end() && *edge==higher);
+
+      arcEdges.emplace_back(edgeOffsets[lower]+(uint32_t)(edge-rankEdges.begin()),a);
+    }
+
+    std::sort(arcEdges.begin(),arcEdges.end());
+
+    FileWriter writer;
+
+    try {
+      writer.Open(filename);
+
+      writer.Write((uint32_t)nodeCount);
+
+      std::vector<Id> rankIds(nodeCount);
+
+      for (size_t n=0; n<nodeCount; n++) {
+        rankIds[ranks[n]]=ids[n];
+      }
+
+      for (Id id : rankIds) {
+        writer.WriteNumber(id);
+      }
+
+      for (uint32_t rank=0; rank<nodeCount; rank++) {
+        uint32_t previous=rank;
+
+        writer.WriteNumber((uint32_t)edges[rank].size());
+
+        for (uint32_t target : edges[rank]) {
+          writer.WriteNumber(target-previous);
+          previous=target;
+        }
+      }
+
+      size_t arcIndex=0;
+
+      for (uint32_t edge=0; edge<edgeOffsets[nodeCount]; edge++) {
+        size_t arcEnd=arcIndex;
+
+        while (arcEnd<arcEdges.size() &&
+               arcEdges[arcEnd].first==edge) {
+          arcEnd++;
+        }
+
+        writer.WriteNumber((uint32_t)(arcEnd-arcIndex));
+
+        for (; arcIndex<arcEnd; arcIndex++) {
+          const Arc& arc=arcs[arcEdges[arcIndex].second];
+
+          writer.Write((uint8_t)(ranks[arc.from]<ranks[arc.to] ? 1 : 0));
+          writer.Write(arc.object);
+          writer.WriteNumber(arc.objectVariantIndex);
+          writer.Write(arc.flags);
+          writer.WriteNumber((uint32_t)floor(arc.distance.As<Kilometer>()*(1000.0*100.0)+0.5));
+        }
+      }
+
+      writer.Close();
+    }
+    catch (const IOException& e) {
+      progress.Error(e.GetDescription());
+      writer.CloseFailsafe();
+      return false;
+    }
+
+    progress.Info(std::to_string(nodeCount)+" route nodes, "+
+                  std::to_string(arcs.size())+" paths, "+
+                  std::to_string(edgeOffsets[nodeCount])+" edges in hierarchy");
+
+    return true;
+  }
+
+  bool ContractionHierarchyGenerator::GenerateHierarchy(const ImportParameter& parameter,
+                                                        const ImportParameter::Router& router,
+                                                        Vehicle vehicle,
+                                                        Progress& progress) const
+  {
+    std::string filename=RoutingService::GetContractionHierarchyFilename(router.GetFilenamebase(),
+                                                                         vehicle);
+
+    progress.SetAction("Generate '"+filename+"'");
+
+    std::vector<Id>  ids;
+    std::vector<Arc> arcs;
+
+    if (!ReadArcs(AppendFileToDir(parameter.GetDestinationDirectory(),
+                                  router.GetDataFilename()),
+                  vehicle,
+                  progress,
+                  ids,
+                  arcs)) {
+      return false;
+    }
+
+    progress.SetAction("Calculate contraction order");
+
+    std::vector<std::vector<uint32_t>> upper;
+    std::vector<uint32_t>              ranks=CalculateRanks(ids,
+                                                            arcs,
+                                                            progress,
+                                                            upper);
+
+    progress.SetAction("Write '"+filename+"'");
+
+    return WriteHierarchy(AppendFileToDir(parameter.GetDestinationDirectory(),
+                                          filename),
+                          ids,
+                          arcs,
+                          ranks,
+                          upper,
+                          progress);
+  }
+
+  bool ContractionHierarchyGenerator::Import(const TypeConfigRef& /*typeConfig*/,
+                                             const ImportParameter& parameter,
+                                             Progress& progress)
+  {
+    if (!parameter.GetRouterContractionHierarchy()) {
+      progress.Info("Generation of contraction hierarchies is disabled");
+      return true;
+    }
+
+    for (const auto& router : parameter.GetRouter()) {
+      for (Vehicle vehicle : {vehicleFoot, vehicleBicycle, vehicleCar}) {
+        if ((router.GetVehicleMask() & vehicle)==0) {
+          continue;
+        }
+
+        if (!GenerateHierarchy(parameter,
+                               router,
+                               vehicle,
+                               progress)) {
+          return false;
+        }
+      }
+    }
+
+    return true;
+  }
+}
@@ -32,6 +32,7 @@
 #include <osmscout/util/ProcessingQueue.h>
 #include <osmscout/util/Worker.h>
 
+#include <osmscoutimport/DenseCoordDataFile.h>
 #include <osmscoutimport/Preprocess.h>
 #include <osmscoutimport/RawCoord.h>
 
@@ -498,7 +499,8 @@ namespace osmscout {
     }
 
     void ProcessPage(const std::vector<RawCoord>& page,
-                     PageSplitter<OSMId,PageEntry>& pageSplitter)
+                     PageSplitter<OSMId,PageEntry>& pageSplitter,
+                     DenseCoordDataFileWriter& denseWriter)
     {
       for (const auto& osmCoord : page) {
         uint8_t serial=serialIdManager.GetNextSerialForId(osmCoord.GetCoord().GetId());
@@ -512,12 +514,19 @@ namespace osmscout {
                          PageEntry{true,
                                    Point(serial,
                                          osmCoord.GetCoord())});
+
+        if (parameter.GetDenseCoordData()) {
+          denseWriter.Write(osmCoord.GetOSMId(),
+                            Point(serial,
+                                  osmCoord.GetCoord()));
+        }
       }
     }
 
     void ProcessingLoop() override
     {
-      FileWriter writer;
+      FileWriter               writer;
+      DenseCoordDataFileWriter denseWriter;
 
       try {
         std::unordered_map<OSMId,FileOffset> pageFileOffsetIndex;
@@ -543,6 +552,12 @@ namespace osmscout {
         // We want a coord page to be page aligned on disk, too
         writer.FlushCurrentBlockWithZeros(coordSortPageSize*coordDiskSize);
 
+        if (parameter.GetDenseCoordData()) {
+          denseWriter.Open(parameter.GetDestinationDirectory());
+
+          progress.Info("Writing file '" + denseWriter.GetFilename() + "'");
+        }
+
         while (true) {
           std::optional<RawCoordPage> value=inQueue.PopTask();
 
@@ -552,7 +567,7 @@ namespace osmscout {
 
           RawCoordPage page=std::move(value.value());
 
-          ProcessPage(page,pageSplitter);
+          ProcessPage(page,pageSplitter,denseWriter);
         }
 
         // Make sure that every page is dumped
@@ -584,10 +599,17 @@ namespace osmscout {
         writer.Close();
 
         progress.Info("File '" + writer.GetFilename() + "' completely written");
+
+        if (parameter.GetDenseCoordData()) {
+          denseWriter.Close();
+
+          progress.Info("File '" + denseWriter.GetFilename() + "' completely written");
+        }
       }
       catch (IOException& e) {
         progress.Error(e.GetDescription());
         writer.CloseFailsafe();
+        denseWriter.CloseFailsafe();
 
         MarkWorkerAsFailed();
       }
@@ -650,7 +672,7 @@ namespace osmscout {
            coordDatFileWorker.WasSuccessful();
   }
 
-  void CoordDataGenerator::GetDescription(const ImportParameter& /*parameter*/,
+  void CoordDataGenerator::GetDescription(const ImportParameter& parameter,
                                           ImportModuleDescription& description) const
   {
     description.SetName("CoordDataGenerator");
@@ -659,6 +681,10 @@ namespace osmscout {
     description.AddRequiredFile(Preprocess::RAWCOORDS_DAT);
 
     description.AddProvidedDebuggingFile(CoordDataFile::COORD_DAT);
+
+    if (parameter.GetDenseCoordData()) {
+      description.AddProvidedTemporaryFile(DenseCoordDataFile::DENSE_COORD_DAT);
+    }
   }
 
   bool CoordDataGenerator::Import(const TypeConfigRef& typeConfig,
@@ -440,7 +440,7 @@ namespace osmscout {
 
   bool RelAreaDataGenerator::ComposeAreaMembers(const TypeConfig& typeConfig,
                                                 Progress& progress,
-                                                const CoordDataFile::ResultMap& coordMap,
+                                                const NodeResolver& resolveNodes,
                                                 const IdRawWayMap& wayMap,
                                                 const std::string& name,
                                                 const RawRelation& rawRelation,
@@ -480,13 +480,24 @@ namespace osmscout {
         part.SetRelationRole(member.role);
         part.SetId(member.id);
 
-        for (size_t n=0; n<way->GetNodeCount(); n++) {
-          OSMId osmId=way->GetNodeId(n);
-          auto  coordEntry=coordMap.find(osmId);
+        std::vector<Point> points;
+
+        if (!resolveNodes(way->GetNodes(),
+                          points)) {
+          progress.Error("Cannot resolve child nodes of way "+
+                         std::to_string(way->GetId())+
+                         " for relation "+
+                         std::to_string(rawRelation.GetId())+" "+
+                         rawRelation.GetType()->GetName()+" "+
+                         name);
 
-          if (coordEntry==coordMap.end()) {
+          return false;
+        }
+
+        for (size_t n=0; n<way->GetNodeCount(); n++) {
+          if (!DenseCoordDataFile::IsResolved(points[n])) {
             progress.Error("Cannot resolve node member "+
-                           std::to_string(osmId)+
+                           std::to_string(way->GetNodeId(n))+
                            " for relation "+
                            std::to_string(rawRelation.GetId())+" "+
                            rawRelation.GetType()->GetName()+" "+
@@ -495,8 +506,7 @@ namespace osmscout {
             return false;
           }
 
-          part.role.nodes[n].Set(coordEntry->second.GetSerial(),
-                                 coordEntry->second.GetCoord());
+          part.role.nodes[n]=points[n];
           }
 
         part.ways.push_back(way);
@@ -510,7 +520,7 @@ namespace osmscout {
 
   bool RelAreaDataGenerator::ComposeBoundaryMembers(const TypeConfig& typeConfig,
                                                     Progress& progress,
-                                                    const CoordDataFile::ResultMap& coordMap,
+                                                    const NodeResolver& resolveNodes,
                                                     const IdRawWayMap& wayMap,
                                                     const std::map<OSMId,RawRelationRef>& relationMap,
                                                     const Area& relation,
@@ -542,7 +552,7 @@ namespace osmscout {
 
           if (!ComposeBoundaryMembers(typeConfig,
                                       progress,
-                                      coordMap,
+                                      resolveNodes,
                                       wayMap,
                                       relationMap,
                                       relation,
@@ -587,13 +597,24 @@ namespace osmscout {
         part.SetId(way->GetId());
         part.SetRelationRole(member.role);
 
-        for (size_t n=0; n<way->GetNodeCount(); n++) {
-          OSMId osmId=way->GetNodeId(n);
-          auto  coordEntry=coordMap.find(osmId);
+        std::vector<Point> points;
+
+        if (!resolveNodes(way->GetNodes(),
+                          points)) {
+          progress.Error("Cannot resolve child nodes of way "+
+                         std::to_string(way->GetId())+
+                         " for relation "+
+                         std::to_string(rawRelation.GetId())+" "+
+                         rawRelation.GetType()->GetName()+" "+
+                         name);
+
+          return false;
+        }
 
-          if (coordEntry==coordMap.end()) {
+        for (size_t n=0; n<way->GetNodeCount(); n++) {
+          if (!DenseCoordDataFile::IsResolved(points[n])) {
             progress.Error("Cannot resolve node member "+
-                           std::to_string(osmId)+
+                           std::to_string(way->GetNodeId(n))+
                            " for relation "+
                            std::to_string(rawRelation.GetId())+" "+
                            rawRelation.GetType()->GetName()+" "+
@@ -602,8 +623,7 @@ namespace osmscout {
             return false;
           }
 
-          part.role.nodes[n].Set(coordEntry->second.GetSerial(),
-                                 coordEntry->second.GetCoord());
+          part.role.nodes[n]=points[n];
         }
 
         part.ways.push_back(way);
@@ -619,6 +639,7 @@ namespace osmscout {
                                                         const ImportParameter& parameter,
                                                         const TypeConfig& typeConfig,
                                                         CoordDataFile& coordDataFile,
+                                                        const DenseCoordDataFile& denseCoordDataFile,
                                                         RawWayIndexedDataFile& wayDataFile,
                                                         RawRelationIndexedDataFile& relDataFile,
                                                         IdSet& resolvedRelations,
@@ -819,13 +840,33 @@ namespace osmscout {
       return false;
     }
 
-    if (!coordDataFile.Get(nodeIds,
-                           coordMap)) {
-      progress.Error("Cannot resolve child nodes of relation "+
-                     std::to_string(rawRelation.GetId())+" "+
-                     rawRelation.GetType()->GetName()+" "+
-                     name);
-      return false;
+    NodeResolver resolveNodes;
+
+    if (parameter.GetDenseCoordData()) {
+      resolveNodes=[&denseCoordDataFile](const std::vector<OSMId>& ids,
+                                         std::vector<Point>& points) {
+        return denseCoordDataFile.Get(ids,
+                                      points);
+      };
+    }
+    else {
+      if (!coordDataFile.Get(nodeIds,
+                             coordMap)) {
+        progress.Error("Cannot resolve child nodes of relation "+
+                       std::to_string(rawRelation.GetId())+" "+
+                       rawRelation.GetType()->GetName()+" "+
+                       name);
+        return false;
+      }
+
+      resolveNodes=[&coordMap](const std::vector<OSMId>& ids,
+                               std::vector<Point>& points) {
+        DenseCoordDataFile::GetPoints(coordMap,
+                                      ids,
+                                      points);
+
+        return true;
+      };
     }
 
     nodeIds.clear();
@@ -835,7 +876,7 @@ namespace osmscout {
     if (boundaryTypes.IsSet(rawRelation.GetType())) {
       return ComposeBoundaryMembers(typeConfig,
                                     progress,
-                                    coordMap,
+                                    resolveNodes,
                                     wayMap,
                                     relationMap,
                                     relation,
@@ -847,7 +888,7 @@ namespace osmscout {
 
     return ComposeAreaMembers(typeConfig,
                               progress,
-                              coordMap,
+                              resolveNodes,
                               wayMap,
                               name,
                               rawRelation,
@@ -932,6 +973,7 @@ namespace osmscout {
                                                         const TypeConfig& typeConfig,
                                                         IdSet& wayAreaIndexBlacklist,
                                                         CoordDataFile& coordDataFile,
+                                                        const DenseCoordDataFile& denseCoordDataFile,
                                                         RawWayIndexedDataFile& wayDataFile,
                                                         RawRelationIndexedDataFile& relDataFile,
                                                         RawRelation& rawRelation,
@@ -946,6 +988,7 @@ namespace osmscout {
                                     parameter,
                                     typeConfig,
                                     coordDataFile,
+                                    denseCoordDataFile,
                                     wayDataFile,
                                     relDataFile,
                                     resolvedRelations,
@@ -1152,13 +1195,18 @@ namespace osmscout {
     return "";
   }
 
-  void RelAreaDataGenerator::GetDescription(const ImportParameter& /*parameter*/,
+  void RelAreaDataGenerator::GetDescription(const ImportParameter& parameter,
                                                  ImportModuleDescription& description) const
   {
     description.SetName("RelAreaDataGenerator");
     description.SetDescription("Resolves raw relations to areas");
 
-    description.AddRequiredFile(CoordDataFile::COORD_DAT);
+    if (parameter.GetDenseCoordData()) {
+      description.AddRequiredFile(DenseCoordDataFile::DENSE_COORD_DAT);
+    }
+    else {
+      description.AddRequiredFile(CoordDataFile::COORD_DAT);
+    }
     description.AddRequiredFile(Preprocess::RAWWAYS_DAT);
     description.AddRequiredFile(Preprocess::RAWRELS_DAT);
     description.AddRequiredFile(RawWayIndexGenerator::RAWWAY_IDX);
@@ -1175,14 +1223,23 @@ namespace osmscout {
     IdSet                      wayAreaIndexBlacklist;
 
     CoordDataFile              coordDataFile;
+    DenseCoordDataFile         denseCoordDataFile;
 
     RawWayIndexedDataFile      wayDataFile(parameter.GetRawWayIndexCacheSize(),/*dataCache*/0);
 
     RawRelationIndexedDataFile relDataFile(parameter.GetRawWayIndexCacheSize(),/*dataCache*/0);
     FeatureRef                 featureName(typeConfig->GetFeature(RefFeature::NAME));
 
-    if (!coordDataFile.Open(parameter.GetDestinationDirectory(),
-                            parameter.GetCoordDataMemoryMaped())) {
+    if (parameter.GetDenseCoordData()) {
+      // The file is sparse, mapping it does not require memory for unused ids
+      if (!denseCoordDataFile.Open(parameter.GetDestinationDirectory(),
+                                   true)) {
+        log.Error() << "Cannot open dense coord data file!";
+        return false;
+      }
+    }
+    else if (!coordDataFile.Open(parameter.GetDestinationDirectory(),
+                                 parameter.GetCoordDataMemoryMaped())) {
       log.Error() << "Cannot open coord data files!";
       return false;
     }
@@ -1254,6 +1311,7 @@ namespace osmscout {
                                         *typeConfig,
                                         wayAreaIndexBlacklist,
                                         coordDataFile,
+                                        denseCoordDataFile,
                                         wayDataFile,
                                         relDataFile,
                                         rawRel,
@@ -1337,7 +1395,7 @@ namespace osmscout {
       writer.Close();
 
       if (!(wayDataFile.Close() &&
-            coordDataFile.Close())) {
+            (parameter.GetDenseCoordData() ? denseCoordDataFile.Close() : coordDataFile.Close()))) {
         return false;
       }
 
@@ -54,6 +54,7 @@ namespace osmscout {
 
     description.AddRequiredFile(CoordDataFile::COORD_DAT);
 
+    description.AddRequiredFile(NodeDataFile::NODES_DAT);
     description.AddRequiredFile(WayDataFile::WAYS_DAT);
     description.AddRequiredFile(AreaDataFile::AREAS_DAT);
 
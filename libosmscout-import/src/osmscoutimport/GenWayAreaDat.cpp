@@ -41,13 +41,18 @@ namespace osmscout {
     // no code
   }
 
-  void WayAreaDataGenerator::GetDescription(const ImportParameter& /*parameter*/,
+  void WayAreaDataGenerator::GetDescription(const ImportParameter& parameter,
                                             ImportModuleDescription& description) const
   {
     description.SetName("WayAreaDataGenerator");
     description.SetDescription("Resolves raw ways to areas");
 
-    description.AddRequiredFile(CoordDataFile::COORD_DAT);
+    if (parameter.GetDenseCoordData()) {
+      description.AddRequiredFile(DenseCoordDataFile::DENSE_COORD_DAT);
+    }
+    else {
+      description.AddRequiredFile(CoordDataFile::COORD_DAT);
+    }
     description.AddRequiredFile(Preprocess::RAWWAYS_DAT);
     description.AddRequiredFile(RelAreaDataGenerator::WAYAREABLACK_DAT);
 
@@ -90,7 +95,7 @@ namespace osmscout {
                                        const TypeConfig& typeConfig,
                                        FileWriter& writer,
                                        uint32_t& writtenWayCount,
-                                       const CoordDataFile::ResultMap& coordsMap,
+                                       const std::vector<Point>& points,
                                        const RawWay& rawWay)
   {
     Area       area;
@@ -102,21 +107,16 @@ namespace osmscout {
     ring.MarkAsOuterRing();
     ring.nodes.resize(rawWay.GetNodeCount());
 
-    size_t index=0;
-    for (const auto& nodeId  : rawWay.GetNodes()) {
-      auto coord=coordsMap.find(nodeId);
-
-      if (coord==coordsMap.end()) {
+    for (size_t n=0; n<rawWay.GetNodeCount(); n++) {
+      if (!DenseCoordDataFile::IsResolved(points[n])) {
         progress.Error("Cannot resolve node with id "+
-                       std::to_string(nodeId)+
+                       std::to_string(rawWay.GetNodeId(n))+
                        " for area "+
                        std::to_string(wayId));
         return;
       }
 
-      ring.nodes[index].Set(coord->second.GetSerial(),
-                            coord->second.GetCoord());
-      index++;
+      ring.nodes[n]=points[n];
     }
 
     if (!IsValidToWrite(ring.nodes)) {
@@ -148,6 +148,8 @@ namespace osmscout {
     progress.SetAction("Generate wayarea.tmp");
 
     CoordDataFile             coordDataFile;
+    DenseCoordDataFile        denseCoordDataFile;
+    std::vector<Point>        points;
 
     FileScanner               scanner;
     std::vector<RawWayRef>    rawWays;
@@ -169,8 +171,16 @@ namespace osmscout {
       return false;
     }
 
-    if (!coordDataFile.Open(parameter.GetDestinationDirectory(),
-                            parameter.GetCoordDataMemoryMaped())) {
+    if (parameter.GetDenseCoordData()) {
+      // The file is sparse, mapping it does not require memory for unused ids
+      if (!denseCoordDataFile.Open(parameter.GetDestinationDirectory(),
+                                   true)) {
+        log.Error() << "Cannot open dense coord data file!";
+        return false;
+      }
+    }
+    else if (!coordDataFile.Open(parameter.GetDestinationDirectory(),
+                                 parameter.GetCoordDataMemoryMaped())) {
       log.Error() << "Cannot open coord data file!";
       return false;
     }
@@ -218,6 +228,24 @@ namespace osmscout {
           continue;
         }
 
+        if (parameter.GetDenseCoordData()) {
+          if (!denseCoordDataFile.Get(way->GetNodes(),
+                                      points)) {
+            log.Error() << "Cannot read coordinates!";
+            return false;
+          }
+
+          WriteArea(parameter,
+                    progress,
+                    *typeConfig,
+                    areaWriter,
+                    writtenWayCount,
+                    points,
+                    *way);
+
+          continue;
+        }
+
         nodeIds.insert(way->GetNodes().begin(),way->GetNodes().end());
 
         rawWays.push_back(way);
@@ -235,12 +263,16 @@ namespace osmscout {
           nodeIds.clear();
 
           for (const auto& rawWay : rawWays) {
+            DenseCoordDataFile::GetPoints(coordsMap,
+                                          rawWay->GetNodes(),
+                                          points);
+
             WriteArea(parameter,
                       progress,
                       *typeConfig,
                       areaWriter,
                       writtenWayCount,
-                      coordsMap,
+                      points,
                       *rawWay);
           }
 
@@ -258,12 +290,16 @@ namespace osmscout {
         }
 
         for (const auto& rawWay : rawWays) {
+          DenseCoordDataFile::GetPoints(coordsMap,
+                                        rawWay->GetNodes(),
+                                        points);
+
           WriteArea(parameter,
                     progress,
                     *typeConfig,
                     areaWriter,
                     writtenWayCount,
-                    coordsMap,
+                    points,
                     *rawWay);
         }
       }
@@ -292,6 +328,10 @@ namespace osmscout {
 
     wayBlacklist.clear();
 
+    if (parameter.GetDenseCoordData()) {
+      return denseCoordDataFile.Close();
+    }
+
     return coordDataFile.Close();
   }
 }
@@ -44,13 +44,21 @@ namespace osmscout {
     return a->GetNodeCount()>b->GetNodeCount();
   }
 
-  void WayWayDataGenerator::GetDescription(const ImportParameter& /*parameter*/,
+  void WayWayDataGenerator::GetDescription(const ImportParameter& parameter,
                                            ImportModuleDescription& description) const
   {
     description.SetName("WayWayDataGenerator");
     description.SetDescription("Merge ways into bigger ways");
 
     description.AddRequiredFile(TypeDistributionDataFile::DISTRIBUTION_DAT);
+
+    if (parameter.GetDenseCoordData()) {
+      description.AddRequiredFile(DenseCoordDataFile::DENSE_COORD_DAT);
+    }
+    else {
+      description.AddRequiredFile(CoordDataFile::COORD_DAT);
+    }
+
     description.AddRequiredFile(Preprocess::RAWWAYS_DAT);
     description.AddRequiredFile(Preprocess::RAWTURNRESTR_DAT);
     description.AddRequiredFile(Preprocess::RAWROUTE_DAT);
@@ -82,11 +90,15 @@ namespace osmscout {
 
         for (const auto &member: route.members){
           if (member.type==RawRelation::memberWay){
-            routeMembers.insert(std::make_pair(member.id, route.GetId()));
+            routeMembers.emplace_back(member.id, route.GetId());
           }
         }
       }
 
+      std::sort(routeMembers.begin(),routeMembers.end());
+      routeMembers.erase(std::unique(routeMembers.begin(),routeMembers.end()),
+                         routeMembers.end());
+
       progress.Info(std::string("Read ") + std::to_string(routeCount) + " routes");
 
       scanner.Close();
@@ -295,16 +307,49 @@ namespace osmscout {
     return false;
   }
 
+  /**
+   * Return true, if both ways are members of the same set of routes (or both are
+   * not member of any route)
+   */
+  bool WayWayDataGenerator::HaveSameRoutes(const RouteMemberData& routeMembers,
+                                           OSMId aWayId,
+                                           OSMId bWayId)
+  {
+    auto wayIdLess=[](const RouteMember& member, OSMId wayId) {
+      return member.first<wayId;
+    };
+
+    auto aRoute=std::lower_bound(routeMembers.begin(),routeMembers.end(),aWayId,wayIdLess);
+    auto bRoute=std::lower_bound(routeMembers.begin(),routeMembers.end(),bWayId,wayIdLess);
+
+    while (aRoute!=routeMembers.end() &&
+           aRoute->first==aWayId) {
+      if (bRoute==routeMembers.end() ||
+          bRoute->first!=bWayId ||
+          bRoute->second!=aRoute->second) {
+        return false;
+      }
+
+      ++aRoute;
+      ++bRoute;
+    }
+
+    return bRoute==routeMembers.end() ||
+           bRoute->first!=bWayId;
+  }
+
   bool WayWayDataGenerator::MergeWays(Progress& progress,
                                       std::list<RawWayRef>& ways,
                                       RestrictionData& restrictions,
-                                      RouteMemberData& routeMembers)
+                                      const RouteMemberData& routeMembers)
   {
     WaysByNodeMap waysByNode;
 
     // Sort by decreasing node count to assure that we merge longest ways first
     ways.sort(WayByNodeCountSorter);
 
+    waysByNode.reserve(ways.size());
+
     // Index by first node id (if way is not circular)
     for (auto w=ways.begin();
         w!=ways.end();
@@ -395,25 +440,10 @@ namespace osmscout {
           }
 
           // check route members
-          auto aRouteFrom = routeMembers.lower_bound(way->GetId());
-          auto aRouteTo = routeMembers.upper_bound(way->GetId());
-          auto bRouteFrom = routeMembers.lower_bound(candidate->GetId());
-          auto bRouteTo = routeMembers.upper_bound(candidate->GetId());
-          if (aRouteFrom != aRouteTo || bRouteFrom != bRouteTo){
-            std::set<OSMId> aRoutes;
-            std::set<OSMId> bRoutes;
-
-            std::for_each(aRouteFrom,aRouteTo,
-                [&aRoutes](auto &pair){aRoutes.insert(pair.second);});
-
-            std::for_each(bRouteFrom,bRouteTo,
-                [&bRoutes](auto &pair){bRoutes.insert(pair.second);});
-
-            assert(!(aRoutes.empty() && bRoutes.empty()));
-
-            if (aRoutes != bRoutes) {
-              continue; // cannot merge, ways have different set of routes
-            }
+          if (!HaveSameRoutes(routeMembers,
+                              way->GetId(),
+                              candidate->GetId())) {
+            continue; // cannot merge, ways have different set of routes
           }
 
           /*
@@ -486,34 +516,37 @@ namespace osmscout {
   }
 
   bool WayWayDataGenerator::SplitLongWays(Progress& progress,
-                     std::list<RawWayRef>& ways,
-                     CoordDataFile::ResultMap& coordsMap)
+                                          std::list<RawWayRef>& ways,
+                                          const NodeResolver& resolveNodes)
   {
     std::list<RawWayRef> newWays;
+    std::vector<Point>   points;
 
     size_t currentWay=1;
     size_t wayCount=ways.size();
 
     for (const auto& way: ways) {
-      //*wayIt;
+      if (!resolveNodes(way->GetNodes(),
+                        points)) {
+        progress.Error("Cannot read nodes");
+        return false;
+      }
+
       Distance length;
-      bool split = way->GetNodeCount() > 300;
-      if ((!split) && way->GetNodeCount() >= 2){
+      size_t   nodeCount=way->GetNodeCount();
+      bool     split=nodeCount > 300;
+      if ((!split) && nodeCount >= 2){
         // check real length
-        auto osmIdIt = way->GetNodes().begin();
-        auto endIt = way->GetNodes().end();
-        auto prev = coordsMap.find(*osmIdIt);
-        osmIdIt ++;
-        while (osmIdIt != endIt && (!split)){
-          auto current = coordsMap.find(*osmIdIt);
-          if (prev == coordsMap.end() || current == coordsMap.end()) {
+        size_t prev=0;
+        for (size_t current=1; current<nodeCount && (!split); current++) {
+          if (!DenseCoordDataFile::IsResolved(points[prev]) ||
+              !DenseCoordDataFile::IsResolved(points[current])) {
             split = true;
           }
           else {
-            length += GetSphericalDistance(prev->second.GetCoord(), current->second.GetCoord());
+            length += GetSphericalDistance(points[prev].GetCoord(), points[current].GetCoord());
           }
           prev = current;
-          osmIdIt ++;
         }
         split = length.As<Kilometer>() > 30.0;
       }
@@ -537,29 +570,29 @@ namespace osmscout {
       size_t segmentNodeCnt=1;
       RawWayRef segment = std::make_shared<RawWay>();
 
-      auto osmIdIt = way->GetNodes().begin();
-      auto endIt = way->GetNodes().end();
-      auto segmentStart = osmIdIt;
-      auto segmentEnd = osmIdIt;
+      auto   nodesBegin = way->GetNodes().begin();
+      size_t n = 0;
+      size_t segmentStart = n;
+      size_t segmentEnd = n;
 
-      auto prev = coordsMap.find(*osmIdIt);
+      Point prev = points[n];
       // jump to first valid node
-      while (prev==coordsMap.end() && osmIdIt != endIt) {
+      while (!DenseCoordDataFile::IsResolved(prev) && n < nodeCount) {
         progress.Error("Cannot resolve node with id "+
-                       std::to_string(*osmIdIt)+
+                       std::to_string(way->GetNodeId(n))+
                        " for way "+
                        std::to_string(way->GetId())+
                        ", skipping");
-        osmIdIt ++;
-        segmentStart = osmIdIt;
-        if (osmIdIt != endIt){
-          prev = coordsMap.find(*osmIdIt);
+        n++;
+        segmentStart = n;
+        if (n < nodeCount){
+          prev = points[n];
         }
       }
 
-      osmIdIt ++;
-      segmentEnd=osmIdIt;
-      while (osmIdIt!=endIt) {
+      n++;
+      segmentEnd=n;
+      while (n < nodeCount) {
 
         if (segment->GetId()==0) {
           segment->SetId(way->GetId());
@@ -567,36 +600,37 @@ namespace osmscout {
           segment->SetFeatureValueBuffer(way->GetFeatureValueBuffer());
         }
 
-        auto current = coordsMap.find(*osmIdIt);
+        const Point& current = points[n];
+        bool         currentResolved = DenseCoordDataFile::IsResolved(current);
 
-        if (current!=coordsMap.end()) {
-          segmentLength += GetSphericalDistance(prev->second.GetCoord(), current->second.GetCoord());
+        if (currentResolved) {
+          segmentLength += GetSphericalDistance(prev.GetCoord(), current.GetCoord());
           segmentNodeCnt ++;
         }
 
-        if (segmentNodeCnt >= 300 || segmentLength.As<Kilometer>() > 30.0 || current==coordsMap.end()) {
+        if (segmentNodeCnt >= 300 || segmentLength.As<Kilometer>() > 30.0 || !currentResolved) {
           auto currentSegmentStart = segmentStart;
-          segmentStart=osmIdIt;
+          segmentStart=n;
           prev = current;
-          osmIdIt ++;
-          segmentEnd=osmIdIt;
+          n++;
+          segmentEnd=n;
 
-          segment->SetNodes(currentSegmentStart, osmIdIt);
+          segment->SetNodes(nodesBegin+currentSegmentStart, nodesBegin+n);
           newWays.push_back(segment);
           //std::cout << "  - New segment " << segment->GetId() <<
           //  " with " << segment->GetNodeCount() << " nodes and real length " << segmentLength << " km" << std::endl;
 
           // skip invalid nodes
-          while (prev==coordsMap.end() && osmIdIt != endIt){
+          while (!DenseCoordDataFile::IsResolved(prev) && n < nodeCount){
             progress.Error("Cannot resolve node with id "+
-                           std::to_string(*osmIdIt)+
+                           std::to_string(way->GetNodeId(n))+
                            " for way "+
                            std::to_string(way->GetId())+
                            ", splitting");
-            osmIdIt ++;
-            segmentStart = osmIdIt;
-            if (osmIdIt != endIt){
-              prev = coordsMap.find(*osmIdIt);
+            n++;
+            segmentStart = n;
+            if (n < nodeCount){
+              prev = points[n];
             }
           }
           // reset segment
@@ -607,12 +641,12 @@ namespace osmscout {
         }
         else {
           prev = current;
-          osmIdIt ++;
-          segmentEnd=osmIdIt;
+          n++;
+          segmentEnd=n;
         }
       }
       if (segment->GetId() != 0 && segmentNodeCnt >= 2) {
-        segment->SetNodes(segmentStart, segmentEnd);
+        segment->SetNodes(nodesBegin+segmentStart, nodesBegin+segmentEnd);
         newWays.push_back(segment);
         //std::cout << "  - New segment (last) " << segment->GetId() <<
         //    " with " << segment->GetNodeCount() << " nodes and real length " << segmentLength << " km" << std::endl;
@@ -628,42 +662,81 @@ namespace osmscout {
     return true;
   }
 
-  void WayWayDataGenerator::WriteWay(Progress& progress,
-                                     const TypeConfig& typeConfig,
-                                     FileWriter& writer,
-                                     uint32_t& writtenWayCount,
-                                     const CoordDataFile::ResultMap& coordsMap,
-                                     const RawWay& rawWay)
+  /**
+   * Convert the raw way to a way using the given resolved points. Returns an
+   * empty reference, if the way cannot be written.
+   */
+  WayRef WayWayDataGenerator::BuildWay(Progress& progress,
+                                       const std::vector<Point>& points,
+                                       const RawWay& rawWay)
   {
-    Way   way;
-    OSMId wayId=rawWay.GetId();
+    WayRef way=std::make_shared<Way>();
+    OSMId  wayId=rawWay.GetId();
 
-    way.SetFeatures(rawWay.GetFeatureValueBuffer());
+    way->SetFeatures(rawWay.GetFeatureValueBuffer());
 
-    way.nodes.resize(rawWay.GetNodeCount());
+    way->nodes.resize(rawWay.GetNodeCount());
 
     for (size_t n=0; n<rawWay.GetNodeCount(); n++) {
-      auto coord=coordsMap.find(rawWay.GetNodeId(n));
-
-      if (coord==coordsMap.end()) {
+      if (!DenseCoordDataFile::IsResolved(points[n])) {
         progress.Error("Cannot resolve node with id "+
                        std::to_string(rawWay.GetNodeId(n))+
                        " for Way "+
                        std::to_string(wayId)+
                        ", skipping");
-        return;
+        return nullptr;
       }
 
-      way.nodes[n].Set(coord->second.GetSerial(),
-                       coord->second.GetCoord());
+      way->nodes[n]=points[n];
     }
 
-    if (!IsValidToWrite(way.nodes)) {
+    if (!IsValidToWrite(way->nodes)) {
       progress.Error("Way coordinates are not dense enough to be written for Way "+
                      std::to_string(wayId)+", skipping");
-      return;
+      return nullptr;
     }
 
+    return way;
+  }
+
+  /**
+   * Resolve the nodes of the given raw ways and append the resulting ways (in the same
+   * order) to the buffer. Ways that cannot be written are skipped.
+   */
+  bool WayWayDataGenerator::BuildWays(Progress& progress,
+                                      const std::list<RawWayRef>& rawWays,
+                                      const NodeResolver& resolveNodes,
+                                      WayBuffer& ways)
+  {
+    std::vector<Point> points;
+
+    ways.reserve(ways.size()+rawWays.size());
+
+    for (const auto& rawWay : rawWays) {
+      if (!resolveNodes(rawWay->GetNodes(),
+                        points)) {
+        progress.Error("Cannot read nodes");
+        return false;
+      }
+
+      WayRef way=BuildWay(progress,
+                          points,
+                          *rawWay);
+
+      if (way) {
+        ways.emplace_back(rawWay->GetId(),way);
+      }
+    }
+
+    return true;
+  }
+
+  void WayWayDataGenerator::WriteWay(const TypeConfig& typeConfig,
+                                     FileWriter& writer,
+                                     uint32_t& writtenWayCount,
+                                     OSMId wayId,
+                                     const Way& way)
+  {
     writer.Write((uint8_t)osmRefWay);
     writer.Write(wayId);
     way.Write(typeConfig,
@@ -678,9 +751,10 @@ namespace osmscout {
                                                     const TypeInfoSet& types,
                                                     FileWriter& writer,
                                                     uint32_t& writtenWayCount,
-                                                    const CoordDataFile& coordDataFile)
+                                                    const NodeResolver& resolveNodes)
   {
-    uint32_t collectedAreasCount=0;
+    uint32_t           collectedAreasCount=0;
+    std::vector<Point> points;
 
     scanner.GotoBegin();
 
@@ -712,27 +786,23 @@ namespace osmscout {
 
       collectedAreasCount++;
 
-      std::set<OSMId>          nodeIds;
-      CoordDataFile::ResultMap coordsMap;
-
-      for (size_t n=0; n<way->GetNodeCount(); n++) {
-        nodeIds.insert(way->GetNodeId(n));
-      }
-
-      if (!coordDataFile.Get(nodeIds,
-                             coordsMap)) {
+      if (!resolveNodes(way->GetNodes(),
+                        points)) {
         progress.Error("Cannot read nodes!");
         return false;
       }
 
-      nodeIds.clear();
+      WayRef resolvedWay=BuildWay(progress,
+                                  points,
+                                  *way);
 
-      WriteWay(progress,
-               typeConfig,
-               writer,
-               writtenWayCount,
-               coordsMap,
-               *way);
+      if (resolvedWay) {
+        WriteWay(typeConfig,
+                 writer,
+                 writtenWayCount,
+                 way->GetId(),
+                 *resolvedWay);
+      }
     }
 
     progress.SetAction("Collected "+std::to_string(collectedAreasCount)+" areas for "+std::to_string(types.Size())+" types");
@@ -796,14 +866,47 @@ namespace osmscout {
       return false;
     }
 
-    CoordDataFile coordDataFile;
+    CoordDataFile      coordDataFile;
+    DenseCoordDataFile denseCoordDataFile;
 
-    if (!coordDataFile.Open(parameter.GetDestinationDirectory(),
-                            parameter.GetCoordDataMemoryMaped())) {
+    if (parameter.GetDenseCoordData()) {
+      // The file is sparse, mapping it does not require memory for unused ids
+      if (!denseCoordDataFile.Open(parameter.GetDestinationDirectory(),
+                                   true)) {
+        log.Error() << "Cannot open dense coord data file!";
+        return false;
+      }
+    }
+    else if (!coordDataFile.Open(parameter.GetDestinationDirectory(),
+                                 parameter.GetCoordDataMemoryMaped())) {
       log.Error() << "Cannot open coord data file!";
       return false;
     }
 
+    // Resolves the nodes of a single way directly from the coord data file
+    NodeResolver resolveWayNodes=[&parameter,&coordDataFile,&denseCoordDataFile](const std::vector<OSMId>& ids,
+                                                                                 std::vector<Point>& points) {
+      if (parameter.GetDenseCoordData()) {
+        return denseCoordDataFile.Get(ids,
+                                      points);
+      }
+
+      std::set<OSMId>          nodeIds(ids.begin(),
+                                       ids.end());
+      CoordDataFile::ResultMap coordsMap;
+
+      if (!coordDataFile.Get(nodeIds,
+                             coordsMap)) {
+        return false;
+      }
+
+      DenseCoordDataFile::GetPoints(coordsMap,
+                                    ids,
+                                    points);
+
+      return true;
+    };
+
     try {
       uint32_t writtenWayCount=0;
       size_t   mergeCount=0;
@@ -840,83 +943,121 @@ namespace osmscout {
           return false;
         }
 
-        // TODO: only print it, if there is something to merge at all
-        progress.SetAction("Merging ways");
+        CoordDataFile::ResultMap coordsMap;
+        NodeResolver             resolveNodes=resolveWayNodes;
 
-#pragma omp parallel for
-        for (int64_t typeIdx = 0; typeIdx<(int64_t)typeConfig->GetTypeCount(); typeIdx++) {
-          size_t originalWayCount=waysByType[typeIdx].size();
+        // With the dense coord data file nodes are resolved on demand,
+        // else we load the nodes of all ways in one go. Merging ways
+        // does not change the set of required nodes.
+        if (!parameter.GetDenseCoordData()) {
+          progress.SetAction("Collecting node ids");
 
-          if (originalWayCount>0) {
-            MergeWays(progress,
-                      waysByType[typeIdx],
-                      restrictions,
-                      routeMembers);
+          std::set<OSMId> nodeIds;
 
-#pragma omp critical
-            if (waysByType[typeIdx].size()<originalWayCount) {
-              progress.Info("Reduced ways of '"+typeConfig->GetTypeInfo(typeIdx)->GetName()+"' from "+
-                            std::to_string(originalWayCount)+" to "+std::to_string(waysByType[typeIdx].size())+ " way(s)");
-              mergeCount+=originalWayCount-waysByType[typeIdx].size();
+          for (auto & type : waysByType) {
+            for (const auto &rawWay : type) {
+              for (size_t n=0; n<rawWay->GetNodeCount(); n++) {
+                nodeIds.insert(rawWay->GetNodeId(n));
+              }
             }
           }
-        }
 
-        progress.SetAction("Collecting node ids");
+          progress.SetAction("Loading "+std::to_string(nodeIds.size())+" nodes");
 
-        std::set<OSMId>          nodeIds;
-        CoordDataFile::ResultMap coordsMap;
+          if (!coordDataFile.Get(nodeIds,
+                                 coordsMap)) {
+            progress.Error("Cannot read nodes");
 
-        for (auto & type : waysByType) {
-          for (const auto &rawWay : type) {
-            for (size_t n=0; n<rawWay->GetNodeCount(); n++) {
-              nodeIds.insert(rawWay->GetNodeId(n));
-            }
+            return false;
           }
-        }
 
-        progress.SetAction("Loading "+std::to_string(nodeIds.size())+" nodes");
+          nodeIds.clear();
 
-        if (!coordDataFile.Get(nodeIds,
-                               coordsMap)) {
-          progress.Error("Cannot read nodes");
+          resolveNodes=[&coordsMap](const std::vector<OSMId>& ids,
+                                    std::vector<Point>& points) {
+            DenseCoordDataFile::GetPoints(coordsMap,
+                                          ids,
+                                          points);
 
-          return false;
+            return true;
+          };
         }
 
-        nodeIds.clear();
+        // Merge ways, split too long ways again to shorter segments and resolve
+        // their nodes. Types are independent and thus processed in parallel,
+        // the result is written in the order of the type index.
+        progress.SetAction("Merging and writing ways");
 
-        // split too long ways again to shorter segments
-        progress.SetAction("Splitting too long ways");
-#pragma omp parallel for
+        bool failed=false;
+
+#pragma omp parallel for ordered schedule(dynamic,1)
         for (int64_t typeIdx = 0; typeIdx<(int64_t)typeConfig->GetTypeCount(); typeIdx++) {
-          size_t originalWayCount=waysByType[typeIdx].size();
+          std::list<RawWayRef>& ways=waysByType[typeIdx];
+          size_t                originalWayCount=ways.size();
+          size_t                mergedWayCount=originalWayCount;
+          WayBuffer             resolvedWays;
+          bool                  success=true;
 
           if (originalWayCount>0) {
-            SplitLongWays(progress, waysByType[typeIdx], coordsMap);
+            MergeWays(progress,
+                      ways,
+                      restrictions,
+                      routeMembers);
 
-#pragma omp critical
-            if (waysByType[typeIdx].size()>originalWayCount) {
+            mergedWayCount=ways.size();
+
+            success=SplitLongWays(progress,
+                                  ways,
+                                  resolveNodes) &&
+                    BuildWays(progress,
+                              ways,
+                              resolveNodes,
+                              resolvedWays);
+          }
+
+#pragma omp ordered
+          {
+            if (mergedWayCount<originalWayCount) {
+              progress.Info("Reduced ways of '"+typeConfig->GetTypeInfo(typeIdx)->GetName()+"' from "+
+                            std::to_string(originalWayCount)+" to "+std::to_string(mergedWayCount)+ " way(s)");
+              mergeCount+=originalWayCount-mergedWayCount;
+            }
+
+            if (ways.size()>mergedWayCount) {
               progress.Info("Splitted long ways of '"+typeConfig->GetTypeInfo(typeIdx)->GetName()+"' from "+
-                            std::to_string(originalWayCount)+" to "+std::to_string(waysByType[typeIdx].size())+ " way(s)");
-              mergeCount+=originalWayCount-waysByType[typeIdx].size();
+                            std::to_string(mergedWayCount)+" to "+std::to_string(ways.size())+ " way(s)");
+              mergeCount+=mergedWayCount-ways.size();
             }
-          }
-        }
 
-        progress.SetAction("Writing ways");
+            if (!success) {
+              failed=true;
+            }
 
-        for (auto& type : waysByType) {
-          for (const auto &rawWay : type) {
-            WriteWay(progress,
-                     *typeConfig,
-                     wayWriter,
-                     writtenWayCount,
-                     coordsMap,
-                     *rawWay);
+            // Exceptions must not leave the parallel region
+            if (!failed) {
+              try {
+                for (const auto& way : resolvedWays) {
+                  WriteWay(*typeConfig,
+                           wayWriter,
+                           writtenWayCount,
+                           way.first,
+                           *way.second);
+                }
+              }
+              catch (IOException& e) {
+                progress.Error(e.GetDescription());
+                failed=true;
+              }
+            }
+
+            ways.clear();
           }
+        }
 
-          type.clear();
+        if (failed) {
+          scanner.CloseFailsafe();
+          wayWriter.CloseFailsafe();
+          return false;
         }
       }
 
@@ -935,7 +1076,7 @@ namespace osmscout {
                                 slowFallbackTypes,
                                 wayWriter,
                                 writtenWayCount,
-                                coordDataFile);
+                                resolveWayNodes);
       }
 
       /* -------*/
@@ -958,7 +1099,12 @@ namespace osmscout {
 
     // Cleaning up...
 
-    if (!coordDataFile.Close()) {
+    if (parameter.GetDenseCoordData()) {
+      if (!denseCoordDataFile.Close()) {
+        return false;
+      }
+    }
+    else if (!coordDataFile.Close()) {
       return false;
     }
 
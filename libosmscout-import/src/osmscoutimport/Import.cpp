@@ -21,6 +21,9 @@
 #include <osmscout/private/Config.h>
 
 #include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <thread>
 
 #include <osmscout/OSMScoutTypes.h>
 
@@ -67,6 +70,7 @@
 // Routing
 #include <osmscoutimport/GenRouteDat.h>
 #include <osmscoutimport/GenIntersectionIndex.h>
+#include <osmscoutimport/GenContractionHierarchy.h>
 
 // Public Transport
 #include <osmscoutimport/GenPTRouteDat.h>
@@ -79,6 +83,8 @@
 #include "tbb/task_scheduler_init.h"
 #endif
 
+#include <osmscout/system/Assert.h>
+
 #include <osmscout/util/MemoryMonitor.h>
 #include <osmscout/util/Progress.h>
 
@@ -228,6 +234,9 @@ namespace osmscout {
     modules.push_back(std::make_shared<TextIndexGenerator>());
 #endif
 
+    /* 29 (28 without text index) */
+    modules.push_back(std::make_shared<ContractionHierarchyGenerator>());
+
     assert(modules.size()==ImportParameter::GetDefaultEndStep());
   }
 
@@ -240,7 +249,167 @@ namespace osmscout {
     progress.Info("Number of area types: "+std::to_string(typeConfig.GetAreaTypes().size())+" "+std::to_string(typeConfig.GetAreaTypeIdBytes())+" byte(s)");
   }
 
+  /**
+   * Progress forwarding all calls to the given progress while holding the given mutex.
+   * Used to serialize the output of modules executed in parallel, prefixing each
+   * message with the name of the module.
+   */
+  class ForwardingProgress CLASS_FINAL : public Progress
+  {
+  private:
+    Progress&   progress;
+    std::mutex& mutex;
+    std::string prefix;
+
+  public:
+    ForwardingProgress(Progress& progress,
+                       std::mutex& mutex,
+                       const std::string& prefix)
+    : progress(progress),
+      mutex(mutex),
+      prefix(prefix)
+    {
+      SetOutputDebug(progress.OutputDebug());
+    }
+
+    void SetStep(const std::string& step) override
+    {
+      std::scoped_lock<std::mutex> lock(mutex);
+
+      progress.SetStep(prefix+step);
+    }
+
+    void SetAction(const std::string& action) override
+    {
+      std::scoped_lock<std::mutex> lock(mutex);
+
+      progress.SetAction(prefix+action);
+    }
+
+    void SetProgress(double current, double total, const std::string& label) override
+    {
+      std::scoped_lock<std::mutex> lock(mutex);
+
+      progress.SetProgress(current,total,prefix+label);
+    }
+
+    void SetProgress(unsigned int current, unsigned int total, const std::string& label) override
+    {
+      std::scoped_lock<std::mutex> lock(mutex);
+
+      progress.SetProgress(current,total,prefix+label);
+    }
+
+    void SetProgress(unsigned long current, unsigned long total, const std::string& label) override
+    {
+      std::scoped_lock<std::mutex> lock(mutex);
+
+      progress.SetProgress(current,total,prefix+label);
+    }
+
+    void SetProgress(unsigned long long current, unsigned long long total, const std::string& label) override
+    {
+      std::scoped_lock<std::mutex> lock(mutex);
+
+      progress.SetProgress(current,total,prefix+label);
+    }
+
+    void Debug(const std::string& text) override
+    {
+      std::scoped_lock<std::mutex> lock(mutex);
+
+      progress.Debug(prefix+text);
+    }
+
+    void Info(const std::string& text) override
+    {
+      std::scoped_lock<std::mutex> lock(mutex);
+
+      progress.Info(prefix+text);
+    }
+
+    void Warning(const std::string& text) override
+    {
+      std::scoped_lock<std::mutex> lock(mutex);
+
+      progress.Warning(prefix+text);
+    }
+
+    void Error(const std::string& text) override
+    {
+      std::scoped_lock<std::mutex> lock(mutex);
+
+      progress.Error(prefix+text);
+    }
+  };
+
+  static void GetAllProvidedFiles(const ImportModuleDescription& description,
+                                  std::set<std::string>& files)
+  {
+    for (const auto& fileList : {description.GetProvidedFiles(),
+                                 description.GetProvidedOptionalFiles(),
+                                 description.GetProvidedDebuggingFiles(),
+                                 description.GetProvidedTemporaryFiles(),
+                                 description.GetProvidedAnalysisFiles()}) {
+      files.insert(fileList.begin(),fileList.end());
+    }
+  }
+
+  static bool HasCommonFile(const std::set<std::string>& a,
+                            const std::set<std::string>& b)
+  {
+    return std::any_of(a.begin(),a.end(),[&b](const std::string& file) {
+      return b.find(file)!=b.end();
+    });
+  }
+
+  /**
+   * Calculate for each module the earlier modules it depends on, based on the files
+   * the modules require and provide. A module depends on an earlier module, if it
+   * requires a file the earlier module provides or if it provides a file the earlier
+   * module requires or provides, too. Modules without any required files are barriers:
+   * they are executed after all previous modules have finished and all following
+   * modules are executed after they have finished.
+   *
+   * Since dependencies always point to earlier modules, executing the modules
+   * in the given order is always valid.
+   */
+  void Importer::GetModuleDependencies(const std::vector<ImportModuleDescription>& moduleDescriptions,
+                                       std::vector<std::set<size_t>>& dependencies)
+  {
+    std::vector<std::set<std::string>> requiredFiles(moduleDescriptions.size());
+    std::vector<std::set<std::string>> providedFiles(moduleDescriptions.size());
+
+    for (size_t i=0; i<moduleDescriptions.size(); i++) {
+      std::list<std::string> files=moduleDescriptions[i].GetRequiredFiles();
+
+      requiredFiles[i].insert(files.begin(),files.end());
+      GetAllProvidedFiles(moduleDescriptions[i],
+                          providedFiles[i]);
+    }
+
+    dependencies.clear();
+    dependencies.resize(moduleDescriptions.size());
+
+    for (size_t i=0; i<moduleDescriptions.size(); i++) {
+      for (size_t j=0; j<i; j++) {
+        if (requiredFiles[i].empty() ||
+            requiredFiles[j].empty() ||
+            HasCommonFile(requiredFiles[i],providedFiles[j]) ||
+            HasCommonFile(providedFiles[i],requiredFiles[j]) ||
+            HasCommonFile(providedFiles[i],providedFiles[j])) {
+          dependencies[i].insert(j);
+        }
+      }
+    }
+  }
+
+  /**
+   * Remove all temporary files required by the given step, that are not required by
+   * any module that has not yet finished.
+   */
   bool Importer::CleanupTemporaries(size_t currentStep,
+                                    const std::vector<bool>& finishedModules,
                                     Progress& progress)
   {
     std::set<std::string> allTemporaryFiles;
@@ -261,7 +430,11 @@ namespace osmscout {
 
     std::set<std::string> inFutureStillRequiredTemporaryFiles;
 
-    for (size_t step=currentStep; step<moduleDescriptions.size(); step++) {
+    for (size_t step=0; step<moduleDescriptions.size(); step++) {
+      if (finishedModules[step]) {
+        continue;
+      }
+
       for (const auto& file : moduleDescriptions[step].GetRequiredFiles()) {
         if (allTemporaryFiles.find(file)!=allTemporaryFiles.end()) {
           inFutureStillRequiredTemporaryFiles.insert(file);
@@ -289,10 +462,11 @@ namespace osmscout {
     return true;
   }
 
-  bool Importer::ExecuteModules(const TypeConfigRef& typeConfig,
-                                ImportProgress& progress)
+  bool Importer::ExecuteModulesSequential(const TypeConfigRef& typeConfig,
+                                          ImportProgress& progress)
   {
-    size_t        currentStep=1;
+    size_t            currentStep=1;
+    std::vector<bool> finishedModules(modules.size(),false);
 
     for (const auto& module : modules) {
       if (currentStep>=parameter.GetStartStep() &&
@@ -309,20 +483,26 @@ namespace osmscout {
                                parameter,
                                progress);
 
-        progress.FinishedModule();
+        progress.FinishedModule(currentStep);
 
         if (!success) {
           progress.Error("Error while executing step '"+moduleDescription.GetName()+"'!");
           return false;
         }
 
+        finishedModules[currentStep-1]=true;
+
         if (parameter.IsEco()) {
           if (!CleanupTemporaries(currentStep,
+                                  finishedModules,
                                   progress)) {
             return false;
           }
         }
       }
+      else {
+        finishedModules[currentStep-1]=true;
+      }
 
       currentStep++;
     }
@@ -330,6 +510,229 @@ namespace osmscout {
     return true;
   }
 
+  /**
+   * Execute the modules with the given dependencies using up to threadCount worker
+   * threads. A module is started as soon as all modules it depends on have finished.
+   * If there are multiple candidates, the one with the lowest index is started first.
+   * Modules already marked as finished are not executed.
+   *
+   * canStartModule is called before a further module is started, while other modules
+   * are still running. If it returns false, the scheduler waits until a module finishes
+   * or one second has passed. executeModule is called for each module from one of the
+   * worker threads, finishedModule after the module and all modules before have been
+   * marked as finished. Calls of canStartModule and finishedModule are serialized.
+   *
+   * Returns false and does not start further modules, if executeModule or
+   * finishedModule returns false.
+   */
+  bool Importer::ExecuteModulesInDependencyOrder(const std::vector<std::set<size_t>>& dependencies,
+                                                 std::vector<bool>& finishedModules,
+                                                 size_t threadCount,
+                                                 const std::function<bool()>& canStartModule,
+                                                 const std::function<bool(size_t)>& executeModule,
+                                                 const std::function<bool(size_t)>& finishedModule)
+  {
+    enum class ModuleState
+    {
+      pending,
+      running,
+      finished
+    };
+
+    std::vector<ModuleState> states(dependencies.size(),ModuleState::pending);
+    std::mutex               stateMutex;
+    std::condition_variable  stateChanged;
+    size_t                   runningCount=0;
+    bool                     failed=false;
+
+    assert(finishedModules.size()==dependencies.size());
+
+    for (size_t i=0; i<dependencies.size(); i++) {
+      if (finishedModules[i]) {
+        states[i]=ModuleState::finished;
+      }
+    }
+
+    auto getRunnableModule=[&]() -> size_t {
+      for (size_t i=0; i<dependencies.size(); i++) {
+        if (states[i]!=ModuleState::pending) {
+          continue;
+        }
+
+        if (std::all_of(dependencies[i].begin(),dependencies[i].end(),[&states](size_t dependency) {
+          return states[dependency]==ModuleState::finished;
+        })) {
+          return i;
+        }
+      }
+
+      return dependencies.size();
+    };
+
+    auto hasPendingModules=[&]() -> bool {
+      return std::any_of(states.begin(),states.end(),[](ModuleState state) {
+        return state==ModuleState::pending;
+      });
+    };
+
+    auto worker=[&]() {
+      std::unique_lock<std::mutex> lock(stateMutex);
+
+      while (!failed && hasPendingModules()) {
+        size_t index=getRunnableModule();
+
+        if (index==dependencies.size() ||
+            (runningCount>0 && !canStartModule())) {
+          // Wake up regularly, since canStartModule() may change without notification
+          stateChanged.wait_for(lock,std::chrono::seconds(1));
+          continue;
+        }
+
+        states[index]=ModuleState::running;
+        runningCount++;
+
+        lock.unlock();
+
+        bool success=executeModule(index);
+
+        lock.lock();
+
+        states[index]=ModuleState::finished;
+        finishedModules[index]=true;
+        runningCount--;
+
+        if (!success ||
+            !finishedModule(index)) {
+          failed=true;
+        }
+
+        stateChanged.notify_all();
+      }
+    };
+
+    std::vector<std::thread> workers;
+
+    for (size_t i=0; i<std::max(threadCount,(size_t)1); i++) {
+      workers.emplace_back(worker);
+    }
+
+    for (auto& thread : workers) {
+      thread.join();
+    }
+
+    return !failed;
+  }
+
+  /**
+   * Execute independent modules in parallel using up to parameter.GetParallelModules()
+   * worker threads (see ExecuteModulesInDependencyOrder()).
+   *
+   * If a memory limit is given, no further module is started while the resident memory
+   * of the process exceeds the limit. A single module is always allowed to run.
+   */
+  bool Importer::ExecuteModulesParallel(const TypeConfigRef& typeConfig,
+                                        ImportProgress& progress,
+                                        std::mutex& progressMutex)
+  {
+    std::vector<std::set<size_t>> dependencies;
+    std::vector<bool>             finishedModules(modules.size(),false);
+
+    GetModuleDependencies(moduleDescriptions,
+                          dependencies);
+
+    // Steps outside of the requested range count as already executed
+    for (size_t i=0; i<modules.size(); i++) {
+      size_t step=i+1;
+
+      if (step<parameter.GetStartStep() ||
+          step>parameter.GetEndStep()) {
+        finishedModules[i]=true;
+      }
+    }
+
+    auto isMemoryAvailable=[this]() -> bool {
+      if (parameter.GetParallelModulesMemoryLimit()==0) {
+        return true;
+      }
+
+      double vmUsage;
+      double residentSet;
+
+      MemoryMonitor::GetCurrentValue(vmUsage,
+                                     residentSet);
+
+      return residentSet<(double)parameter.GetParallelModulesMemoryLimit();
+    };
+
+    auto executeModule=[&](size_t index) -> bool {
+      size_t                  currentStep=index+1;
+      ImportModuleDescription moduleDescription;
+      bool                    success;
+
+      modules[index]->GetDescription(parameter,
+                                     moduleDescription);
+
+      {
+        std::scoped_lock<std::mutex> progressLock(progressMutex);
+
+        progress.StartModule(currentStep, moduleDescription);
+      }
+
+      ForwardingProgress moduleProgress(progress,
+                                        progressMutex,
+                                        "["+moduleDescription.GetName()+"] ");
+
+      success=modules[index]->Import(typeConfig,
+                                     parameter,
+                                     moduleProgress);
+
+      std::scoped_lock<std::mutex> progressLock(progressMutex);
+
+      progress.FinishedModule(currentStep);
+
+      if (!success) {
+        progress.Error("Error while executing step '"+moduleDescription.GetName()+"'!");
+      }
+
+      return success;
+    };
+
+    auto finishedModule=[&](size_t index) -> bool {
+      if (!parameter.IsEco()) {
+        return true;
+      }
+
+      ForwardingProgress moduleProgress(progress,
+                                        progressMutex,
+                                        "["+moduleDescriptions[index].GetName()+"] ");
+
+      return CleanupTemporaries(index+1,
+                                finishedModules,
+                                moduleProgress);
+    };
+
+    return ExecuteModulesInDependencyOrder(dependencies,
+                                           finishedModules,
+                                           parameter.GetParallelModules(),
+                                           isMemoryAvailable,
+                                           executeModule,
+                                           finishedModule);
+  }
+
+  bool Importer::ExecuteModules(const TypeConfigRef& typeConfig,
+                                ImportProgress& progress,
+                                std::mutex& progressMutex)
+  {
+    if (parameter.GetParallelModules()<=1) {
+      return ExecuteModulesSequential(typeConfig,
+                                      progress);
+    }
+
+    return ExecuteModulesParallel(typeConfig,
+                                  progress,
+                                  progressMutex);
+  }
+
   bool Importer::Import(ImportProgress& progress)
   {
 #if defined(HAVE_STD_EXECUTION) && defined(TBB_HAS_SCHEDULER_INIT)
@@ -394,14 +797,20 @@ namespace osmscout {
       langIndex+=3;
     }
 
-    ImportErrorReporterRef errorReporter=std::make_shared<ImportErrorReporter>(progress,
+    // Modules executed in parallel report errors concurrently
+    std::mutex             progressMutex;
+    ForwardingProgress     errorProgress(progress,
+                                         progressMutex,
+                                         "");
+    ImportErrorReporterRef errorReporter=std::make_shared<ImportErrorReporter>(errorProgress,
                                                                                typeConfig,
                                                                                parameter.GetDestinationDirectory());
 
     parameter.SetErrorReporter(errorReporter);
 
     bool result=ExecuteModules(typeConfig,
-                               progress);
+                               progress,
+                               progressMutex);
 
     parameter.GetErrorReporter()->FinishedImport();
     progress.FinishedImport();
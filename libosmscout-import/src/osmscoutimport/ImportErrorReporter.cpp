@@ -236,6 +236,8 @@ namespace osmscout {
   void ImportErrorReporter::ReportLocationDebug(const ObjectFileRef& object,
                                                 const std::string& error)
   {
+    std::unique_lock <std::mutex> lock(mutex);
+
     progress.Debug(object.GetName()+" - "+error);
 
     errors.emplace_back(reportLocation,object,error);
@@ -244,6 +246,8 @@ namespace osmscout {
   void ImportErrorReporter::ReportLocation(const ObjectFileRef& object,
                                            const std::string& error)
   {
+    std::unique_lock <std::mutex> lock(mutex);
+
     progress.Warning(object.GetName()+" - "+error);
 
     errors.emplace_back(reportLocation,object,error);
@@ -28,9 +28,9 @@ namespace osmscout {
 
 static const size_t defaultStartStep=1;
 #if defined(OSMSCOUT_IMPORT_HAVE_LIB_MARISA)
-static const size_t defaultEndStep=28;
+static const size_t defaultEndStep=29;
 #else
-static const size_t defaultEndStep=27;
+static const size_t defaultEndStep=28;
 #endif
 
 size_t ImportParameter::GetDefaultStartStep()
@@ -57,9 +57,12 @@ ImportParameter::ImportParameter()
       startStep(defaultStartStep),
       endStep(defaultEndStep),
       eco(false),
+      parallelModules(1),
+      parallelModulesMemoryLimit(0),
       strictAreas(false),
       sortObjects(true),
       sortBlockSize(40000000),
+      sortMemoryLimit(1024*1024*1024),
       sortTileMag(14),
       processingQueueSize(std::max((unsigned int)1,std::thread::hardware_concurrency())),
       numericIndexPageSize(1024),
@@ -69,6 +72,7 @@ ImportParameter::ImportParameter()
       rawWayDataMemoryMaped(false),
       rawWayIndexCacheSize(10000),
       rawWayBlockSize(500000),
+      denseCoordData(false),
       coordDataMemoryMaped(false),
       coordIndexCacheSize(1000000),
       coordBlockSize(250000),
@@ -99,6 +103,7 @@ ImportParameter::ImportParameter()
       optimizationWayMethod(TransPolygon::quality),
       routeNodeBlockSize(500000),
       routeNodeTileMag(13),
+      routerContractionHierarchy(false),
       assumeLand(AssumeLandStrategy::automatic),
       langOrder({"#"}),
       maxAdminLevel(10),
@@ -153,6 +158,16 @@ bool ImportParameter::IsEco() const
   return eco;
 }
 
+size_t ImportParameter::GetParallelModules() const
+{
+  return parallelModules;
+}
+
+size_t ImportParameter::GetParallelModulesMemoryLimit() const
+{
+  return parallelModulesMemoryLimit;
+}
+
 const std::list<ImportParameter::Router>& ImportParameter::GetRouter() const
 {
   return router;
@@ -168,11 +183,20 @@ bool ImportParameter::GetSortObjects() const
   return sortObjects;
 }
 
+/**
+ * Deprecated, the value is not used anymore. The memory used for sorting is
+ * limited by GetSortMemoryLimit().
+ */
 size_t ImportParameter::GetSortBlockSize() const
 {
   return sortBlockSize;
 }
 
+size_t ImportParameter::GetSortMemoryLimit() const
+{
+  return sortMemoryLimit;
+}
+
 size_t ImportParameter::GetSortTileMag() const
 {
   return sortTileMag;
@@ -218,6 +242,11 @@ size_t ImportParameter::GetRawWayBlockSize() const
   return rawWayBlockSize;
 }
 
+bool ImportParameter::GetDenseCoordData() const
+{
+  return denseCoordData;
+}
+
 bool ImportParameter::GetCoordDataMemoryMaped() const
 {
   return coordDataMemoryMaped;
@@ -368,6 +397,11 @@ uint32_t ImportParameter::GetRouteNodeTileMag() const
   return routeNodeTileMag;
 }
 
+bool ImportParameter::GetRouterContractionHierarchy() const
+{
+  return routerContractionHierarchy;
+}
+
 ImportParameter::AssumeLandStrategy ImportParameter::GetAssumeLand() const
 {
   return assumeLand;
@@ -435,6 +469,16 @@ void ImportParameter::SetEco(bool eco)
   this->eco=eco;
 }
 
+void ImportParameter::SetParallelModules(size_t parallelModules)
+{
+  this->parallelModules=parallelModules;
+}
+
+void ImportParameter::SetParallelModulesMemoryLimit(size_t parallelModulesMemoryLimit)
+{
+  this->parallelModulesMemoryLimit=parallelModulesMemoryLimit;
+}
+
 void ImportParameter::ClearRouter()
 {
   router.clear();
@@ -455,11 +499,20 @@ void ImportParameter::SetSortObjects(bool renumberIds)
   this->sortObjects=renumberIds;
 }
 
+/**
+ * Deprecated, the value is not used anymore. Use SetSortMemoryLimit() to limit
+ * the memory used for sorting.
+ */
 void ImportParameter::SetSortBlockSize(size_t sortBlockSize)
 {
   this->sortBlockSize=sortBlockSize;
 }
 
+void ImportParameter::SetSortMemoryLimit(size_t sortMemoryLimit)
+{
+  this->sortMemoryLimit=sortMemoryLimit;
+}
+
 void ImportParameter::SetSortTileMag(size_t sortTileMag)
 {
   this->sortTileMag=sortTileMag;
@@ -505,6 +558,11 @@ void ImportParameter::SetRawWayBlockSize(size_t blockSize)
   this->rawWayBlockSize=blockSize;
 }
 
+void ImportParameter::SetDenseCoordData(bool denseCoordData)
+{
+  this->denseCoordData=denseCoordData;
+}
+
 void ImportParameter::SetCoordDataMemoryMaped(bool memoryMaped)
 {
   this->coordDataMemoryMaped=memoryMaped;
@@ -662,6 +720,11 @@ void ImportParameter::SetRouteNodeTileMag(uint32_t routeNodeTileMag)
   this->routeNodeTileMag=routeNodeTileMag;
 }
 
+void ImportParameter::SetRouterContractionHierarchy(bool routerContractionHierarchy)
+{
+  this->routerContractionHierarchy=routerContractionHierarchy;
+}
+
 void ImportParameter::SetAssumeLand(AssumeLandStrategy assumeLand)
 {
   this->assumeLand=assumeLand;
@@ -68,6 +68,15 @@ void ImportProgress::FinishedModule()
 
 }
 
+/**
+ * Called if the module of the given step has finished. Modules may finish in
+ * a different order than they were started, if modules are executed in parallel.
+ */
+void ImportProgress::FinishedModule(size_t /*currentStep*/)
+{
+  FinishedModule();
+}
+
 void StatImportProgress::StartImport(const ImportParameter &param)
 {
   destinationDirectory=param.GetDestinationDirectory();
@@ -76,6 +85,7 @@ void StatImportProgress::StartImport(const ImportParameter &param)
   maxVMUsage=0.0;
   maxResidentSet=0.0;
   moduleStats.clear();
+  runningModules.clear();
 }
 
 void StatImportProgress::FinishedImport()
@@ -93,14 +103,29 @@ void StatImportProgress::FinishedImport()
 void StatImportProgress::StartModule(size_t currentStep, const ImportModuleDescription& moduleDescription)
 {
   ImportProgress::StartModule(currentStep, moduleDescription);
-  timer=StopClock();
-  currentModule=moduleDescription;
+  runningModules.erase(currentStep);
+  runningModules[currentStep].description=moduleDescription;
 }
 
 void StatImportProgress::FinishedModule()
 {
-  double vmUsage;
-  double residentSet;
+  if (!runningModules.empty()) {
+    FinishedModule(runningModules.rbegin()->first);
+  }
+}
+
+void StatImportProgress::FinishedModule(size_t currentStep)
+{
+  auto runningModule=runningModules.find(currentStep);
+
+  if (runningModule==runningModules.end()) {
+    return;
+  }
+
+  StopClock&                     timer=runningModule->second.timer;
+  const ImportModuleDescription& currentModule=runningModule->second.description;
+  double                         vmUsage;
+  double                         residentSet;
 
   timer.Stop();
 
@@ -118,6 +143,7 @@ void StatImportProgress::FinishedModule()
   }
 
   moduleStats.emplace_back(ModuleStat{
+    currentStep,
     currentModule,
     timer.GetDuration(),
     vmUsage,
@@ -136,6 +162,8 @@ void StatImportProgress::FinishedModule()
   addFileStat(currentModule.GetProvidedDebuggingFiles());
   addFileStat(currentModule.GetProvidedOptionalFiles());
   addFileStat(currentModule.GetProvidedTemporaryFiles());
+
+  runningModules.erase(runningModule);
 }
 
 std::ostream& operator<<(std::ostream& stream, const std::chrono::steady_clock::duration &d)
@@ -195,13 +223,12 @@ bool StatImportProgress::DumpDotStats(const std::string &filename)
     }
   };
 
-  size_t currentStep=1;
   for (const auto &moduleStat: moduleStats){
     out << "  " << moduleStat.description.GetName() << " [color=\"#b2ab9c\"," << std::endl
         << "    fillcolor=\"#edecea\"," << std::endl
         << "    fontsize=14," << std::endl
         << "    height=1.1528," << std::endl
-        << "    label=<" << "<b>Step #" << currentStep << " - " <<  moduleStat.description.GetName() << "</b><br/>"
+        << "    label=<" << "<b>Step #" << moduleStat.step << " - " <<  moduleStat.description.GetName() << "</b><br/>"
                          << "<i>" << moduleStat.description.GetDescription() << "</i><br/>"
                          << moduleStat.duration << " s; " << ByteSizeToString(moduleStat.residentSet) << " RSS"
                          << ">," << std::endl
@@ -219,8 +246,6 @@ bool StatImportProgress::DumpDotStats(const std::string &filename)
     for (const std::string &f : moduleStat.description.GetRequiredFiles()){
       out << "  " << fileToId(f) << " -> " << moduleStat.description.GetName() << std::endl;
     }
-
-    currentStep++;
   }
 
 
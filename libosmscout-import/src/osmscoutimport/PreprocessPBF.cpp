@@ -39,6 +39,18 @@
   #include <zlib.h>
 #endif
 
+#if defined(HAVE_LIB_ZSTD)
+  #include <zstd.h>
+#endif
+
+#if defined(HAVE_LIB_LZ4)
+  #include <lz4.h>
+#endif
+
+#include <deque>
+#include <exception>
+#include <thread>
+
 #include <osmscout/util/File.h>
 #include <osmscout/util/String.h>
 
@@ -121,7 +133,6 @@ namespace osmscout {
 
     if (fread(buffer,sizeof(char),length,file)!=length) {
       progress.Error("Cannot read block header!");
-      delete[] buffer;
       return false;
     }
 
@@ -133,154 +144,166 @@ namespace osmscout {
     return true;
   }
 
-  bool PreprocessPBF::ReadHeaderBlock(Progress& progress,
-                                      FILE* file,
-                                      const OSMPBF::BlobHeader& blockHeader,
-                                      OSMPBF::HeaderBlock& headerBlock)
+  /**
+   * Read the (still encoded) blob following the given block header
+   */
+  bool PreprocessPBF::ReadBlob(Progress& progress,
+                               FILE* file,
+                               const OSMPBF::BlobHeader& blockHeader,
+                               std::string& blobData)
   {
-    OSMPBF::Blob            blob;
     google::protobuf::int32 length=blockHeader.datasize();
 
-    if (length==0 || length>MAX_BLOB_SIZE) {
+    if (length<=0 || length>MAX_BLOB_SIZE) {
       progress.Error("Blob size invalid!");
       return false;
     }
 
-    AssureBlockSize(length);
+    blobData.resize((size_t)length);
 
-    if (fread(buffer,sizeof(char),length,file)!=(size_t)length) {
+    if (fread(blobData.data(),sizeof(char),(size_t)length,file)!=(size_t)length) {
       progress.Error("Cannot read blob!");
       return false;
     }
 
-    if (!blob.ParseFromArray(buffer,length)) {
-      progress.Error("Cannot parse blob!");
-      return false;
-    }
+    return true;
+  }
 
+  /**
+   * Decompress the content of the blob. Called from multiple decoder threads in parallel,
+   * so errors are returned and not reported directly.
+   */
+  bool PreprocessPBF::DecodeBlob(const OSMPBF::Blob& blob,
+                                 std::string& data,
+                                 std::string& error)
+  {
     if (blob.has_raw()) {
-      length=(uint32_t)blob.raw().length();
-      AssureBlockSize(length);
-      memcpy(buffer,blob.raw().data(),(size_t)length);
+      data=blob.raw();
+
+      return true;
     }
-    else if (blob.has_zlib_data()) {
-#if defined(HAVE_LIB_ZLIB) || defined(OSMSCOUT_IMPORT_HAVE_PROTOBUF_SUPPORT)
-      length=blob.raw_size();
-      AssureBlockSize(length);
 
+    if (blob.raw_size()<0 || blob.raw_size()>MAX_BLOB_SIZE) {
+      error="Uncompressed blob size invalid!";
+      return false;
+    }
+
+    data.resize((size_t)blob.raw_size());
+
+    if (blob.has_zlib_data()) {
+#if defined(HAVE_LIB_ZLIB) || defined(OSMSCOUT_IMPORT_HAVE_PROTOBUF_SUPPORT)
       z_stream compressedStream;
 
       compressedStream.next_in=(Bytef*)const_cast<char*>(blob.zlib_data().data());
       compressedStream.avail_in=(uint32_t)blob.zlib_data().size();
-      compressedStream.next_out=(Bytef*)buffer;
-      compressedStream.avail_out=(uInt)length;
+      compressedStream.next_out=(Bytef*)data.data();
+      compressedStream.avail_out=(uInt)data.size();
       compressedStream.zalloc=Z_NULL;
       compressedStream.zfree=Z_NULL;
       compressedStream.opaque=Z_NULL;
 
       if (inflateInit( &compressedStream)!=Z_OK) {
-        progress.Error("Cannot decode zlib compressed blob data!");
+        error="Cannot decode zlib compressed blob data!";
         return false;
       }
 
       if (inflate(&compressedStream,Z_FINISH)!=Z_STREAM_END) {
-        progress.Error("Cannot decode zlib compressed blob data!");
+        inflateEnd(&compressedStream);
+        error="Cannot decode zlib compressed blob data!";
         return false;
       }
 
       if (inflateEnd(&compressedStream)!=Z_OK) {
-        progress.Error("Cannot decode zlib compressed blob data!");
+        error="Cannot decode zlib compressed blob data!";
         return false;
       }
+
+      return true;
 #else
-      progress.Error("Data is zlib encoded but zlib support is not enabled!");
+      error="Data is zlib encoded but zlib support is not enabled!";
       return false;
 #endif
     }
-    else if (blob.has_lzma_data()) {
-      progress.Error("Data is lzma encoded but lzma support is not enabled!");
-      return false;
-    }
-
-    if (!headerBlock.ParseFromArray(buffer,length)) {
-      progress.Error("Cannot parse header block!");
-      return false;
-    }
 
-    return true;
-  }
+    if (blob.has_zstd_data()) {
+#if defined(HAVE_LIB_ZSTD)
+      size_t size=ZSTD_decompress(data.data(),
+                                  data.size(),
+                                  blob.zstd_data().data(),
+                                  blob.zstd_data().size());
 
-  bool PreprocessPBF::ReadPrimitiveBlock(Progress& progress,
-                                         FILE* file,
-                                         const OSMPBF::BlobHeader& blockHeader,
-                                         OSMPBF::PrimitiveBlock& primitiveBlock)
-  {
-    OSMPBF::Blob            blob;
-    google::protobuf::int32 length=blockHeader.datasize();
+      if (ZSTD_isError(size) || size!=data.size()) {
+        error="Cannot decode zstd compressed blob data!";
+        return false;
+      }
 
-    if (length==0 || length>MAX_BLOB_SIZE) {
-      progress.Error("Blob size invalid!");
+      return true;
+#else
+      error="Data is zstd encoded but zstd support is not enabled!";
       return false;
+#endif
     }
 
-    AssureBlockSize(length);
+    if (blob.has_lz4_data()) {
+#if defined(HAVE_LIB_LZ4)
+      int size=LZ4_decompress_safe(blob.lz4_data().data(),
+                                   data.data(),
+                                   (int)blob.lz4_data().size(),
+                                   (int)data.size());
 
-    if (fread(buffer,sizeof(char),length,file)!=(size_t)length) {
-      progress.Error("Cannot read blob!");
-      return false;
-    }
+      if (size<0 || (size_t)size!=data.size()) {
+        error="Cannot decode lz4 compressed blob data!";
+        return false;
+      }
 
-    if (!blob.ParseFromArray(buffer,length)) {
-      progress.Error("Cannot parse blob!");
+      return true;
+#else
+      error="Data is lz4 encoded but lz4 support is not enabled!";
       return false;
+#endif
     }
 
-    if (blob.has_raw()) {
-      length=(uint32_t)blob.raw().length();
-      AssureBlockSize(length);
-      memcpy(buffer,blob.raw().data(),(size_t)length);
+    if (blob.has_lzma_data()) {
+      error="Data is lzma encoded but lzma support is not enabled!";
+      return false;
     }
-    else if (blob.has_zlib_data()) {
-#if defined(HAVE_LIB_ZLIB) || defined(OSMSCOUT_IMPORT_HAVE_PROTOBUF_SUPPORT)
-      length=blob.raw_size();
-      AssureBlockSize(length);
-
-      z_stream compressedStream;
 
-      compressedStream.next_in=(Bytef*)const_cast<char*>(blob.zlib_data().data());
-      compressedStream.avail_in=(uint32_t)blob.zlib_data().size();
-      compressedStream.next_out=(Bytef*)buffer;
-      compressedStream.avail_out=(uInt)length;
-      compressedStream.zalloc=Z_NULL;
-      compressedStream.zfree=Z_NULL;
-      compressedStream.opaque=Z_NULL;
+    error="Blob does not contain any supported data!";
 
-      if (inflateInit( &compressedStream)!=Z_OK) {
-        progress.Error("Cannot decode zlib compressed blob data!");
-        return false;
-      }
+    return false;
+  }
 
-      if (inflate(&compressedStream,Z_FINISH)!=Z_STREAM_END) {
-        progress.Error("Cannot decode zlib compressed blob data!");
-        return false;
-      }
+  bool PreprocessPBF::ReadHeaderBlock(Progress& progress,
+                                      FILE* file,
+                                      const OSMPBF::BlobHeader& blockHeader,
+                                      OSMPBF::HeaderBlock& headerBlock)
+  {
+    std::string  blobData;
+    OSMPBF::Blob blob;
+    std::string  data;
+    std::string  error;
+
+    if (!ReadBlob(progress,
+                  file,
+                  blockHeader,
+                  blobData)) {
+      return false;
+    }
 
-      if (inflateEnd(&compressedStream)!=Z_OK) {
-        progress.Error("Cannot decode zlib compressed blob data!");
-        return false;
-      }
-#else
-      progress.Error("Data is zlib encoded but zlib support is not enabled!");
+    if (!blob.ParseFromString(blobData)) {
+      progress.Error("Cannot parse blob!");
       return false;
-#endif
     }
-    else if (blob.has_lzma_data()) {
-      progress.Error("Data is lzma encoded but lzma support is not enabled!");
+
+    if (!DecodeBlob(blob,
+                    data,
+                    error)) {
+      progress.Error(error);
       return false;
     }
 
-    if (!primitiveBlock.ParseFromArray(buffer,length)) {
-      progress.Error("Cannot parse primitive block!");
+    if (!headerBlock.ParseFromString(data)) {
+      progress.Error("Cannot parse header block!");
       return false;
     }
 
@@ -303,8 +326,6 @@ namespace osmscout {
       nodeData.coord.Set((inputNode.lat()*block.granularity()+block.lat_offset())/NANO,
                          (inputNode.lon()*block.granularity()+block.lon_offset())/NANO);
 
-      tagMap.clear();
-
       for (int t=0; t<inputNode.keys_size(); t++) {
         TagId id=typeConfig.GetTagId(block.stringtable().s(inputNode.keys(t)));
 
@@ -413,8 +434,6 @@ namespace osmscout {
 
       relationData.id=inputRelation.id();
 
-      members.clear();
-
       for (int t=0; t<inputRelation.keys_size(); t++) {
         TagId id=typeConfig.GetTagId(block.stringtable().s(inputRelation.keys(t)));
 
@@ -466,52 +485,195 @@ namespace osmscout {
     delete[] buffer;
   }
 
-  void PreprocessPBF::ProcessBlock(const TypeConfigRef& typeConfig,
-                                   std::unique_ptr<OSMPBF::PrimitiveBlock>&& block)
+  /**
+   * Decode the given blob into raw block data. Executed by the decoder threads,
+   * errors are signaled by an IOException.
+   */
+  PreprocessorCallback::RawBlockDataRef PreprocessPBF::DecodeBlock(const TypeConfig& typeConfig,
+                                                                   const std::string& filename,
+                                                                   const std::string& blobData)
   {
-    PreprocessorCallback::RawBlockDataRef blockData(new PreprocessorCallback::RawBlockData());
+    OSMPBF::Blob           blob;
+    std::string            data;
+    std::string            error;
+    OSMPBF::PrimitiveBlock block;
+
+    if (!blob.ParseFromString(blobData)) {
+      throw IOException(filename,"Cannot decode data block","Cannot parse blob");
+    }
+
+    if (!DecodeBlob(blob,
+                    data,
+                    error)) {
+      throw IOException(filename,"Cannot decode data block",error);
+    }
+
+    if (!block.ParseFromString(data)) {
+      throw IOException(filename,"Cannot decode data block","Cannot parse primitive block");
+    }
+
+    PreprocessorCallback::RawBlockDataRef blockData=std::make_shared<PreprocessorCallback::RawBlockData>();
 
     for (int currentGroup=0;
-         currentGroup<block->primitivegroup_size();
+         currentGroup<block.primitivegroup_size();
          currentGroup++) {
-      const OSMPBF::PrimitiveGroup &group=block->primitivegroup(currentGroup);
+      const OSMPBF::PrimitiveGroup &group=block.primitivegroup(currentGroup);
 
       if (group.nodes_size()>0) {
-        ReadNodes(*typeConfig,
-                  *block,
+        ReadNodes(typeConfig,
+                  block,
                   group,
                   *blockData);
       }
       else if (group.has_dense()) {
-        ReadDenseNodes(*typeConfig,
-                       *block,
+        ReadDenseNodes(typeConfig,
+                       block,
                        group,
                        *blockData);
       }
       else if (group.ways_size()>0) {
-        ReadWays(*typeConfig,
-                 *block,
+        ReadWays(typeConfig,
+                 block,
                  group,
                  *blockData);
       }
       else if (group.relations_size()>0) {
-        ReadRelations(*typeConfig,
-                      *block,
+        ReadRelations(typeConfig,
+                      block,
                       group,
                       *blockData);
       }
     }
 
-    callback.ProcessBlock(std::move(blockData));
+    return blockData;
+  }
+
+  void PreprocessPBF::DecodeWorkerLoop(DecodeQueue& queue)
+  {
+    std::packaged_task<PreprocessorCallback::RawBlockDataRef()> task;
+
+    while (queue.PopTask(task)) {
+      task();
+    }
+  }
+
+  /**
+   * Read all data blocks of the file and pass them to the decoder threads. Decoded
+   * blocks are handed to the callback in file order. The number of blocks in flight
+   * is limited by the processing queue size.
+   */
+  bool PreprocessPBF::ReadDataBlocks(const TypeConfigRef& typeConfig,
+                                     const ImportParameter& parameter,
+                                     Progress& progress,
+                                     const std::string& filename,
+                                     FILE* file,
+                                     FileOffset fileSize)
+  {
+    size_t                                                    decodeWorkerCount=std::max((unsigned int)1,std::thread::hardware_concurrency());
+    size_t                                                    maxPendingBlocks=decodeWorkerCount+parameter.GetProcessingQueueSize();
+    DecodeQueue                                               decodeQueue(parameter.GetProcessingQueueSize());
+    std::vector<std::thread>                                  decodeWorkers;
+    std::deque<std::future<PreprocessorCallback::RawBlockDataRef>> pendingBlocks;
+    bool                                                      success=true;
+    std::exception_ptr                                        exception;
+
+    progress.Info("Using "+std::to_string(decodeWorkerCount)+" decoder threads");
+
+    for (size_t t=1; t<=decodeWorkerCount; t++) {
+      decodeWorkers.emplace_back(&PreprocessPBF::DecodeWorkerLoop,
+                                 std::ref(decodeQueue));
+    }
+
+    try {
+      while (true) {
+        OSMPBF::BlobHeader blockHeader;
+        FileOffset         currentPosition;
+
+        if (!GetPos(file,
+                    currentPosition)) {
+          progress.Error("Cannot read current position in '"+filename+"'!");
+          success=false;
+          break;
+        }
+
+        progress.SetProgress(currentPosition,
+                             fileSize);
+
+        if (!ReadBlockHeader(progress,
+                             file,
+                             blockHeader,
+                             true)) {
+          break;
+        }
+
+        if (blockHeader.type()!="OSMData") {
+          progress.Error("File '"+filename+"' is not valid (block header type is '"+blockHeader.type()+"' and not 'OSMData')!");
+          success=false;
+          break;
+        }
+
+        std::string blobData;
+
+        if (!ReadBlob(progress,
+                      file,
+                      blockHeader,
+                      blobData)) {
+          success=false;
+          break;
+        }
+
+        std::packaged_task<PreprocessorCallback::RawBlockDataRef()> task([&typeConfig,&filename,data=std::move(blobData)]() {
+          return DecodeBlock(*typeConfig,
+                             filename,
+                             data);
+        });
+
+        pendingBlocks.push_back(task.get_future());
+        decodeQueue.PushTask(task);
+
+        // Pass already decoded blocks (or if too many blocks are pending, the oldest block) to the callback
+        while (!pendingBlocks.empty() &&
+               (pendingBlocks.size()>maxPendingBlocks ||
+                pendingBlocks.front().wait_for(std::chrono::seconds(0))==std::future_status::ready)) {
+          callback.ProcessBlock(pendingBlocks.front().get());
+          pendingBlocks.pop_front();
+        }
+      }
+
+      while (success &&
+             !pendingBlocks.empty()) {
+        callback.ProcessBlock(pendingBlocks.front().get());
+        pendingBlocks.pop_front();
+      }
+    }
+    catch (IOException& e) {
+      progress.Error(e.GetDescription());
+      success=false;
+    }
+    catch (std::exception&) {
+      // The decoder threads must be joined before the exception leaves this method
+      exception=std::current_exception();
+    }
+
+    decodeQueue.Stop();
+
+    for (auto& thread : decodeWorkers) {
+      thread.join();
+    }
+
+    if (exception) {
+      std::rethrow_exception(exception);
+    }
+
+    return success;
   }
 
   bool PreprocessPBF::Import(const TypeConfigRef& typeConfig,
-                             const ImportParameter& /*parameter*/,
+                             const ImportParameter& parameter,
                              Progress& progress,
                              const std::string& filename)
   {
     FileOffset fileSize;
-    FileOffset currentPosition;
 
     progress.SetAction(std::string("Parsing *.osm.pbf file '")+filename+"'");
 
@@ -565,68 +727,20 @@ namespace osmscout {
         }
       }
 
-      nodes.reserve(20000);
-      members.reserve(2000);
-
-      std::future<void> currentBlockTask;
-
-      while (true) {
-        OSMPBF::BlobHeader blockHeader;
-
-        if (!GetPos(file,
-                    currentPosition)) {
-          progress.Error("Cannot read current position in '"+filename+"'!");
-          fclose(file);
-          return false;
-        }
-
-        progress.SetProgress(currentPosition,
-                             fileSize);
-
-        if (!ReadBlockHeader(progress,
-                             file,
-                             blockHeader,
-                             true)) {
-          fclose(file);
-          break;
-        }
-
-        if (blockHeader.type()!="OSMData") {
-          progress.Error("File '"+filename+"' is not valid (block header type is '"+blockHeader.type()+"' and not 'OSMData')!");
-          fclose(file);
-          return false;
-        }
+      bool success=ReadDataBlocks(typeConfig,
+                                  parameter,
+                                  progress,
+                                  filename,
+                                  file,
+                                  fileSize);
 
-        std::unique_ptr<OSMPBF::PrimitiveBlock> block(new OSMPBF::PrimitiveBlock());
+      fclose(file);
 
-        if (!ReadPrimitiveBlock(progress,
-                                file,
-                                blockHeader,
-                                *block)) {
-          fclose(file);
-          return false;
-        }
-
-        if (currentBlockTask.valid()) {
-          currentBlockTask.get();
-        }
-
-        currentBlockTask=std::async(std::launch::async,
-                                    &PreprocessPBF::ProcessBlock,this,
-                                    typeConfig,
-                                    std::move(block));
-      }
-
-      if (currentBlockTask.valid()) {
-        currentBlockTask.get();
-      }
+      return success;
     }
     catch (IOException& e) {
       progress.Error(e.GetDescription());
       return false;
     }
-
-    return true;
   }
 }
-
@@ -39,6 +39,7 @@
 #include <osmscoutmapcairo/MapCairoImportExport.h>
 
 #include <osmscoutmap/MapPainter.h>
+#include <osmscoutmap/TextLayoutCache.h>
 
 
 namespace osmscout {
@@ -59,7 +60,7 @@ namespace osmscout {
     using CairoFont = cairo_scaled_font_t*;
     struct CairoNativeLabel {
       std::wstring          wstr;
-      CairoFont             font;
+      std::shared_ptr<cairo_scaled_font_t> font; //!< Own reference, the label may outlive the painter
       cairo_text_extents_t  textExtents;
       cairo_font_extents_t  fontExtents;
     };
@@ -77,6 +78,8 @@ namespace osmscout {
     using CairoLabelInstance = LabelInstance<CairoNativeGlyph, CairoNativeLabel>;
     using CairoLabelLayouter = LabelLayouter<CairoNativeGlyph, CairoNativeLabel, MapPainterCairo>;
     friend CairoLabelLayouter;
+    using CairoTextLayoutCache = TextLayoutCache<CairoNativeGlyph, CairoNativeLabel>;
+    using CairoTextLayoutCacheRef = std::shared_ptr<CairoTextLayoutCache>;
 
   private:
     CairoLabelLayouter labelLayouter;
@@ -88,6 +91,7 @@ namespace osmscout {
     std::vector<cairo_surface_t*>          patternImages;    //! vector of cairo surfaces for patterns
     std::vector<cairo_pattern_t*>          patterns;         //! cairo pattern structure for patterns
     FontMap                                fonts;            //! Cached scaled font
+    CairoTextLayoutCacheRef                textLayoutCache;  //! Cached label layouts, possibly shared with other painters
     double                                 minimumLineWidth; //! Minimum width a line must have to be visible
 
     std::mutex                             mutex;            //! Mutex for locking concurrent calls
@@ -203,6 +207,13 @@ namespace osmscout {
     explicit MapPainterCairo(const StyleConfigRef& styleConfig);
     ~MapPainterCairo() override;
 
+    void SetTextLayoutCache(const CairoTextLayoutCacheRef& textLayoutCache);
+
+    CairoTextLayoutCacheRef GetTextLayoutCache() const
+    {
+      return textLayoutCache;
+    }
+
 
     bool DrawMap(const Projection& projection,
                  const MapParameter& parameter,
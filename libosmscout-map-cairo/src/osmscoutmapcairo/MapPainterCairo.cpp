@@ -262,7 +262,8 @@ namespace osmscout {
 
   MapPainterCairo::MapPainterCairo(const StyleConfigRef &styleConfig)
       : MapPainter(styleConfig),
-        labelLayouter(this)
+        labelLayouter(this),
+        textLayoutCache(std::make_shared<CairoTextLayoutCache>())
   {
     // no code
   }
@@ -298,6 +299,19 @@ namespace osmscout {
     }
   }
 
+  /**
+   * Use the given cache for label layouts. The cache may be shared between
+   * multiple painters (for example of parallel tile renderers). The layout
+   * of a label only depends on the properties of the context it was laid out
+   * for, so it is reused for all contexts with the same properties.
+   */
+  void MapPainterCairo::SetTextLayoutCache(const CairoTextLayoutCacheRef& textLayoutCache)
+  {
+    assert(textLayoutCache);
+
+    this->textLayoutCache=textLayoutCache;
+  }
+
   MapPainterCairo::CairoFont MapPainterCairo::GetFont(const Projection &projection,
                                                       const MapParameter &parameter,
                                                       double fontSize)
@@ -744,9 +758,39 @@ namespace osmscout {
                                                                        double fontSize,
                                                                        double objectWidth,
                                                                        bool enableWrapping,
-                                                                       bool /*contourLabel*/)
+                                                                       bool contourLabel)
   {
-    auto label = std::make_shared<MapPainterCairo::CairoLabel>(
+    int proposedWidth=(int)std::ceil(objectWidth);
+
+    TextLayoutKey key;
+
+    // The Pango context of the layout takes the font options from the context and its target
+    cairo_font_options_t *fontOptions=cairo_font_options_create();
+    cairo_font_options_t *contextFontOptions=cairo_font_options_create();
+
+    cairo_surface_get_font_options(cairo_get_target(draw),fontOptions);
+    cairo_get_font_options(draw,contextFontOptions);
+    cairo_font_options_merge(fontOptions,contextFontOptions);
+
+    key.deviceType=cairo_surface_get_type(cairo_get_target(draw));
+    key.fontOptions=cairo_font_options_hash(fontOptions);
+    key.text=text;
+    key.fontName=parameter.GetFontName();
+    key.fontSize=fontSize*projection.ConvertWidthToPixel(parameter.GetFontSize());
+    key.proposedWidth=proposedWidth;
+    key.enableWrapping=enableWrapping;
+    key.contourLabel=contourLabel;
+
+    cairo_font_options_destroy(contextFontOptions);
+    cairo_font_options_destroy(fontOptions);
+
+    std::shared_ptr<MapPainterCairo::CairoLabel> label=textLayoutCache->Get(key);
+
+    if (label) {
+      return label;
+    }
+
+    label = std::make_shared<MapPainterCairo::CairoLabel>(
         std::shared_ptr<PangoLayout>(pango_cairo_create_layout(draw), g_object_unref));
 
     CairoFont font=GetFont(projection,
@@ -755,8 +799,6 @@ namespace osmscout {
 
     pango_layout_set_font_description(label->label.get(),font);
 
-    int proposedWidth=(int)std::ceil(objectWidth);
-
     pango_layout_set_text(label->label.get(),
                           text.c_str(),
                           (int)text.length());
@@ -783,6 +825,8 @@ namespace osmscout {
     label->width=extends.width;
     label->height=extends.height;
 
+    textLayoutCache->Set(key,label);
+
     return label;
   }
 
@@ -867,7 +911,7 @@ namespace osmscout {
       result.back().glyph.character = WStringToUTF8String(label.wstr.substr(ch,1));
 
       cairo_text_extents_t  textExtents;
-      cairo_scaled_font_text_extents(label.font,
+      cairo_scaled_font_text_extents(label.font.get(),
                                      result.back().glyph.character.c_str(),
                                      &textExtents);
 
@@ -917,18 +961,34 @@ namespace osmscout {
                                                                        double fontSize,
                                                                        double /*objectWidth*/,
                                                                        bool /*enableWrapping*/,
-                                                                       bool /*contourLabel*/)
+                                                                       bool contourLabel)
   {
-    auto label = std::make_shared<MapPainterCairo::CairoLabel>();
+    // object width and wrapping are not supported and thus not part of the key.
+    // Fonts are created with fixed options, the layout does not depend on the context.
+    TextLayoutKey key;
+
+    key.text=text;
+    key.fontName=parameter.GetFontName();
+    key.fontSize=fontSize*projection.ConvertWidthToPixel(parameter.GetFontSize());
+    key.contourLabel=contourLabel;
+
+    std::shared_ptr<MapPainterCairo::CairoLabel> label=textLayoutCache->Get(key);
+
+    if (label) {
+      return label;
+    }
+
+    label = std::make_shared<MapPainterCairo::CairoLabel>();
 
     label->label.wstr = UTF8StringToWString(text);
 
-    label->label.font = GetFont(projection, parameter, fontSize);
+    label->label.font = std::shared_ptr<cairo_scaled_font_t>(cairo_scaled_font_reference(GetFont(projection, parameter, fontSize)),
+                                                             cairo_scaled_font_destroy);
 
-    cairo_scaled_font_extents(label->label.font,
+    cairo_scaled_font_extents(label->label.font.get(),
                               &(label->label.fontExtents));
 
-    cairo_scaled_font_text_extents(label->label.font,
+    cairo_scaled_font_text_extents(label->label.font.get(),
                                    text.c_str(),
                                    &(label->label.textExtents));
     label->text=text;
@@ -936,6 +996,8 @@ namespace osmscout {
     label->width=label->label.textExtents.width;
     label->height=label->label.fontExtents.height;
 
+    textLayoutCache->Set(key,label);
+
     return label;
   }
 
@@ -29,6 +29,7 @@
 #include <osmscoutmapqt/MapQtImportExport.h>
 
 #include <osmscoutmap/MapPainter.h>
+#include <osmscoutmap/TextLayoutCache.h>
 
 #include <QtGui/QTextLayout>
 
@@ -37,6 +38,8 @@ namespace osmscout {
   using QtGlyph = Glyph<QGlyphRun>;
   using QtLabel = Label<QGlyphRun, QTextLayout>;
   using QtLabelInstance = LabelInstance<QGlyphRun, QTextLayout>;
+  using QtTextLayoutCache = TextLayoutCache<QGlyphRun, QTextLayout>;
+  using QtTextLayoutCacheRef = std::shared_ptr<QtTextLayoutCache>;
 
   class MapPainterBatchQt;
 
@@ -90,6 +93,7 @@ namespace osmscout {
     std::vector<QImage>          patternImages; //! vector of QImage for fill patterns, index is patter id
     std::vector<QBrush>          patterns;      //! vector of QBrush for fill patterns
     QMap<FontDescriptor,QFont>   fonts;         //! Cached fonts
+    QtTextLayoutCacheRef         textLayoutCache; //! Cached label layouts, possibly shared with other painters
     std::vector<double>          sin;           //! Lookup table for sin calculation
 
     std::mutex                   mutex;         //! Mutex for locking concurrent calls
@@ -228,6 +232,13 @@ namespace osmscout {
     explicit MapPainterQt(const StyleConfigRef& styleConfig);
     ~MapPainterQt() override;
 
+    void SetTextLayoutCache(const QtTextLayoutCacheRef& textLayoutCache);
+
+    QtTextLayoutCacheRef GetTextLayoutCache() const
+    {
+      return textLayoutCache;
+    }
+
     void DrawGroundTiles(const Projection& projection,
                          const MapParameter& parameter,
                          const std::list<GroundTile>& groundTiles,
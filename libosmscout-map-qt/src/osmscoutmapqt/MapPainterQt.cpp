@@ -41,7 +41,8 @@ namespace osmscout {
   MapPainterQt::MapPainterQt(const StyleConfigRef& styleConfig)
   : MapPainter(styleConfig),
     painter(nullptr),
-    labelLayouter(this)
+    labelLayouter(this),
+    textLayoutCache(std::make_shared<QtTextLayoutCache>())
   {
     sin.resize(360*10);
 
@@ -56,6 +57,19 @@ namespace osmscout {
     // TODO: Clean up fonts
   }
 
+  /**
+   * Use the given cache for label layouts. The cache may be shared between
+   * multiple painters (for example of parallel tile renderers). The layout
+   * of a label only depends on the properties of the paint device it was laid
+   * out for, so it is reused for all paint devices with the same properties.
+   */
+  void MapPainterQt::SetTextLayoutCache(const QtTextLayoutCacheRef& textLayoutCache)
+  {
+    assert(textLayoutCache);
+
+    this->textLayoutCache=textLayoutCache;
+  }
+
   QFont MapPainterQt::GetFont(const Projection& projection,
                               const MapParameter& parameter,
                               double fontSize)
@@ -397,9 +411,8 @@ namespace osmscout {
                                                 double fontSize,
                                                 double objectWidth,
                                                 bool enableWrapping,
-                                                bool /*contourLabel*/)
+                                                bool contourLabel)
   {
-    // TODO: cache labels
     QFont font(GetFont(projection,
                        parameter,
                        fontSize));
@@ -411,11 +424,6 @@ namespace osmscout {
     QFontMetrics fontMetrics=QFontMetrics(font, painter->device());
     qreal leading=fontMetrics.leading();
 
-    std::shared_ptr<QtLabel> label=std::make_shared<QtLabel>(
-        QString::fromUtf8(text.c_str()), font, painter->device());
-
-    label->label.setCacheEnabled(true);
-
     double proposedWidth = -1;
     if (enableWrapping) {
       proposedWidth = GetProposedLabelWidth(parameter,
@@ -424,6 +432,29 @@ namespace osmscout {
                                             text.length());
     }
 
+    TextLayoutKey key;
+
+    // Font options (like antialiasing) are part of the font, the device only
+    // contributes its resolution
+    key.deviceType=painter->device()->devType();
+    key.dpi=painter->device()->logicalDpiY();
+    key.text=text;
+    key.fontName=parameter.GetFontName();
+    key.fontSize=fontSize*projection.ConvertWidthToPixel(parameter.GetFontSize());
+    key.proposedWidth=proposedWidth;
+    key.enableWrapping=enableWrapping;
+    key.contourLabel=contourLabel;
+
+    std::shared_ptr<QtLabel> label=textLayoutCache->Get(key);
+
+    if (label) {
+      return label;
+    }
+
+    label=std::make_shared<QtLabel>(QString::fromUtf8(text.c_str()), font, painter->device());
+
+    label->label.setCacheEnabled(true);
+
     // evaluate layout
     label->label.beginLayout();
     while (true) {
@@ -460,6 +491,8 @@ namespace osmscout {
     label->fontSize=fontSize;
     label->text=text;
 
+    textLayoutCache->Set(key,label);
+
     return label;
   }
 
@@ -37,12 +37,56 @@
 
 #include <osmscout/util/GeoBox.h>
 #include <osmscout/util/Magnification.h>
+#include <osmscout/util/ObjectArena.h>
 #include <osmscout/util/TileId.h>
 
 #include <osmscout/system/Assert.h>
 
 namespace osmscout {
 
+  /**
+   * \ingroup tiledcache
+   *
+   * Estimated memory footprint of the given objects in bytes, including the
+   * coordinate and segment arrays but without the feature values.
+   */
+  inline size_t GetObjectMemory(const Node& /*node*/)
+  {
+    return sizeof(Node);
+  }
+
+  inline size_t GetObjectMemory(const Way& way)
+  {
+    return sizeof(Way)+
+           way.nodes.capacity()*sizeof(Point)+
+           way.segments.capacity()*sizeof(SegmentGeoBox);
+  }
+
+  inline size_t GetObjectMemory(const Area& area)
+  {
+    size_t memory=sizeof(Area)+
+                  area.rings.capacity()*sizeof(Area::Ring);
+
+    for (const auto& ring : area.rings) {
+      memory+=ring.nodes.capacity()*sizeof(Point)+
+              ring.segments.capacity()*sizeof(SegmentGeoBox);
+    }
+
+    return memory;
+  }
+
+  inline size_t GetObjectMemory(const Route& route)
+  {
+    size_t memory=sizeof(Route)+
+                  route.segments.capacity()*sizeof(Route::Segment);
+
+    for (const auto& segment : route.segments) {
+      memory+=segment.members.capacity()*sizeof(Route::SegmentMember);
+    }
+
+    return memory;
+  }
+
   /**
    * \ingroup tiledcache
    *
@@ -52,14 +96,36 @@ namespace osmscout {
   class OSMSCOUT_MAP_API TileData
   {
   private:
-    mutable std::mutex mutex;
+    mutable std::mutex          mutex;
+
+    TypeInfoSet                 types;
+
+    std::vector<O>              prefillData;
+    std::vector<O>              data;
+
+    bool                        complete=false;
+
+    size_t                      dataMemory=0; //!< Estimated memory of the objects in data
+    std::vector<ObjectArenaRef> arenas;       //!< Arenas the loaded objects are allocated in, released with the data
+
+  private:
+    static size_t GetDataMemory(const std::vector<O>& data)
+    {
+      size_t memory=0;
 
-    TypeInfoSet        types;
+      for (const auto& object : data) {
+        memory+=GetObjectMemory(*object);
+      }
 
-    std::vector<O>     prefillData;
-    std::vector<O>     data;
+      return memory;
+    }
 
-    bool               complete=false;
+    void AddArena(const ObjectArenaRef& arena)
+    {
+      if (arena) {
+        arenas.push_back(arena);
+      }
+    }
 
   public:
     /**
@@ -86,13 +152,16 @@ namespace osmscout {
 
     /**
      * Assign data to the tile that was derived from existing tiles. Resets the list of loaded types
-     * to the list given.
+     * to the list given. If the data was loaded into a new arena, the arena is kept with the data.
      */
     void AddPrefillData(const TypeInfoSet& types,
-                        const std::vector<O>& data)
+                        const std::vector<O>& data,
+                        const ObjectArenaRef& arena=nullptr)
     {
       std::scoped_lock<std::mutex> guard(mutex);
 
+      AddArena(arena);
+
       if (this->types.Empty()) {
         this->types=types;
       }
@@ -116,10 +185,13 @@ namespace osmscout {
      * to the list given. This version has move semantics for the data.
      */
     void AddPrefillData(const TypeInfoSet& types,
-                        std::vector<O>&& data)
+                        std::vector<O>&& data,
+                        const ObjectArenaRef& arena=nullptr)
     {
       std::scoped_lock<std::mutex> guard(mutex);
 
+      AddArena(arena);
+
       if (this->types.Empty()) {
         this->types=types;
       }
@@ -139,29 +211,38 @@ namespace osmscout {
     }
 
     /**
-     * Add data to the tile and mark the tile as completed.
+     * Add data to the tile and mark the tile as completed. If the data was loaded
+     * into a new arena, the arena is kept in addition to the arenas of the existing data.
      */
     void AddData(const TypeInfoSet& types,
-                 const std::vector<O>& data)
+                 const std::vector<O>& data,
+                 const ObjectArenaRef& arena=nullptr)
     {
       std::scoped_lock<std::mutex> guard(mutex);
 
       this->data.insert(this->data.end(), data.begin(), data.end());
       this->types.Add(types);
+      dataMemory+=GetDataMemory(data);
+      AddArena(arena);
 
       complete=true;
     }
 
     /**
-     * Assign data to the tile and mark the tile as completed.
+     * Assign data to the tile and mark the tile as completed. The arenas of the
+     * replaced data are released, the arena of the new data (if any) is kept instead.
      */
     void SetData(const TypeInfoSet& types,
-                 const std::vector<O>& data)
+                 const std::vector<O>& data,
+                 const ObjectArenaRef& arena=nullptr)
     {
       std::scoped_lock<std::mutex> guard(mutex);
 
       this->data=data;
       this->types=types;
+      dataMemory=GetDataMemory(this->data);
+      arenas.clear();
+      AddArena(arena);
 
       complete=true;
     }
@@ -170,12 +251,16 @@ namespace osmscout {
      * Assign data to the tile and mark the tile as completed.  This version has move semantics for the data.
      */
     void SetData(const TypeInfoSet& types,
-                 std::vector<O>&& data)
+                 std::vector<O>&& data,
+                 const ObjectArenaRef& arena=nullptr)
     {
       std::scoped_lock<std::mutex> guard(mutex);
 
       this->data=std::move(data);
       this->types=types;
+      dataMemory=GetDataMemory(this->data);
+      arenas.clear();
+      AddArena(arena);
 
       complete=true;
     }
@@ -221,6 +306,37 @@ namespace osmscout {
       return prefillData.size()+data.size();
     }
 
+    /**
+     * Return the number of objects loaded from the database, that is without
+     * the objects copied from other tiles
+     */
+    size_t GetLoadedDataSize() const
+    {
+      std::scoped_lock<std::mutex> guard(mutex);
+
+      return data.size();
+    }
+
+    /**
+     * Return the estimated memory footprint in bytes. Prefill data is
+     * shared with the tile it was copied from and thus only counted with the
+     * size of the references. The chunks of the arenas the data was loaded
+     * into are counted completely.
+     */
+    size_t GetMemory() const
+    {
+      std::scoped_lock<std::mutex> guard(mutex);
+
+      size_t memory=(prefillData.capacity()+data.capacity())*sizeof(O)+
+                    dataMemory;
+
+      for (const auto& arena : arenas) {
+        memory+=arena->GetMemory();
+      }
+
+      return memory;
+    }
+
     void CopyData(std::function<void(const O&)> function) const
     {
       std::scoped_lock<std::mutex> guard(mutex);
@@ -433,6 +549,34 @@ namespace osmscout {
              optimizedWayData.IsEmpty() &&
              optimizedAreaData.IsEmpty();
     }
+
+    /**
+     * Return the estimated memory footprint of the tile in bytes
+     */
+    size_t GetMemory() const
+    {
+      return sizeof(Tile)+
+             nodeData.GetMemory()+
+             wayData.GetMemory()+
+             areaData.GetMemory()+
+             routeData.GetMemory()+
+             optimizedWayData.GetMemory()+
+             optimizedAreaData.GetMemory();
+    }
+
+    /**
+     * Return the number of objects that would have to be loaded again
+     * from the database, if the tile is dropped
+     */
+    size_t GetLoadedDataSize() const
+    {
+      return nodeData.GetLoadedDataSize()+
+             wayData.GetLoadedDataSize()+
+             areaData.GetLoadedDataSize()+
+             routeData.GetLoadedDataSize()+
+             optimizedWayData.GetLoadedDataSize()+
+             optimizedAreaData.GetLoadedDataSize();
+    }
   };
 
   /**
@@ -450,8 +594,13 @@ namespace osmscout {
    * if a cleanup is explicitely triggered. So temporary overbooking can happen. This should
    * assure that prefilling of tiles is possible even with a very low limit.
    *
-   * The cache will free least recently used tiles first,
+   * Additionally a memory budget can be set. Tiles are then also freed until the
+   * estimated memory footprint of all cached tiles is within the budget.
    *
+   * The cache will free least recently used tiles first. Among the least recently
+   * used tiles the tile that is cheapest to reload relative to the memory it frees
+   * is dropped first. Tiles of lower magnification levels are considered more
+   * expensive to reload, since tiles of higher levels are prefilled from them.
    */
   class OSMSCOUT_MAP_API DataTileCache
   {
@@ -483,8 +632,13 @@ namespace osmscout {
     //! An index from TileIds to cache entries
     using CacheIndex = std::map<TileKey, CacheRef>;
 
+  private:
+    //! Number of least recently used tiles considered for eviction
+    static constexpr size_t evictionCandidates=8;
+
   private:
     size_t             cacheSize;
+    size_t             memoryBudget=0; //!< Maximum memory in bytes, 0 for no limit
 
     mutable CacheIndex tileIndex;
     mutable Cache      tileCache;
@@ -521,10 +675,21 @@ namespace osmscout {
       return tileCache.size();
     }
 
+    void SetMemoryBudget(size_t memoryBudget);
+
+    size_t GetMemoryBudget() const
+    {
+      return memoryBudget;
+    }
+
+    size_t GetCurrentMemory() const;
+
     void CleanupCache();
 
     void InvalidateCache();
 
+    void DumpStatistics() const;
+
     TileRef GetCachedTile(const TileKey& id) const;
     TileRef GetTile(const TileKey& id) const;
 
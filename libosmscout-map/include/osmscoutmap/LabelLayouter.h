@@ -21,6 +21,7 @@
 */
 
 #include <memory>
+#include <optional>
 #include <set>
 #include <array>
 
@@ -28,6 +29,7 @@
 
 #include <osmscoutmap/StyleConfig.h>
 #include <osmscoutmap/LabelPath.h>
+#include <osmscoutmap/LabelRegistry.h>
 #include <osmscout/system/Math.h>
 
 //#define DEBUG_LABEL_LAYOUTER
@@ -93,6 +95,7 @@ namespace osmscout {
     PathTextStyleRef  style;
     double            contourLabelOffset;
     double            contourLabelSpace;
+    ObjectFileRef     object;      //!< Object the label belongs to (optional, used by the LabelRegistry)
   };
 
   class LabelData
@@ -119,6 +122,8 @@ namespace osmscout {
     double            iconWidth{0};
     double            iconHeight{0};
 
+    ObjectFileRef     object;    //!< Object the label belongs to (optional, used by the LabelRegistry)
+
   public:
     LabelData() = default;
     ~LabelData() = default;
@@ -185,6 +190,7 @@ namespace osmscout {
     size_t                priority{std::numeric_limits<size_t>::max()}; //!< Priority of the entry (minimum of priority label elements)
     // TODO: move priority from label to element
     std::vector<Element>  elements;
+    ObjectFileRef         object;   //!< Object the label belongs to (optional, used by the LabelRegistry)
   };
 
   template<class NativeGlyph>
@@ -197,6 +203,8 @@ namespace osmscout {
     size_t priority;
     std::vector<Glyph<NativeGlyph>> glyphs;
     osmscout::PathTextStyleRef style;    //!< Style for drawing
+    ObjectFileRef object;                //!< Object the label belongs to (optional, used by the LabelRegistry)
+    size_t index{0};                     //!< Index of the label along the path of the object
   };
 
   class Mask
@@ -322,9 +330,17 @@ namespace osmscout {
      * As final step process labels and contour labels (from highest priority) and check
      * its visual rectangle in corresponding canvas. When pixels are not occupied yet,
      * it is added and pixels on canvas mark.
+     *
+     * If the parameter holds a LabelRegistry, labels already decided by the rendering
+     * of another tile are placed (or dropped) first as registered. Decisions for the
+     * remaining labels, visible in the current viewport, are registered.
      */
     struct LayoutJob {
       DoubleRectangle layoutViewport;
+      DoubleRectangle visibleViewport;
+
+      const Projection& projection;
+      LabelRegistryRef  labelRegistry;
 
       double iconPadding;
       double labelPadding;
@@ -342,9 +358,13 @@ namespace osmscout {
       std::vector<uint64_t> overlayCanvas;
 
       LayoutJob(const DoubleRectangle &layoutViewport,
+                const DoubleRectangle &visibleViewport,
                 const Projection& projection,
                 const MapParameter& parameter):
         layoutViewport(layoutViewport),
+        visibleViewport(visibleViewport),
+        projection(projection),
+        labelRegistry(parameter.GetLabelRegistry()),
         iconPadding(projection.ConvertWidthToPixel(parameter.GetIconPadding())),
         labelPadding(projection.ConvertWidthToPixel(parameter.GetLabelPadding())),
         shieldLabelPadding(projection.ConvertWidthToPixel(parameter.GetPlateLabelPadding())),
@@ -392,6 +412,21 @@ namespace osmscout {
         }
       }
 
+      /**
+       * Clear the place marked by MarkLabelPlace(). The place must not have been
+       * occupied before, as it is the case after a successful collision check.
+       */
+      void UnmarkLabelPlace(std::vector<uint64_t> &canvas,
+                            const Mask &mask,
+                            int viewportHeight) const
+      {
+        for (int r=std::max(0,mask.rowFrom); r<=std::min((int)viewportHeight-1, mask.rowTo); r++){
+          for (int c=std::max(0,mask.cellFrom); c<=std::min((int)mask.size()-1, mask.cellTo); c++){
+            canvas[r*mask.size() + c] = ~mask.d[c] & canvas[r*mask.size() + c];
+          }
+        }
+      }
+
       bool CheckLabelCollision(const std::vector<uint64_t> &canvas,
                                const Mask &mask,
                                int64_t viewportHeight) const
@@ -421,6 +456,64 @@ namespace osmscout {
         return labelPadding;
       }
 
+      /**
+       * Prepare the mask of the element and return the canvas the element is placed on
+       */
+      std::vector<uint64_t>* PrepareElementMask(const typename LabelInstanceType::Element& element,
+                                                [[maybe_unused]] size_t priority,
+                                                Mask& row)
+      {
+        double padding = LabelPadding(element.labelData);
+
+        IntRectangle rectangle{ (int)std::floor(element.x - layoutViewport.x - padding),
+                                (int)std::floor(element.y - layoutViewport.y - padding),
+                                0, 0 };
+        std::vector<uint64_t> *canvas = &labelCanvas;
+        if (element.labelData.type==LabelData::Icon || element.labelData.type==LabelData::Symbol){
+          if (element.labelData.iconStyle->IsOverlay()) {
+            rectangle.width = 0;
+            rectangle.height = 0;
+          }
+          else {
+            rectangle.width = std::ceil(element.labelData.iconWidth + 2*padding);
+            rectangle.height = std::ceil(element.labelData.iconHeight + 2*padding);
+          }
+          canvas = &iconCanvas;
+#ifdef DEBUG_LABEL_LAYOUTER
+          if (element.labelData.type==LabelData::Icon) {
+            std::cout << "Test icon " << element.labelData.iconStyle->GetIconName() <<
+                      " prio " << priority;
+          }else{
+            std::cout << "Test symbol " << element.labelData.iconStyle->GetSymbol()->GetName() <<
+                      " prio " << priority;
+          }
+#endif
+        } else {
+#ifdef DEBUG_LABEL_LAYOUTER
+          std::cout << "Test " << (IsOverlay(element.labelData) ? "overlay " : "") <<
+                    "label prio " << priority << ": " <<
+                    element.labelData.text;
+#endif
+
+          rectangle.width = std::ceil(element.label->width + 2*padding);
+          rectangle.height = std::ceil(element.label->height + 2*padding);
+
+          if (IsOverlay(element.labelData)){
+            canvas = &overlayCanvas;
+          }
+        }
+        row.prepare(rectangle);
+
+        return canvas;
+      }
+
+      /**
+       * Place the label, if there is no collision with labels placed before.
+       *
+       * If there is a LabelRegistry, the decision is committed before the canvas
+       * is marked. If the rendering of another tile was faster and decided
+       * differently, its decision is used instead.
+       */
       void ProcessLabelInstance(const LabelInstanceType &currentLabel,
                                 std::vector<LabelInstanceType> &labelInstances)
       {
@@ -429,55 +522,20 @@ namespace osmscout {
         std::vector<std::vector<uint64_t> *> canvases(elementCount, nullptr);
 
         std::vector<typename LabelInstance<NativeGlyph, NativeLabel>::Element> visibleElements;
+        uint64_t visibleMask=0;
 
         for (size_t eli=0; eli < elementCount; eli++){
           const typename LabelInstance<NativeGlyph, NativeLabel>::Element& element = currentLabel.elements[eli];
           Mask& row=masks[eli];
 
-          double padding = LabelPadding(element.labelData);
-
-          IntRectangle rectangle{ (int)std::floor(element.x - layoutViewport.x - padding),
-                                  (int)std::floor(element.y - layoutViewport.y - padding),
-                                  0, 0 };
-          std::vector<uint64_t> *canvas = &labelCanvas;
-          if (element.labelData.type==LabelData::Icon || element.labelData.type==LabelData::Symbol){
-            if (element.labelData.iconStyle->IsOverlay()) {
-              rectangle.width = 0;
-              rectangle.height = 0;
-            }
-            else {
-              rectangle.width = std::ceil(element.labelData.iconWidth + 2*padding);
-              rectangle.height = std::ceil(element.labelData.iconHeight + 2*padding);
-            }
-            canvas = &iconCanvas;
-#ifdef DEBUG_LABEL_LAYOUTER
-            if (element.labelData.type==LabelData::Icon) {
-              std::cout << "Test icon " << element.labelData.iconStyle->GetIconName() <<
-                        " prio " << currentLabel.priority;
-            }else{
-              std::cout << "Test symbol " << element.labelData.iconStyle->GetSymbol()->GetName() <<
-                        " prio " << currentLabel.priority;
-            }
-#endif
-          } else {
-#ifdef DEBUG_LABEL_LAYOUTER
-            std::cout << "Test " << (IsOverlay(element.labelData) ? "overlay " : "") <<
-                      "label prio " << currentLabel.priority << ": " <<
-                      element.labelData.text;
-#endif
-
-            rectangle.width = std::ceil(element.label->width + 2*padding);
-            rectangle.height = std::ceil(element.label->height + 2*padding);
-
-            if (IsOverlay(element.labelData)){
-              canvas = &overlayCanvas;
-            }
-          }
-          row.prepare(rectangle);
+          std::vector<uint64_t> *canvas = PrepareElementMask(element, currentLabel.priority, row);
           bool collision = CheckLabelCollision(*canvas, row, layoutViewport.height);
           if (!collision) {
             visibleElements.push_back(element);
             canvases[eli]=canvas;
+            if (eli<64) {
+              visibleMask|=uint64_t(1) << eli;
+            }
           }
 #ifdef DEBUG_LABEL_LAYOUTER
           std::cout << " -> " << (collision ? "skipped" : "added") << std::endl;
@@ -487,8 +545,17 @@ namespace osmscout {
 #endif
         }
 
+        if (labelRegistry) {
+          std::optional<LabelRegistry::Placement> registered=CommitLabelInstance(currentLabel, visibleMask);
+
+          if (registered) {
+            PlaceRegisteredLabelInstance(currentLabel, *registered, labelInstances);
+            return;
+          }
+        }
+
         if (!visibleElements.empty()) {
-          LabelInstanceType instanceCopy{currentLabel.priority, visibleElements};
+          LabelInstanceType instanceCopy{currentLabel.priority, visibleElements, currentLabel.object};
           labelInstances.push_back(instanceCopy);
 
           // mark all labels at once (elements of single label may have no padding)
@@ -500,6 +567,242 @@ namespace osmscout {
         }
       }
 
+      bool IsVisible(const LabelInstanceType &label) const
+      {
+        DoubleRectangle viewport=visibleViewport;
+
+        for (const auto& element : label.elements) {
+          if (element.labelData.type==LabelData::Text) {
+            if (viewport.Intersects(DoubleRectangle(element.x, element.y, element.label->width, element.label->height))) {
+              return true;
+            }
+          }
+          else if (viewport.Intersects(DoubleRectangle(element.x, element.y, element.labelData.iconWidth, element.labelData.iconHeight))) {
+            return true;
+          }
+        }
+
+        return false;
+      }
+
+      bool IsVisible(const ContourLabelType &label) const
+      {
+        DoubleRectangle viewport=visibleViewport;
+
+        for (const auto& glyph : label.glyphs) {
+          if (viewport.Intersects(DoubleRectangle(glyph.trPosition.GetX(), glyph.trPosition.GetY(), glyph.trWidth, glyph.trHeight))) {
+            return true;
+          }
+        }
+
+        return false;
+      }
+
+      /**
+       * Register the decision for the label, if it is visible in the current viewport.
+       *
+       * @return the registered decision, if another rendering was faster and decided differently
+       */
+      std::optional<LabelRegistry::Placement> CommitLabelInstance(const LabelInstanceType &label,
+                                                                  uint64_t visibleMask)
+      {
+        if (label.object.Invalid() ||
+            label.elements.size()>64 ||
+            !IsVisible(label)) {
+          return std::nullopt;
+        }
+
+        LabelRegistry::Placement placement;
+
+        if (visibleMask!=0 &&
+            projection.PixelToGeo(label.elements.front().x,
+                                  label.elements.front().y,
+                                  placement.origin)) {
+          placement.placed=true;
+          placement.visibleElements=visibleMask;
+        }
+
+        LabelRegistry::Placement registered=labelRegistry->Commit(label.object,
+                                                                  projection.GetMagnification(),
+                                                                  placement);
+
+        if (registered.placed==placement.placed &&
+            registered.visibleElements==placement.visibleElements &&
+            registered.origin==placement.origin) {
+          return std::nullopt;
+        }
+
+        return registered;
+      }
+
+      /**
+       * Register the decision for the contour label, if it is visible in the current viewport.
+       *
+       * @return the registered decision, if another rendering was faster and decided differently
+       */
+      std::optional<LabelRegistry::Placement> CommitContourLabel(const ContourLabelType &label,
+                                                                 bool placed)
+      {
+        if (label.object.Invalid() ||
+            !IsVisible(label)) {
+          return std::nullopt;
+        }
+
+        LabelRegistry::Placement placement;
+
+        placement.placed=placed;
+
+        LabelRegistry::Placement registered=labelRegistry->Commit(label.object,
+                                                                  projection.GetMagnification(),
+                                                                  placement,
+                                                                  label.index);
+
+        if (registered.placed==placement.placed) {
+          return std::nullopt;
+        }
+
+        return registered;
+      }
+
+      /**
+       * Place the label at the registered position, without checking for collisions
+       */
+      void PlaceRegisteredLabelInstance(const LabelInstanceType &label,
+                                        const LabelRegistry::Placement& placement,
+                                        std::vector<LabelInstanceType> &labelInstances)
+      {
+        double x;
+        double y;
+
+        if (!placement.placed ||
+            !projection.GeoToPixel(placement.origin, x, y)) {
+          return;
+        }
+
+        double dx=x-label.elements.front().x;
+        double dy=y-label.elements.front().y;
+
+        LabelInstanceType instance;
+
+        instance.priority=label.priority;
+        instance.object=label.object;
+
+        Mask row(rowSize);
+        for (size_t eli=0; eli < label.elements.size() && eli < 64; eli++) {
+          if ((placement.visibleElements & (uint64_t(1) << eli))==0) {
+            continue;
+          }
+
+          typename LabelInstanceType::Element element=label.elements[eli];
+
+          element.x+=dx;
+          element.y+=dy;
+
+          std::vector<uint64_t> *canvas = PrepareElementMask(element, label.priority, row);
+          MarkLabelPlace(*canvas, row, layoutViewport.height);
+#ifdef DEBUG_LABEL_LAYOUTER
+          std::cout << " -> registered" << std::endl;
+#endif
+
+          instance.elements.push_back(element);
+        }
+
+        if (!instance.elements.empty()) {
+          labelInstances.push_back(std::move(instance));
+        }
+      }
+
+      /**
+       * Place the contour label, without checking for collisions
+       */
+      void PlaceRegisteredContourLabel(const ContourLabelType &label,
+                                       std::vector<ContourLabelType> &contourLabelInstances)
+      {
+        Mask row(rowSize);
+        for (const auto& glyph : label.glyphs) {
+          PrepareGlyphMask(glyph, row);
+          MarkLabelPlace(labelCanvas, row, layoutViewport.height);
+        }
+#ifdef DEBUG_LABEL_LAYOUTER
+        std::cout << "Contour label prio " << label.priority << ": " << label.text << " -> registered" << std::endl;
+#endif
+
+        contourLabelInstances.push_back(label);
+      }
+
+      /**
+       * Place (or drop) all labels already decided by the rendering of another
+       * tile. Labels without registered decision remain for ProcessLabels().
+       */
+      void ProcessRegisteredLabels(std::vector<LabelInstanceType> &labelInstances,
+                                   std::vector<ContourLabelType> &contourLabelInstances)
+      {
+        if (!labelRegistry) {
+          return;
+        }
+
+        size_t remaining=0;
+        for (size_t i=0; i<allSortedLabels.size(); i++) {
+          const LabelInstanceType& label=allSortedLabels[i];
+          std::optional<LabelRegistry::Placement> placement;
+
+          if (label.object.Valid()) {
+            placement=labelRegistry->Get(label.object,
+                                         projection.GetMagnification());
+          }
+
+          if (placement) {
+            PlaceRegisteredLabelInstance(label, *placement, labelInstances);
+            continue;
+          }
+
+          if (remaining!=i) {
+            allSortedLabels[remaining]=std::move(allSortedLabels[i]);
+          }
+          remaining++;
+        }
+
+        allSortedLabels.resize(remaining);
+
+        size_t remainingContourLabels=0;
+        for (size_t i=0; i<allSortedContourLabels.size(); i++) {
+          const ContourLabelType& label=allSortedContourLabels[i];
+          std::optional<LabelRegistry::Placement> placement;
+
+          if (label.object.Valid()) {
+            placement=labelRegistry->Get(label.object,
+                                         projection.GetMagnification(),
+                                         label.index);
+          }
+
+          if (placement) {
+            if (placement->placed) {
+              PlaceRegisteredContourLabel(label, contourLabelInstances);
+            }
+            continue;
+          }
+
+          if (remainingContourLabels!=i) {
+            allSortedContourLabels[remainingContourLabels]=std::move(allSortedContourLabels[i]);
+          }
+          remainingContourLabels++;
+        }
+
+        allSortedContourLabels.resize(remainingContourLabels);
+      }
+
+      void PrepareGlyphMask(const Glyph<NativeGlyph>& glyph,
+                            Mask& mask) const
+      {
+        IntRectangle rect{
+          (int)(glyph.trPosition.GetX() - layoutViewport.x - contourLabelPadding),
+          (int)(glyph.trPosition.GetY() - layoutViewport.y - contourLabelPadding),
+          (int)(glyph.trWidth + 2*contourLabelPadding),
+          (int)(glyph.trHeight + 2*contourLabelPadding)
+        };
+        mask.prepare(rect);
+      }
+
       void ProcessLabelContourLabel(const ContourLabelType &currentContourLabel,
                                     std::vector<ContourLabelType> &contourLabelInstances)
       {
@@ -513,26 +816,38 @@ namespace osmscout {
         std::vector<Mask> masks(glyphCnt, m);
         bool collision=false;
         for (int gi=0; !collision && gi<glyphCnt; gi++) {
-
-          auto glyph=currentContourLabel.glyphs[gi];
-          IntRectangle rect{
-            (int)(glyph.trPosition.GetX() - layoutViewport.x - contourLabelPadding),
-            (int)(glyph.trPosition.GetY() - layoutViewport.y - contourLabelPadding),
-            (int)(glyph.trWidth + 2*contourLabelPadding),
-            (int)(glyph.trHeight + 2*contourLabelPadding)
-          };
-          masks[gi].prepare(rect);
+          PrepareGlyphMask(currentContourLabel.glyphs[gi], masks[gi]);
           collision |= CheckLabelCollision(labelCanvas, masks[gi], layoutViewport.height);
         }
         if (!collision) {
           for (int gi=0; gi<glyphCnt; gi++) {
             MarkLabelPlace(labelCanvas, masks[gi], layoutViewport.height);
           }
-          contourLabelInstances.push_back(currentContourLabel);
         }
 #ifdef DEBUG_LABEL_LAYOUTER
         std::cout << " -> " << (collision ? "skipped" : "added") << std::endl;
 #endif
+
+        if (labelRegistry) {
+          std::optional<LabelRegistry::Placement> registered=CommitContourLabel(currentContourLabel, !collision);
+
+          if (registered) {
+            // another rendering was faster and decided differently, use its decision
+            if (registered->placed) {
+              PlaceRegisteredContourLabel(currentContourLabel, contourLabelInstances);
+            }
+            else {
+              for (int gi=0; gi<glyphCnt; gi++) {
+                UnmarkLabelPlace(labelCanvas, masks[gi], layoutViewport.height);
+              }
+            }
+            return;
+          }
+        }
+
+        if (!collision) {
+          contourLabelInstances.push_back(currentContourLabel);
+        }
       };
 
       void ProcessLabels(std::vector<LabelInstanceType> &labelInstances,
@@ -576,9 +891,10 @@ namespace osmscout {
                 const MapParameter& parameter)
     {
       // compute collisions, hide some labels
-      LayoutJob job(layoutViewport, projection, parameter);
+      LayoutJob job(layoutViewport, visibleViewport, projection, parameter);
       job.Swap(labelInstances, contourLabelInstances);
       job.SortLabels();
+      job.ProcessRegisteredLabels(labelInstances, contourLabelInstances);
       job.ProcessLabels(labelInstances, contourLabelInstances);
     }
 
@@ -689,6 +1005,7 @@ namespace osmscout {
     {
       typename LabelInstance<NativeGlyph, NativeLabel>::Element element;
       element.labelData=data;
+      instance.object=data.object;
       if (data.type==LabelData::Type::Icon || data.type==LabelData::Type::Symbol){
         instance.priority = std::min(data.priority, instance.priority);
         element.x = point.GetX() - data.iconWidth / 2;
@@ -726,6 +1043,10 @@ namespace osmscout {
                        const LabelData& data,
                        double objectWidth = 10.0)
     {
+      if (IsRejected(projection, parameter, data.object)) {
+        return;
+      }
+
       LabelInstanceType instance;
 
       double offset=-1;
@@ -746,6 +1067,11 @@ namespace osmscout {
                        const std::vector<LabelData>& data,
                        double objectWidth = 10.0)
     {
+      if (!data.empty() &&
+          IsRejected(projection, parameter, data.front().object)) {
+        return;
+      }
+
       LabelInstanceType instance;
 
       double offset=-1;
@@ -794,12 +1120,16 @@ namespace osmscout {
       double labelSpace=(pathLength-countLabels*label->width)/(countLabels+1);
 
       double offset=labelSpace;
+      size_t index=0;
 
       while (offset+label->width<pathLength){
         double nextOffset =offset+label->width+labelSpace;
+        size_t labelIndex =index++;
 
         // skip string rendering when path is too much squiggly at this offset
-        if (!labelPath.TestAngleVariance(offset,offset+label->width,M_PI_4)){
+        // or another tile already decided to not place this label
+        if (!labelPath.TestAngleVariance(offset,offset+label->width,M_PI_4) ||
+            IsRejected(projection, parameter, labelData.object, labelIndex)){
           // skip drawing current label and let offset point to the next instance
           offset=nextOffset;
           continue;
@@ -808,6 +1138,8 @@ namespace osmscout {
         ContourLabelType cLabel;
         cLabel.priority = labelData.priority;
         cLabel.style = labelData.style;
+        cLabel.object = labelData.object;
+        cLabel.index = labelIndex;
 
 #if defined(DEBUG_LABEL_LAYOUTER)
         cLabel.text = labelData.text;
@@ -906,6 +1238,31 @@ namespace osmscout {
       return contourLabelInstances;
     }
 
+  private:
+    /**
+     * Return true, if the rendering of another tile already decided to not place
+     * the label (with the given index) of the object. We can skip the text layout then.
+     */
+    static bool IsRejected(const Projection& projection,
+                           const MapParameter& parameter,
+                           const ObjectFileRef& object,
+                           size_t index=0)
+    {
+      LabelRegistryRef labelRegistry=parameter.GetLabelRegistry();
+
+      if (!labelRegistry ||
+          object.Invalid()) {
+        return false;
+      }
+
+      std::optional<LabelRegistry::Placement> placement=labelRegistry->Get(object,
+                                                                           projection.GetMagnification(),
+                                                                           index);
+
+      return placement &&
+             !placement->placed;
+    }
+
   private:
     TextLayouter *textLayouter;
     std::vector<ContourLabelType> contourLabelInstances;
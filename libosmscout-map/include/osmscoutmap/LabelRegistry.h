@@ -0,0 +1,123 @@
+#ifndef OSMSCOUT_MAP_LABELREGISTRY_H
+#define OSMSCOUT_MAP_LABELREGISTRY_H
+
+/*
+  This source is part of the libosmscout-map library
+  Copyright (C) 2026  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+#include <osmscoutmap/MapImportExport.h>
+
+#include <osmscout/ObjectRef.h>
+
+#include <osmscout/GeoCoord.h>
+#include <osmscout/util/Magnification.h>
+
+namespace osmscout {
+
+  /**
+   * \ingroup Renderer
+   *
+   * Registry of label placement decisions shared between renderings of
+   * neighbouring tiles (either concurrently or later on). For each label of an
+   * object and magnification, the registry stores if the label was placed
+   * and where. Objects with multiple labels (like the repeated contour labels
+   * of a way) distinguish their labels by index. The LabelLayouter reuses these decisions instead of deciding
+   * again, so that labels crossing tile borders are either drawn in all tiles
+   * at the same position or in none of them.
+   *
+   * Decisions depend on the style sheet and the map parameter, the registry must
+   * be cleared, if one of them changes. If the registry holds the maximum number
+   * of entries, the least recently used decision is dropped for each new one.
+   *
+   * All methods are thread-safe.
+   */
+  class OSMSCOUT_MAP_API LabelRegistry CLASS_FINAL
+  {
+  public:
+    static constexpr size_t defaultMaxEntries=100000;
+
+    struct Placement
+    {
+      bool     placed=false;      //!< The label was placed, else it was rejected
+      GeoCoord origin;            //!< Coordinate of the left, top edge of the first element of the label
+      uint64_t visibleElements=0; //!< Bit mask of the visible elements of the label
+    };
+
+  private:
+    struct Key
+    {
+      ObjectFileRef object;
+      double        magnification;
+      size_t        index;
+
+      bool operator==(const Key& other) const
+      {
+        return object==other.object &&
+               magnification==other.magnification &&
+               index==other.index;
+      }
+    };
+
+    struct KeyHasher
+    {
+      size_t operator()(const Key& key) const
+      {
+        return std::hash<FileOffset>()(key.object.GetFileOffset()) ^
+               (size_t(key.object.GetType()) << 56) ^
+               std::hash<double>()(key.magnification) ^
+               (std::hash<size_t>()(key.index) << 32);
+      }
+    };
+
+    using Entry = std::pair<Key,Placement>;
+    using EntryList = std::list<Entry>;
+
+  private:
+    mutable std::mutex                                    mutex;
+    mutable EntryList                                     entries;    //!< Decisions, most recently used first
+    std::unordered_map<Key,EntryList::iterator,KeyHasher> placements; //!< Index of the decisions by key
+    size_t                                                maxEntries;
+
+  public:
+    explicit LabelRegistry(size_t maxEntries=defaultMaxEntries);
+
+    std::optional<Placement> Get(const ObjectFileRef& object,
+                                 const Magnification& magnification,
+                                 size_t index=0) const;
+
+    Placement Commit(const ObjectFileRef& object,
+                     const Magnification& magnification,
+                     const Placement& placement,
+                     size_t index=0);
+
+    void Clear();
+
+    size_t GetSize() const;
+  };
+
+  using LabelRegistryRef = std::shared_ptr<LabelRegistry>;
+}
+
+#endif
@@ -170,6 +170,7 @@ namespace osmscout {
       const FeatureValueBuffer *buffer;         //!< Features of the line segment. Not owned pointer.
       CoordBufferRange         coordRange;      //!< Range of coordinates in transformation buffer
       double                   mainSlotWidth;   //!< Width of main slot, used for relative positioning
+      bool                     isSimple;        //!< flag if the path holds all nodes of the way, independent of the projection
     };
 
     /**
@@ -185,6 +186,7 @@ namespace osmscout {
       GeoBox                      boundingBox;     //!< Bounding box of the area
       std::optional<GeoCoord>     center;          //!< "visual" polygon center (pole of inaccessibility)
       bool                        isOuter;         //!< flag if this area is outer ring of some relation
+      bool                        isSimple;        //!< flag if this area is the only ring of its area
       CoordBufferRange            coordRange;      //!< Range of coordinates in transformation buffer
       std::list<CoordBufferRange> clippings;       //!< Clipping polygons to be used during drawing of this area
     };
@@ -353,6 +355,7 @@ namespace osmscout {
 
     void LayoutPointLabels(const Projection& projection,
                            const MapParameter& parameter,
+                           const ObjectFileRef& object,
                            const FeatureValueBuffer& buffer,
                            const IconStyleRef& iconStyle,
                            const std::vector<TextStyleRef>& textStyles,
@@ -378,6 +381,7 @@ namespace osmscout {
     bool DrawWayContourLabel(const Projection& projection,
                              const MapParameter& parameter,
                              const WayPathData& data,
+                             const ObjectFileRef& object,
                              const PathTextStyleRef &pathTextStyle,
                              const std::string &textLabel);
 
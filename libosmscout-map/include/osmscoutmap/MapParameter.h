@@ -25,6 +25,7 @@
 
 #include <osmscoutmap/MapImportExport.h>
 
+#include <osmscoutmap/LabelRegistry.h>
 #include <osmscoutmap/StyleProcessor.h>
 
 #include <osmscout/util/Breaker.h>
@@ -122,6 +123,8 @@ namespace osmscout {
 
     BreakerRef                          breaker;                   //!< Breaker to abort processing on external request
 
+    LabelRegistryRef                    labelRegistry;             //!< Optional registry of label placements shared between tiles
+
   public:
     MapParameter();
 
@@ -194,6 +197,8 @@ namespace osmscout {
 
     void SetBreaker(const BreakerRef& breaker);
 
+    void SetLabelRegistry(const LabelRegistryRef& labelRegistry);
+
 
     inline std::string GetFontName() const
     {
@@ -415,6 +420,11 @@ namespace osmscout {
       return locale;
     }
 
+    inline LabelRegistryRef GetLabelRegistry() const
+    {
+      return labelRegistry;
+    }
+
     bool IsAborted() const
     {
       if (breaker) {
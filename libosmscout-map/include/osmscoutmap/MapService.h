@@ -20,8 +20,11 @@
   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
 */
 
+#include <future>
 #include <list>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <thread>
 #include <vector>
 
@@ -57,6 +60,8 @@ namespace osmscout {
     BreakerRef    breaker;
     bool          useMultithreading=false;
     bool          resolveRouteMembers=true;
+    bool          lowPriority=false;
+    bool          useObjectArena=false;
 
   public:
     AreaSearchParameter() = default;
@@ -69,6 +74,10 @@ namespace osmscout {
 
     void SetResolveRouteMembers(bool resolveRouteMembers);
 
+    void SetLowPriority(bool lowPriority);
+
+    void SetUseObjectArena(bool useObjectArena);
+
     void SetBreaker(const BreakerRef& breaker);
 
     unsigned long GetMaximumAreaLevel() const;
@@ -79,7 +88,13 @@ namespace osmscout {
 
     bool GetResolveRouteMembers() const;
 
+    bool GetLowPriority() const;
+
+    bool GetUseObjectArena() const;
+
     bool IsAborted() const;
+
+    bool CanShareLoad(const AreaSearchParameter& other) const;
   };
 
   /**
@@ -115,28 +130,57 @@ namespace osmscout {
     using TileStateCallback = std::function<void (const TileRef &)>;
 
   private:
-    mutable std::mutex           stateMutex;           //!< Mutex to protect internal state
+    /**
+     * The kinds of objects of a tile, that are loaded by separate tasks
+     */
+    enum class TileDataKind : uint8_t
+    {
+      nodes,
+      areasLowZoom,
+      areas,
+      waysLowZoom,
+      ways,
+      routes
+    };
 
-    DatabaseRef                  database;             //!< The reference to the database
-    mutable DataTileCache        cache;                //!< Data cache
+    /**
+     * A load task that is queued or running
+     */
+    struct InFlightLoad
+    {
+      size_t                   id;        //!< Unique id of the task
+      AreaSearchParameter      parameter; //!< The parameter of the task
+      bool                     prefill;   //!< The task loads prefill data
+      TypeInfoSet              types;     //!< The types loaded by the task
+      std::shared_future<bool> result;    //!< The result of the task
+    };
+
+    using InFlightKey = std::pair<TileKey,TileDataKind>;
 
-    mutable WorkQueue<bool>      nodeWorkerQueue;
-    std::thread                  nodeWorkerThread;
+    /**
+     * Serializes the loads of one kind of objects for one tile
+     */
+    struct LoadLock
+    {
+      std::mutex mutex;       //!< Locked while one of the loads is running
+      size_t     taskCount=0; //!< Number of loads queued or running
+    };
 
-    mutable WorkQueue<bool>      wayWorkerQueue;
-    std::thread                  wayWorkerThread;
+    using LoadLockRef = std::shared_ptr<LoadLock>;
 
-    mutable WorkQueue<bool>      wayLowZoomWorkerQueue;
-    std::thread                  wayLowZoomWorkerThread;
+  private:
+    mutable std::mutex           stateMutex;           //!< Mutex to protect the cache
 
-    mutable WorkQueue<bool>      areaWorkerQueue;
-    std::thread                  areaWorkerThread;
+    DatabaseRef                  database;             //!< The reference to the database
+    mutable DataTileCache        cache;                //!< Data cache
 
-    mutable WorkQueue<bool>      areaLowZoomWorkerQueue;
-    std::thread                  areaLowZoomWorkerThread;
+    mutable WorkQueue<bool>      workerQueue;          //!< Load tasks, one per tile and object kind
+    std::vector<std::thread>     workerThreads;        //!< Threads working on the load tasks
 
-    mutable WorkQueue<bool>      routeWorkerQueue;
-    std::thread                  routeWorkerThread;
+    mutable std::mutex           inFlightMutex;        //!< Mutex to protect the in-flight loads
+    mutable size_t               nextInFlightId=0;
+    mutable std::map<InFlightKey,InFlightLoad> inFlightLoads; //!< Loads queued or running
+    mutable std::map<InFlightKey,LoadLockRef>  loadLocks;     //!< Serialization of the loads queued or running
 
     CallbackId                   nextCallbackId;
     std::map<CallbackId,TileStateCallback> tileStateCallbacks;
@@ -197,7 +241,8 @@ namespace osmscout {
                     AreaObjectIndex areaObjectIndex,
                     ObjectByOffsetFn objectByOffsetFn,
                     const std::string_view &objectTypeName,
-                    const std::string_view &objectTypeNamePl) const
+                    const std::string_view &objectTypeNamePl,
+                    const ObjectArenaRef& arena=nullptr) const
     {
       if (!areaObjectIndex) {
         return false;
@@ -253,13 +298,13 @@ namespace osmscout {
           }
 
           if (prefill) {
-            tileData.AddPrefillData(loadedTypes, std::move(objects));
+            tileData.AddPrefillData(loadedTypes, std::move(objects), arena);
           }
           else {
             if (cachedTypes.Empty()){
-              tileData.SetData(loadedTypes, std::move(objects));
+              tileData.SetData(loadedTypes, std::move(objects), arena);
             }else{
-              tileData.AddData(loadedTypes, objects);
+              tileData.AddData(loadedTypes, objects, arena);
             }
           }
         }
@@ -274,51 +319,63 @@ namespace osmscout {
       return !parameter.IsAborted();
     }
 
-    void NodeWorkerLoop();
-    void WayWorkerLoop();
-    void WayLowZoomWorkerLoop();
-    void AreaWorkerLoop();
-    void AreaLowZoomWorkerLoop();
-    void RouteWorkerLoop();
+    void WorkerLoop();
 
-    std::future<bool> PushNodeTask(const AreaSearchParameter& parameter,
-                                   const TypeInfoSet& nodeTypes,
-                                   const GeoBox& boundingBox,
-                                   bool prefill,
-                                   const TileRef& tile) const;
+    std::shared_future<bool> PushTask(TileDataKind kind,
+                                      const TileRef& tile,
+                                      const AreaSearchParameter& parameter,
+                                      bool prefill,
+                                      const TypeInfoSet& types,
+                                      const std::function<bool()>& load) const;
 
-    std::future<bool> PushAreaLowZoomTask(const AreaSearchParameter& parameter,
+    std::shared_future<bool> PushNodeTask(const AreaSearchParameter& parameter,
+                                          const TypeInfoSet& nodeTypes,
+                                          const GeoBox& boundingBox,
+                                          bool prefill,
+                                          const TileRef& tile) const;
+
+    std::shared_future<bool> PushAreaLowZoomTask(const AreaSearchParameter& parameter,
+                                                 const TypeInfoSet& areaTypes,
+                                                 const Magnification& magnification,
+                                                 const GeoBox& boundingBox,
+                                                 bool prefill,
+                                                 const TileRef& tile) const;
+
+    std::shared_future<bool> PushAreaTask(const AreaSearchParameter& parameter,
                                           const TypeInfoSet& areaTypes,
                                           const Magnification& magnification,
                                           const GeoBox& boundingBox,
                                           bool prefill,
                                           const TileRef& tile) const;
 
-    std::future<bool> PushAreaTask(const AreaSearchParameter& parameter,
-                                   const TypeInfoSet& areaTypes,
-                                   const Magnification& magnification,
-                                   const GeoBox& boundingBox,
-                                   bool prefill,
-                                   const TileRef& tile) const;
+    std::shared_future<bool> PushWayLowZoomTask(const AreaSearchParameter& parameter,
+                                                const TypeInfoSet& wayTypes,
+                                                const Magnification& magnification,
+                                                const GeoBox& boundingBox,
+                                                bool prefill,
+                                                const TileRef& tile) const;
 
-    std::future<bool> PushWayLowZoomTask(const AreaSearchParameter& parameter,
+    std::shared_future<bool> PushWayTask(const AreaSearchParameter& parameter,
                                          const TypeInfoSet& wayTypes,
-                                         const Magnification& magnification,
                                          const GeoBox& boundingBox,
                                          bool prefill,
                                          const TileRef& tile) const;
 
-    std::future<bool> PushWayTask(const AreaSearchParameter& parameter,
-                                  const TypeInfoSet& wayTypes,
-                                  const GeoBox& boundingBox,
-                                  bool prefill,
-                                  const TileRef& tile) const;
+    std::shared_future<bool> PushRouteTask(const AreaSearchParameter& parameter,
+                                           const TypeInfoSet& routeTypes,
+                                           const GeoBox& boundingBox,
+                                           bool prefill,
+                                           const TileRef& tile) const;
+
+    LoadLockRef LockForPrefill(TileDataKind kind,
+                               const TileRef& tile) const;
 
-    std::future<bool> PushRouteTask(const AreaSearchParameter& parameter,
-                                    const TypeInfoSet& routeTypes,
-                                    const GeoBox& boundingBox,
-                                    bool prefill,
-                                    const TileRef& tile) const;
+    void UnlockAfterPrefill(TileDataKind kind,
+                            const TileRef& tile,
+                            const LoadLockRef& loadLock) const;
+
+    void PrefillDataFromCache(const TileRef& tile,
+                              const TypeDefinition& typeDefinition) const;
 
     void NotifyTileStateCallbacks(const TileRef& tile) const;
 
@@ -341,6 +398,12 @@ namespace osmscout {
     size_t GetCacheSize() const;
     size_t GetCurrentCacheSize() const;
 
+    void SetCacheMemoryBudget(size_t memoryBudget);
+    size_t GetCacheMemoryBudget() const;
+    size_t GetCurrentCacheMemory() const;
+
+    void DumpStatistics() const;
+
     void CleanupTileCache();
     void FlushTileCache();
     void InvalidateTileCache();
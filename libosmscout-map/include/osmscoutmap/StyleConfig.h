@@ -20,7 +20,10 @@
   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
 */
 
+#include <algorithm>
+#include <cstdint>
 #include <limits>
+#include <list>
 #include <map>
 #include <memory>
 #include <unordered_map>
@@ -43,6 +46,8 @@
 #include <osmscout/util/Color.h>
 #include <osmscout/util/Transformation.h>
 
+#include <osmscout/system/Assert.h>
+
 #include <osmscoutmap/LabelProvider.h>
 #include <osmscoutmap/StyleDescription.h>
 #include <osmscoutmap/Styles.h>
@@ -51,6 +56,21 @@ namespace osmscout {
 
   using ColorPostprocessor = osmscout::Color (*)(const osmscout::Color &);
 
+  struct OSMSCOUT_MAP_API FeatureFilterData CLASS_FINAL
+  {
+    size_t featureFilterIndex;
+    size_t flagIndex;
+
+    FeatureFilterData(size_t featureFilterIndex,
+                      size_t flagIndex);
+
+    bool operator==(const FeatureFilterData& other) const
+    {
+      return featureFilterIndex==other.featureFilterIndex &&
+             flagIndex==other.flagIndex;
+    }
+  };
+
   /**
    * \ingroup Stylesheet
    *
@@ -85,6 +105,9 @@ namespace osmscout {
       return featureReaders[featureIndex].GetValue(buffer);
     }
 
+    bool MatchesFeature(const FeatureFilterData& feature,
+                        const FeatureValueBuffer& buffer) const;
+
     bool IsOneway(const FeatureValueBuffer& buffer) const;
   };
 
@@ -217,21 +240,6 @@ namespace osmscout {
 
   using SizeConditionRef = std::shared_ptr<SizeCondition>;
 
-  struct OSMSCOUT_MAP_API FeatureFilterData CLASS_FINAL
-  {
-    size_t featureFilterIndex;
-    size_t flagIndex;
-
-    FeatureFilterData(size_t featureFilterIndex,
-                      size_t flagIndex);
-
-    bool operator==(const FeatureFilterData& other) const
-    {
-      return featureFilterIndex==other.featureFilterIndex &&
-             flagIndex==other.flagIndex;
-    }
-  };
-
   /**
    * \ingroup Stylesheet
    *
@@ -341,6 +349,16 @@ namespace osmscout {
       return oneway;
     }
 
+    const std::list<FeatureFilterData>& GetFeatures() const
+    {
+      return features;
+    }
+
+    const SizeConditionRef& GetSizeCondition() const
+    {
+      return sizeCondition;
+    }
+
     bool Matches(const StyleResolveContext& context,
                  const FeatureValueBuffer& buffer,
                  double meterInPixel,
@@ -482,59 +500,334 @@ namespace osmscout {
     }
   };
 
+  /**
+   * \ingroup Stylesheet
+   *
+   * Precompiled resolution of the style selectors of one type and magnification level.
+   *
+   * The distinct feature, size and oneway criteria of all selectors get numbered. For
+   * an object each of these conditions is evaluated only once and the resulting bit
+   * signature is used as index into the table of the already composed styles. If there
+   * are more than maxConditions distinct conditions, the selectors are evaluated one
+   * by one instead.
+   */
+  template<class S, class A>
+  class StyleDecision
+  {
+  public:
+    static constexpr size_t maxConditions=8;
+
+  private:
+    std::vector<FeatureFilterData>  features;       //!< Distinct feature conditions
+    std::vector<SizeConditionRef>   sizeConditions; //!< Distinct size conditions
+    bool                            oneway=false;   //!< Oneway condition is used
+    std::vector<std::shared_ptr<S>> styles;         //!< Resulting style by condition signature
+    std::list<StyleSelector<S,A>>   selectors;      //!< Selectors, if there are too many conditions
+    bool                            compiled=false;
+
+  private:
+    /**
+     * Sum up the styles of all selectors matching (in order of the selectors).
+     */
+    template<typename Matches>
+    static std::shared_ptr<S> Compose(const std::list<StyleSelector<S,A>>& selectors,
+                                      Matches matches)
+    {
+      bool               fastpath=false;
+      bool               composed=false;
+      size_t             index=0;
+      std::shared_ptr<S> style;
+
+      for (const auto& selector : selectors) {
+        if (!matches(selector,index++)) {
+          continue;
+        }
+
+        if (!style) {
+          style=selector.style;
+          fastpath=true;
+
+          continue;
+        }
+
+        if (fastpath) {
+          style=std::make_shared<S>(*style);
+          fastpath=false;
+        }
+
+        style->CopyAttributes(*selector.style,
+                              selector.attributes);
+        composed=true;
+      }
+
+      if (composed &&
+          !style->IsVisible()) {
+        style=nullptr;
+      }
+
+      return style;
+    }
+
+  public:
+    void Compile(const std::list<StyleSelector<S,A>>& selectorList)
+    {
+      features.clear();
+      sizeConditions.clear();
+      oneway=false;
+      styles.clear();
+      selectors.clear();
+      compiled=false;
+
+      for (const auto& selector : selectorList) {
+        for (const auto& feature : selector.criteria.GetFeatures()) {
+          if (std::find(features.begin(),features.end(),feature)==features.end()) {
+            features.push_back(feature);
+          }
+        }
+
+        const SizeConditionRef& sizeCondition=selector.criteria.GetSizeCondition();
+
+        if (sizeCondition &&
+            std::find(sizeConditions.begin(),sizeConditions.end(),sizeCondition)==sizeConditions.end()) {
+          sizeConditions.push_back(sizeCondition);
+        }
+
+        oneway=oneway || selector.criteria.GetOneway();
+      }
+
+      size_t conditionCount=features.size()+sizeConditions.size()+(oneway ? 1 : 0);
+
+      if (conditionCount>maxConditions) {
+        features.clear();
+        sizeConditions.clear();
+        oneway=false;
+        selectors=selectorList;
+
+        return;
+      }
+
+      // The signature bits each selector requires to match
+      std::vector<uint32_t> required;
+
+      required.reserve(selectorList.size());
+
+      for (const auto& selector : selectorList) {
+        uint32_t mask=0;
+
+        for (const auto& feature : selector.criteria.GetFeatures()) {
+          mask|=1u << (std::find(features.begin(),features.end(),feature)-features.begin());
+        }
+
+        if (selector.criteria.GetSizeCondition()) {
+          mask|=1u << (features.size()+
+                       (std::find(sizeConditions.begin(),sizeConditions.end(),selector.criteria.GetSizeCondition())-sizeConditions.begin()));
+        }
+
+        if (selector.criteria.GetOneway()) {
+          mask|=1u << (features.size()+sizeConditions.size());
+        }
+
+        required.push_back(mask);
+      }
+
+      styles.resize(size_t(1) << conditionCount);
+
+      for (uint32_t signature=0; signature<styles.size(); signature++) {
+        styles[signature]=Compose(selectorList,
+                                  [&required,signature](const StyleSelector<S,A>& /*selector*/, size_t index) {
+                                    return (required[index] & signature)==required[index];
+                                  });
+      }
+
+      compiled=true;
+    }
+
+    std::shared_ptr<S> GetStyle(const StyleResolveContext& context,
+                                const FeatureValueBuffer& buffer,
+                                double meterInPixel,
+                                double meterInMM) const
+    {
+      if (!compiled) {
+        return Compose(selectors,
+                       [&](const StyleSelector<S,A>& selector, size_t /*index*/) {
+                         return selector.criteria.Matches(context,
+                                                          buffer,
+                                                          meterInPixel,
+                                                          meterInMM);
+                       });
+      }
+
+      uint32_t signature=0;
+      uint32_t bit=1;
+
+      for (const auto& feature : features) {
+        if (context.MatchesFeature(feature,buffer)) {
+          signature|=bit;
+        }
+
+        bit<<=1;
+      }
+
+      for (const auto& sizeCondition : sizeConditions) {
+        if (sizeCondition->Evaluate(meterInPixel,meterInMM)) {
+          signature|=bit;
+        }
+
+        bit<<=1;
+      }
+
+      if (oneway &&
+          context.IsOneway(buffer)) {
+        signature|=bit;
+      }
+
+      return styles[signature];
+    }
+  };
+
+  /**
+   * \ingroup Stylesheet
+   *
+   * The StyleDecisions of all types and magnification levels for one kind of style. Decisions
+   * are stored in a flat vector, with an index by type and level. Identical decisions (mostly
+   * for consecutive levels and for types without styles) are only stored once.
+   */
+  template<class S, class A>
+  class StyleDecisionTable
+  {
+  private:
+    size_t                           levelCount=0;  //!< Number of levels per type
+    std::vector<uint32_t>            decisionIndex; //!< Index into decisions by type and level
+    std::vector<StyleDecision<S,A>>  decisions;     //!< Decision, the first one is the empty decision
+
+  public:
+    void Clear()
+    {
+      levelCount=0;
+      decisionIndex.clear();
+      decisions.clear();
+    }
+
+    void Compile(const std::vector<std::vector<std::list<StyleSelector<S,A>>>>& selectors)
+    {
+      auto sameSelector=[](const StyleSelector<S,A>& a,
+                           const StyleSelector<S,A>& b) {
+        return a.criteria==b.criteria &&
+               a.style==b.style &&
+               a.attributes==b.attributes;
+      };
+
+      levelCount=selectors.empty() ? 0 : selectors.front().size();
+      decisionIndex.assign(selectors.size()*levelCount,0);
+      decisions.clear();
+      decisions.emplace_back();
+      decisions.back().Compile({});
+
+      for (size_t type=0; type<selectors.size(); type++) {
+        assert(selectors[type].size()==levelCount);
+
+        for (size_t level=0; level<levelCount; level++) {
+          const auto& levelSelectors=selectors[type][level];
+
+          if (levelSelectors.empty()) {
+            continue;
+          }
+
+          // Selectors are often the same for a range of levels
+          if (level>0 &&
+              std::equal(levelSelectors.begin(),levelSelectors.end(),
+                         selectors[type][level-1].begin(),selectors[type][level-1].end(),
+                         sameSelector)) {
+            decisionIndex[type*levelCount+level]=decisionIndex[type*levelCount+level-1];
+            continue;
+          }
+
+          decisions.emplace_back();
+          decisions.back().Compile(levelSelectors);
+          decisionIndex[type*levelCount+level]=static_cast<uint32_t>(decisions.size()-1);
+        }
+      }
+    }
+
+    std::shared_ptr<S> GetStyle(const StyleResolveContext& context,
+                                size_t typeIndex,
+                                const FeatureValueBuffer& buffer,
+                                const Projection& projection) const
+    {
+      assert(levelCount>0);
+
+      size_t level=std::min(static_cast<size_t>(projection.GetMagnification().GetLevel()),
+                            levelCount-1);
+
+      return decisions[decisionIndex[typeIndex*levelCount+level]].GetStyle(context,
+                                                                           buffer,
+                                                                           projection.GetMeterInPixel(),
+                                                                           projection.GetMeterInMM());
+    }
+  };
+
   using LinePartialStyle = PartialStyle<LineStyle,LineStyle::Attribute>;
   using LineConditionalStyle = ConditionalStyle<LineStyle,LineStyle::Attribute>;
   using LineStyleSelector = StyleSelector<LineStyle,LineStyle::Attribute>;
   using LineStyleSelectorList = std::list<LineStyleSelector>; //! List of selectors
   using LineStyleLookupTable = std::vector<std::vector<LineStyleSelectorList> >;  //!Index selectors by type and level
+  using LineStyleDecisionTable = StyleDecisionTable<LineStyle,LineStyle::Attribute>; //!Decisions by type and level
 
   using FillPartialStyle = PartialStyle<FillStyle, FillStyle::Attribute>;
   using FillConditionalStyle = ConditionalStyle<FillStyle, FillStyle::Attribute>;
   using FillStyleSelector = StyleSelector<FillStyle, FillStyle::Attribute>;
   using FillStyleSelectorList = std::list<FillStyleSelector>; //! List of selectors
   using FillStyleLookupTable = std::vector<std::vector<FillStyleSelectorList> >;  //!Index selectors by type and level
+  using FillStyleDecisionTable = StyleDecisionTable<FillStyle,FillStyle::Attribute>; //!Decisions by type and level
 
   using BorderPartialStyle = PartialStyle<BorderStyle, BorderStyle::Attribute>;
   using BorderConditionalStyle = ConditionalStyle<BorderStyle, BorderStyle::Attribute>;
   using BorderStyleSelector = StyleSelector<BorderStyle, BorderStyle::Attribute>;
   using BorderStyleSelectorList = std::list<BorderStyleSelector>; //! List of selectors
   using BorderStyleLookupTable = std::vector<std::vector<BorderStyleSelectorList> >;  //!Index selectors by type and level
+  using BorderStyleDecisionTable = StyleDecisionTable<BorderStyle,BorderStyle::Attribute>; //!Decisions by type and level
 
   using TextPartialStyle = PartialStyle<TextStyle, TextStyle::Attribute>;
   using TextConditionalStyle = ConditionalStyle<TextStyle, TextStyle::Attribute>;
   using TextStyleSelector = StyleSelector<TextStyle, TextStyle::Attribute>;
   using TextStyleSelectorList = std::list<TextStyleSelector>; //! List of selectors
   using TextStyleLookupTable = std::vector<std::vector<TextStyleSelectorList> >;  //!Index selectors by type and level
+  using TextStyleDecisionTable = StyleDecisionTable<TextStyle,TextStyle::Attribute>; //!Decisions by type and level
 
   using ShieldPartialStyle = PartialStyle<ShieldStyle, ShieldStyle::Attribute>;
   using ShieldConditionalStyle = ConditionalStyle<ShieldStyle, ShieldStyle::Attribute>;
   using ShieldStyleSelector = StyleSelector<ShieldStyle, ShieldStyle::Attribute>;
   using ShieldStyleSelectorList = std::list<ShieldStyleSelector>; //! List of selectors
   using ShieldStyleLookupTable = std::vector<std::vector<ShieldStyleSelectorList> >;  //!Index selectors by type and level
+  using ShieldStyleDecisionTable = StyleDecisionTable<ShieldStyle,ShieldStyle::Attribute>; //!Decisions by type and level
 
   using PathShieldPartialStyle = PartialStyle<PathShieldStyle, PathShieldStyle::Attribute>;
   using PathShieldConditionalStyle = ConditionalStyle<PathShieldStyle, PathShieldStyle::Attribute>;
   using PathShieldStyleSelector = StyleSelector<PathShieldStyle, PathShieldStyle::Attribute>;
   using PathShieldStyleSelectorList = std::list<PathShieldStyleSelector>; //! List of selectors
   using PathShieldStyleLookupTable = std::vector<std::vector<PathShieldStyleSelectorList> >;  //!Index selectors by type and level
+  using PathShieldStyleDecisionTable = StyleDecisionTable<PathShieldStyle,PathShieldStyle::Attribute>; //!Decisions by type and level
 
   using PathTextPartialStyle = PartialStyle<PathTextStyle, PathTextStyle::Attribute>;
   using PathTextConditionalStyle = ConditionalStyle<PathTextStyle, PathTextStyle::Attribute>;
   using PathTextStyleSelector = StyleSelector<PathTextStyle, PathTextStyle::Attribute>;
   using PathTextStyleSelectorList = std::list<PathTextStyleSelector>; //! List of selectors
   using PathTextStyleLookupTable = std::vector<std::vector<PathTextStyleSelectorList> >;  //!Index selectors by type and level
+  using PathTextStyleDecisionTable = StyleDecisionTable<PathTextStyle,PathTextStyle::Attribute>; //!Decisions by type and level
 
   using IconPartialStyle = PartialStyle<IconStyle, IconStyle::Attribute>;
   using IconConditionalStyle = ConditionalStyle<IconStyle, IconStyle::Attribute>;
   using IconStyleSelector = StyleSelector<IconStyle, IconStyle::Attribute>;
   using IconStyleSelectorList = std::list<IconStyleSelector>; //! List of selectors
   using IconStyleLookupTable = std::vector<std::vector<IconStyleSelectorList> >;  //!Index selectors by type and level
+  using IconStyleDecisionTable = StyleDecisionTable<IconStyle,IconStyle::Attribute>; //!Decisions by type and level
 
   using PathSymbolPartialStyle = PartialStyle<PathSymbolStyle, PathSymbolStyle::Attribute>;
   using PathSymbolConditionalStyle = ConditionalStyle<PathSymbolStyle, PathSymbolStyle::Attribute>;
   using PathSymbolStyleSelector = StyleSelector<PathSymbolStyle, PathSymbolStyle::Attribute>;
   using PathSymbolStyleSelectorList = std::list<PathSymbolStyleSelector>; //! List of selectors
   using PathSymbolStyleLookupTable = std::vector<std::vector<PathSymbolStyleSelectorList> >;  //!Index selectors by type and level
+  using PathSymbolStyleDecisionTable = StyleDecisionTable<PathSymbolStyle,PathSymbolStyle::Attribute>; //!Decisions by type and level
 
   /**
    * \ingroup Stylesheet
@@ -576,6 +869,9 @@ namespace osmscout {
     std::vector<TextStyleLookupTable>          nodeTextStyleSelectors;
     IconStyleLookupTable                       nodeIconStyleSelectors;
 
+    std::vector<TextStyleDecisionTable>        nodeTextStyleDecisions;
+    IconStyleDecisionTable                     nodeIconStyleDecisions;
+
   public:
     std::vector<TypeInfoSet>                   nodeTypeSets;
 
@@ -593,6 +889,11 @@ namespace osmscout {
     std::vector<PathSymbolStyleLookupTable>    wayPathSymbolStyleSelectors;
     PathShieldStyleLookupTable                 wayPathShieldStyleSelectors;
 
+    std::vector<LineStyleDecisionTable>        wayLineStyleDecisions;
+    PathTextStyleDecisionTable                 wayPathTextStyleDecisions;
+    std::vector<PathSymbolStyleDecisionTable>  wayPathSymbolStyleDecisions;
+    PathShieldStyleDecisionTable               wayPathShieldStyleDecisions;
+
     std::vector<bool>                          wayTextFlags;    //!< flags by magnification level if there is style with way label
     std::vector<bool>                          wayShieldFlags;  //!< flags by magnification level if there is style with way shield
 
@@ -615,6 +916,9 @@ namespace osmscout {
     std::list<PathTextConditionalStyle>        routePathTextStyleConditionals;
     PathTextStyleLookupTable                   routePathTextStyleSelectors;
 
+    std::vector<LineStyleDecisionTable>        routeLineStyleDecisions;
+    PathTextStyleDecisionTable                 routePathTextStyleDecisions;
+
     FillStyleLookupTable                       areaFillStyleSelectors;
     std::vector<BorderStyleLookupTable>        areaBorderStyleSelectors;
     std::vector<TextStyleLookupTable>          areaTextStyleSelectors;
@@ -622,6 +926,13 @@ namespace osmscout {
     PathTextStyleLookupTable                   areaBorderTextStyleSelectors;
     PathSymbolStyleLookupTable                 areaBorderSymbolStyleSelectors;
 
+    FillStyleDecisionTable                     areaFillStyleDecisions;
+    std::vector<BorderStyleDecisionTable>      areaBorderStyleDecisions;
+    std::vector<TextStyleDecisionTable>        areaTextStyleDecisions;
+    IconStyleDecisionTable                     areaIconStyleDecisions;
+    PathTextStyleDecisionTable                 areaBorderTextStyleDecisions;
+    PathSymbolStyleDecisionTable               areaBorderSymbolStyleDecisions;
+
   public:
     std::vector<TypeInfoSet>                   areaTypeSets;
 
@@ -645,6 +956,7 @@ namespace osmscout {
     void PostprocessRoutes();
     void PostprocessIconId();
     void PostprocessPatternId();
+    void PostprocessDecisions();
 
   public:
     explicit StyleConfig(const TypeConfigRef& typeConfig);
@@ -822,9 +1134,15 @@ namespace osmscout {
     //@}
 
     /**
-     * Methods for low level debugging access to the style sheet internals
+     * Methods for low level debugging access to the style sheet internals. The
+     * variants filling a vector return the selectors of each slot separately.
      */
     //@{
+    const StyleResolveContext& GetStyleResolveContext() const
+    {
+      return styleResolveContext;
+    }
+
     void GetNodeTextStyleSelectors(size_t level,
                                    const TypeInfoRef& type,
                                    std::list<TextStyleSelector>& selectors) const;
@@ -834,6 +1152,19 @@ namespace osmscout {
     void GetAreaTextStyleSelectors(size_t level,
                                    const TypeInfoRef& type,
                                    std::list<TextStyleSelector>& selectors) const;
+
+    void GetNodeTextStyleSelectors(size_t level,
+                                   const TypeInfoRef& type,
+                                   std::vector<TextStyleSelectorList>& selectors) const;
+    void GetWayLineStyleSelectors(size_t level,
+                                  const TypeInfoRef& type,
+                                  std::vector<LineStyleSelectorList>& selectors) const;
+    void GetAreaBorderStyleSelectors(size_t level,
+                                     const TypeInfoRef& type,
+                                     std::vector<BorderStyleSelectorList>& selectors) const;
+    void GetAreaTextStyleSelectors(size_t level,
+                                   const TypeInfoRef& type,
+                                   std::vector<TextStyleSelectorList>& selectors) const;
     //@}
 
     /**
@@ -0,0 +1,200 @@
+#ifndef OSMSCOUT_MAP_TEXTLAYOUTCACHE_H
+#define OSMSCOUT_MAP_TEXTLAYOUTCACHE_H
+
+/*
+  This source is part of the libosmscout-map library
+  Copyright (C) 2026  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+
+#include <osmscoutmap/LabelLayouter.h>
+
+#include <osmscout/util/Cache.h>
+
+namespace osmscout {
+
+  /**
+   * \ingroup Renderer
+   *
+   * Everything that influences the layout of a label text. The device is described
+   * by its properties relevant for the layout, so labels can be reused for all
+   * devices with the same properties.
+   */
+  struct TextLayoutKey
+  {
+    int         deviceType=0;      //!< Backend specific type of the device (like the surface type)
+    double      dpi=0.0;           //!< Resolution of the device, 0 if it does not influence the layout
+    size_t      fontOptions=0;     //!< Backend specific hash of the font options of the device (like antialiasing and hinting)
+    std::string text;
+    std::string fontName;
+    double      fontSize=0.0;      //!< Font size in pixel
+    double      proposedWidth=0.0; //!< Width proposed for the text, <=0 if there is none
+    bool        enableWrapping=false;
+    bool        contourLabel=false;
+
+    bool operator==(const TextLayoutKey& other) const
+    {
+      return deviceType==other.deviceType &&
+             dpi==other.dpi &&
+             fontOptions==other.fontOptions &&
+             text==other.text &&
+             fontName==other.fontName &&
+             fontSize==other.fontSize &&
+             proposedWidth==other.proposedWidth &&
+             enableWrapping==other.enableWrapping &&
+             contourLabel==other.contourLabel;
+    }
+
+    bool operator!=(const TextLayoutKey& other) const
+    {
+      return !(*this==other);
+    }
+  };
+}
+
+namespace std {
+  template <>
+  struct hash<osmscout::TextLayoutKey>
+  {
+    size_t operator()(const osmscout::TextLayoutKey& key) const
+    {
+      size_t result=hash<int>()(key.deviceType);
+
+      result=result*31+hash<double>()(key.dpi);
+      result=result*31+key.fontOptions;
+      result=result*31+hash<string>()(key.text);
+      result=result*31+hash<string>()(key.fontName);
+      result=result*31+hash<double>()(key.fontSize);
+      result=result*31+hash<double>()(key.proposedWidth);
+      result=result*31+(key.enableWrapping ? 1 : 0);
+      result=result*31+(key.contourLabel ? 1 : 0);
+
+      return result;
+    }
+  };
+}
+
+namespace osmscout {
+
+  /**
+   * \ingroup Renderer
+   *
+   * Cache for labels laid out by a backend, so that label texts repeating
+   * between frames are shaped only once. Entries are evicted in least recently
+   * used order (approximated by the CLOCK algorithm of Cache).
+   *
+   * Labels are completely laid out before they are cached and are not modified
+   * afterwards, so they may be shared between painters (also running in different
+   * threads, like the painters of parallel tile renderers). Cached labels must not
+   * reference resources owned by the painter that laid them out.
+   *
+   * All methods are thread-safe.
+   */
+  template<class NativeGlyph, class NativeLabel>
+  class TextLayoutCache CLASS_FINAL
+  {
+  public:
+    static constexpr size_t defaultMaxEntries=2000;
+
+    using LabelType = Label<NativeGlyph, NativeLabel>;
+    using LabelPtr = std::shared_ptr<LabelType>;
+
+  private:
+    using LabelCache = Cache<TextLayoutKey,LabelPtr>;
+
+  private:
+    mutable std::mutex mutex;
+    LabelCache         cache;
+    size_t             hits=0;   //!< Number of successful lookups
+    size_t             misses=0; //!< Number of failed lookups
+
+  public:
+    explicit TextLayoutCache(size_t maxEntries=defaultMaxEntries)
+    : cache(maxEntries)
+    {
+      // no code
+    }
+
+    /**
+     * Return the cached label for the given key or nullptr, if
+     * there is none.
+     */
+    LabelPtr Get(const TextLayoutKey& key)
+    {
+      std::scoped_lock<std::mutex> lock(mutex);
+      typename LabelCache::CacheRef entry;
+
+      if (cache.GetEntry(key,entry)) {
+        hits++;
+
+        return entry->value;
+      }
+
+      misses++;
+
+      return nullptr;
+    }
+
+    void Set(const TextLayoutKey& key,
+             const LabelPtr& label)
+    {
+      std::scoped_lock<std::mutex> lock(mutex);
+
+      cache.SetEntry(typename LabelCache::CacheEntry(key,label));
+    }
+
+    /**
+     * Remove all labels (for example, if the font changed) and
+     * reset the statistics
+     */
+    void Clear()
+    {
+      std::scoped_lock<std::mutex> lock(mutex);
+
+      cache.Flush();
+      hits=0;
+      misses=0;
+    }
+
+    size_t GetSize() const
+    {
+      std::scoped_lock<std::mutex> lock(mutex);
+
+      return cache.GetSize();
+    }
+
+    size_t GetHits() const
+    {
+      std::scoped_lock<std::mutex> lock(mutex);
+
+      return hits;
+    }
+
+    size_t GetMisses() const
+    {
+      std::scoped_lock<std::mutex> lock(mutex);
+
+      return misses;
+    }
+  };
+}
+
+#endif
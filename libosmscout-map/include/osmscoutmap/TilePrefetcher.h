@@ -0,0 +1,136 @@
+#ifndef OSMSCOUT_MAP_TILEPREFETCHER_H
+#define OSMSCOUT_MAP_TILEPREFETCHER_H
+
+/*
+  This source is part of the libosmscout-map library
+  Copyright (C) 2026  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <chrono>
+#include <deque>
+#include <list>
+#include <mutex>
+#include <set>
+
+#include <osmscoutmap/MapImportExport.h>
+
+#include <osmscout/util/Breaker.h>
+#include <osmscout/util/GeoBox.h>
+#include <osmscout/util/Projection.h>
+
+#include <osmscoutmap/MapService.h>
+#include <osmscoutmap/StyleConfig.h>
+
+namespace osmscout {
+
+  /**
+   * \ingroup Service
+   * \ingroup Renderer
+   *
+   * Speculatively loads the tiles that will most likely become visible next.
+   *
+   * The prefetcher keeps a short history of the viewports passed to
+   * ViewportChanged(). From this it derives the velocity of the viewport
+   * center and the zoom direction and predicts the viewport after the look
+   * ahead time. The tiles of the predicted viewport (and, while zooming,
+   * the tiles of the next zoom level) that are not already loaded are loaded
+   * asynchronously with low priority.
+   *
+   * Prefetches that do not match the current prediction anymore are
+   * cancelled using a Breaker. Statistics allow to evaluate how many of the
+   * tiles becoming visible had been prefetched in time.
+   *
+   * Note that the tile cache of the MapService must be large enough to hold
+   * the visible and the prefetched tiles.
+   */
+  class OSMSCOUT_MAP_API TilePrefetcher CLASS_FINAL
+  {
+  public:
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * Counters for tuning the prefetcher. A tile is counted (at most once)
+     * when it becomes visible without being completely loaded before.
+     */
+    struct Statistics
+    {
+      size_t prefetches=0;          //!< Number of prefetches started
+      size_t cancelledPrefetches=0; //!< Number of prefetches cancelled, because the prediction changed
+      size_t prefetchedTiles=0;     //!< Number of tiles requested by prefetches
+      size_t hits=0;                //!< Prefetched tiles that were complete when becoming visible
+      size_t lateHits=0;            //!< Prefetched tiles that were still loading when becoming visible
+      size_t misses=0;              //!< Tiles becoming visible that were not prefetched
+
+      double GetHitRate() const;
+    };
+
+  private:
+    struct Viewport
+    {
+      Clock::time_point time;
+      GeoCoord          center;
+      double            magnification;
+      GeoBox            boundingBox;
+    };
+
+  private:
+    mutable std::mutex        mutex;
+
+    MapServiceRef             mapService;
+    StyleConfigRef            styleConfig;
+    AreaSearchParameter       searchParameter;
+    std::chrono::milliseconds lookAhead=std::chrono::milliseconds(500);
+    std::chrono::milliseconds historyDuration=std::chrono::milliseconds(1000);
+    size_t                    maxTiles=32;
+
+    std::deque<Viewport>      history;          //!< Recent viewports, oldest first
+    std::set<TileKey>         visibleTiles;     //!< Tiles visible in the last viewport
+    std::list<TileRef>        pendingTiles;     //!< Tiles of the current prefetch
+    BreakerRef                breaker;          //!< Breaker of the current prefetch
+    std::set<TileKey>         prefetchedTiles;  //!< Prefetched tiles, that did not become visible yet
+    std::deque<TileKey>       prefetchedOrder;  //!< Order of prefetchedTiles, oldest first
+    Statistics                statistics;
+
+  private:
+    void UpdateStatistics(const std::list<TileRef>& tiles);
+    void AddPrefetchedTile(const TileKey& key);
+    void PredictTiles(const Viewport& current,
+                      std::list<TileRef>& tiles) const;
+    void CancelPrefetch();
+
+  public:
+    TilePrefetcher(const MapServiceRef& mapService,
+                   const StyleConfigRef& styleConfig);
+    ~TilePrefetcher();
+
+    void SetSearchParameter(const AreaSearchParameter& parameter);
+    void SetLookAhead(const std::chrono::milliseconds& lookAhead);
+    void SetMaxTiles(size_t maxTiles);
+
+    void ViewportChanged(const Projection& projection,
+                         const Clock::time_point& time=Clock::now());
+
+    void Cancel();
+
+    Statistics GetStatistics() const;
+    void ResetStatistics();
+  };
+
+  using TilePrefetcherRef = std::shared_ptr<TilePrefetcher>;
+}
+
+#endif
@@ -19,6 +19,9 @@
 
 #include <osmscoutmap/DataTileCache.h>
 
+#include <algorithm>
+#include <iterator>
+
 #include <osmscout/util/Logger.h>
 #include <osmscout/util/String.h>
 #include <osmscout/util/Tiling.h>
@@ -59,28 +62,95 @@ namespace osmscout {
   }
 
   /**
-   * Cleanup the cache. Free least recently used tiles until the given maximum cache
-   * size is reached again.
+   * Change the memory budget of the cache in bytes, 0 for no limit. Cache
+   * will be cleaned immediately.
+   */
+  void DataTileCache::SetMemoryBudget(size_t memoryBudget)
+  {
+    bool cleanupCache=memoryBudget!=0 &&
+                      (this->memoryBudget==0 || memoryBudget<this->memoryBudget);
+
+    this->memoryBudget=memoryBudget;
+
+    if (cleanupCache) {
+      CleanupCache();
+    }
+  }
+
+  /**
+   * Return the estimated memory footprint of all cached tiles in bytes
+   */
+  size_t DataTileCache::GetCurrentMemory() const
+  {
+    size_t memory=0;
+
+    for (const auto& entry : tileCache) {
+      memory+=entry.tile->GetMemory();
+    }
+
+    return memory;
+  }
+
+  /**
+   * Estimated cost for loading the tile again in relation to the memory
+   * freed by dropping it. Each loaded object has to be read from disk again.
+   * Tiles of lower levels are more valuable, since tiles of higher levels
+   * can be prefilled from them.
+   */
+  static double GetEvictionCost(const Tile& tile,
+                                size_t memory)
+  {
+    double reloadCost=static_cast<double>(tile.GetLoadedDataSize()+1);
+
+    reloadCost*=1.0+1.0/static_cast<double>(tile.GetLevel()+1);
+
+    return reloadCost/static_cast<double>(std::max(memory,size_t(1)));
+  }
+
+  /**
+   * Cleanup the cache. Free tiles until the given maximum cache size and
+   * the memory budget is reached again. Tiles still referenced outside of
+   * the cache are not freed.
    */
   void DataTileCache::CleanupCache()
   {
-    if (tileCache.size()>cacheSize) {
-      auto currentEntry=tileCache.rbegin();
-
-      while (currentEntry!=tileCache.rend() &&
-              tileCache.size()>cacheSize) {
-        //if (currentEntry->tile.expired()) {
-        if (currentEntry->tile.use_count()==1) {
-          //std::cout << "Dropping tile " << (std::string)currentEntry->id << " from cache " << cache.size() << "/" << cacheSize << std::endl;
-          tileIndex.erase(currentEntry->key);
-
-          ++currentEntry;
-          currentEntry=std::reverse_iterator<Cache::iterator>(tileCache.erase(currentEntry.base()));
+    size_t currentMemory=memoryBudget>0 ? GetCurrentMemory() : 0;
+
+    while (tileCache.size()>cacheSize ||
+           currentMemory>memoryBudget) {
+      auto   victim=tileCache.end();
+      double victimCost=0.0;
+      size_t victimMemory=0;
+      size_t candidateCount=0;
+
+      for (auto currentEntry=tileCache.rbegin();
+           currentEntry!=tileCache.rend() && candidateCount<evictionCandidates;
+           ++currentEntry) {
+        if (currentEntry->tile.use_count()!=1) {
+          continue;
         }
-        else {
-          ++currentEntry;
+
+        size_t memory=currentEntry->tile->GetMemory();
+        double cost=GetEvictionCost(*currentEntry->tile,memory);
+
+        if (victim==tileCache.end() ||
+            cost<victimCost) {
+          victim=std::prev(currentEntry.base());
+          victimCost=cost;
+          victimMemory=memory;
         }
+
+        candidateCount++;
       }
+
+      if (victim==tileCache.end()) {
+        break;
+      }
+
+      tileIndex.erase(victim->key);
+      tileCache.erase(victim);
+
+      currentMemory-=std::min(currentMemory,victimMemory);
     }
   }
 
@@ -98,6 +168,14 @@ namespace osmscout {
     }
   }
 
+  /**
+   * Print the number of cached tiles and their estimated memory footprint
+   */
+  void DataTileCache::DumpStatistics() const
+  {
+    log.Debug() << "Tile cache entries: " << tileCache.size() << ", memory " << GetCurrentMemory();
+  }
+
   /**
    * Return the cache tiles with the given id. If the tiles is not cache,
    * an empty reference will be returned.
@@ -0,0 +1,109 @@
+/*
+  This source is part of the libosmscout-map library
+  Copyright (C) 2026  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <osmscoutmap/LabelRegistry.h>
+
+namespace osmscout {
+
+  LabelRegistry::LabelRegistry(size_t maxEntries)
+  : maxEntries(maxEntries)
+  {
+    // no code
+  }
+
+  /**
+   * Return the placement decision for the label with the given index of the given
+   * object on the given magnification, if there is one.
+   */
+  std::optional<LabelRegistry::Placement> LabelRegistry::Get(const ObjectFileRef& object,
+                                                             const Magnification& magnification,
+                                                             size_t index) const
+  {
+    std::scoped_lock<std::mutex> lock(mutex);
+
+    auto entry=placements.find(Key{object,magnification.GetMagnification(),index});
+
+    if (entry==placements.end()) {
+      return std::nullopt;
+    }
+
+    entries.splice(entries.begin(),entries,entry->second);
+
+    return entry->second->second;
+  }
+
+  /**
+   * Store the placement decision for the label with the given index of the given
+   * object on the given magnification. If there is already a decision (because another
+   * rendering was faster), the existing decision is kept. The decision finally stored
+   * is returned. If the registry is full, the least recently used decision is
+   * dropped.
+   */
+  LabelRegistry::Placement LabelRegistry::Commit(const ObjectFileRef& object,
+                                                 const Magnification& magnification,
+                                                 const Placement& placement,
+                                                 size_t index)
+  {
+    std::scoped_lock<std::mutex> lock(mutex);
+
+    Key  key{object,magnification.GetMagnification(),index};
+    auto entry=placements.find(key);
+
+    if (entry!=placements.end()) {
+      entries.splice(entries.begin(),entries,entry->second);
+
+      return entry->second->second;
+    }
+
+    if (maxEntries==0) {
+      return placement;
+    }
+
+    while (placements.size()>=maxEntries) {
+      placements.erase(entries.back().first);
+      entries.pop_back();
+    }
+
+    entries.emplace_front(key,placement);
+    placements.emplace(key,entries.begin());
+
+    return placement;
+  }
+
+  /**
+   * Remove all decisions
+   */
+  void LabelRegistry::Clear()
+  {
+    std::scoped_lock<std::mutex> lock(mutex);
+
+    placements.clear();
+    entries.clear();
+  }
+
+  /**
+   * Return the number of stored decisions
+   */
+  size_t LabelRegistry::GetSize() const
+  {
+    std::scoped_lock<std::mutex> lock(mutex);
+
+    return placements.size();
+  }
+}
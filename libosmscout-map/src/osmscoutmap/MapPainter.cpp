@@ -559,6 +559,8 @@ namespace osmscout {
    *    Projection instance to use
    * @param parameter
    *    General map drawing parameter that might influence the result
+   * @param object
+   *    The object that owns the label, if it identifies the label (else an invalid reference)
    * @param buffer
    *    The FeatureValueBuffer of the object that owns the label
    * @param iconStyle
@@ -577,6 +579,7 @@ namespace osmscout {
    */
   void MapPainter::LayoutPointLabels(const Projection& projection,
                                      const MapParameter& parameter,
+                                     const ObjectFileRef& object,
                                      const FeatureValueBuffer& buffer,
                                      const IconStyleRef& iconStyle,
                                      const std::vector<TextStyleRef>& textStyles,
@@ -601,6 +604,7 @@ namespace osmscout {
         data.iconStyle=iconStyle;
         data.iconWidth=iconStyle->GetWidth();
         data.iconHeight=iconStyle->GetHeight();
+        data.object=object;
 
         labelLayoutData.push_back(data);
       }
@@ -614,6 +618,7 @@ namespace osmscout {
 
         data.iconWidth=iconStyle->GetSymbol()->GetWidth(projection);
         data.iconHeight=iconStyle->GetSymbol()->GetHeight(projection);
+        data.object=object;
 
         labelLayoutData.push_back(data);
       }
@@ -668,6 +673,7 @@ namespace osmscout {
       data.position=textStyle->GetPosition();
       data.text=label;
       data.style=textStyle;
+      data.object=object;
 
       labelLayoutData.push_back(data);
     }
@@ -807,8 +813,11 @@ namespace osmscout {
       labelY = (y1+y2)/2;
     }
 
+    // Rings of the same area would share the object reference, so only simple
+    // areas take part in sharing label placements between tiles
     LayoutPointLabels(projection,
                       parameter,
+                      areaData.isSimple ? areaData.ref : ObjectFileRef(),
                       *areaData.buffer,
                       iconStyle,
                       textStyles,
@@ -869,6 +878,8 @@ namespace osmscout {
     labelData.text=label;
     labelData.contourLabelOffset=contourLabelOffset;
     labelData.contourLabelSpace=contourLabelSpace;
+    // Rings of the same area would share the object reference
+    labelData.object=areaData.isSimple ? areaData.ref : ObjectFileRef();
 
     RegisterContourLabel(projection, parameter, labelData, labelPath);
 
@@ -940,6 +951,7 @@ namespace osmscout {
 
     LayoutPointLabels(projection,
                       parameter,
+                      node->GetObjectFileRef(),
                       node->GetFeatureValueBuffer(),
                       iconStyle,
                       textStyles,
@@ -1136,9 +1148,13 @@ namespace osmscout {
       return false;
     }
 
+    // Labels of ways split into segments depend on the segments visible
+    // in the projection, so only complete ways take part in sharing label
+    // placements between tiles
     return DrawWayContourLabel(projection,
                                parameter,
                                data,
+                               data.isSimple ? ObjectFileRef(data.ref,refWay) : ObjectFileRef(),
                                pathTextStyle,
                                textLabel);
   }
@@ -1146,6 +1162,7 @@ namespace osmscout {
   bool MapPainter::DrawWayContourLabel(const Projection& projection,
                                        const MapParameter& parameter,
                                        const WayPathData& data,
+                                       const ObjectFileRef& object,
                                        const PathTextStyleRef &pathTextStyle,
                                        const std::string &textLabel)
   {
@@ -1176,6 +1193,7 @@ namespace osmscout {
     labelData.height=pathTextStyle->GetSize();
     labelData.contourLabelOffset=contourLabelOffset;
     labelData.contourLabelSpace=contourLabelSpace;
+    labelData.object=object;
 
     // TODO: use coordBuffer for label path
     LabelPath labelPath;
@@ -1345,6 +1363,7 @@ namespace osmscout {
 
     a.boundingBox=ring.GetBoundingBox();
     a.isOuter=ring.IsOuter();
+    a.isSimple=area.IsSimple();
 
     if (!IsVisibleArea(projection,
                        a.boundingBox,
@@ -1546,6 +1565,8 @@ namespace osmscout {
                                      const Way& way,
                                      WayPathData &pathData)
   {
+    pathData.isSimple=way.segments.size() <= 1;
+
     if (way.segments.size() <= 1) {
       pathData.coordRange=TransformWay(way.nodes,
                                        transBuffer,
@@ -2005,6 +2026,8 @@ namespace osmscout {
               pathData.buffer=&(it->second->GetFeatureValueBuffer());
               TransformPathData(projection, parameter, *(it->second), pathData);
               pathData.mainSlotWidth=0.0;
+              // The way may be drawn (and labeled) itself, too
+              pathData.isSimple=false;
 
               wayPathData.push_back(pathData);
 
@@ -2779,6 +2802,7 @@ static void DumpGroundTile(const GroundTile& tile)
         if (DrawWayContourLabel(projection,
                                 parameter,
                                 *(routeLabel.wayData),
+                                ObjectFileRef(),
                                 labelEntry.first,
                                 labels.str())) {
           drawnCount++;
@@ -272,6 +272,18 @@ namespace osmscout {
     this->breaker=breaker;
   }
 
+  /**
+   * Set a registry for sharing label placement decisions between the
+   * rendering of neighbouring tiles. Labels crossing tile borders are then
+   * placed at the same position in all tiles (or in none of them).
+   *
+   * The registry must be cleared, if the style sheet or the map parameter change.
+   */
+  void MapParameter::SetLabelRegistry(const LabelRegistryRef& labelRegistry)
+  {
+    this->labelRegistry=labelRegistry;
+  }
+
   void MapParameter::RegisterFillStyleProcessor(size_t typeIndex,
                                                 const FillStyleProcessorRef& processor)
   {
@@ -55,6 +55,37 @@ namespace osmscout {
     return resolveRouteMembers;
   }
 
+  /**
+   * Load tasks with low priority are only processed, if there are no other
+   * load tasks queued. Useful for loading tiles that are not yet visible.
+   */
+  void AreaSearchParameter::SetLowPriority(bool lowPriority)
+  {
+    this->lowPriority=lowPriority;
+  }
+
+  bool AreaSearchParameter::GetLowPriority() const
+  {
+    return lowPriority;
+  }
+
+  /**
+   * If set, nodes, ways and areas loaded for a tile are allocated in a new arena
+   * per load instead of individually on the heap. The arena is kept with the
+   * loaded data of the tile and counted in its memory footprint. Memory of the
+   * objects is released at once, if the data and all references to its objects
+   * are gone.
+   */
+  void AreaSearchParameter::SetUseObjectArena(bool useObjectArena)
+  {
+    this->useObjectArena=useObjectArena;
+  }
+
+  bool AreaSearchParameter::GetUseObjectArena() const
+  {
+    return useObjectArena;
+  }
+
   void AreaSearchParameter::SetBreaker(const BreakerRef& breaker)
   {
     this->breaker=breaker;
@@ -85,35 +116,42 @@ namespace osmscout {
     }
   }
 
+  /**
+   * Return true, if a load with this parameter returns the same data as a
+   * load with the other parameter and is aborted by the same breaker, so
+   * that one load can serve both requests. The priority is not compared.
+   */
+  bool AreaSearchParameter::CanShareLoad(const AreaSearchParameter& other) const
+  {
+    return maxAreaLevel==other.maxAreaLevel &&
+           useLowZoomOptimization==other.useLowZoomOptimization &&
+           breaker==other.breaker &&
+           useMultithreading==other.useMultithreading &&
+           resolveRouteMembers==other.resolveRouteMembers &&
+           useObjectArena==other.useObjectArena;
+  }
+
   MapService::MapService(const DatabaseRef& database)
    : database(database),
      cache(25),
-     nodeWorkerThread(&MapService::NodeWorkerLoop,this),
-     wayWorkerThread(&MapService::WayWorkerLoop,this),
-     wayLowZoomWorkerThread(&MapService::WayLowZoomWorkerLoop,this),
-     areaWorkerThread(&MapService::AreaWorkerLoop,this),
-     areaLowZoomWorkerThread(&MapService::AreaLowZoomWorkerLoop,this),
-     routeWorkerThread(&MapService::RouteWorkerLoop,this),
      nextCallbackId(0)
   {
-    // no code
+    size_t threadCount=std::max(1u,std::thread::hardware_concurrency());
+
+    workerThreads.reserve(threadCount);
+
+    for (size_t i=0; i<threadCount; i++) {
+      workerThreads.emplace_back(&MapService::WorkerLoop,this);
+    }
   }
 
   MapService::~MapService()
   {
-    nodeWorkerQueue.Stop();
-    wayWorkerQueue.Stop();
-    wayLowZoomWorkerQueue.Stop();
-    areaWorkerQueue.Stop();
-    routeWorkerQueue.Stop();
-    areaLowZoomWorkerQueue.Stop();
-
-    nodeWorkerThread.join();
-    wayWorkerThread.join();
-    wayLowZoomWorkerThread.join();
-    areaWorkerThread.join();
-    routeWorkerThread.join();
-    areaLowZoomWorkerThread.join();
+    workerQueue.Stop();
+
+    for (auto& thread : workerThreads) {
+      thread.join();
+    }
   }
 
   /**
@@ -141,7 +179,47 @@ namespace osmscout {
   }
 
   /**
-   * Evict tiles from cache until tile count <= cacheSize
+   * Set the maximum estimated memory in bytes used by the tile data cache,
+   * 0 for no limit
+   */
+  void MapService::SetCacheMemoryBudget(size_t memoryBudget)
+  {
+    std::lock_guard<std::mutex> lock(stateMutex);
+
+    cache.SetMemoryBudget(memoryBudget);
+  }
+
+  size_t MapService::GetCacheMemoryBudget() const
+  {
+    std::lock_guard<std::mutex> lock(stateMutex);
+
+    return cache.GetMemoryBudget();
+  }
+
+  size_t MapService::GetCurrentCacheMemory() const
+  {
+    std::lock_guard<std::mutex> lock(stateMutex);
+
+    return cache.GetCurrentMemory();
+  }
+
+  /**
+   * Print the statistics of the tile data cache and of the database
+   */
+  void MapService::DumpStatistics() const
+  {
+    {
+      std::lock_guard<std::mutex> lock(stateMutex);
+
+      cache.DumpStatistics();
+    }
+
+    database->DumpStatistics();
+  }
+
+  /**
+   * Evict tiles from cache until tile count <= cacheSize and the
+   * memory budget is met
    */
   void MapService::CleanupTileCache()
   {
@@ -285,10 +363,12 @@ namespace osmscout {
         }
 
         std::vector<NodeRef> nodes;
+        ObjectArenaRef       arena=parameter.GetUseObjectArena() ? std::make_shared<ObjectArena>() : nullptr;
 
         if (!database->GetNodesByOffset(offsets,
                                         boundingBox,
-                                        nodes)) {
+                                        nodes,
+                                        arena)) {
           log.Error() << "Error reading nodes in area!";
           return false;
         }
@@ -299,13 +379,13 @@ namespace osmscout {
 
         if (prefill)
         {
-          tile->GetNodeData().AddPrefillData(loadedNodeTypes,std::move(nodes));
+          tile->GetNodeData().AddPrefillData(loadedNodeTypes,std::move(nodes),arena);
         }
         else {
           if (cachedNodeTypes.Empty()){
-            tile->GetNodeData().SetData(loadedNodeTypes,std::move(nodes));
+            tile->GetNodeData().SetData(loadedNodeTypes,std::move(nodes),arena);
           }else{
-            tile->GetNodeData().AddData(loadedNodeTypes,nodes);
+            tile->GetNodeData().AddData(loadedNodeTypes,nodes,arena);
           }
         }
       }
@@ -449,9 +529,11 @@ namespace osmscout {
         }
 
         std::vector<AreaRef> areas;
+        ObjectArenaRef       arena=parameter.GetUseObjectArena() ? std::make_shared<ObjectArena>() : nullptr;
 
         if (!database->GetAreasByBlockSpans(spans,
-                                            areas)) {
+                                            areas,
+                                            arena)) {
           log.Error() << "Error reading areas in area!";
           return false;
         }
@@ -461,13 +543,13 @@ namespace osmscout {
         }
 
         if (prefill) {
-          tile->GetAreaData().AddPrefillData(loadedAreaTypes,std::move(areas));
+          tile->GetAreaData().AddPrefillData(loadedAreaTypes,std::move(areas),arena);
         }
         else {
           if (cachedAreaTypes.Empty()){
-            tile->GetAreaData().SetData(loadedAreaTypes,std::move(areas));
+            tile->GetAreaData().SetData(loadedAreaTypes,std::move(areas),arena);
           }else{
-            tile->GetAreaData().AddData(loadedAreaTypes,areas);
+            tile->GetAreaData().AddData(loadedAreaTypes,areas,arena);
           }
         }
       }
@@ -563,6 +645,8 @@ namespace osmscout {
                            const TileRef& tile) const
   {
     using namespace std::string_view_literals;
+    ObjectArenaRef arena=parameter.GetUseObjectArena() ? std::make_shared<ObjectArena>() : nullptr;
+
     return GetObjects(parameter,
                       wayTypes,
                       boundingBox,
@@ -570,10 +654,11 @@ namespace osmscout {
                       tile,
                       tile->GetWayData(),
                       database->GetAreaWayIndex(),
-                      [&db=this->database](const std::vector<FileOffset>& offsets, std::vector<WayRef>& ways){
-                        return db->GetWaysByOffset(offsets, ways);
+                      [&db=this->database, arena](const std::vector<FileOffset>& offsets, std::vector<WayRef>& ways){
+                        return db->GetWaysByOffset(offsets, ways, arena);
                       },
-                      "way"sv, "ways"sv);
+                      "way"sv, "ways"sv,
+                      arena);
   }
 
   bool MapService::GetRoutes(const AreaSearchParameter& parameter,
@@ -611,184 +696,305 @@ namespace osmscout {
                       "route"sv, "routes"sv);
   }
 
-  void MapService::NodeWorkerLoop()
+  void MapService::WorkerLoop()
   {
     std::packaged_task<bool()> task;
 
-    while (nodeWorkerQueue.PopTask(task)) {
+    while (workerQueue.PopTask(task)) {
       task();
+
+      // Release the tile referenced by the load
+      task=std::packaged_task<bool()>();
     }
   }
 
-  void MapService::WayWorkerLoop()
+  /**
+   * Queue the given load of the given kind of objects for the given tile.
+   *
+   * If an identical load for the tile is already queued or running (because
+   * another client requested the same tile), no new task is queued and the
+   * result of the existing load is returned instead. Loads are only shared
+   * between requests with equivalent parameters (see
+   * AreaSearchParameter::CanShareLoad()). A load with normal priority does
+   * not wait for a queued load with low priority, though, and aborted loads
+   * are not reused.
+   *
+   * Loads of the same kind of objects for the same tile that are not shared
+   * run one after the other. Each load checks the data already stored in the
+   * tile, so a later load only adds the data still missing.
+   */
+  std::shared_future<bool> MapService::PushTask(TileDataKind kind,
+                                                const TileRef& tile,
+                                                const AreaSearchParameter& parameter,
+                                                bool prefill,
+                                                const TypeInfoSet& types,
+                                                const std::function<bool()>& load) const
   {
-    std::packaged_task<bool()> task;
+    std::lock_guard<std::mutex> lock(inFlightMutex);
+    InFlightKey                 key(tile->GetKey(),kind);
+    auto                        entry=inFlightLoads.find(key);
 
-    while (wayWorkerQueue.PopTask(task)) {
-      task();
+    if (entry!=inFlightLoads.end() &&
+        entry->second.prefill==prefill &&
+        entry->second.parameter.CanShareLoad(parameter) &&
+        (!entry->second.parameter.GetLowPriority() || parameter.GetLowPriority()) &&
+        !entry->second.parameter.IsAborted() &&
+        entry->second.types==types) {
+      return entry->second.result;
     }
-  }
 
-  void MapService::WayLowZoomWorkerLoop()
-  {
-    std::packaged_task<bool()> task;
+    LoadLockRef& loadLock=loadLocks[key];
 
-    while (wayLowZoomWorkerQueue.PopTask(task)) {
-      task();
+    if (!loadLock) {
+      loadLock=std::make_shared<LoadLock>();
     }
-  }
 
-  void MapService::AreaWorkerLoop()
-  {
-    std::packaged_task<bool()> task;
+    loadLock->taskCount++;
 
-    while (areaWorkerQueue.PopTask(task)) {
-      task();
-    }
-  }
+    size_t                     id=nextInFlightId++;
+    std::packaged_task<bool()> task([this,key,id,load,loadLock=loadLock]() {
+      bool result;
 
-  void MapService::AreaLowZoomWorkerLoop()
-  {
-    std::packaged_task<bool()> task;
+      {
+        std::lock_guard<std::mutex> loadGuard(loadLock->mutex);
 
-    while (areaLowZoomWorkerQueue.PopTask(task)) {
-      task();
-    }
-  }
+        result=load();
+      }
 
-  void MapService::RouteWorkerLoop()
-  {
-    std::packaged_task<bool()> task;
+      std::lock_guard<std::mutex> inFlightLock(inFlightMutex);
+      auto                        inFlightEntry=inFlightLoads.find(key);
 
-    while (routeWorkerQueue.PopTask(task)) {
-      task();
-    }
-  }
+      // A later load with different parameters may have replaced us
+      if (inFlightEntry!=inFlightLoads.end() &&
+          inFlightEntry->second.id==id) {
+        inFlightLoads.erase(inFlightEntry);
+      }
 
-  std::future<bool> MapService::PushNodeTask(const AreaSearchParameter& parameter,
-                                             const TypeInfoSet& nodeTypes,
-                                             const GeoBox& boundingBox,
-                                             bool prefill,
-                                             const TileRef& tile) const
-  {
-    std::packaged_task<bool()> task(std::bind(&MapService::GetNodes,this,
-                                              parameter,
-                                              nodeTypes,
-                                              boundingBox,
-                                              prefill,
-                                              tile));
+      if (--loadLock->taskCount==0) {
+        loadLocks.erase(key);
+      }
+
+      return result;
+    });
 
-    std::future<bool> future=task.get_future();
+    std::shared_future<bool> future=task.get_future().share();
 
-    nodeWorkerQueue.PushTask(task);
+    inFlightLoads[key]=InFlightLoad{id,parameter,prefill,types,future};
+
+    if (parameter.GetLowPriority()) {
+      workerQueue.PushLowPriorityTask(task);
+    }
+    else {
+      workerQueue.PushTask(task);
+    }
 
     return future;
   }
 
-  std::future<bool> MapService::PushAreaLowZoomTask(const AreaSearchParameter& parameter,
-                                                    const TypeInfoSet& areaTypes,
-                                                    const Magnification& magnification,
+  std::shared_future<bool> MapService::PushNodeTask(const AreaSearchParameter& parameter,
+                                                    const TypeInfoSet& nodeTypes,
                                                     const GeoBox& boundingBox,
                                                     bool prefill,
                                                     const TileRef& tile) const
   {
-    std::packaged_task<bool()> task(std::bind(&MapService::GetAreasLowZoom,this,
-                                              parameter,
-                                              areaTypes,
-                                              magnification,
-                                              boundingBox,
-                                              prefill,
-                                              tile));
-
-    std::future<bool> future=task.get_future();
-
-    areaLowZoomWorkerQueue.PushTask(task);
-
-    return future;
+    return PushTask(TileDataKind::nodes,
+                    tile,
+                    parameter,
+                    prefill,
+                    nodeTypes,
+                    std::bind(&MapService::GetNodes,this,
+                              parameter,
+                              nodeTypes,
+                              boundingBox,
+                              prefill,
+                              tile));
   }
 
-  std::future<bool> MapService::PushAreaTask(const AreaSearchParameter& parameter,
-                                             const TypeInfoSet& areaTypes,
-                                             const Magnification& magnification,
-                                             const GeoBox& boundingBox,
-                                             bool prefill,
-                                             const TileRef& tile) const
+  std::shared_future<bool> MapService::PushAreaLowZoomTask(const AreaSearchParameter& parameter,
+                                                           const TypeInfoSet& areaTypes,
+                                                           const Magnification& magnification,
+                                                           const GeoBox& boundingBox,
+                                                           bool prefill,
+                                                           const TileRef& tile) const
   {
-    std::packaged_task<bool()> task(std::bind(&MapService::GetAreas,this,
-                                              parameter,
-                                              areaTypes,
-                                              magnification,
-                                              boundingBox,
-                                              prefill,
-                                              tile));
-
-    std::future<bool> future=task.get_future();
+    return PushTask(TileDataKind::areasLowZoom,
+                    tile,
+                    parameter,
+                    prefill,
+                    areaTypes,
+                    std::bind(&MapService::GetAreasLowZoom,this,
+                              parameter,
+                              areaTypes,
+                              magnification,
+                              boundingBox,
+                              prefill,
+                              tile));
+  }
 
-    areaWorkerQueue.PushTask(task);
+  std::shared_future<bool> MapService::PushAreaTask(const AreaSearchParameter& parameter,
+                                                    const TypeInfoSet& areaTypes,
+                                                    const Magnification& magnification,
+                                                    const GeoBox& boundingBox,
+                                                    bool prefill,
+                                                    const TileRef& tile) const
+  {
+    return PushTask(TileDataKind::areas,
+                    tile,
+                    parameter,
+                    prefill,
+                    areaTypes,
+                    std::bind(&MapService::GetAreas,this,
+                              parameter,
+                              areaTypes,
+                              magnification,
+                              boundingBox,
+                              prefill,
+                              tile));
+  }
 
-    return future;
+  std::shared_future<bool> MapService::PushWayLowZoomTask(const AreaSearchParameter& parameter,
+                                                          const TypeInfoSet& wayTypes,
+                                                          const Magnification& magnification,
+                                                          const GeoBox& boundingBox,
+                                                          bool prefill,
+                                                          const TileRef& tile) const
+  {
+    return PushTask(TileDataKind::waysLowZoom,
+                    tile,
+                    parameter,
+                    prefill,
+                    wayTypes,
+                    std::bind(&MapService::GetWaysLowZoom,this,
+                              parameter,
+                              wayTypes,
+                              magnification,
+                              boundingBox,
+                              prefill,
+                              tile));
   }
 
-  std::future<bool> MapService::PushWayLowZoomTask(const AreaSearchParameter& parameter,
+  std::shared_future<bool> MapService::PushWayTask(const AreaSearchParameter& parameter,
                                                    const TypeInfoSet& wayTypes,
-                                                   const Magnification& magnification,
                                                    const GeoBox& boundingBox,
                                                    bool prefill,
                                                    const TileRef& tile) const
   {
-    std::packaged_task<bool()> task(std::bind(&MapService::GetWaysLowZoom,this,
-                                              parameter,
-                                              wayTypes,
-                                              magnification,
-                                              boundingBox,
-                                              prefill,
-                                              tile));
+    return PushTask(TileDataKind::ways,
+                    tile,
+                    parameter,
+                    prefill,
+                    wayTypes,
+                    std::bind(&MapService::GetWays,this,
+                              parameter,
+                              wayTypes,
+                              boundingBox,
+                              prefill,
+                              tile));
+  }
 
-    std::future<bool> future=task.get_future();
+  std::shared_future<bool> MapService::PushRouteTask(const AreaSearchParameter& parameter,
+                                                     const TypeInfoSet& routeTypes,
+                                                     const GeoBox& boundingBox,
+                                                     bool prefill,
+                                                     const TileRef& tile) const
+  {
+    return PushTask(TileDataKind::routes,
+                    tile,
+                    parameter,
+                    prefill,
+                    routeTypes,
+                    std::bind(&MapService::GetRoutes,this,
+                              parameter,
+                              routeTypes,
+                              boundingBox,
+                              prefill,
+                              tile));
+  }
 
-    wayLowZoomWorkerQueue.PushTask(task);
+  /**
+   * Registers a prefill of the given kind of objects of the tile like a load and
+   * holds its load lock. Returns nullptr, if a load (or prefill) of the same kind
+   * is already queued or running. That load will add all data still missing anyway
+   * and a prefill in parallel would interleave with it.
+   */
+  MapService::LoadLockRef MapService::LockForPrefill(TileDataKind kind,
+                                                     const TileRef& tile) const
+  {
+    std::lock_guard<std::mutex> lock(inFlightMutex);
+    LoadLockRef&                loadLock=loadLocks[InFlightKey(tile->GetKey(),kind)];
 
-    return future;
+    if (loadLock) {
+      return nullptr;
+    }
+
+    loadLock=std::make_shared<LoadLock>();
+    loadLock->taskCount++;
+
+    // Not contended, the lock has just been created
+    loadLock->mutex.lock();
+
+    return loadLock;
   }
 
-  std::future<bool> MapService::PushWayTask(const AreaSearchParameter& parameter,
-                                            const TypeInfoSet& wayTypes,
-                                            const GeoBox& boundingBox,
-                                            bool prefill,
-                                            const TileRef& tile) const
+  void MapService::UnlockAfterPrefill(TileDataKind kind,
+                                      const TileRef& tile,
+                                      const LoadLockRef& loadLock) const
   {
-    std::packaged_task<bool()> task(std::bind(&MapService::GetWays,this,
-                                              parameter,
-                                              wayTypes,
-                                              boundingBox,
-                                              prefill,
-                                              tile));
-
-    std::future<bool> future=task.get_future();
+    loadLock->mutex.unlock();
 
-    wayWorkerQueue.PushTask(task);
+    std::lock_guard<std::mutex> lock(inFlightMutex);
 
-    return future;
+    if (--loadLock->taskCount==0) {
+      loadLocks.erase(InFlightKey(tile->GetKey(),kind));
+    }
   }
 
-  std::future<bool> MapService::PushRouteTask(const AreaSearchParameter& parameter,
-                                              const TypeInfoSet& routeTypes,
-                                              const GeoBox& boundingBox,
-                                              bool prefill,
-                                              const TileRef& tile) const
+  /**
+   * Prefill the tile with data from the cache. Loads of the same tile queued
+   * later wait for the prefill to finish. Kinds of objects that are already
+   * complete or are currently loaded are not prefilled.
+   */
+  void MapService::PrefillDataFromCache(const TileRef& tile,
+                                        const TypeDefinition& typeDefinition) const
   {
-    std::packaged_task<bool()> task(std::bind(&MapService::GetRoutes,this,
-                                              parameter,
-                                              routeTypes,
-                                              boundingBox,
-                                              prefill,
-                                              tile));
+    LoadLockRef nodeLock=LockForPrefill(TileDataKind::nodes,tile);
+    LoadLockRef wayLock=LockForPrefill(TileDataKind::ways,tile);
+    LoadLockRef areaLock=LockForPrefill(TileDataKind::areas,tile);
+    LoadLockRef routeLock=LockForPrefill(TileDataKind::routes,tile);
 
-    std::future<bool> future=task.get_future();
+    // Checked after locking, the last load may have finished in the meantime
+    TypeInfoSet nodeTypes=nodeLock && !tile->GetNodeData().IsComplete() ? typeDefinition.nodeTypes : TypeInfoSet();
+    TypeInfoSet wayTypes=wayLock && !tile->GetWayData().IsComplete() ? typeDefinition.wayTypes : TypeInfoSet();
+    TypeInfoSet areaTypes=areaLock && !tile->GetAreaData().IsComplete() ? typeDefinition.areaTypes : TypeInfoSet();
+    TypeInfoSet routeTypes=routeLock && !tile->GetRouteData().IsComplete() ? typeDefinition.routeTypes : TypeInfoSet();
 
-    routeWorkerQueue.PushTask(task);
+    {
+      std::lock_guard<std::mutex> lock(stateMutex);
 
-    return future;
+      cache.PrefillDataFromCache(*tile,
+                                 nodeTypes,
+                                 wayTypes,
+                                 areaTypes,
+                                 routeTypes,
+                                 typeDefinition.optimizedWayTypes,
+                                 typeDefinition.optimizedAreaTypes);
+    }
+
+    if (nodeLock) {
+      UnlockAfterPrefill(TileDataKind::nodes,tile,nodeLock);
+    }
+
+    if (wayLock) {
+      UnlockAfterPrefill(TileDataKind::ways,tile,wayLock);
+    }
+
+    if (areaLock) {
+      UnlockAfterPrefill(TileDataKind::areas,tile,areaLock);
+    }
+
+    if (routeLock) {
+      UnlockAfterPrefill(TileDataKind::routes,tile,routeLock);
+    }
   }
 
   void MapService::NotifyTileStateCallbacks(const TileRef& tile) const
@@ -873,20 +1079,23 @@ namespace osmscout {
 
   /**
    * Load all missing data for the given tiles based on the given style config.
+   *
+   * Each kind of object of each tile is loaded by a separate task, the tasks
+   * are distributed over all worker threads. The cache is only locked while
+   * prefilling a tile and during cleanup, so loads of multiple clients run
+   * in parallel.
    */
   bool MapService::LoadMissingTileDataStyleSheet(const AreaSearchParameter& parameter,
                                                  const StyleConfig& styleConfig,
                                                  std::list<TileRef>& tiles,
                                                  bool async) const
   {
-    std::lock_guard<std::mutex>  lock(stateMutex);
+    StopClock                           overallTime;
 
-    StopClock                    overallTime;
+    TypeDefinitionRef                   typeDefinition;
+    Magnification                       typeDefinitionMagnification;
 
-    TypeDefinitionRef            typeDefinition;
-    Magnification                typeDefinitionMagnification;
-
-    std::list<std::future<bool>> results;
+    std::list<std::shared_future<bool>> results;
 
     for (auto& tile : tiles) {
       GeoBox          tileBoundingBox(tile->GetBoundingBox());
@@ -907,13 +1116,8 @@ namespace osmscout {
           typeDefinitionMagnification=magnification;
         }
 
-        cache.PrefillDataFromCache(*tile,
-                                   typeDefinition->nodeTypes,
-                                   typeDefinition->wayTypes,
-                                   typeDefinition->areaTypes,
-                                   typeDefinition->routeTypes,
-                                   typeDefinition->optimizedWayTypes,
-                                   typeDefinition->optimizedAreaTypes);
+        PrefillDataFromCache(tile,
+                             *typeDefinition);
 
         NotifyTileStateCallbacks(tile);
 
@@ -997,6 +1201,8 @@ namespace osmscout {
       log.Warn() << "Retrieving all tile data took " << overallTime.ResultString();
     }
 
+    std::lock_guard<std::mutex> lock(stateMutex);
+
     cache.CleanupCache();
 
     return success;
@@ -1008,11 +1214,9 @@ namespace osmscout {
                                                      std::list<TileRef>& tiles,
                                                      bool async) const
   {
-    std::lock_guard<std::mutex>  lock(stateMutex);
-
-    StopClock                    overallTime;
+    StopClock                           overallTime;
 
-    std::list<std::future<bool>> results;
+    std::list<std::shared_future<bool>> results;
 
     for (auto& tile : tiles) {
       GeoBox tileBoundingBox(tile->GetBoundingBox());
@@ -1022,13 +1226,8 @@ namespace osmscout {
 
         //std::cout << "Loading tile: " << (std::string)tile->GetId() << std::endl;
 
-        cache.PrefillDataFromCache(*tile,
-                                   typeDefinition.nodeTypes,
-                                   typeDefinition.wayTypes,
-                                   typeDefinition.areaTypes,
-                                   typeDefinition.routeTypes,
-                                   typeDefinition.optimizedWayTypes,
-                                   typeDefinition.optimizedAreaTypes);
+        PrefillDataFromCache(tile,
+                             typeDefinition);
 
         NotifyTileStateCallbacks(tile);
 
@@ -1108,6 +1307,8 @@ namespace osmscout {
       log.Warn() << "Retrieving all tile data took " << overallTime.ResultString();
     }
 
+    std::lock_guard<std::mutex> lock(stateMutex);
+
     cache.CleanupCache();
 
     return success;
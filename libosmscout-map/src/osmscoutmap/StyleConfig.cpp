@@ -56,6 +56,34 @@ namespace osmscout {
     }
   }
 
+  /**
+   * Return true, if the feature is set in the given buffer and - if the filter
+   * references a flag of the feature - the flag is set, too.
+   */
+  bool StyleResolveContext::MatchesFeature(const FeatureFilterData& feature,
+                                           const FeatureValueBuffer& buffer) const
+  {
+    if (!HasFeature(feature.featureFilterIndex,
+                    buffer)) {
+      return false;
+    }
+
+    if (feature.flagIndex!=std::numeric_limits<size_t>::max()) {
+      FeatureValue *value=GetFeatureValue(feature.featureFilterIndex,
+                                          buffer);
+
+      if (value==nullptr) {
+        return false;
+      }
+
+      if (!value->IsFlagSet(feature.flagIndex)) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
   size_t StyleResolveContext::GetFeatureReaderIndex(const Feature& feature)
   {
     auto entry=featureReaderMap.find(feature.GetName());
@@ -267,23 +295,10 @@ namespace osmscout {
                               double meterInMM) const
   {
     for (const auto& feature : features) {
-      if (!context.HasFeature(feature.featureFilterIndex,
-                              buffer)) {
+      if (!context.MatchesFeature(feature,
+                                  buffer)) {
         return false;
       }
-
-      if (feature.flagIndex!=std::numeric_limits<size_t>::max()) {
-        FeatureValue *value=context.GetFeatureValue(feature.featureFilterIndex,
-                                                    buffer);
-
-        if (value==nullptr) {
-          return false;
-        }
-
-        if (!value->IsFlagSet(feature.flagIndex)) {
-          return false;
-        }
-      }
     }
 
     if (oneway &&
@@ -333,6 +348,8 @@ namespace osmscout {
     nodeIconStyleConditionals.clear();
     nodeTextStyleSelectors.clear();
     nodeIconStyleSelectors.clear();
+    nodeTextStyleDecisions.clear();
+    nodeIconStyleDecisions.Clear();
     nodeTypeSets.clear();
 
     wayPrio.clear();
@@ -344,6 +361,10 @@ namespace osmscout {
     wayPathTextStyleSelectors.clear();
     wayPathSymbolStyleSelectors.clear();
     wayPathShieldStyleSelectors.clear();
+    wayLineStyleDecisions.clear();
+    wayPathTextStyleDecisions.Clear();
+    wayPathSymbolStyleDecisions.clear();
+    wayPathShieldStyleDecisions.Clear();
     wayTypeSets.clear();
     wayTextFlags.clear();
     wayShieldFlags.clear();
@@ -361,11 +382,19 @@ namespace osmscout {
     areaIconStyleSelectors.clear();
     areaBorderTextStyleSelectors.clear();
     areaBorderSymbolStyleSelectors.clear();
+    areaFillStyleDecisions.Clear();
+    areaBorderStyleDecisions.clear();
+    areaTextStyleDecisions.clear();
+    areaIconStyleDecisions.Clear();
+    areaBorderTextStyleDecisions.Clear();
+    areaBorderSymbolStyleDecisions.Clear();
     areaTypeSets.clear();
 
     routeTypeSets.clear();
     routeLineStyleSelectors.clear();
     routePathTextStyleConditionals.clear();
+    routeLineStyleDecisions.clear();
+    routePathTextStyleDecisions.Clear();
 
     constants.clear();
   }
@@ -918,6 +947,44 @@ namespace osmscout {
     }
   }
 
+  template <class S, class A>
+  void CompileDecisionsBySlot(const std::vector<std::vector<std::vector<std::list<StyleSelector<S,A> > > > >& selectors,
+                              std::vector<StyleDecisionTable<S,A> >& decisions)
+  {
+    decisions.clear();
+    decisions.resize(selectors.size());
+
+    for (size_t slot=0; slot<selectors.size(); slot++) {
+      decisions[slot].Compile(selectors[slot]);
+    }
+  }
+
+  /**
+   * Compile the style selectors into decision tables for fast style resolution. Must be
+   * called after all other postprocessing steps, since the decision tables hold
+   * (composed) copies of the styles.
+   */
+  void StyleConfig::PostprocessDecisions()
+  {
+    CompileDecisionsBySlot(nodeTextStyleSelectors,nodeTextStyleDecisions);
+    nodeIconStyleDecisions.Compile(nodeIconStyleSelectors);
+
+    CompileDecisionsBySlot(wayLineStyleSelectors,wayLineStyleDecisions);
+    wayPathTextStyleDecisions.Compile(wayPathTextStyleSelectors);
+    CompileDecisionsBySlot(wayPathSymbolStyleSelectors,wayPathSymbolStyleDecisions);
+    wayPathShieldStyleDecisions.Compile(wayPathShieldStyleSelectors);
+
+    areaFillStyleDecisions.Compile(areaFillStyleSelectors);
+    CompileDecisionsBySlot(areaBorderStyleSelectors,areaBorderStyleDecisions);
+    CompileDecisionsBySlot(areaTextStyleSelectors,areaTextStyleDecisions);
+    areaIconStyleDecisions.Compile(areaIconStyleSelectors);
+    areaBorderTextStyleDecisions.Compile(areaBorderTextStyleSelectors);
+    areaBorderSymbolStyleDecisions.Compile(areaBorderSymbolStyleSelectors);
+
+    CompileDecisionsBySlot(routeLineStyleSelectors,routeLineStyleDecisions);
+    routePathTextStyleDecisions.Compile(routePathTextStyleSelectors);
+  }
+
   void StyleConfig::Postprocess()
   {
     PostprocessNodes();
@@ -927,6 +994,8 @@ namespace osmscout {
 
     PostprocessIconId();
     PostprocessPatternId();
+
+    PostprocessDecisions();
   }
 
   TypeConfigRef StyleConfig::GetTypeConfig() const
@@ -1097,62 +1166,6 @@ namespace osmscout {
     }
   }
 
-  /**
-   * Get the style data based on the given features of an object,
-   * a given style (S) and its style attributes (A).
-   */
-  template <class S, class A>
-  std::shared_ptr<S> GetFeatureStyle(const StyleResolveContext& context,
-                                     const std::vector<std::list<StyleSelector<S,A> > >& styleSelectors,
-                                     const FeatureValueBuffer& buffer,
-                                     const Projection& projection)
-  {
-    assert(!styleSelectors.empty());
-
-    bool               fastpath=false;
-    bool               composed=false;
-    size_t             level=projection.GetMagnification().GetLevel();
-    double             meterInPixel=projection.GetMeterInPixel();
-    double             meterInMM=projection.GetMeterInMM();
-    std::shared_ptr<S> style;
-
-    if (level>=styleSelectors.size()) {
-      level=styleSelectors.size()-1;
-    }
-
-    for (const auto& selector : styleSelectors[level]) {
-      if (!selector.criteria.Matches(context,
-                                     buffer,
-                                     meterInPixel,
-                                     meterInMM)) {
-        continue;
-      }
-
-      if (!style) {
-        style=selector.style;
-        fastpath=true;
-
-        continue;
-      }
-
-      if (fastpath) {
-        style=std::make_shared<S>(*style);
-        fastpath=false;
-      }
-
-      style->CopyAttributes(*selector.style,
-                            selector.attributes);
-      composed=true;
-    }
-
-    if (composed &&
-        !style->IsVisible()) {
-      style=nullptr;
-    }
-
-    return style;
-  }
-
   bool StyleConfig::HasNodeTextStyles(const TypeInfoRef& type,
                                       const Magnification& magnification) const
   {
@@ -1177,13 +1190,13 @@ namespace osmscout {
   {
 
     textStyles.clear();
-    textStyles.reserve(nodeTextStyleSelectors.size());
+    textStyles.reserve(nodeTextStyleDecisions.size());
 
-    for (const auto& nodeTextStyleSelector : nodeTextStyleSelectors) {
-      TextStyleRef style=GetFeatureStyle(styleResolveContext,
-                                         nodeTextStyleSelector[buffer.GetType()->GetIndex()],
-                                         buffer,
-                                         projection);
+    for (const auto& nodeTextStyleDecision : nodeTextStyleDecisions) {
+      TextStyleRef style=nodeTextStyleDecision.GetStyle(styleResolveContext,
+                                                        buffer.GetType()->GetIndex(),
+                                                        buffer,
+                                                        projection);
 
       if (style) {
         textStyles.push_back(style);
@@ -1196,11 +1209,11 @@ namespace osmscout {
   {
     size_t count=0;
 
-    for (const auto& nodeTextStyleSelector : nodeTextStyleSelectors) {
-      TextStyleRef style=GetFeatureStyle(styleResolveContext,
-                                         nodeTextStyleSelector[buffer.GetType()->GetIndex()],
-                                         buffer,
-                                         projection);
+    for (const auto& nodeTextStyleDecision : nodeTextStyleDecisions) {
+      TextStyleRef style=nodeTextStyleDecision.GetStyle(styleResolveContext,
+                                                        buffer.GetType()->GetIndex(),
+                                                        buffer,
+                                                        projection);
 
       if (style) {
         count++;
@@ -1213,10 +1226,10 @@ namespace osmscout {
   IconStyleRef StyleConfig::GetNodeIconStyle(const FeatureValueBuffer& buffer,
                                              const Projection& projection) const
   {
-    return GetFeatureStyle(styleResolveContext,
-                           nodeIconStyleSelectors[buffer.GetType()->GetIndex()],
-                           buffer,
-                           projection);
+    return nodeIconStyleDecisions.GetStyle(styleResolveContext,
+                                           buffer.GetType()->GetIndex(),
+                                           buffer,
+                                           projection);
   }
 
   void StyleConfig::GetWayLineStyles(const FeatureValueBuffer& buffer,
@@ -1224,15 +1237,15 @@ namespace osmscout {
                                      std::vector<LineStyleRef>& lineStyles) const
   {
     lineStyles.clear();
-    lineStyles.reserve(wayLineStyleSelectors.size());
+    lineStyles.reserve(wayLineStyleDecisions.size());
 
     bool requireSort=false;
 
-    for (const auto& wayLineStyleSelector : wayLineStyleSelectors) {
-      LineStyleRef style=GetFeatureStyle(styleResolveContext,
-                                         wayLineStyleSelector[buffer.GetType()->GetIndex()],
-                                         buffer,
-                                         projection);
+    for (const auto& wayLineStyleDecision : wayLineStyleDecisions) {
+      LineStyleRef style=wayLineStyleDecision.GetStyle(styleResolveContext,
+                                                       buffer.GetType()->GetIndex(),
+                                                       buffer,
+                                                       projection);
 
       if (style) {
         if (style->GetOffsetRel()!=OffsetRel::base) {
@@ -1258,15 +1271,15 @@ namespace osmscout {
                                        std::vector<LineStyleRef>& lineStyles) const
   {
     lineStyles.clear();
-    lineStyles.reserve(routeLineStyleSelectors.size());
+    lineStyles.reserve(routeLineStyleDecisions.size());
 
     bool requireSort=false;
 
-    for (const auto& routeLineStyleSelector : routeLineStyleSelectors) {
-      LineStyleRef style=GetFeatureStyle(styleResolveContext,
-                                         routeLineStyleSelector[buffer.GetType()->GetIndex()],
-                                         buffer,
-                                         projection);
+    for (const auto& routeLineStyleDecision : routeLineStyleDecisions) {
+      LineStyleRef style=routeLineStyleDecision.GetStyle(styleResolveContext,
+                                                         buffer.GetType()->GetIndex(),
+                                                         buffer,
+                                                         projection);
 
       if (style) {
         if (style->GetOffsetRel()!=OffsetRel::base) {
@@ -1292,12 +1305,12 @@ namespace osmscout {
                                           std::vector<PathSymbolStyleRef> &symbolStyles) const
   {
     symbolStyles.clear();
-    symbolStyles.reserve(wayLineStyleSelectors.size());
-    for (const auto& wayPathSymbolStyleSelector : wayPathSymbolStyleSelectors) {
-      PathSymbolStyleRef style=GetFeatureStyle(styleResolveContext,
-                                               wayPathSymbolStyleSelector[buffer.GetType()->GetIndex()],
-                                               buffer,
-                                               projection);
+    symbolStyles.reserve(wayLineStyleDecisions.size());
+    for (const auto& wayPathSymbolStyleDecision : wayPathSymbolStyleDecisions) {
+      PathSymbolStyleRef style=wayPathSymbolStyleDecision.GetStyle(styleResolveContext,
+                                                                   buffer.GetType()->GetIndex(),
+                                                                   buffer,
+                                                                   projection);
       if (style) {
         symbolStyles.push_back(style);
       }
@@ -1308,10 +1321,10 @@ namespace osmscout {
   PathTextStyleRef StyleConfig::GetWayPathTextStyle(const FeatureValueBuffer& buffer,
                                                     const Projection& projection) const
   {
-    return GetFeatureStyle(styleResolveContext,
-                           wayPathTextStyleSelectors[buffer.GetType()->GetIndex()],
-                           buffer,
-                           projection);
+    return wayPathTextStyleDecisions.GetStyle(styleResolveContext,
+                                              buffer.GetType()->GetIndex(),
+                                              buffer,
+                                              projection);
   }
 
   bool StyleConfig::HasWayPathTextStyle(const Projection& projection) const
@@ -1326,19 +1339,19 @@ namespace osmscout {
   PathTextStyleRef StyleConfig::GetRoutePathTextStyle(const FeatureValueBuffer& buffer,
                                                       const Projection& projection) const
   {
-    return GetFeatureStyle(styleResolveContext,
-                           routePathTextStyleSelectors[buffer.GetType()->GetIndex()],
-                           buffer,
-                           projection);
+    return routePathTextStyleDecisions.GetStyle(styleResolveContext,
+                                                buffer.GetType()->GetIndex(),
+                                                buffer,
+                                                projection);
   }
 
   PathShieldStyleRef StyleConfig::GetWayPathShieldStyle(const FeatureValueBuffer& buffer,
                                                         const Projection& projection) const
   {
-    return GetFeatureStyle(styleResolveContext,
-                           wayPathShieldStyleSelectors[buffer.GetType()->GetIndex()],
-                           buffer,
-                           projection);
+    return wayPathShieldStyleDecisions.GetStyle(styleResolveContext,
+                                                buffer.GetType()->GetIndex(),
+                                                buffer,
+                                                projection);
   }
 
   bool StyleConfig::HasWayPathShieldStyle(const Projection& projection) const
@@ -1354,10 +1367,10 @@ namespace osmscout {
                                              const FeatureValueBuffer& buffer,
                                              const Projection& projection) const
   {
-    return GetFeatureStyle(styleResolveContext,
-                           areaFillStyleSelectors[type->GetIndex()],
-                           buffer,
-                           projection);
+    return areaFillStyleDecisions.GetStyle(styleResolveContext,
+                                           type->GetIndex(),
+                                           buffer,
+                                           projection);
   }
 
   void StyleConfig::GetAreaBorderStyles(const TypeInfoRef& type,
@@ -1366,13 +1379,13 @@ namespace osmscout {
                                         std::vector<BorderStyleRef>& borderStyles) const
   {
     borderStyles.clear();
-    borderStyles.reserve(areaBorderStyleSelectors.size());
+    borderStyles.reserve(areaBorderStyleDecisions.size());
 
-    for (const auto& areaBorderStyleSelector : areaBorderStyleSelectors) {
-      BorderStyleRef style=GetFeatureStyle(styleResolveContext,
-                                           areaBorderStyleSelector[type->GetIndex()],
-                                           buffer,
-                                           projection);
+    for (const auto& areaBorderStyleDecision : areaBorderStyleDecisions) {
+      BorderStyleRef style=areaBorderStyleDecision.GetStyle(styleResolveContext,
+                                                            type->GetIndex(),
+                                                            buffer,
+                                                            projection);
 
       if (style) {
         borderStyles.push_back(style);
@@ -1404,13 +1417,13 @@ namespace osmscout {
                                       std::vector<TextStyleRef>& textStyles) const
   {
     textStyles.clear();
-    textStyles.reserve(areaTextStyleSelectors.size());
+    textStyles.reserve(areaTextStyleDecisions.size());
 
-    for (const auto& areaTextStyleSelector : areaTextStyleSelectors) {
-      TextStyleRef style=GetFeatureStyle(styleResolveContext,
-                                         areaTextStyleSelector[type->GetIndex()],
-                                         buffer,
-                                         projection);
+    for (const auto& areaTextStyleDecision : areaTextStyleDecisions) {
+      TextStyleRef style=areaTextStyleDecision.GetStyle(styleResolveContext,
+                                                        type->GetIndex(),
+                                                        buffer,
+                                                        projection);
 
       if (style) {
         textStyles.push_back(style);
@@ -1424,11 +1437,11 @@ namespace osmscout {
   {
     size_t count=0;
 
-    for (const auto& areaTextStyleSelector : areaTextStyleSelectors) {
-      TextStyleRef style=GetFeatureStyle(styleResolveContext,
-                                         areaTextStyleSelector[type->GetIndex()],
-                                         buffer,
-                                         projection);
+    for (const auto& areaTextStyleDecision : areaTextStyleDecisions) {
+      TextStyleRef style=areaTextStyleDecision.GetStyle(styleResolveContext,
+                                                        type->GetIndex(),
+                                                        buffer,
+                                                        projection);
 
       if (style) {
         count++;
@@ -1442,71 +1455,71 @@ namespace osmscout {
                                              const FeatureValueBuffer& buffer,
                                              const Projection& projection) const
   {
-    return GetFeatureStyle(styleResolveContext,
-                           areaIconStyleSelectors[type->GetIndex()],
-                           buffer,
-                           projection);
+    return areaIconStyleDecisions.GetStyle(styleResolveContext,
+                                           type->GetIndex(),
+                                           buffer,
+                                           projection);
   }
 
   PathTextStyleRef StyleConfig::GetAreaBorderTextStyle(const TypeInfoRef& type,
                                                        const FeatureValueBuffer& buffer,
                                                        const Projection& projection) const
   {
-    return GetFeatureStyle(styleResolveContext,
-                           areaBorderTextStyleSelectors[type->GetIndex()],
-                           buffer,
-                           projection);
+    return areaBorderTextStyleDecisions.GetStyle(styleResolveContext,
+                                                 type->GetIndex(),
+                                                 buffer,
+                                                 projection);
   }
 
   PathSymbolStyleRef StyleConfig::GetAreaBorderSymbolStyle(const TypeInfoRef& type,
                                                            const FeatureValueBuffer& buffer,
                                                            const Projection& projection) const
   {
-    return GetFeatureStyle(styleResolveContext,
-                           areaBorderSymbolStyleSelectors[type->GetIndex()],
-                           buffer,
-                           projection);
+    return areaBorderSymbolStyleDecisions.GetStyle(styleResolveContext,
+                                                   type->GetIndex(),
+                                                   buffer,
+                                                   projection);
   }
 
   FillStyleRef StyleConfig::GetLandFillStyle(const Projection& projection) const
   {
-    return GetFeatureStyle(styleResolveContext,
-                           areaFillStyleSelectors[tileLandBuffer.GetType()->GetIndex()],
-                           tileLandBuffer,
-                           projection);
+    return areaFillStyleDecisions.GetStyle(styleResolveContext,
+                                           tileLandBuffer.GetType()->GetIndex(),
+                                           tileLandBuffer,
+                                           projection);
   }
 
   FillStyleRef StyleConfig::GetSeaFillStyle(const Projection& projection) const
   {
-    return GetFeatureStyle(styleResolveContext,
-                           areaFillStyleSelectors[tileSeaBuffer.GetType()->GetIndex()],
-                           tileSeaBuffer,
-                           projection);
+    return areaFillStyleDecisions.GetStyle(styleResolveContext,
+                                           tileSeaBuffer.GetType()->GetIndex(),
+                                           tileSeaBuffer,
+                                           projection);
   }
 
   FillStyleRef StyleConfig::GetCoastFillStyle(const Projection& projection) const
   {
-    return GetFeatureStyle(styleResolveContext,
-                           areaFillStyleSelectors[tileCoastBuffer.GetType()->GetIndex()],
-                           tileCoastBuffer,
-                           projection);
+    return areaFillStyleDecisions.GetStyle(styleResolveContext,
+                                           tileCoastBuffer.GetType()->GetIndex(),
+                                           tileCoastBuffer,
+                                           projection);
   }
 
   FillStyleRef StyleConfig::GetUnknownFillStyle(const Projection& projection) const
   {
-    return GetFeatureStyle(styleResolveContext,
-                           areaFillStyleSelectors[tileUnknownBuffer.GetType()->GetIndex()],
-                           tileUnknownBuffer,
-                           projection);
+    return areaFillStyleDecisions.GetStyle(styleResolveContext,
+                                           tileUnknownBuffer.GetType()->GetIndex(),
+                                           tileUnknownBuffer,
+                                           projection);
   }
 
   LineStyleRef StyleConfig::GetCoastlineLineStyle(const Projection& projection) const
   {
-    for (const auto& wayLineStyleSelector : wayLineStyleSelectors) {
-      LineStyleRef style=GetFeatureStyle(styleResolveContext,
-                                         wayLineStyleSelector[coastlineBuffer.GetType()->GetIndex()],
-                                         coastlineBuffer,
-                                         projection);
+    for (const auto& wayLineStyleDecision : wayLineStyleDecisions) {
+      LineStyleRef style=wayLineStyleDecision.GetStyle(styleResolveContext,
+                                                       coastlineBuffer.GetType()->GetIndex(),
+                                                       coastlineBuffer,
+                                                       projection);
 
       if (style) {
         return style;
@@ -1518,11 +1531,11 @@ namespace osmscout {
 
   LineStyleRef StyleConfig::GetOSMTileBorderLineStyle(const Projection& projection) const
   {
-    for (const auto& wayLineStyleSelector : wayLineStyleSelectors) {
-      LineStyleRef style=GetFeatureStyle(styleResolveContext,
-                                         wayLineStyleSelector[osmTileBorderBuffer.GetType()->GetIndex()],
-                                         osmTileBorderBuffer,
-                                         projection);
+    for (const auto& wayLineStyleDecision : wayLineStyleDecisions) {
+      LineStyleRef style=wayLineStyleDecision.GetStyle(styleResolveContext,
+                                                       osmTileBorderBuffer.GetType()->GetIndex(),
+                                                       osmTileBorderBuffer,
+                                                       projection);
 
       if (style) {
         return style;
@@ -1534,11 +1547,11 @@ namespace osmscout {
 
   LineStyleRef StyleConfig::GetOSMSubTileBorderLineStyle(const Projection& projection) const
   {
-    for (const auto& wayLineStyleSelector : wayLineStyleSelectors) {
-      LineStyleRef style=GetFeatureStyle(styleResolveContext,
-                                         wayLineStyleSelector[osmSubTileBorderBuffer.GetType()->GetIndex()],
-                                         osmSubTileBorderBuffer,
-                                         projection);
+    for (const auto& wayLineStyleDecision : wayLineStyleDecisions) {
+      LineStyleRef style=wayLineStyleDecision.GetStyle(styleResolveContext,
+                                                       osmSubTileBorderBuffer.GetType()->GetIndex(),
+                                                       osmSubTileBorderBuffer,
+                                                       projection);
 
       if (style) {
         return style;
@@ -1601,6 +1614,69 @@ namespace osmscout {
     }
   }
 
+  /**
+   * Copy the selectors of all slots for the given type and level, one list per slot
+   */
+  template<class S, class A>
+  static void GetSlotStyleSelectors(const std::vector<std::vector<std::vector<std::list<StyleSelector<S,A>>>>>& slots,
+                                    size_t level,
+                                    const TypeInfoRef& type,
+                                    std::vector<std::list<StyleSelector<S,A>>>& selectors)
+  {
+    selectors.clear();
+    selectors.reserve(slots.size());
+
+    for (const auto& slotEntry : slots) {
+      size_t l=level;
+
+      if (l>=slotEntry[type->GetIndex()].size()) {
+        l=slotEntry[type->GetIndex()].size()-1;
+      }
+
+      selectors.push_back(slotEntry[type->GetIndex()][l]);
+    }
+  }
+
+  void StyleConfig::GetNodeTextStyleSelectors(size_t level,
+                                              const TypeInfoRef& type,
+                                              std::vector<TextStyleSelectorList>& selectors) const
+  {
+    GetSlotStyleSelectors(nodeTextStyleSelectors,
+                          level,
+                          type,
+                          selectors);
+  }
+
+  void StyleConfig::GetWayLineStyleSelectors(size_t level,
+                                             const TypeInfoRef& type,
+                                             std::vector<LineStyleSelectorList>& selectors) const
+  {
+    GetSlotStyleSelectors(wayLineStyleSelectors,
+                          level,
+                          type,
+                          selectors);
+  }
+
+  void StyleConfig::GetAreaBorderStyleSelectors(size_t level,
+                                                const TypeInfoRef& type,
+                                                std::vector<BorderStyleSelectorList>& selectors) const
+  {
+    GetSlotStyleSelectors(areaBorderStyleSelectors,
+                          level,
+                          type,
+                          selectors);
+  }
+
+  void StyleConfig::GetAreaTextStyleSelectors(size_t level,
+                                              const TypeInfoRef& type,
+                                              std::vector<TextStyleSelectorList>& selectors) const
+  {
+    GetSlotStyleSelectors(areaTextStyleSelectors,
+                          level,
+                          type,
+                          selectors);
+  }
+
   bool StyleConfig::LoadContent(const std::string& filename,
                                 const std::string& content,
                                 ColorPostprocessor colorPostprocessor,
@@ -0,0 +1,347 @@
+/*
+  This source is part of the libosmscout-map library
+  Copyright (C) 2026  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <osmscoutmap/TilePrefetcher.h>
+
+#include <algorithm>
+#include <vector>
+
+namespace osmscout {
+
+  double TilePrefetcher::Statistics::GetHitRate() const
+  {
+    size_t total=hits+lateHits+misses;
+
+    if (total==0) {
+      return 0.0;
+    }
+
+    return static_cast<double>(hits)/static_cast<double>(total);
+  }
+
+  TilePrefetcher::TilePrefetcher(const MapServiceRef& mapService,
+                                 const StyleConfigRef& styleConfig)
+  : mapService(mapService),
+    styleConfig(styleConfig)
+  {
+    // no code
+  }
+
+  TilePrefetcher::~TilePrefetcher()
+  {
+    Cancel();
+  }
+
+  /**
+   * Set the parameter used for loading the tiles. Breaker and priority of
+   * the parameter are overwritten by the prefetcher.
+   */
+  void TilePrefetcher::SetSearchParameter(const AreaSearchParameter& parameter)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    searchParameter=parameter;
+  }
+
+  /**
+   * Set how far into the future the viewport is predicted
+   */
+  void TilePrefetcher::SetLookAhead(const std::chrono::milliseconds& lookAhead)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    this->lookAhead=lookAhead;
+  }
+
+  /**
+   * Set the maximum number of tiles loaded by one prefetch
+   */
+  void TilePrefetcher::SetMaxTiles(size_t maxTiles)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    this->maxTiles=maxTiles;
+  }
+
+  void TilePrefetcher::UpdateStatistics(const std::list<TileRef>& tiles)
+  {
+    std::set<TileKey> currentTiles;
+
+    for (const auto& tile : tiles) {
+      TileKey key=tile->GetKey();
+
+      currentTiles.insert(key);
+
+      // Only count tiles becoming visible
+      if (visibleTiles.find(key)!=visibleTiles.end()) {
+        continue;
+      }
+
+      if (prefetchedTiles.erase(key)>0) {
+        if (tile->IsComplete()) {
+          statistics.hits++;
+        }
+        else {
+          statistics.lateHits++;
+        }
+      }
+      else if (!tile->IsComplete()) {
+        statistics.misses++;
+      }
+    }
+
+    visibleTiles=std::move(currentTiles);
+  }
+
+  void TilePrefetcher::AddPrefetchedTile(const TileKey& key)
+  {
+    if (!prefetchedTiles.insert(key).second) {
+      return;
+    }
+
+    prefetchedOrder.push_back(key);
+
+    // Forget about prefetched tiles that did not become visible for a long time
+    while (prefetchedOrder.size()>4*maxTiles) {
+      prefetchedTiles.erase(prefetchedOrder.front());
+      prefetchedOrder.pop_front();
+    }
+  }
+
+  /**
+   * Return the tiles of the viewport predicted from the history, that are
+   * neither visible nor completely loaded, nearest to the predicted center
+   * first.
+   */
+  void TilePrefetcher::PredictTiles(const Viewport& current,
+                                    std::list<TileRef>& tiles) const
+  {
+    const Viewport& oldest=history.front();
+    double          seconds=std::chrono::duration<double>(current.time-oldest.time).count();
+
+    if (seconds<=0.0) {
+      return;
+    }
+
+    double factor=std::chrono::duration<double>(lookAhead).count()/seconds;
+    double latShift=(current.center.GetLat()-oldest.center.GetLat())*factor;
+    double lonShift=(current.center.GetLon()-oldest.center.GetLon())*factor;
+    bool   zoomingIn=current.magnification>oldest.magnification;
+    bool   zoomingOut=current.magnification<oldest.magnification;
+
+    if (latShift==0.0 &&
+        lonShift==0.0 &&
+        !zoomingIn &&
+        !zoomingOut) {
+      return;
+    }
+
+    GeoCoord predictedCenter(std::clamp(current.center.GetLat()+latShift,-85.0,85.0),
+                             std::clamp(current.center.GetLon()+lonShift,-180.0,180.0));
+    double   latHalf=current.boundingBox.GetHeight()/2;
+    double   lonHalf=current.boundingBox.GetWidth()/2;
+
+    auto getBox=[&predictedCenter](double latExtent, double lonExtent) {
+      return GeoBox(GeoCoord(std::max(predictedCenter.GetLat()-latExtent,-85.0),
+                             std::max(predictedCenter.GetLon()-lonExtent,-180.0)),
+                    GeoCoord(std::min(predictedCenter.GetLat()+latExtent,85.0),
+                             std::min(predictedCenter.GetLon()+lonExtent,180.0)));
+    };
+
+    Magnification      magnification(current.magnification);
+    std::list<TileRef> candidates;
+
+    if (latShift!=0.0 ||
+        lonShift!=0.0) {
+      mapService->LookupTiles(magnification,
+                              getBox(latHalf,lonHalf),
+                              candidates);
+    }
+
+    // While zooming, the next zoom level covers half (or twice) the area
+    if (zoomingIn ||
+        (zoomingOut && magnification.GetLevel()>0)) {
+      std::list<TileRef> zoomTiles;
+      double             zoomFactor=zoomingIn ? 0.5 : 2.0;
+
+      mapService->LookupTiles(Magnification(MagnificationLevel(zoomingIn ? magnification.GetLevel()+1 : magnification.GetLevel()-1)),
+                              getBox(latHalf*zoomFactor,lonHalf*zoomFactor),
+                              zoomTiles);
+
+      candidates.splice(candidates.end(),zoomTiles);
+    }
+
+    std::vector<std::pair<double,TileRef>> sortedCandidates;
+
+    for (const auto& tile : candidates) {
+      if (tile->IsComplete() ||
+          visibleTiles.find(tile->GetKey())!=visibleTiles.end()) {
+        continue;
+      }
+
+      GeoCoord tileCenter=tile->GetBoundingBox().GetCenter();
+      double   latDistance=tileCenter.GetLat()-predictedCenter.GetLat();
+      double   lonDistance=tileCenter.GetLon()-predictedCenter.GetLon();
+
+      sortedCandidates.emplace_back(latDistance*latDistance+lonDistance*lonDistance,tile);
+    }
+
+    std::stable_sort(sortedCandidates.begin(),
+                     sortedCandidates.end(),
+                     [](const std::pair<double,TileRef>& a, const std::pair<double,TileRef>& b) {
+                       return a.first<b.first;
+                     });
+
+    for (const auto& candidate : sortedCandidates) {
+      if (tiles.size()>=maxTiles) {
+        break;
+      }
+
+      tiles.push_back(candidate.second);
+    }
+  }
+
+  void TilePrefetcher::CancelPrefetch()
+  {
+    if (breaker &&
+        std::any_of(pendingTiles.begin(),
+                    pendingTiles.end(),
+                    [](const TileRef& tile) {
+                      return !tile->IsComplete();
+                    })) {
+      breaker->Break();
+      statistics.cancelledPrefetches++;
+    }
+
+    breaker=nullptr;
+    pendingTiles.clear();
+  }
+
+  /**
+   * Pass the new viewport of the map to the prefetcher. Must be called for
+   * each new viewport, before loading the data of the visible tiles.
+   *
+   * If the prediction contains tiles not prefetched yet, the current prefetch
+   * is cancelled and a new prefetch for the predicted tiles is started.
+   *
+   * @param projection
+   *    The new viewport
+   * @param time
+   *    The time the viewport was shown
+   */
+  void TilePrefetcher::ViewportChanged(const Projection& projection,
+                                       const Clock::time_point& time)
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::list<TileRef>          tiles;
+
+    mapService->LookupTiles(projection,
+                            tiles);
+
+    UpdateStatistics(tiles);
+
+    Viewport current{time,
+                     projection.GetCenter(),
+                     projection.GetMagnification().GetMagnification(),
+                     projection.GetDimensions()};
+
+    while (!history.empty() &&
+           current.time-history.front().time>historyDuration) {
+      history.pop_front();
+    }
+
+    history.push_back(current);
+
+    std::list<TileRef> predictedTiles;
+
+    PredictTiles(current,
+                 predictedTiles);
+
+    std::set<TileKey> predictedKeys;
+    std::set<TileKey> pendingKeys;
+
+    for (const auto& tile : predictedTiles) {
+      predictedKeys.insert(tile->GetKey());
+    }
+
+    for (const auto& tile : pendingTiles) {
+      pendingKeys.insert(tile->GetKey());
+    }
+
+    // All predicted tiles are already being prefetched
+    if (!predictedKeys.empty() &&
+        std::includes(pendingKeys.begin(),
+                      pendingKeys.end(),
+                      predictedKeys.begin(),
+                      predictedKeys.end())) {
+      return;
+    }
+
+    CancelPrefetch();
+
+    if (predictedTiles.empty()) {
+      return;
+    }
+
+    AreaSearchParameter parameter(searchParameter);
+
+    breaker=std::make_shared<ThreadedBreaker>();
+    parameter.SetBreaker(breaker);
+    parameter.SetLowPriority(true);
+
+    pendingTiles=predictedTiles;
+
+    for (const auto& key : predictedKeys) {
+      AddPrefetchedTile(key);
+    }
+
+    statistics.prefetches++;
+    statistics.prefetchedTiles+=predictedTiles.size();
+
+    mapService->LoadMissingTileDataAsync(parameter,
+                                         *styleConfig,
+                                         predictedTiles);
+  }
+
+  /**
+   * Cancel the current prefetch, for example because the map is not visible
+   * anymore
+   */
+  void TilePrefetcher::Cancel()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    CancelPrefetch();
+    history.clear();
+  }
+
+  TilePrefetcher::Statistics TilePrefetcher::GetStatistics() const
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    return statistics;
+  }
+
+  void TilePrefetcher::ResetStatistics()
+  {
+    std::lock_guard<std::mutex> lock(mutex);
+
+    statistics=Statistics();
+  }
+}
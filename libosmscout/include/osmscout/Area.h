@@ -305,11 +305,21 @@ namespace osmscout {
     }
 
     /**
-     * Read the area as written by Write().
+     * Read the area as written by Write() from the given FileScanner.
      */
     void Read(const TypeConfig& typeConfig,
               FileScanner& scanner);
 
+    /**
+     * Read the area from the given MemoryScanner (faster than reading from
+     * the FileScanner the MemoryScanner was created for).
+     *
+     * Instantiated for MemoryScanner.
+     */
+    template<typename S>
+    void Read(const TypeConfig& typeConfig,
+              S& scanner);
+
     /**
      * Read the area as written by WriteImport().
      */
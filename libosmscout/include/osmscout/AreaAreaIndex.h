@@ -48,6 +48,9 @@ namespace osmscout {
 
     Internally the index is implemented as quadtree. As a result each index entry
     has 4 children (besides entries in the lowest level).
+
+    If the index file is memory mapped, levels with many cells are expanded
+    by multiple threads in parallel, reading the cells directly from memory.
     */
   class OSMSCOUT_API AreaAreaIndex
   {
@@ -95,6 +98,18 @@ namespace osmscout {
       }
     };
 
+    /**
+      Result of expanding a range of cells of one level
+      */
+    struct LevelResult
+    {
+      std::vector<DataBlockSpan> spans;        //!< Spans of the expanded cells
+      std::vector<CellRef>       nextCellRefs; //!< Cells of the next level to expand
+    };
+
+    static constexpr size_t defaultParallelCellThreshold=512; //!< Default minimum number of cells in a level for parallel expansion
+    static constexpr size_t minCellsPerThread=128;     //!< Minimum number of cells expanded per thread
+
   private:
     std::string           datafilename;   //!< Full path and name of the data file
     mutable FileScanner   scanner;        //!< Scanner instance for reading this file, guarded by lookupMutex
@@ -104,6 +119,9 @@ namespace osmscout {
 
     mutable IndexCache    indexCache;     //!< Cached map of all index entries by file offset, guarded by lookupMutex
 
+    bool                  memoryMapped=false; //!< Index file can be read via MemoryScanner, set by Open() only
+    size_t                parallelCellThreshold; //!< Minimum number of cells in a level for parallel expansion
+
     mutable std::mutex    lookupMutex;
 
   private:
@@ -127,6 +145,28 @@ namespace osmscout {
                                size_t cy,
                                std::vector<CellRef>& nextCellRefs) const;
 
+    void ExpandCells(const TypeConfig& typeConfig,
+                     const TypeInfoSet& types,
+                     uint32_t level,
+                     double minlon,
+                     double minlat,
+                     double maxlon,
+                     double maxlat,
+                     std::vector<CellRef>::const_iterator begin,
+                     std::vector<CellRef>::const_iterator end,
+                     LevelResult& result) const;
+
+    void ExpandLevelParallel(const TypeConfig& typeConfig,
+                             const TypeInfoSet& types,
+                             uint32_t level,
+                             double minlon,
+                             double minlat,
+                             double maxlon,
+                             double maxlat,
+                             const std::vector<CellRef>& cellRefs,
+                             std::vector<DataBlockSpan>& spans,
+                             std::vector<CellRef>& nextCellRefs) const;
+
   public:
     explicit AreaAreaIndex(size_t cacheSize);
     virtual ~AreaAreaIndex();
@@ -151,6 +191,13 @@ namespace osmscout {
                         std::vector<DataBlockSpan>& spans,
                         TypeInfoSet& loadedTypes) const;
 
+    void SetParallelCellThreshold(size_t threshold);
+
+    inline size_t GetParallelCellThreshold() const
+    {
+      return parallelCellThreshold;
+    }
+
     void DumpStatistics();
 
     void FlushCache();
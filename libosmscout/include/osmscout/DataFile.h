@@ -20,9 +20,15 @@
   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
 */
 
+#include <algorithm>
+#include <array>
+#include <iterator>
+#include <list>
 #include <memory>
 #include <mutex>
 #include <set>
+#include <thread>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
@@ -32,6 +38,9 @@
 #include <osmscout/util/Cache.h>
 #include <osmscout/util/FileScanner.h>
 #include <osmscout/util/Logger.h>
+#include <osmscout/util/MemoryScanner.h>
+#include <osmscout/util/ObjectArena.h>
+#include <osmscout/util/ObjectPool.h>
 
 //#include <map>
 namespace osmscout {
@@ -62,6 +71,20 @@ namespace osmscout {
     }
   };
 
+  /**
+   * True, if N can be read via N::Read(const TypeConfig&, MemoryScanner&)
+   */
+  template<class N, class = void>
+  struct IsMemoryScannable : std::false_type
+  {
+  };
+
+  template<class N>
+  struct IsMemoryScannable<N,std::void_t<decltype(std::declval<N&>().Read(std::declval<const TypeConfig&>(),
+                                                                           std::declval<MemoryScanner&>()))>> : std::true_type
+  {
+  };
+
   /**
    * \ingroup Database
    *
@@ -79,24 +102,155 @@ namespace osmscout {
     using ValueCacheEntry = typename Cache<FileOffset, ValueType>::CacheEntry;
     using ValueCacheRef = typename Cache<FileOffset, ValueType>::CacheRef;
 
+  private:
+    /**
+     * Pool of scanners for the data file. Each reading thread borrows its own
+     * scanner, so uncached reads of different objects do not block each other.
+     * In case of memory mapped files the file is mapped only once and all
+     * scanners share this mapping.
+     */
+    class ScannerPool : public ObjectPool<FileScanner>
+    {
+    private:
+      std::string filename;
+      FileScanner mappedScanner; //!< Owner of the memory mapping shared by all pooled scanners
+
+    public:
+      ScannerPool()
+      : ObjectPool<FileScanner>(std::max((unsigned int)1,std::thread::hardware_concurrency()))
+      {
+        // no code
+      }
+
+      ~ScannerPool() override
+      {
+        Close();
+      }
+
+      /**
+       * Open the pool for the given file. If the file should be memory mapped,
+       * it is mapped once here.
+       *
+       * @throws IOException
+       */
+      void Open(const std::string& filename,
+                bool memoryMapped)
+      {
+        this->filename=filename;
+
+        if (memoryMapped) {
+          mappedScanner.Open(filename,
+                             FileScanner::LowMemRandom,
+                             true);
+        }
+
+        ObjectPool<FileScanner>::Open();
+      }
+
+      /**
+       * Close the pool. Waits until all borrowed scanners are returned.
+       */
+      void Close()
+      {
+        ObjectPool<FileScanner>::Close();
+
+        mappedScanner.CloseFailsafe();
+      }
+
+      FileScanner* MakeNew() noexcept override
+      {
+        auto* scanner=new FileScanner();
+
+        try {
+          if (mappedScanner.IsOpen()) {
+            scanner->Open(mappedScanner,
+                          FileScanner::LowMemRandom);
+          }
+          else {
+            scanner->Open(filename,
+                          FileScanner::LowMemRandom,
+                          false);
+          }
+        }
+        catch (const IOException& e) {
+          log.Error() << e.GetDescription();
+          delete scanner;
+          return nullptr;
+        }
+
+        return scanner;
+      }
+
+      void Destroy(FileScanner* scanner) noexcept override
+      {
+        scanner->CloseFailsafe();
+        delete scanner;
+      }
+
+      bool IsValid(FileScanner* scanner) noexcept override
+      {
+        return !scanner->HasError();
+      }
+    };
+
+    /**
+     * One shard of the object cache. Objects are distributed over the shards by
+     * their file offset, so concurrent lookups usually do not lock the same mutex.
+     */
+    struct CacheShard
+    {
+      std::mutex mutex;
+      ValueCache cache{0};
+    };
+
+    static constexpr size_t cacheShardCount=16;
+
+    static constexpr FileOffset prefetchMaxGap=64*1024;    //!< Offsets of a batch closer than this are prefetched as one range
+    static constexpr FileOffset prefetchObjectSize=4*1024; //!< Number of bytes prefetched for the last object in a range
+
+    using ScannerRef = ObjectPool<FileScanner>::Ptr;
+
   private:
     std::string         datafile;        //!< Basename part of the data file name
     std::string         datafilename;    //!< complete filename for data file
+    size_t              cacheSize;       //!< Overall size of the cache (sum of all shards)
+    bool                isOpen=false;    //!< Data file was opened
 
-    mutable ValueCache  cache;
+    mutable std::array<CacheShard,cacheShardCount> cacheShards; //!< Cache of loaded objects, sharded by file offset
 
-    mutable FileScanner scanner;         //!< File stream to the data file
-
-    mutable std::mutex  accessMutex;     //!< Mutex to secure multi-thread access
+    mutable ScannerPool scannerPool;     //!< File streams to the data file, one per reading thread
 
   protected:
     TypeConfigRef       typeConfig;
 
   private:
-    bool ReadData(N& data) const;
-    bool ReadData(FileOffset offset,
+    CacheShard& GetCacheShard(FileOffset offset) const
+    {
+      // Fibonacci hashing, file offsets of objects are not evenly distributed in the lower bits
+      return cacheShards[((offset*11400714819323198485ull) >> 32) % cacheShardCount];
+    }
+
+    bool GetFromCache(FileOffset offset,
+                      ValueType& value) const;
+    void StoreInCache(FileOffset offset,
+                      const ValueType& value) const;
+
+    ScannerRef BorrowScanner() const;
+
+    void ReadObject(FileScanner& scanner,
+                    N& data) const;
+    bool ReadData(FileScanner& scanner,
+                  N& data) const;
+    bool ReadData(FileScanner& scanner,
+                  FileOffset offset,
                   N& data) const;
 
+    template<typename IteratorIn>
+    bool ReadBatch(IteratorIn begin, IteratorIn end,
+                   size_t size,
+                   std::vector<ValueType>& values,
+                   const ObjectArenaRef& arena) const;
+
   public:
     DataFile(const std::string& datafile,
              size_t cacheSize);
@@ -130,12 +284,14 @@ namespace osmscout {
 
     template<typename IteratorIn>
     bool GetByOffset(IteratorIn begin, IteratorIn end, size_t size,
-                     std::vector<ValueType>& data) const;
+                     std::vector<ValueType>& data,
+                     const ObjectArenaRef& arena=nullptr) const;
 
     template<typename IteratorIn>
     bool GetByOffset(IteratorIn begin, IteratorIn end, size_t size,
                      const GeoBox& boundingBox,
-                     std::vector<ValueType>& data) const;
+                     std::vector<ValueType>& data,
+                     const ObjectArenaRef& arena=nullptr) const;
 
     template<typename IteratorIn>
     bool GetByOffset(IteratorIn begin, IteratorIn end, size_t size,
@@ -143,14 +299,20 @@ namespace osmscout {
 
     template<typename IteratorIn>
     bool GetByBlockSpans(IteratorIn begin, IteratorIn end,
-                         std::vector<ValueType>& data) const;
+                         std::vector<ValueType>& data,
+                         const ObjectArenaRef& arena=nullptr) const;
   };
 
   template <class N>
   DataFile<N>::DataFile(const std::string& datafile, size_t cacheSize)
-  : datafile(datafile),cache(cacheSize)
+  : datafile(datafile),
+    cacheSize(cacheSize)
   {
-    // no code
+    size_t shardSize=cacheSize==0 ? 0 : (cacheSize+cacheShardCount-1)/cacheShardCount;
+
+    for (auto& shard : cacheShards) {
+      shard.cache.SetMaxSize(shardSize);
+    }
   }
 
   template <class N>
@@ -161,20 +323,103 @@ namespace osmscout {
     }
   }
 
+  /**
+   * Return the cached value for the given offset, if available.
+   *
+   * Method is thread-safe.
+   */
+  template <class N>
+  bool DataFile<N>::GetFromCache(FileOffset offset,
+                                 ValueType& value) const
+  {
+    CacheShard& shard=GetCacheShard(offset);
+    std::scoped_lock<std::mutex> lock(shard.mutex);
+
+    ValueCacheRef entryRef;
+    if (!shard.cache.GetEntry(offset,entryRef)) {
+      return false;
+    }
+
+    value=entryRef->value;
+
+    return true;
+  }
+
+  /**
+   * Store the given value for the given offset in the cache.
+   *
+   * Method is thread-safe.
+   */
+  template <class N>
+  void DataFile<N>::StoreInCache(FileOffset offset,
+                                 const ValueType& value) const
+  {
+    CacheShard& shard=GetCacheShard(offset);
+    std::scoped_lock<std::mutex> lock(shard.mutex);
+
+    shard.cache.SetEntry(ValueCacheEntry(offset,value));
+  }
+
+  /**
+   * Borrow a scanner for exclusive use by the calling thread. The scanner
+   * is returned to the pool, if the returned reference gets destroyed.
+   *
+   * Throws an IOException, if the file could not be opened.
+   *
+   * Method is thread-safe.
+   */
+  template <class N>
+  typename DataFile<N>::ScannerRef DataFile<N>::BorrowScanner() const
+  {
+    ScannerRef scanner=scannerPool.Borrow();
+
+    if (!scanner) {
+      throw IOException(datafilename,"Cannot open file for reading");
+    }
+
+    return scanner;
+  }
+
+  /**
+   * Read one data value from the current position of the scanner. If the data type
+   * supports it and the file is memory mapped, data is decoded directly from memory
+   * using a MemoryScanner.
+   *
+   * @throws IOException
+   */
+  template <class N>
+  void DataFile<N>::ReadObject(FileScanner& scanner,
+                               N& data) const
+  {
+    if constexpr (IsMemoryScannable<N>::value) {
+      if (MemoryScanner::CanScan(scanner)) {
+        MemoryScanner memoryScanner(scanner);
+
+        data.Read(*typeConfig,
+                  memoryScanner);
+        return;
+      }
+    }
+
+    data.Read(*typeConfig,
+              scanner);
+  }
+
   /**
    * Read one data value from the given file offset.
    *
-   * Method is NOT thread-safe.
+   * Method is thread-safe, as long as the scanner is not shared.
    */
   template <class N>
-  bool DataFile<N>::ReadData(FileOffset offset,
+  bool DataFile<N>::ReadData(FileScanner& scanner,
+                             FileOffset offset,
                              N& data) const
   {
     try {
       scanner.SetPos(offset);
 
-      data.Read(*typeConfig,
-                scanner);
+      ReadObject(scanner,
+                 data);
     }
     catch (const IOException& e) {
       log.Error() << e.GetDescription();
@@ -187,14 +432,15 @@ namespace osmscout {
   /**
    * Read one data value from the current position of the stream
    *
-   * Method is NOT thread-safe.
+   * Method is thread-safe, as long as the scanner is not shared.
    */
   template <class N>
-  bool DataFile<N>::ReadData(N& data) const
+  bool DataFile<N>::ReadData(FileScanner& scanner,
+                             N& data) const
   {
     try {
-      data.Read(*typeConfig,
-                scanner);
+      ReadObject(scanner,
+                 data);
     }
     catch (const IOException& e) {
       log.Error() << e.GetDescription();
@@ -219,16 +465,23 @@ namespace osmscout {
     datafilename=AppendFileToDir(path,datafile);
 
     try {
-      scanner.Open(datafilename,
-                   FileScanner::LowMemRandom,
-                   memoryMappedData);
+      scannerPool.Open(datafilename,
+                       memoryMappedData);
     }
     catch (const IOException& e) {
       log.Error() << e.GetDescription();
-      scanner.CloseFailsafe();
+      scannerPool.Close();
       return false;
     }
 
+    // Open the first scanner to detect errors early, it is kept in the pool
+    if (!scannerPool.Borrow()) {
+      scannerPool.Close();
+      return false;
+    }
+
+    isOpen=true;
+
     return true;
   }
 
@@ -240,39 +493,141 @@ namespace osmscout {
   template <class N>
   bool DataFile<N>::IsOpen() const
   {
-    return scanner.IsOpen();
+    return isOpen;
   }
 
   /**
-   * Close the index.
+   * Close the index. Reads started by other threads are finished before the
+   * file is closed, reads started afterwards fail.
    *
    * Method is NOT thread-safe.
    */
   template <class N>
   bool DataFile<N>::Close()
   {
+    scannerPool.Close();
+
     typeConfig=nullptr;
-    cache.Flush();
 
-    try  {
-      if (scanner.IsOpen()) {
-        scanner.Close();
-      }
-    }
-    catch (const IOException& e) {
-      log.Error() << e.GetDescription();
-      scanner.CloseFailsafe();
-      return false;
+    for (auto& shard : cacheShards) {
+      shard.cache.Flush();
     }
 
+    isOpen=false;
+
     return true;
   }
 
   template <class N>
   void DataFile<N>::FlushCache()
   {
-    std::scoped_lock<std::mutex> lock(accessMutex);
-    cache.Flush();
+    for (auto& shard : cacheShards) {
+      std::scoped_lock<std::mutex> lock(shard.mutex);
+      shard.cache.Flush();
+    }
+  }
+
+  /**
+   * Read the data values for the given file offsets as one batch. Values are returned
+   * in the order of the given offsets.
+   *
+   * Offsets not found in the cache are sorted, so that the file is read in one
+   * forward pass. Neighbouring offsets are merged into ranges and the operating
+   * system is asked to read ahead all ranges before the first value is decoded.
+   *
+   * If an arena is given, values not found in the cache are allocated in the arena
+   * and are not stored in the cache (a cached value would keep the arena alive).
+   *
+   * Method is thread-safe.
+   */
+  template <class N>
+  template <typename IteratorIn>
+  bool DataFile<N>::ReadBatch(IteratorIn begin, IteratorIn end,
+                              size_t size,
+                              std::vector<ValueType>& values,
+                              const ObjectArenaRef& arena) const
+  {
+    // Offset and index in result for each value not found in the cache
+    std::vector<std::pair<FileOffset,size_t>> misses;
+
+    values.clear();
+    values.reserve(size);
+
+    for (IteratorIn offsetIter=begin; offsetIter!=end; ++offsetIter) {
+      ValueType value;
+
+      if (!GetFromCache(*offsetIter,value)) {
+        misses.emplace_back(*offsetIter,values.size());
+      }
+
+      values.push_back(std::move(value));
+    }
+
+    if (misses.empty()) {
+      return true;
+    }
+
+    std::sort(misses.begin(),misses.end());
+
+    try {
+      ScannerRef scanner=BorrowScanner();
+
+      if (misses.size()>1) {
+        FileOffset rangeStart=misses.front().first;
+        FileOffset rangeEnd=rangeStart;
+
+        for (const auto& miss : misses) {
+          if (miss.first-rangeEnd>prefetchMaxGap) {
+            scanner->Prefetch(rangeStart,
+                              rangeEnd-rangeStart+prefetchObjectSize);
+            rangeStart=miss.first;
+          }
+
+          rangeEnd=miss.first;
+        }
+
+        scanner->Prefetch(rangeStart,
+                          rangeEnd-rangeStart+prefetchObjectSize);
+      }
+
+      const std::pair<FileOffset,size_t>* previous=nullptr;
+
+      for (const auto& miss : misses) {
+        // The same offset was requested multiple times
+        if (previous!=nullptr &&
+            previous->first==miss.first) {
+          values[miss.second]=values[previous->second];
+          continue;
+        }
+
+        auto value=MakeShared<N>(arena);
+
+        // Objects stored back to back do not require repositioning of the scanner
+        bool success=scanner->GetPos()==miss.first ? ReadData(*scanner,
+                                                               *value)
+                                                   : ReadData(*scanner,
+                                                               miss.first,
+                                                               *value);
+
+        if (!success) {
+          log.Error() << "Error while reading data from offset " << miss.first << " of file " << datafilename << "!";
+          return false;
+        }
+
+        if (!arena) {
+          StoreInCache(miss.first,value);
+        }
+
+        values[miss.second]=std::move(value);
+        previous=&miss;
+      }
+    }
+    catch (const IOException& e) {
+      log.Error() << e.GetDescription();
+      return false;
+    }
+
+    return true;
   }
 
   /**
@@ -293,6 +648,8 @@ namespace osmscout {
    *    in result vector.
    * @param data
    *    vector containing data. Data is appended.
+   * @param arena
+   *    Optional arena to allocate the loaded data in
    * @return
    *    false if there was an error, else true
    *
@@ -302,38 +659,35 @@ namespace osmscout {
   template <typename IteratorIn>
   bool DataFile<N>::GetByOffset(IteratorIn begin, IteratorIn end,
                                 size_t size,
-                                std::vector<ValueType>& data) const
+                                std::vector<ValueType>& data,
+                                const ObjectArenaRef& arena) const
   {
     if (size==0) {
       return true;
     }
 
-    data.reserve(data.size()+size);
-    std::scoped_lock<std::mutex> lock(accessMutex);
-
-    if (cache.GetMaxSize()>0 &&
-        size>cache.GetMaxSize()){
-      log.Warn() << "Cache size (" << cache.GetMaxSize() << ") for file " << datafile << " is smaller than current request (" << size << ")";
+    if (cacheSize>0 &&
+        size>cacheSize){
+      log.Warn() << "Cache size (" << cacheSize << ") for file " << datafile << " is smaller than current request (" << size << ")";
     }
 
-    for (IteratorIn offsetIter=begin; offsetIter!=end; ++offsetIter) {
-      ValueCacheRef entryRef;
+    std::vector<ValueType> values;
 
-      if (cache.GetEntry(*offsetIter,entryRef)) {
-        data.push_back(entryRef->value);
-      }
-      else {
-        ValueType value=std::make_shared<N>();
-
-        if (!ReadData(*offsetIter,
-                      *value)) {
-          log.Error() << "Error while reading data from offset " << *offsetIter << " of file " << datafilename << "!";
-          return false;
-        }
+    if (!ReadBatch(begin,
+                   end,
+                   size,
+                   values,
+                   arena)) {
+      return false;
+    }
 
-        cache.SetEntry(ValueCacheEntry(*offsetIter,value));
-        data.push_back(value);
-      }
+    if (data.empty()) {
+      data=std::move(values);
+    }
+    else {
+      data.insert(data.end(),
+                  std::make_move_iterator(values.begin()),
+                  std::make_move_iterator(values.end()));
     }
 
     return true;
@@ -349,39 +703,35 @@ namespace osmscout {
   bool DataFile<N>::GetByOffset(IteratorIn begin, IteratorIn end,
                                 size_t size,
                                 const GeoBox& boundingBox,
-                                std::vector<ValueType>& data) const
+                                std::vector<ValueType>& data,
+                                const ObjectArenaRef& arena) const
   {
     if (size==0) {
       return true;
     }
 
-    data.reserve(data.size()+size);
-    std::scoped_lock<std::mutex> lock(accessMutex);
+    if (cacheSize>0 &&
+        size>cacheSize){
+      log.Warn() << "Cache size (" << cacheSize << ") for file " << datafile << " is smaller than current request (" << size << ")";
+    }
+
+    std::vector<ValueType> values;
 
-    if (cache.GetMaxSize()>0 &&
-        size>cache.GetMaxSize()){
-      log.Warn() << "Cache size (" << cache.GetMaxSize() << ") for file " << datafile << " is smaller than current request (" << size << ")";
+    if (!ReadBatch(begin,
+                   end,
+                   size,
+                   values,
+                   arena)) {
+      return false;
     }
 
     //std::map<std::string,size_t> hitRateTypes;
     //std::map<std::string,size_t> missRateTypes;
     size_t inBoxCount=0;
-    for (IteratorIn offsetIter=begin; offsetIter!=end; ++offsetIter) {
-      ValueType value=std::make_shared<N>();
-
-      ValueCacheRef entryRef;
-      if (cache.GetEntry(*offsetIter,entryRef)){
-        value=entryRef->value;
-      }else{
-        if (!ReadData(*offsetIter,
-                      *value)) {
-          log.Error() << "Error while reading data from offset " << *offsetIter << " of file " << datafilename << "!";
-          return false;
-        }
 
-        cache.SetEntry(ValueCacheEntry(*offsetIter,value));
-      }
+    data.reserve(data.size()+values.size());
 
+    for (auto& value : values) {
       if (!value->Intersects(boundingBox)) {
         //missRateTypes[value->GetType()->GetName()]++;
         continue;
@@ -392,7 +742,7 @@ namespace osmscout {
 
       inBoxCount++;
 
-      data.push_back(value);
+      data.push_back(std::move(value));
     }
 
     size_t hitRate=inBoxCount*100/size;
@@ -450,24 +800,28 @@ namespace osmscout {
   bool DataFile<N>::GetByOffset(FileOffset offset,
                                 ValueType& entry) const
   {
-    std::scoped_lock<std::mutex> lock(accessMutex);
+    if (GetFromCache(offset,entry)) {
+      return true;
+    }
 
-    ValueCacheRef entryRef;
-    if (cache.GetEntry(offset,entryRef)){
-      entry=entryRef->value;
-    }else{
-      ValueType value=std::make_shared<N>();
+    try {
+      ScannerRef scanner=BorrowScanner();
+      ValueType  value=std::make_shared<N>();
 
-      if (!ReadData(offset,
+      if (!ReadData(*scanner,
+                    offset,
                     *value)) {
         log.Error() << "Error while reading data from offset " << offset << " of file " << datafilename << "!";
-        // TODO: Remove broken entry from cache
         return false;
       }
 
-      cache.SetEntry(ValueCacheEntry(offset,value));
+      StoreInCache(offset,value);
       entry=value;
     }
+    catch (const IOException& e) {
+      log.Error() << e.GetDescription();
+      return false;
+    }
 
     return true;
   }
@@ -481,60 +835,22 @@ namespace osmscout {
   bool DataFile<N>::GetByBlockSpan(const DataBlockSpan& span,
                                    std::vector<ValueType>& data) const
   {
-    if (span.count==0) {
-      return true;
-    }
-
-    std::scoped_lock<std::mutex> lock(accessMutex);
-
-    try {
-      bool offsetSetup=false;
-      FileOffset offset=span.startOffset;
-
-      data.reserve(data.size()+span.count);
-
-      for (uint32_t i=1; i<=span.count; i++) {
-        ValueCacheRef entryRef;
-        if (cache.GetEntry(offset,entryRef)){
-          data.push_back(entryRef->value);
-          offset=entryRef->value->GetNextFileOffset();
-          offsetSetup=false;
-        }else{
-          if (!offsetSetup){
-            scanner.SetPos(offset);
-          }
-
-          ValueType value=std::make_shared<N>();
-
-          if (!ReadData(*value)) {
-            log.Error() << "Error while reading data #" << i << " starting from offset " << span.startOffset << " of file " << datafilename << "!";
-            return false;
-          }
-
-          cache.SetEntry(ValueCacheEntry(offset,value));
-          offset=value->GetNextFileOffset();
-          offsetSetup=true;
-          data.push_back(value);
-        }
-      }
-
-      return true;
-    }
-    catch (const IOException& e) {
-      log.Error() << e.GetDescription();
-      return false;
-    }
+    return GetByBlockSpans(&span,
+                           &span+1,
+                           data);
   }
 
   /**
-   * Read data values from the given DataBlockSpans.
+   * Read data values from the given DataBlockSpans. If an arena is given, values
+   * not found in the cache are allocated in the arena and are not stored in the cache.
    *
    * Method is thread-safe.
    */
   template <class N>
   template<typename IteratorIn>
   bool DataFile<N>::GetByBlockSpans(IteratorIn begin, IteratorIn end,
-                                    std::vector<ValueType>& data) const
+                                    std::vector<ValueType>& data,
+                                    const ObjectArenaRef& arena) const
   {
     uint32_t overallCount=0;
 
@@ -545,7 +861,8 @@ namespace osmscout {
     data.reserve(data.size()+overallCount);
 
     try {
-      std::scoped_lock<std::mutex> lock(accessMutex);
+      ScannerRef scanner;
+
       for (IteratorIn spanIter=begin; spanIter!=end; ++spanIter) {
         if (spanIter->count==0) {
           continue;
@@ -555,25 +872,33 @@ namespace osmscout {
         FileOffset offset=spanIter->startOffset;
 
         for (uint32_t i=1; i<=spanIter->count; i++) {
-          ValueCacheRef entryRef;
-          if (cache.GetEntry(offset,entryRef)){
-            data.push_back(entryRef->value);
-            offset=entryRef->value->GetNextFileOffset();
+          ValueType value;
+
+          if (GetFromCache(offset,value)) {
+            data.push_back(value);
+            offset=value->GetNextFileOffset();
             offsetSetup=false;
           }else{
+            if (!scanner) {
+              scanner=BorrowScanner();
+            }
+
             if (!offsetSetup){
-              scanner.SetPos(offset);
+              scanner->SetPos(offset);
             }
 
-            ValueType value=std::make_shared<N>();
+            value=MakeShared<N>(arena);
 
-            if (!ReadData(*value)) {
+            if (!ReadData(*scanner,
+                          *value)) {
               log.Error() << "Error while reading data #" << i << " starting from offset " << spanIter->startOffset <<
               " of file " << datafilename << "!";
               return false;
             }
 
-            cache.SetEntry(ValueCacheEntry(offset,value));
+            if (!arena) {
+              StoreInCache(offset,value);
+            }
             offset=value->GetNextFileOffset();
             offsetSetup=true;
             data.push_back(value);
@@ -346,11 +346,12 @@ namespace osmscout {
     mutable std::mutex              srtmIndexMutex;           //!< Mutex to make lazy initialisation of optimized ways index thread-safe
 
   private:
-    template<typename DataFile, typename OffsetsCol, typename DataCol>
+    template<typename DataFile, typename OffsetsCol, typename DataCol, typename... Args>
     bool GetObjectsByOffset(DataFile dataFile,
                             const OffsetsCol& offsets,
                             DataCol& objects,
-                            const std::string_view &typeName) const
+                            const std::string_view &typeName,
+                            const Args&... args) const
     {
       if (!dataFile) {
         return false;
@@ -358,7 +359,7 @@ namespace osmscout {
 
       StopClock time;
 
-      bool result=dataFile->GetByOffset(offsets.begin(), offsets.end(), offsets.size(), objects);
+      bool result=dataFile->GetByOffset(offsets.begin(), offsets.end(), offsets.size(), objects, args...);
 
       if (time.GetMilliseconds()>100) {
         log.Warn() << "Retrieving " << objects.size() << " " << typeName << " by offset took " << time.ResultString();
@@ -412,7 +413,8 @@ namespace osmscout {
                           std::vector<NodeRef>& nodes) const;
     bool GetNodesByOffset(const std::vector<FileOffset>& offsets,
                           const GeoBox& boundingBox,
-                          std::vector<NodeRef>& nodes) const;
+                          std::vector<NodeRef>& nodes,
+                          const ObjectArenaRef& arena=nullptr) const;
     bool GetNodesByOffset(const std::set<FileOffset>& offsets,
                           std::vector<NodeRef>& nodes) const;
     bool GetNodesByOffset(const std::list<FileOffset>& offsets,
@@ -431,10 +433,23 @@ namespace osmscout {
       return GetObjectsByOffset(GetAreaDataFile(), offsets, areas, "areas"sv);
     }
 
+    /**
+     * Load the areas at the given offsets, allocating them in the given arena
+     */
+    template<typename OffsetsCol>
+    bool GetAreasByOffset(const OffsetsCol& offsets,
+                          std::vector<AreaRef>& areas,
+                          const ObjectArenaRef& arena) const
+    {
+      using namespace std::string_view_literals;
+      return GetObjectsByOffset(GetAreaDataFile(), offsets, areas, "areas"sv, arena);
+    }
+
     bool GetAreasByBlockSpan(const DataBlockSpan& span,
                              std::vector<AreaRef>& area) const;
     bool GetAreasByBlockSpans(const std::vector<DataBlockSpan>& spans,
-                              std::vector<AreaRef>& areas) const;
+                              std::vector<AreaRef>& areas,
+                              const ObjectArenaRef& arena=nullptr) const;
 
 
     bool GetWayByOffset(const FileOffset& offset,
@@ -448,6 +463,18 @@ namespace osmscout {
       return GetObjectsByOffset(GetWayDataFile(), offsets, ways, "ways"sv);
     }
 
+    /**
+     * Load the ways at the given offsets, allocating them in the given arena
+     */
+    template<typename OffsetsCol>
+    bool GetWaysByOffset(const OffsetsCol& offsets,
+                         std::vector<WayRef>& ways,
+                         const ObjectArenaRef& arena) const
+    {
+      using namespace std::string_view_literals;
+      return GetObjectsByOffset(GetWayDataFile(), offsets, ways, "ways"sv, arena);
+    }
+
     template<typename OffsetsCol, typename DataCol>
     bool GetRoutesByOffset(const OffsetsCol& offsets,
                            DataCol& routes) const
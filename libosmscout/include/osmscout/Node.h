@@ -115,8 +115,22 @@ namespace osmscout {
     void SetCoords(const GeoCoord& coords);
     void SetFeatures(const FeatureValueBuffer& buffer);
 
+    /**
+     * Read the node from the given FileScanner.
+     */
     void Read(const TypeConfig& typeConfig,
               FileScanner& scanner);
+
+    /**
+     * Read the node from the given MemoryScanner (faster than reading from
+     * the FileScanner the MemoryScanner was created for).
+     *
+     * Instantiated for MemoryScanner.
+     */
+    template<typename S>
+    void Read(const TypeConfig& typeConfig,
+              S& scanner);
+
     void Write(const TypeConfig& typeConfig,
                FileWriter& writer) const;
   };
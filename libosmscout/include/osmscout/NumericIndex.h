@@ -20,9 +20,20 @@
   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
 */
 
+#include <algorithm>
+#include <array>
+#include <bitset>
+#include <cstdint>
+#include <limits>
 #include <mutex>
+#include <type_traits>
+#include <unordered_map>
 #include <vector>
 
+#if defined(__AVX2__) || defined(__SSE4_2__)
+  #include <immintrin.h>
+#endif
+
 #include <osmscout/util/Cache.h>
 #include <osmscout/util/File.h>
 #include <osmscout/util/FileScanner.h>
@@ -36,10 +47,23 @@ namespace osmscout {
     \ingroup Database
     Numeric index handles an index over instance of class <T> where the index criteria
     is of type <N>, where <N> has a numeric nature (usually Id).
+
+    Two file layouts are supported:
+    * The paged layout, a tree of pages with delta encoded entries, as written by
+      former versions of the importer.
+    * The static B+ tree layout (marked by a page size of 0). Keys are stored with fixed
+      size in cache line sized key blocks. Leaf blocks hold 8 keys followed by their 8
+      file offsets, each inner level holds the first key of each block of the level below.
+      Upper levels are held in memory (as far as the cache size allows), key blocks are
+      searched using SIMD comparison if available.
     */
   template <class N>
   class NumericIndex
   {
+  public:
+    static constexpr uint32_t blockKeyCount=8;     //!< Number of keys in one key block of the static layout
+    static constexpr size_t   maxStaticLevels=24;  //!< Maximum number of levels of the static layout
+
   private:
     /**
       an individual index entry.
@@ -75,6 +99,35 @@ namespace osmscout {
       }
     };
 
+    /**
+      One level of the static B+ tree layout
+      */
+    struct Level
+    {
+      FileOffset            offset=0;   //!< File offset of the first key block of the level
+      uint64_t              keyCount=0; //!< Number of (valid) keys in the level
+      std::vector<uint64_t> keys;       //!< Keys of the level padded to complete key blocks, empty if not held in memory
+    };
+
+    using KeyBlock = std::array<uint64_t,blockKeyCount>;
+
+    /**
+      Key blocks of the last search path in the static layout for levels not held in memory.
+      Looking up ids in ascending order using the same search path reads each key block
+      only once.
+      */
+    struct SearchPath
+    {
+      std::array<uint64_t,maxStaticLevels>   blockIndex;  //!< Index of the loaded block per level
+      std::array<KeyBlock,maxStaticLevels>   keys;        //!< Loaded key block per level
+      std::array<FileOffset,blockKeyCount>   leafOffsets; //!< File offsets of the loaded leaf block
+
+      SearchPath()
+      {
+        blockIndex.fill(std::numeric_limits<uint64_t>::max());
+      }
+    };
+
   private:
     std::string                         filepart;             //!< Name of the index file
     std::string                         filename;             //!< Complete file name including directory
@@ -92,6 +145,9 @@ namespace osmscout {
     mutable std::vector<PageSimpleCache> simplePageCache;     //!< Simple map to cache all entries
     mutable std::vector<PageCache>       pageCaches;          //!< Complex cache with LRU characteristics
 
+    bool                                 staticLayout=false;  //!< The file uses the static B+ tree layout
+    std::vector<Level>                   levelData;           //!< Levels of the static layout, root level first
+
     mutable std::mutex                   accessMutex;         //!< Mutex to secure multi-thread access
 
   private:
@@ -99,6 +155,18 @@ namespace osmscout {
     void ReadPage(FileOffset offset, PageRef& page) const;
     void InitializeCache();
 
+    static uint32_t CountLessOrEqual(const uint64_t* keys,
+                                     uint64_t key);
+    void OpenStaticLayout();
+    void ReadKeyBlock(size_t level,
+                      uint64_t block,
+                      SearchPath& path) const;
+    bool LookupStatic(const N& id,
+                      SearchPath& path,
+                      FileOffset& offset) const;
+    bool GetOffsetPaged(const N& id,
+                        FileOffset& offset) const;
+
   public:
     NumericIndex(const std::string& filename,
                  size_t cacheSize);
@@ -119,6 +187,20 @@ namespace osmscout {
                     std::vector<FileOffset>& offsets) const;
 
     void DumpStatistics() const;
+
+    /**
+     * Return the order preserving unsigned key for the given id as stored in the
+     * static layout
+     */
+    static uint64_t ToKey(N id)
+    {
+      if constexpr (std::is_signed_v<N>) {
+        return static_cast<uint64_t>(static_cast<int64_t>(id)) ^ (uint64_t(1) << 63u);
+      }
+      else {
+        return static_cast<uint64_t>(id);
+      }
+    }
   };
 
   template <class N>
@@ -280,6 +362,14 @@ namespace osmscout {
       pageSize=scanner.ReadUInt32Number();                  // Size of one index page
       /*uint32_t entries=*/scanner.ReadUInt32Number();                   // Number of entries in data file
 
+      staticLayout=pageSize==0;
+
+      if (staticLayout) {
+        OpenStaticLayout();
+
+        return !scanner.HasError();
+      }
+
       levels=scanner.ReadUInt32();                    // Number of levels
       pageCounts.resize(levels);
 
@@ -332,6 +422,182 @@ namespace osmscout {
     return scanner.IsOpen();
   }
 
+  /**
+   * Return the number of keys in the key block, that are less or equal to the given key.
+   * Keys in the key block are sorted.
+   */
+  template <class N>
+  inline uint32_t NumericIndex<N>::CountLessOrEqual(const uint64_t* keys,
+                                                    uint64_t key)
+  {
+#if defined(__AVX2__)
+    // There is no unsigned 64 bit compare, flipping the sign bit makes signed compare work
+    const __m256i sign=_mm256_set1_epi64x(std::numeric_limits<int64_t>::min());
+    const __m256i value=_mm256_xor_si256(_mm256_set1_epi64x(static_cast<int64_t>(key)),sign);
+    const __m256i low=_mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys)),sign);
+    const __m256i high=_mm256_xor_si256(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(keys+4)),sign);
+
+    int greater=_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(low,value))) |
+                (_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpgt_epi64(high,value))) << 4);
+
+    return blockKeyCount-(uint32_t)std::bitset<blockKeyCount>(greater).count();
+#elif defined(__SSE4_2__)
+    const __m128i sign=_mm_set1_epi64x(std::numeric_limits<int64_t>::min());
+    const __m128i value=_mm_xor_si128(_mm_set1_epi64x(static_cast<int64_t>(key)),sign);
+    int           greater=0;
+
+    for (uint32_t i=0; i<blockKeyCount; i+=2) {
+      const __m128i current=_mm_xor_si128(_mm_loadu_si128(reinterpret_cast<const __m128i*>(keys+i)),sign);
+
+      greater|=_mm_movemask_pd(_mm_castsi128_pd(_mm_cmpgt_epi64(current,value))) << i;
+    }
+
+    return blockKeyCount-(uint32_t)std::bitset<blockKeyCount>(greater).count();
+#else
+    uint32_t count=0;
+
+    // Branch free, so that the compiler can vectorize
+    for (uint32_t i=0; i<blockKeyCount; i++) {
+      count+=keys[i]<=key ? 1 : 0;
+    }
+
+    return count;
+#endif
+  }
+
+  /**
+   * Read the level table of the static layout and load the upper levels into memory
+   * as far as the cache size (in key blocks) allows.
+   *
+   * @throws IOException
+   */
+  template <class N>
+  void NumericIndex<N>::OpenStaticLayout()
+  {
+    uint32_t   levelCount=scanner.ReadUInt32();          // Number of levels
+    FileOffset levelTableOffset=scanner.ReadFileOffset(); // Start of the table of levels
+
+    if (levelCount>maxStaticLevels) {
+      throw IOException(filename,"Cannot open index","Unsupported number of levels "+std::to_string(levelCount));
+    }
+
+    levels=levelCount;
+    levelData.resize(levelCount);
+
+    scanner.SetPos(levelTableOffset);
+
+    for (auto& level : levelData) {
+      level.offset=scanner.ReadFileOffset();
+      level.keyCount=scanner.ReadUInt64Number();
+    }
+
+    size_t residentBlocks=0;
+
+    // The leaf level stores file offsets next to the keys and is never held in memory
+    for (size_t l=0; l+1<levelData.size(); l++) {
+      Level& level=levelData[l];
+      size_t blockCount=(level.keyCount+blockKeyCount-1)/blockKeyCount;
+
+      if (residentBlocks+blockCount>cacheSize) {
+        log.Warn() << "Warning: Index " << filepart << " has cache size " << cacheSize << ", but requires cache size " << residentBlocks+blockCount << " to load index level " << l << " into memory!";
+        break;
+      }
+
+      level.keys.resize(blockCount*blockKeyCount);
+
+      scanner.SetPos(level.offset);
+
+      for (auto& key : level.keys) {
+        key=scanner.ReadUInt64();
+      }
+
+      residentBlocks+=blockCount;
+    }
+  }
+
+  /**
+   * Read the given key block of the given level into the search path.
+   *
+   * @throws IOException
+   */
+  template <class N>
+  void NumericIndex<N>::ReadKeyBlock(size_t level,
+                                     uint64_t block,
+                                     SearchPath& path) const
+  {
+    bool                        leaf=level+1==levelData.size();
+    std::lock_guard<std::mutex> lock(accessMutex);
+
+    scanner.SetPos(levelData[level].offset+block*(leaf ? 2 : 1)*blockKeyCount*sizeof(uint64_t));
+
+    for (auto& key : path.keys[level]) {
+      key=scanner.ReadUInt64();
+    }
+
+    if (leaf) {
+      for (auto& offset : path.leafOffsets) {
+        offset=scanner.ReadFileOffset();
+      }
+    }
+
+    path.blockIndex[level]=block;
+  }
+
+  /**
+   * Look up the file offset for the given id in the static layout.
+   *
+   * @throws IOException
+   */
+  template <class N>
+  bool NumericIndex<N>::LookupStatic(const N& id,
+                                     SearchPath& path,
+                                     FileOffset& offset) const
+  {
+    uint64_t key=ToKey(id);
+    uint64_t block=0;
+
+    for (size_t l=0; l<levelData.size(); l++) {
+      const Level&    level=levelData[l];
+      const uint64_t* keys;
+
+      if (!level.keys.empty()) {
+        keys=level.keys.data()+block*blockKeyCount;
+      }
+      else {
+        if (path.blockIndex[l]!=block) {
+          ReadKeyBlock(l,
+                       block,
+                       path);
+        }
+
+        keys=path.keys[l].data();
+      }
+
+      // Padding keys of the last block must not be counted
+      uint32_t count=std::min(CountLessOrEqual(keys,key),
+                              (uint32_t)std::min<uint64_t>(blockKeyCount,level.keyCount-block*blockKeyCount));
+
+      if (count==0) {
+        return false;
+      }
+
+      if (l+1==levelData.size()) {
+        if (keys[count-1]!=key) {
+          return false;
+        }
+
+        offset=path.leafOffsets[count-1];
+
+        return true;
+      }
+
+      // Each key of this level references one block of the level below
+      block=block*blockKeyCount+count-1;
+    }
+
+    return false;
+  }
+
   /**
    * Return the file offset in the data file for the given object id.
    *
@@ -340,6 +606,33 @@ namespace osmscout {
   template <class N>
   bool NumericIndex<N>::GetOffset(const N& id,
                                   FileOffset& offset) const
+  {
+    if (!staticLayout) {
+      return GetOffsetPaged(id,
+                            offset);
+    }
+
+    try {
+      SearchPath path;
+
+      return LookupStatic(id,
+                          path,
+                          offset);
+    }
+    catch (IOException& e) {
+      log.Error() << e.GetDescription();
+      return false;
+    }
+  }
+
+  /**
+   * Return the file offset in the data file for the given object id using the paged layout.
+   *
+   * This method is thread-safe.
+   */
+  template <class N>
+  bool NumericIndex<N>::GetOffsetPaged(const N& id,
+                                       FileOffset& offset) const
   {
     try
     {
@@ -422,7 +715,11 @@ namespace osmscout {
   }
 
   /**
-   * Return the file offsets in the data file for the given object ids.
+   * Return the file offsets in the data file for the given object ids. Offsets of ids
+   * not found are skipped, the order of the ids is preserved.
+   *
+   * For the static layout ids are looked up in ascending order in one pass, reading
+   * each key block not held in memory only once.
    *
    * This method is thread-safe.
    */
@@ -436,12 +733,50 @@ namespace osmscout {
     offsets.clear();
     offsets.reserve(size);
 
+    if (!staticLayout) {
+      for (IteratorIn idIter=begin; idIter!=end; ++idIter) {
+        FileOffset offset;
+
+        if (GetOffset(*idIter,
+                      offset)) {
+          offsets.push_back(offset);
+        }
+      }
+
+      return true;
+    }
+
+    // Id and position in the request
+    std::vector<std::pair<N,size_t>> ids;
+
+    ids.reserve(size);
+
     for (IteratorIn idIter=begin; idIter!=end; ++idIter) {
-      FileOffset offset;
+      ids.emplace_back(*idIter,ids.size());
+    }
+
+    std::sort(ids.begin(),ids.end());
+
+    std::vector<FileOffset> idOffsets(ids.size());
+    std::vector<bool>       found(ids.size(),false);
+
+    try {
+      SearchPath path;
+
+      for (const auto& [id,index] : ids) {
+        found[index]=LookupStatic(id,
+                                  path,
+                                  idOffsets[index]);
+      }
+    }
+    catch (IOException& e) {
+      log.Error() << e.GetDescription();
+      return false;
+    }
 
-      if (GetOffset(*idIter,
-                    offset)) {
-        offsets.push_back(offset);
+    for (size_t i=0; i<idOffsets.size(); i++) {
+      if (found[i]) {
+        offsets.push_back(idOffsets[i]);
       }
     }
 
@@ -454,6 +789,18 @@ namespace osmscout {
     size_t memory=0;
     size_t pages=0;
 
+    if (staticLayout) {
+      size_t blocks=0;
+
+      for (const auto& level : levelData) {
+        blocks+=level.keys.size()/blockKeyCount;
+        memory+=level.keys.size()*sizeof(uint64_t);
+      }
+
+      log.Info() << "Index " << filepart << ": " << levelData.size() << " levels, " << blocks << " key blocks in memory, memory " << memory;
+      return;
+    }
+
     pages+=1;
     memory+=root->entries.size()*sizeof(Entry);
 
@@ -23,6 +23,7 @@
 #include <list>
 #include <memory>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -877,6 +878,70 @@ namespace osmscout {
               bool& specialFlag2,
               bool& specialFlag3);
 
+    /**
+     * Read the FeatureValueBuffer from the given MemoryScanner (or any other
+     * scanner type besides FileScanner).
+     *
+     * @throws IOException
+     */
+    template<typename S>
+    void Read(S& scanner)
+    {
+      std::array<bool,0> specialFlags;
+      Read<0>(scanner, specialFlags);
+    }
+
+    /**
+     * Reads the FeatureValueBuffer to the given MemoryScanner.
+     * It also reads the value of the special flag as passed to the Write method.
+     *
+     * @throws IOException
+     */
+    template<typename S>
+    void Read(S& scanner,
+              bool& specialFlag)
+    {
+      std::array<bool,1> specialFlags;
+      Read<1>(scanner, specialFlags);
+      specialFlag=specialFlags[0];
+    }
+
+    /**
+     * Reads the FeatureValueBuffer to the given MemoryScanner.
+     * It also reads the value of two special flags as passed to the Write method.
+     *
+     * @throws IOException
+     */
+    template<typename S>
+    void Read(S& scanner,
+              bool& specialFlag1,
+              bool& specialFlag2)
+    {
+      std::array<bool,2> specialFlags;
+      Read<2>(scanner, specialFlags);
+      specialFlag1=specialFlags[0];
+      specialFlag2=specialFlags[1];
+    }
+
+    /**
+     * Reads the FeatureValueBuffer to the given MemoryScanner.
+     * It also reads the value of three special flags as passed to the Write method.
+     *
+     * @throws IOException
+     */
+    template<typename S>
+    void Read(S& scanner,
+              bool& specialFlag1,
+              bool& specialFlag2,
+              bool& specialFlag3)
+    {
+      std::array<bool,3> specialFlags;
+      Read<3>(scanner, specialFlags);
+      specialFlag1=specialFlags[0];
+      specialFlag2=specialFlags[1];
+      specialFlag3=specialFlags[2];
+    }
+
     /**
      * Writes the FeatureValueBuffer to the given FileWriter.
      *
@@ -922,13 +987,16 @@ namespace osmscout {
     bool operator!=(const FeatureValueBuffer& other) const;
 
     /**
-     * Reads the FeatureValueBuffer to the given FileScanner.
+     * Reads the FeatureValueBuffer to the given FileScanner (or MemoryScanner).
      * It also reads the array of special flags (up to 8) as passed to the Write method.
      *
+     * Feature values can only be read via FileScanner, in case of a MemoryScanner
+     * they are read via MemoryScanner::ReadVia().
+     *
      * @throws IOException
      */
-    template<std::size_t FlagCnt>
-    void Read(FileScanner& scanner, std::array<bool,FlagCnt> &specialFlags)
+    template<std::size_t FlagCnt, typename S>
+    void Read(S& scanner, std::array<bool,FlagCnt> &specialFlags)
     {
       for (size_t i=0; i<type->GetFeatureMaskBytes(); i++) {
         featureBits[i]=scanner.ReadUInt8();
@@ -956,7 +1024,12 @@ namespace osmscout {
             feature.GetFeature()->HasValue()) {
           FeatureValue* value=feature.GetFeature()->AllocateValue(GetValueAndAllocateBuffer(idx));
 
-          value->Read(scanner);
+          if constexpr (std::is_same_v<S,FileScanner>) {
+            value->Read(scanner);
+          }
+          else {
+            scanner.ReadVia(*value);
+          }
         }
       }
     }
@@ -1040,7 +1113,7 @@ namespace osmscout {
   // Forward declaration
   class TypeConfig;
 
-  static const uint32_t FILE_FORMAT_VERSION=24;
+  static const uint32_t FILE_FORMAT_VERSION=25;
 
   /**
    * \ingroup type
@@ -1052,7 +1125,8 @@ namespace osmscout {
   {
   public:
     static const char* FILE_TYPES_DAT;
-    static const uint32_t MIN_FORMAT_VERSION = FILE_FORMAT_VERSION;
+    // Version 24 only differs in the layout of the numeric indexes, NumericIndex reads both layouts
+    static const uint32_t MIN_FORMAT_VERSION = 24;
     static const uint32_t MAX_FORMAT_VERSION = FILE_FORMAT_VERSION;
 
   private:
@@ -198,8 +198,22 @@ namespace osmscout {
       featureValueBuffer.Set(buffer);
     }
 
+    /**
+     * Read the way from the given FileScanner.
+     */
     void Read(const TypeConfig& typeConfig,
               FileScanner& scanner);
+
+    /**
+     * Read the way from the given MemoryScanner (faster than reading from
+     * the FileScanner the MemoryScanner was created for).
+     *
+     * Instantiated for MemoryScanner.
+     */
+    template<typename S>
+    void Read(const TypeConfig& typeConfig,
+              S& scanner);
+
     void ReadOptimized(const TypeConfig& typeConfig,
                        FileScanner& scanner);
 
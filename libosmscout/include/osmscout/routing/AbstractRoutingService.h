@@ -22,11 +22,13 @@
 */
 
 #include <functional>
+#include <limits>
 #include <list>
 #include <memory>
 #include <set>
 #include <unordered_map>
 #include <unordered_set>
+#include <vector>
 
 #include <osmscout/CoreFeatures.h>
 #include <osmscout/TypeConfig.h>
@@ -38,6 +40,7 @@
 #include <osmscout/routing/RouteNode.h>
 #include <osmscout/routing/RoutingService.h>
 #include <osmscout/routing/MultiDBRoutingState.h>
+#include <osmscout/routing/Reachability.h>
 
 namespace osmscout {
 
@@ -94,6 +97,91 @@ namespace osmscout {
     }
   };
 
+  /**
+   * Result of a many-to-many routing calculation (see
+   * AbstractRoutingService::CalculateMatrix()).
+   *
+   * Costs and distances of the cheapest route from each source to each
+   * target are stored as dense matrices with one row per source. Pairs
+   * without a route have infinite costs.
+   */
+  class OSMSCOUT_API RoutingMatrixResult CLASS_FINAL
+  {
+  private:
+    bool                  success=false;
+    size_t                sourceCount=0;
+    size_t                targetCount=0;
+    std::vector<double>   costs;
+    std::vector<Distance> distances;
+
+  public:
+    RoutingMatrixResult();
+    RoutingMatrixResult(size_t sourceCount,
+                        size_t targetCount);
+
+    inline void SetSuccess(bool success)
+    {
+      this->success=success;
+    }
+
+    inline void SetRoute(size_t source,
+                         size_t target,
+                         double cost,
+                         const Distance& distance)
+    {
+      costs[source*targetCount+target]=cost;
+      distances[source*targetCount+target]=distance;
+    }
+
+    /**
+     * @return
+     *    True, if the calculation was not aborted and did not fail because of
+     *    technical errors. Single pairs may still have no route.
+     */
+    inline bool Success() const
+    {
+      return success;
+    }
+
+    inline size_t GetSourceCount() const
+    {
+      return sourceCount;
+    }
+
+    inline size_t GetTargetCount() const
+    {
+      return targetCount;
+    }
+
+    inline bool HasRoute(size_t source,
+                         size_t target) const
+    {
+      return costs[source*targetCount+target]<std::numeric_limits<double>::infinity();
+    }
+
+    inline double GetCost(size_t source,
+                          size_t target) const
+    {
+      return costs[source*targetCount+target];
+    }
+
+    inline Distance GetDistance(size_t source,
+                                size_t target) const
+    {
+      return distances[source*targetCount+target];
+    }
+
+    inline const std::vector<double>& GetCosts() const
+    {
+      return costs;
+    }
+
+    inline const std::vector<Distance>& GetDistances() const
+    {
+      return distances;
+    }
+  };
+
   struct OSMSCOUT_API RoutePoints
   {
     const std::vector<Point> points;
@@ -174,6 +262,20 @@ namespace osmscout {
   template <class RoutingState>
   class OSMSCOUT_API AbstractRoutingService: public RoutingService
   {
+  protected:
+    /**
+     * A route node next to a target position of a matrix calculation
+     */
+    struct MatrixTarget
+    {
+      size_t   targetIndex; //!< Index of the target position
+      double   cost;        //!< Costs from the route node to the target position
+      Distance distance;    //!< Distance from the route node to the target position
+      GeoCoord coord;       //!< Coordinate of the target position
+    };
+
+    using MatrixTargetMap = std::unordered_map<DBId,std::vector<MatrixTarget>>;
+
   protected:
     bool debugPerformance;
 
@@ -283,6 +385,7 @@ namespace osmscout {
                        const GeoCoord& targetCoord,
                        RouteNodeRef& forwardRouteNode,
                        RouteNodeRef& backwardRouteNode,
+                       RNodePool& nodePool,
                        RNodeRef& forwardRNode,
                        RNodeRef& backwardRNode);
 
@@ -305,6 +408,7 @@ namespace osmscout {
                   const RouteNodeRef& routeNode,
                   const GeoCoord& startCoord,
                   const GeoCoord& targetCoord,
+                  RNodePool& nodePool,
                   RNodeRef& node);
 
     void AddNodes(RouteData& route,
@@ -322,6 +426,7 @@ namespace osmscout {
                           const GeoCoord& targetCoord,
                           RouteNodeRef& forwardRouteNode,
                           RouteNodeRef& backwardRouteNode,
+                          RNodePool& nodePool,
                           RNodeRef& forwardRNode,
                           RNodeRef& backwardRNode);
 
@@ -331,11 +436,18 @@ namespace osmscout {
                                   const RoutePosition& target,
                                   RouteData& route);
 
+    /**
+     * Note: WalkToOtherDatabases() and WalkPaths() got the additional parameter
+     * nodePool (new RNodes have to be allocated from it) and OpenList, OpenMap
+     * and ClosedSet are no standard containers anymore (see RoutingSearchSpace.h).
+     * Subclasses overriding these methods have to be adapted.
+     */
     virtual bool WalkToOtherDatabases(const RoutingState& state,
                                       RNodeRef &current,
                                       RouteNodeRef &currentRouteNode,
                                       OpenList &openList,
                                       OpenMap &openMap,
+                                      RNodePool &nodePool,
                                       const ClosedSet &closedSet,
                                       const ClosedSet &closedRestrictedSet);
 
@@ -344,6 +456,7 @@ namespace osmscout {
                            RouteNodeRef &currentRouteNode,
                            OpenList &openList,
                            OpenMap &openMap,
+                           RNodePool &nodePool,
                            ClosedSet &closedSet,
                            ClosedSet &closedRestrictedSet,
                            RoutingResult &result,
@@ -354,6 +467,53 @@ namespace osmscout {
                            Distance &currentMaxDistance,
                            const Distance &overallDistance,
                            const double &costLimit);
+
+    virtual bool CalculateRouteNodeChain(const RoutingState& state,
+                                         const RoutePosition& start,
+                                         const RoutePosition& target,
+                                         const RNodeRef& startForwardNode,
+                                         const RNodeRef& startBackwardNode,
+                                         const RouteNodeRef& targetForwardRouteNode,
+                                         const RouteNodeRef& targetBackwardRouteNode,
+                                         const RoutingParameter& parameter,
+                                         double costLimit,
+                                         std::list<VNode>& nodes);
+
+    bool GetMatrixTargets(const RoutingState& state,
+                          const std::vector<RoutePosition>& targets,
+                          MatrixTargetMap& targetMap);
+
+    bool GetBatchRouteNode(RouteNodeBatch& batch,
+                           const DBId& id,
+                           RouteNodeRef& node);
+
+    template<typename PathVisitor>
+    bool ExpandRouteNode(const RoutingState& state,
+                         Vehicle vehicle,
+                         const RNodeRef& current,
+                         RoutingSearchSpace& searchSpace,
+                         RouteNodeBatch& batch,
+                         PathVisitor&& visitor);
+
+    bool CloseRouteNode(const RoutingState& state,
+                        RNodeRef& current,
+                        RoutingSearchSpace& searchSpace);
+
+    bool CalculateMatrixRow(const RoutingState& state,
+                            size_t sourceIndex,
+                            const RoutePosition& source,
+                            const std::vector<RoutePosition>& targets,
+                            const MatrixTargetMap& targetMap,
+                            const RoutingParameter& parameter,
+                            RouteNodeBatch& batch,
+                            RoutingMatrixResult& result);
+
+    bool CalculateReachabilityFrom(const RoutingState& state,
+                                   const RoutePosition& center,
+                                   const RoutingParameter& parameter,
+                                   RouteNodeBatch& batch,
+                                   ReachabilityResult& result);
+
   public:
     explicit AbstractRoutingService(const RouterParameter& parameter);
     ~AbstractRoutingService() override;
@@ -363,6 +523,21 @@ namespace osmscout {
                                  const RoutePosition& target,
                                  const RoutingParameter& parameter);
 
+    RoutingMatrixResult CalculateMatrix(RoutingState& state,
+                                        const std::vector<RoutePosition>& sources,
+                                        const std::vector<RoutePosition>& targets,
+                                        const RoutingParameter& parameter);
+
+    ReachabilityResult CalculateReachability(RoutingState& state,
+                                             const RoutePosition& center,
+                                             double maxCost,
+                                             const RoutingParameter& parameter);
+
+    std::vector<ReachabilityResult> CalculateReachability(RoutingState& state,
+                                                          const std::vector<RoutePosition>& centers,
+                                                          double maxCost,
+                                                          const RoutingParameter& parameter);
+
     RouteDescriptionResult TransformRouteDataToRouteDescription(const RouteData& data);
     RoutePointsResult TransformRouteDataToPoints(const RouteData& data);
     RouteWayResult TransformRouteDataToWay(const RouteData& data);
@@ -0,0 +1,160 @@
+#ifndef OSMSCOUT_ROUTING_CONTRACTIONHIERARCHY_H
+#define OSMSCOUT_ROUTING_CONTRACTIONHIERARCHY_H
+
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2026  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <limits>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <osmscout/CoreImportExport.h>
+
+#include <osmscout/OSMScoutTypes.h>
+#include <osmscout/ObjectRef.h>
+
+#include <osmscout/routing/RouteNode.h>
+#include <osmscout/routing/RoutingProfile.h>
+
+#include <osmscout/util/Breaker.h>
+#include <osmscout/util/Distance.h>
+
+#include <osmscout/system/Compiler.h>
+
+namespace osmscout {
+
+  /**
+   * \ingroup Routing
+   *
+   * Customizable contraction hierarchy of the routing graph of one vehicle.
+   *
+   * The importer orders all route nodes by importance (rank) and contracts
+   * them in this order without looking at costs. Contracting a node connects
+   * all of its remaining neighbours with each other, so the resulting
+   * topology (edges from each node to its higher ranked neighbours) is
+   * valid for every routing profile of the vehicle.
+   *
+   * Costs are assigned at runtime by customizing the hierarchy for a
+   * concrete RoutingProfile (see Customize()), the resulting Metric can then
+   * be used for any number of bidirectional upward searches (see FindRoute()).
+   */
+  class OSMSCOUT_API ContractionHierarchy CLASS_FINAL
+  {
+  public:
+    static constexpr uint32_t noRank=std::numeric_limits<uint32_t>::max();
+
+    /**
+     * A path of the original routing graph, it is attached to the edge of the
+     * hierarchy between its two route nodes.
+     */
+    struct Arc
+    {
+      ObjectFileRef object;             //!< The way or area the path belongs to
+      uint16_t      objectVariantIndex; //!< Index into the object variant data
+      uint8_t       flags;              //!< Flags of the path, see RouteNode
+      bool          upward;             //!< true, if the path leads from the lower to the higher ranked node
+      Distance      distance;           //!< Length of the path
+    };
+
+    /**
+     * Costs of all edges of the hierarchy for one routing profile.
+     *
+     * "up" is the direction from the lower to the higher ranked node of an
+     * edge, "down" the opposite direction. For a shortcut the via vector
+     * holds the rank of the node the shortcut bypasses, for an original
+     * path the arc vector holds the index of the cheapest Arc.
+     */
+    struct Metric
+    {
+      std::vector<double>   upCosts;
+      std::vector<double>   downCosts;
+      std::vector<uint32_t> upVias;
+      std::vector<uint32_t> downVias;
+      std::vector<uint32_t> upArcs;
+      std::vector<uint32_t> downArcs;
+    };
+
+    using MetricRef = std::shared_ptr<const Metric>;
+
+    /**
+     * One step of an unpacked route, the route node reached and the object
+     * used to reach it.
+     */
+    struct RouteStep
+    {
+      Id            id;
+      ObjectFileRef object;
+    };
+
+  private:
+    Vehicle                             vehicle=vehicleCar;
+    std::vector<Id>                     ids;         //!< Route node id for each rank
+    std::vector<std::pair<Id,uint32_t>> idRanks;     //!< Rank for each route node id, sorted by id
+    std::vector<uint32_t>               edgeOffsets; //!< Index of the first edge for each rank
+    std::vector<uint32_t>               edgeTargets; //!< Higher ranked node of each edge
+    std::vector<uint32_t>               arcOffsets;  //!< Index of the first arc for each edge
+    std::vector<Arc>                    arcs;        //!< Original paths
+
+  public:
+    bool Load(const std::string& filename,
+              Vehicle vehicle);
+
+    Vehicle GetVehicle() const
+    {
+      return vehicle;
+    }
+
+    size_t GetNodeCount() const
+    {
+      return ids.size();
+    }
+
+    size_t GetEdgeCount() const
+    {
+      return edgeTargets.size();
+    }
+
+    uint32_t GetRank(Id id) const;
+
+    Id GetId(uint32_t rank) const
+    {
+      return ids[rank];
+    }
+
+    size_t FindEdge(uint32_t lower,
+                    uint32_t higher) const;
+
+    MetricRef Customize(const RoutingProfile& profile,
+                        const std::vector<ObjectVariantData>& objectVariantData) const;
+
+    bool FindRoute(const Metric& metric,
+                   const std::vector<std::pair<Id,double>>& sources,
+                   const std::vector<Id>& targets,
+                   double maxCost,
+                   const BreakerRef& breaker,
+                   Id& source,
+                   std::vector<RouteStep>& route) const;
+  };
+
+  using ContractionHierarchyRef = std::shared_ptr<ContractionHierarchy>;
+}
+
+#endif
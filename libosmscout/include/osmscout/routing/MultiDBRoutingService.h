@@ -52,9 +52,13 @@ namespace osmscout {
 
   private:
     std::vector<DatabaseHandle> handles;
+    bool                        useContractionHierarchy; //!< Use contraction hierarchies, if there is only one database
     bool                        isOpen=false;
 
   private:
+    bool GetPositionDatabases(const std::vector<RoutePosition>& positions,
+                              std::set<DatabaseId>& databases) const;
+
     Vehicle GetVehicle(const MultiDBRoutingState& state) override;
 
     bool CanUseForward(const MultiDBRoutingState& state,
@@ -112,6 +116,17 @@ namespace osmscout {
                                    DatabaseId database,
                                    Id id) override;
 
+    bool CalculateRouteNodeChain(const MultiDBRoutingState& state,
+                                 const RoutePosition& start,
+                                 const RoutePosition& target,
+                                 const RNodeRef& startForwardNode,
+                                 const RNodeRef& startBackwardNode,
+                                 const RouteNodeRef& targetForwardRouteNode,
+                                 const RouteNodeRef& targetBackwardRouteNode,
+                                 const RoutingParameter& parameter,
+                                 double costLimit,
+                                 std::list<VNode>& nodes) override;
+
     bool CanUse(const MultiDBRoutingState& state,
                 DatabaseId databaseId,
                 const RouteNode& routeNode,
@@ -137,6 +152,18 @@ namespace osmscout {
                                  const Distance &radius,
                                  const RoutingParameter& parameter);
 
+    RoutingMatrixResult CalculateMatrix(const std::vector<RoutePosition>& sources,
+                                        const std::vector<RoutePosition>& targets,
+                                        const RoutingParameter& parameter);
+
+    ReachabilityResult CalculateReachability(const RoutePosition& center,
+                                             double maxCost,
+                                             const RoutingParameter& parameter);
+
+    std::vector<ReachabilityResult> CalculateReachability(const std::vector<RoutePosition>& centers,
+                                                          double maxCost,
+                                                          const RoutingParameter& parameter);
+
     RouteDescriptionResult TransformRouteDataToRouteDescription(const RouteData& data);
 
     RoutePointsResult TransformRouteDataToPoints(const RouteData& data);
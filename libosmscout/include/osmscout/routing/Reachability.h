@@ -0,0 +1,170 @@
+#ifndef OSMSCOUT_ROUTING_REACHABILITY_H
+#define OSMSCOUT_ROUTING_REACHABILITY_H
+
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2026  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <vector>
+
+#include <osmscout/CoreImportExport.h>
+
+#include <osmscout/GeoCoord.h>
+
+#include <osmscout/routing/DBFileOffset.h>
+
+#include <osmscout/util/Distance.h>
+
+#include <osmscout/system/Compiler.h>
+
+namespace osmscout {
+
+  /**
+   * \ingroup Routing
+   *
+   * Polygons covering the area reachable from a center within a given cost.
+   *
+   * Outer rings are oriented counterclockwise, holes (unreachable areas within
+   * an outer ring) clockwise. Each hole references the outer ring it lies in,
+   * so polygons with holes can be rebuilt from the rings.
+   */
+  class OSMSCOUT_API Isochrone CLASS_FINAL
+  {
+  public:
+    struct Ring
+    {
+      bool                  outer;     //!< true for an outer ring, false for a hole
+      size_t                outerRing; //!< Index of the outer ring containing the hole, for outer rings its own index
+      std::vector<GeoCoord> coords;
+    };
+
+  private:
+    double            cost=0.0;
+    std::vector<Ring> rings;
+
+  public:
+    Isochrone() = default;
+    Isochrone(double cost,
+              const std::vector<Ring>& rings);
+
+    double GetCost() const
+    {
+      return cost;
+    }
+
+    const std::vector<Ring>& GetRings() const
+    {
+      return rings;
+    }
+
+    bool IsEmpty() const
+    {
+      return rings.empty();
+    }
+  };
+
+  /**
+   * \ingroup Routing
+   *
+   * Result of a reachability calculation (see
+   * AbstractRoutingService::CalculateReachability()).
+   *
+   * Holds all route nodes reachable from the center within the maximum cost
+   * of the calculation (sorted by cost) and the paths leaving them. The center
+   * itself is the first node (with an invalid id).
+   */
+  class OSMSCOUT_API ReachabilityResult CLASS_FINAL
+  {
+  public:
+    struct Node
+    {
+      DBId     id;       //!< Id of the route node
+      GeoCoord coord;    //!< Coordinate of the route node
+      double   cost;     //!< Costs of the cheapest route from the center
+      Distance distance; //!< Length of the cheapest route from the center
+    };
+
+    /**
+     * A path leaving a reachable node, the target of the path may not be
+     * reachable within the maximum cost.
+     */
+    struct Edge
+    {
+      size_t   from;     //!< Index of the node the path starts at
+      GeoCoord to;       //!< Coordinate of the route node the path leads to
+      double   cost;     //!< Costs of the path
+    };
+
+  private:
+    bool              success=false;
+    double            maxCost=0.0;
+    std::vector<Node> nodes;
+    std::vector<Edge> edges;
+
+  public:
+    ReachabilityResult() = default;
+    explicit ReachabilityResult(double maxCost);
+
+    void SetSuccess(bool success)
+    {
+      this->success=success;
+    }
+
+    size_t AddNode(const DBId& id,
+                   const GeoCoord& coord,
+                   double cost,
+                   const Distance& distance)
+    {
+      nodes.push_back(Node{id,coord,cost,distance});
+
+      return nodes.size()-1;
+    }
+
+    void AddEdge(size_t from,
+                 const GeoCoord& to,
+                 double cost)
+    {
+      edges.push_back(Edge{from,to,cost});
+    }
+
+    bool Success() const
+    {
+      return success;
+    }
+
+    double GetMaxCost() const
+    {
+      return maxCost;
+    }
+
+    const std::vector<Node>& GetNodes() const
+    {
+      return nodes;
+    }
+
+    const std::vector<Edge>& GetEdges() const
+    {
+      return edges;
+    }
+
+    Isochrone GetIsochrone(double cost,
+                           const Distance& resolution) const;
+  };
+}
+
+#endif
@@ -21,6 +21,7 @@
 */
 
 #include <map>
+#include <mutex>
 #include <vector>
 
 #include <osmscout/DataFile.h>
@@ -64,8 +65,8 @@ namespace osmscout {
 
     std::map<Pixel,IndexEntry> index;
 
-    mutable FileScanner        scanner;         //!< File stream to the data file
-    mutable ValueCache         cache;           //!< Cache of loaded route node pages
+    mutable FileScanner        scanner;         //!< File stream to the data file, guarded by accessMutex
+    mutable ValueCache         cache;           //!< Cache of loaded route node pages, guarded by accessMutex
     mutable std::mutex         accessMutex;     //!< Mutex to secure multi-thread access
     mutable Magnification      magnification;   //!< Magnification of tiled index
 
@@ -97,6 +98,8 @@ namespace osmscout {
     bool Get(IteratorIn begin, IteratorIn end, size_t size,
              std::vector<RouteNodeRef>& data) const
     {
+      std::scoped_lock<std::mutex> lock(accessMutex);
+
       data.reserve(size);
 
       for (IteratorIn idIter=begin; idIter!=end; ++idIter) {
@@ -130,6 +133,8 @@ namespace osmscout {
     bool Get(IteratorIn begin, IteratorIn end, size_t /*size*/,
              std::unordered_map<Id,RouteNodeRef>& dataMap) const
     {
+      std::scoped_lock<std::mutex> lock(accessMutex);
+
       for (IteratorIn idIter=begin; idIter!=end; ++idIter) {
         Id                   id=*idIter;
         ValueCache::CacheRef cacheRef;
@@ -190,8 +190,14 @@ namespace osmscout {
     double                     minSpeed;
     double                     maxSpeed;
     double                     vehicleMaxSpeed;
+    size_t                     generation=0; //!< Incremented on each change of the profile
 
   protected:
+    void Changed()
+    {
+      generation++;
+    }
+
     template <typename Obj>
     Duration GetTime2(const Obj& obj,
                       const Distance &distance) const
@@ -220,6 +226,15 @@ namespace osmscout {
   public:
     explicit AbstractRoutingProfile(const TypeConfigRef& typeConfig);
 
+    /**
+     * Returns a number that changes each time the profile is modified.
+     * Allows caching data derived from the profile.
+     */
+    size_t GetGeneration() const
+    {
+      return generation;
+    }
+
     void SetVehicle(Vehicle vehicle);
     void SetVehicleMaxSpeed(double maxSpeed);
 
@@ -396,6 +411,7 @@ namespace osmscout {
     void SetJunctionPenalty(bool b)
     {
       applyJunctionPenalty=b;
+      Changed();
     }
 
     Distance GetPenaltySameType() const
@@ -406,6 +422,7 @@ namespace osmscout {
     void SetPenaltySameType(const Distance &d)
     {
       penaltySameType=d;
+      Changed();
     }
 
     Distance GetPenaltyDifferentType() const
@@ -416,6 +433,7 @@ namespace osmscout {
     void SetPenaltyDifferentType(const Distance &d)
     {
       penaltyDifferentType=d;
+      Changed();
     }
 
     HourDuration GetMaxPenalty() const
@@ -426,6 +444,7 @@ namespace osmscout {
     void SetMaxPenalty(const HourDuration &d)
     {
       maxPenalty=d;
+      Changed();
     }
 
     double GetCosts(const RouteNode& currentNode,
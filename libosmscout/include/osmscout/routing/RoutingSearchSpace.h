@@ -0,0 +1,512 @@
+#ifndef OSMSCOUT_ROUTING_ROUTINGSEARCHSPACE_H
+#define OSMSCOUT_ROUTING_ROUTINGSEARCHSPACE_H
+
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2026  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <algorithm>
+#include <cassert>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include <osmscout/routing/DBFileOffset.h>
+
+#include <osmscout/system/Compiler.h>
+
+namespace osmscout {
+
+  /**
+   * \ingroup Routing
+   *
+   * Arena for search nodes of a routing graph search. Nodes are allocated
+   * in chunks and never move, so raw pointers to them stay valid until
+   * the arena gets cleared. Clearing resets all nodes handed out, but keeps
+   * the chunks for the next search.
+   */
+  template<typename N, size_t ChunkSize = 4096>
+  class NodeArena CLASS_FINAL
+  {
+  private:
+    std::vector<std::unique_ptr<N[]>> chunks;
+    size_t                            used=0;
+
+  public:
+    template<typename... Args>
+    N* Create(Args&&... args)
+    {
+      size_t chunk=used/ChunkSize;
+
+      if (chunk==chunks.size()) {
+        chunks.push_back(std::make_unique<N[]>(ChunkSize));
+      }
+
+      N* node=&chunks[chunk][used%ChunkSize];
+
+      *node=N(std::forward<Args>(args)...);
+      used++;
+
+      return node;
+    }
+
+    /**
+     * Reset all nodes handed out (so that they do not hold references anymore)
+     * and make the memory available for reuse.
+     */
+    void Clear()
+    {
+      for (size_t i=0; i<used; i++) {
+        chunks[i/ChunkSize][i%ChunkSize]=N();
+      }
+
+      used=0;
+    }
+
+    size_t Size() const
+    {
+      return used;
+    }
+
+    size_t Capacity() const
+    {
+      return chunks.size()*ChunkSize;
+    }
+  };
+
+  /**
+   * \ingroup Routing
+   *
+   * Indexed d-ary min heap of node pointers. Each node stores its current
+   * position in the heap in its member 'heapIndex', which allows changing
+   * the cost of a node already in the heap (decrease-key) in O(log n) without
+   * removing and reinserting it.
+   *
+   * Less is a strict weak ordering on node pointers, the smallest node is on
+   * top.
+   */
+  template<typename N, typename Less, size_t Arity = 4>
+  class IndexedHeap CLASS_FINAL
+  {
+  public:
+    static constexpr size_t npos=std::numeric_limits<size_t>::max();
+
+    using const_iterator = typename std::vector<N*>::const_iterator;
+
+  private:
+    std::vector<N*> heap;
+    Less            less;
+
+  private:
+    void Place(N* node, size_t index)
+    {
+      heap[index]=node;
+      node->heapIndex=index;
+    }
+
+    bool SiftUp(size_t index)
+    {
+      N*     node=heap[index];
+      size_t start=index;
+
+      while (index>0) {
+        size_t parent=(index-1)/Arity;
+
+        if (!less(node,heap[parent])) {
+          break;
+        }
+
+        Place(heap[parent],index);
+        index=parent;
+      }
+
+      Place(node,index);
+
+      return index!=start;
+    }
+
+    void SiftDown(size_t index)
+    {
+      N*     node=heap[index];
+      size_t size=heap.size();
+
+      while (true) {
+        size_t first=index*Arity+1;
+
+        if (first>=size) {
+          break;
+        }
+
+        size_t last=std::min(first+Arity,size);
+        size_t best=first;
+
+        for (size_t child=first+1; child<last; child++) {
+          if (less(heap[child],heap[best])) {
+            best=child;
+          }
+        }
+
+        if (!less(heap[best],node)) {
+          break;
+        }
+
+        Place(heap[best],index);
+        index=best;
+      }
+
+      Place(node,index);
+    }
+
+  public:
+    bool Empty() const
+    {
+      return heap.empty();
+    }
+
+    size_t Size() const
+    {
+      return heap.size();
+    }
+
+    bool Contains(const N* node) const
+    {
+      return node->heapIndex<heap.size() &&
+             heap[node->heapIndex]==node;
+    }
+
+    void Reserve(size_t size)
+    {
+      heap.reserve(size);
+    }
+
+    void Push(N* node)
+    {
+      heap.push_back(node);
+      SiftUp(heap.size()-1);
+    }
+
+    N* Top() const
+    {
+      assert(!heap.empty());
+
+      return heap.front();
+    }
+
+    void Pop()
+    {
+      assert(!heap.empty());
+
+      N* top=heap.front();
+      N* last=heap.back();
+
+      heap.pop_back();
+      top->heapIndex=npos;
+
+      if (!heap.empty()) {
+        Place(last,0);
+        SiftDown(0);
+      }
+    }
+
+    /**
+     * Restore the heap order after the cost of the given node (which must
+     * be part of the heap) has changed.
+     */
+    void Update(N* node)
+    {
+      assert(Contains(node));
+
+      if (!SiftUp(node->heapIndex)) {
+        SiftDown(node->heapIndex);
+      }
+    }
+
+    void Clear()
+    {
+      for (N* node : heap) {
+        node->heapIndex=npos;
+      }
+
+      heap.clear();
+    }
+
+    //! Iterate over all nodes in the heap (in heap, not in cost order)
+    const_iterator begin() const
+    {
+      return heap.begin();
+    }
+
+    const_iterator end() const
+    {
+      return heap.end();
+    }
+  };
+
+  /**
+   * \ingroup Routing
+   *
+   * Open addressing hash table of values identified by a DBId, using linear
+   * probing and backward shift deletion. KeyOf extracts the DBId from a
+   * value, a default constructed value must have an invalid DBId and marks
+   * an empty slot.
+   *
+   * Clearing the table keeps the allocated slots for the next search.
+   */
+  template<typename V, typename KeyOf>
+  class DBIdHashTable CLASS_FINAL
+  {
+  private:
+    std::vector<V> slots;
+    size_t         count=0;
+    size_t         mask=0;
+    KeyOf          keyOf;
+
+  private:
+    static size_t Hash(const DBId& id)
+    {
+      uint64_t hash=(id.id ^ (uint64_t(id.database) << 48))*0x9E3779B97F4A7C15ULL;
+
+      return size_t(hash ^ (hash >> 32));
+    }
+
+    bool IsEmpty(const V& value) const
+    {
+      return !keyOf(value).IsValid();
+    }
+
+    size_t FindSlot(const DBId& id) const
+    {
+      size_t index=Hash(id) & mask;
+
+      while (!IsEmpty(slots[index]) &&
+             keyOf(slots[index])!=id) {
+        index=(index+1) & mask;
+      }
+
+      return index;
+    }
+
+    void Rehash(size_t slotCount)
+    {
+      std::vector<V> oldSlots(slotCount);
+
+      std::swap(slots,oldSlots);
+      mask=slotCount-1;
+
+      for (auto& value : oldSlots) {
+        if (!IsEmpty(value)) {
+          slots[FindSlot(keyOf(value))]=std::move(value);
+        }
+      }
+    }
+
+  public:
+    class const_iterator
+    {
+    private:
+      const DBIdHashTable* table;
+      size_t               index;
+
+      void SkipEmpty()
+      {
+        while (index<table->slots.size() &&
+               table->IsEmpty(table->slots[index])) {
+          index++;
+        }
+      }
+
+    public:
+      using iterator_category = std::forward_iterator_tag;
+      using value_type        = V;
+      using difference_type   = std::ptrdiff_t;
+      using pointer           = const V*;
+      using reference         = const V&;
+
+      const_iterator(const DBIdHashTable* table, size_t index)
+      : table(table),
+        index(index)
+      {
+        SkipEmpty();
+      }
+
+      const V& operator*() const
+      {
+        return table->slots[index];
+      }
+
+      const V* operator->() const
+      {
+        return &table->slots[index];
+      }
+
+      const_iterator& operator++()
+      {
+        index++;
+        SkipEmpty();
+
+        return *this;
+      }
+
+      bool operator==(const const_iterator& other) const
+      {
+        return index==other.index;
+      }
+
+      bool operator!=(const const_iterator& other) const
+      {
+        return index!=other.index;
+      }
+    };
+
+  public:
+    bool Empty() const
+    {
+      return count==0;
+    }
+
+    size_t Size() const
+    {
+      return count;
+    }
+
+    /**
+     * Make sure, that the given number of values can be stored without rehashing
+     */
+    void Reserve(size_t size)
+    {
+      size_t slotCount=16;
+
+      while (slotCount*3<size*4) {
+        slotCount*=2;
+      }
+
+      if (slotCount>slots.size()) {
+        Rehash(slotCount);
+      }
+    }
+
+    /**
+     * Return the value with the given id or nullptr, if there is none
+     */
+    const V* Find(const DBId& id) const
+    {
+      if (count==0) {
+        return nullptr;
+      }
+
+      const V& value=slots[FindSlot(id)];
+
+      return IsEmpty(value) ? nullptr : &value;
+    }
+
+    V* Find(const DBId& id)
+    {
+      if (count==0) {
+        return nullptr;
+      }
+
+      V& value=slots[FindSlot(id)];
+
+      return IsEmpty(value) ? nullptr : &value;
+    }
+
+    /**
+     * Insert the value, if there is not already a value with the same id.
+     *
+     * @return
+     *    true, if the value was inserted
+     */
+    bool Insert(const V& value)
+    {
+      if ((count+1)*4>slots.size()*3) {
+        Rehash(std::max(slots.size()*2,size_t(16)));
+      }
+
+      size_t index=FindSlot(keyOf(value));
+
+      if (!IsEmpty(slots[index])) {
+        return false;
+      }
+
+      slots[index]=value;
+      count++;
+
+      return true;
+    }
+
+    /**
+     * Remove the value with the given id (if there is one)
+     */
+    void Erase(const DBId& id)
+    {
+      if (count==0) {
+        return;
+      }
+
+      size_t index=FindSlot(id);
+
+      if (IsEmpty(slots[index])) {
+        return;
+      }
+
+      // Move following entries of the same probe sequence back into the hole
+      size_t next=index;
+
+      while (true) {
+        next=(next+1) & mask;
+
+        if (IsEmpty(slots[next])) {
+          break;
+        }
+
+        size_t home=Hash(keyOf(slots[next])) & mask;
+
+        if (((next-home) & mask)>=((next-index) & mask)) {
+          slots[index]=std::move(slots[next]);
+          index=next;
+        }
+      }
+
+      slots[index]=V();
+      count--;
+    }
+
+    void Clear()
+    {
+      if (count>0) {
+        std::fill(slots.begin(),slots.end(),V());
+        count=0;
+      }
+    }
+
+    const_iterator begin() const
+    {
+      return const_iterator(this,0);
+    }
+
+    const_iterator end() const
+    {
+      return const_iterator(this,slots.size());
+    }
+  };
+}
+
+#endif /* OSMSCOUT_ROUTING_ROUTINGSEARCHSPACE_H */
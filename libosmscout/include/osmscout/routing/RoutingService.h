@@ -20,10 +20,13 @@
   Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
 */
 
+#include <array>
 #include <atomic>
 #include <functional>
 #include <list>
+#include <limits>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <unordered_map>
 #include <unordered_set>
@@ -48,6 +51,7 @@
 #include <osmscout/routing/RouteNodeDataFile.h>
 #include <osmscout/routing/RoutingProfile.h>
 #include <osmscout/routing/DBFileOffset.h>
+#include <osmscout/routing/RoutingSearchSpace.h>
 
 #include <osmscout/util/Breaker.h>
 #include <osmscout/util/Cache.h>
@@ -136,6 +140,7 @@ namespace osmscout {
   {
   private:
     bool          debugPerformance;
+    bool          contractionHierarchy;
 
   public:
     RouterParameter();
@@ -143,6 +148,10 @@ namespace osmscout {
     void SetDebugPerformance(bool debug);
 
     bool IsDebugPerformance() const;
+
+    void SetContractionHierarchy(bool contractionHierarchy);
+
+    bool IsContractionHierarchy() const;
   };
 
   /**
@@ -227,9 +236,12 @@ namespace osmscout {
       double        currentCost=0;   //!< The cost of the current up to the current node
       double        estimateCost=0;  //!< The estimated cost from here to the target
       double        overallCost=0;   //!< The overall costs (currentCost+estimateCost)
+      Distance      distance;        //!< The length of the route up to the current node
 
       bool          access=true;     //!< Flags to signal, if we had access ("access restrictions") to this node
 
+      size_t        heapIndex=std::numeric_limits<size_t>::max(); //!< Position in the OpenList
+
       RNode() = default;
 
       RNode(const DBId& id,
@@ -265,7 +277,15 @@ namespace osmscout {
       }
     };
 
-    using RNodeRef = std::shared_ptr<RNode>;
+    /**
+     * RNodes are allocated from the RNodePool of the current search and stay
+     * valid until the search is finished.
+     *
+     * Note: RNodeRef was a std::shared_ptr<RNode> before. Code that stores
+     * RNodeRefs beyond the end of a search (for example in subclasses of
+     * AbstractRoutingService) has to copy the RNode instead.
+     */
+    using RNodeRef = RNode*;
 
     struct RNodeCostCompare
     {
@@ -310,6 +330,11 @@ namespace osmscout {
         return currentNode==other.currentNode;
       }
 
+      /**
+       * Constructor for an empty slot in the ClosedSet.
+       */
+      VNode() = default;
+
       /**
        * Simple constructor for searching for VNodes in the
        * ClosedSet.
@@ -344,24 +369,105 @@ namespace osmscout {
       }
     };
 
+    struct RNodeKey
+    {
+      DBId operator()(const RNodeRef& node) const
+      {
+        return node!=nullptr ? node->id : DBId();
+      }
+    };
+
+    struct VNodeKey
+    {
+      const DBId& operator()(const VNode& node) const
+      {
+        return node.currentNode;
+      }
+    };
+
+    using RNodePool   = NodeArena<RNode>;
+    using OpenList    = IndexedHeap<RNode, RNodeCostCompare>;
+    using OpenMap     = DBIdHashTable<RNodeRef, RNodeKey>;
+    using ClosedSet   = DBIdHashTable<VNode, VNodeKey>;
+
+    /**
+     * \ingroup Routing
+     *
+     * All data structures of one route search. Search spaces are recycled
+     * for following searches, so that the memory allocated by large searches
+     * can be reused. Search spaces that grew beyond maxPooledNodes are
+     * released instead of recycled, so that a single long route does not
+     * keep its peak memory for the lifetime of the service.
+     */
+    struct RoutingSearchSpace
+    {
+      static constexpr size_t maxPooledNodes=128*1024; //!< Maximum number of nodes of a recycled search space
+
+      RNodePool nodePool;            //!< Owner of all RNodes of the search
+      OpenList  openList;            //!< Open nodes, sorted by cost (smallest cost first)
+      OpenMap   openMap;             //!< Open nodes, by route node id
+      ClosedSet closedSet;           //!< Closed nodes reached without access restriction
+      ClosedSet closedRestrictedSet; //!< Closed nodes reached via ways with access restriction
+
+      void Clear();
+    };
+
+    using RoutingSearchSpaceRef = std::shared_ptr<RoutingSearchSpace>;
+
     /**
-     * Helper class for calculating hash codes for
-     * VNode instances to make it usable in std::unordered_set.
+     * \ingroup Routing
+     *
+     * Route nodes loaded by all searches of one batch calculation, shared by
+     * the threads of the batch, so that each route node is only loaded once per
+     * batch. Route nodes are distributed over shards by their id, so concurrent
+     * lookups usually do not lock the same mutex.
      */
-    struct ClosedNodeHasher
+    class RouteNodeBatch CLASS_FINAL
     {
-      size_t operator()(const VNode& node) const
+    private:
+      struct Shard
       {
-        return std::hash<Id>()(node.currentNode.id) ^
-               std::hash<DatabaseId>()(node.currentNode.database);
+        std::mutex                            mutex;
+        std::unordered_map<DBId,RouteNodeRef> nodes;
+      };
+
+      static constexpr size_t shardCount=16;
+
+    private:
+      std::array<Shard,shardCount> shards;
+
+    private:
+      Shard& GetShard(const DBId& id)
+      {
+        return shards[std::hash<DBId>{}(id)%shardCount];
+      }
+
+    public:
+      RouteNodeRef Find(const DBId& id)
+      {
+        Shard&                      shard=GetShard(id);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+        auto                        entry=shard.nodes.find(id);
+
+        return entry!=shard.nodes.end() ? entry->second : RouteNodeRef();
+      }
+
+      void Insert(const DBId& id,
+                  const RouteNodeRef& node)
+      {
+        Shard&                      shard=GetShard(id);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        shard.nodes.emplace(id,node);
       }
     };
 
-    using OpenList    = std::set<RNodeRef, RNodeCostCompare>;
-    using OpenListRef = std::set<RNodeRef, RNodeCostCompare>::iterator;
+  private:
+    std::mutex                                       searchSpaceMutex;
+    std::vector<std::unique_ptr<RoutingSearchSpace>> searchSpaces;     //!< Unused search spaces
 
-    using OpenMap     = std::unordered_map<DBId, OpenListRef>;
-    using ClosedSet   = std::unordered_set<VNode, ClosedNodeHasher>;
+  protected:
+    RoutingSearchSpaceRef AcquireSearchSpace();
 
   public:
     //! Relative filename of the intersection data file
@@ -375,6 +481,8 @@ namespace osmscout {
     static std::string GetDataFilename(const std::string& filenamebase);
     static std::string GetData2Filename(const std::string& filenamebase);
     static std::string GetIndexFilename(const std::string& filenamebase);
+    static std::string GetContractionHierarchyFilename(const std::string& filenamebase,
+                                                       Vehicle vehicle);
 
   public:
     RoutingService();
@@ -24,6 +24,7 @@
 #include <functional>
 #include <list>
 #include <memory>
+#include <mutex>
 #include <set>
 #include <unordered_map>
 #include <unordered_set>
@@ -45,6 +46,7 @@
 #include <osmscout/Intersection.h>
 #include <osmscout/routing/RouteDescription.h>
 #include <osmscout/routing/RouteData.h>
+#include <osmscout/routing/ContractionHierarchy.h>
 #include <osmscout/routing/RoutingDB.h>
 #include <osmscout/routing/RoutingProfile.h>
 #include <osmscout/routing/RoutingService.h>
@@ -122,6 +124,22 @@ namespace osmscout {
 
     RoutingDatabase                      routingDatabase;       //!< Access to routing data and index files
 
+    /**
+     * A contraction hierarchy customized for a routing profile
+     */
+    struct ContractionHierarchyMetric
+    {
+      RoutingProfileRef               profile;
+      size_t                          profileGeneration; //!< Generation of the profile the metric was prepared for
+      ContractionHierarchyRef         hierarchy;
+      ContractionHierarchy::MetricRef metric;
+    };
+
+    bool                                    useContractionHierarchy;     //!< Load and use contraction hierarchies
+    std::vector<ContractionHierarchyRef>    contractionHierarchies;      //!< Loaded contraction hierarchies, one per vehicle
+    std::mutex                              contractionHierarchyMutex;   //!< Guards the prepared metrics
+    std::vector<ContractionHierarchyMetric> contractionHierarchyMetrics; //!< Prepared metrics
+
   private:
     bool HasNodeWithId(const std::vector<Point>& nodes) const;
 
@@ -188,6 +206,17 @@ namespace osmscout {
                                    DatabaseId database,
                                    Id id) override;
 
+    bool CalculateRouteNodeChain(const RoutingProfile& profile,
+                                 const RoutePosition& start,
+                                 const RoutePosition& target,
+                                 const RNodeRef& startForwardNode,
+                                 const RNodeRef& startBackwardNode,
+                                 const RouteNodeRef& targetForwardRouteNode,
+                                 const RouteNodeRef& targetBackwardRouteNode,
+                                 const RoutingParameter& parameter,
+                                 double costLimit,
+                                 std::list<VNode>& nodes) override;
+
   public:
     SimpleRoutingService(const DatabaseRef& database,
                          const RouterParameter& parameter,
@@ -200,6 +229,17 @@ namespace osmscout {
 
     TypeConfigRef GetTypeConfig() const;
 
+    bool PrepareContractionHierarchy(const RoutingProfileRef& profile);
+
+    bool CalculateContractionHierarchyRoute(const RoutingProfile& profile,
+                                            const RNodeRef& startForwardNode,
+                                            const RNodeRef& startBackwardNode,
+                                            const RouteNodeRef& targetForwardRouteNode,
+                                            const RouteNodeRef& targetBackwardRouteNode,
+                                            const RoutingParameter& parameter,
+                                            double costLimit,
+                                            std::list<VNode>& nodes);
+
     RoutingResult CalculateRouteViaCoords(RoutingProfile& profile,
                                           const std::vector<GeoCoord>& via,
                                           const Distance &radius,
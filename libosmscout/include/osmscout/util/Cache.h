@@ -22,9 +22,11 @@
 
 #include <osmscout/CoreFeatures.h>
 
+#include <cstdint>
+#include <functional>
 #include <limits>
-#include <list>
-#include <unordered_map>
+#include <memory>
+#include <utility>
 #include <vector>
 
 #include <osmscout/system/Assert.h>
@@ -37,7 +39,7 @@ namespace osmscout {
 
   /**
    * \ingroup Util
-   * Generic FIFO cache implementation with O(n log n) semantic.
+   * Generic cache implementation with O(1) semantic and CLOCK eviction.
    *
    * Template parameter class K holds the key value (must be a numerical value),
    * parameter class V holds the data class that is to be cached,
@@ -45,14 +47,22 @@ namespace osmscout {
    * default is PageId.
    *
    * * The cache is not threadsafe.
-   * * It uses a std::vector<std::list>> as a hash table for data lookup
-   * * It uses an std::list for implementing FIFO characteristics.
-   *
-   * Implementation details: If std::unordered_map ist available we use this
-   * for fast detection (O(1)) if an object is already in the cast. If it is not
-   * available, we use a vector as a hashtable via the key value with list
-   * as entry type for hash code conflict handling.
+   * * Entries are stored in a flat vector of slots, that is allocated once for
+   *   the maximum size of the cache. Inserting or updating entries does not
+   *   allocate memory (besides memory allocated by copying the value itself).
+   * * Lookup is done via an open addressing hash table (linear probing) of slot indexes.
+   * * Eviction uses the CLOCK algorithm with a small usage counter per slot (GCLOCK).
+   *   New entries start with a counter of one, so they survive at least one pass
+   *   of the CLOCK hand, and each hit increments it. So entries that were only
+   *   touched once (for example by a large sequential scan) are evicted before
+   *   entries of the hot working set.
+   * * Optionally the cache can be limited by the memory of its values, see SetMemoryBudget().
    *
+   * References returned by GetEntry() and SetEntry() stay valid until the entry gets
+   * evicted, the cache gets flushed, SetMaxSize() is called or the cache is destroyed.
+   * A reference must not be kept beyond the next call of a non-const method
+   * of the cache. Dereferencing an invalid reference is detected by an
+   * assertion (see CacheRef::IsValid()).
    */
   template <class K, class V, class IK = PageId>
   class Cache
@@ -66,6 +76,8 @@ namespace osmscout {
       K key; // NOLINT
       V value; // NOLINT
 
+      CacheEntry() = default;
+
       explicit CacheEntry(const K& key)
       : key(key)
       {
@@ -94,45 +106,269 @@ namespace osmscout {
       virtual size_t GetSize(const V& value) const = 0;
     };
 
-    using OrderList = std::list<CacheEntry>;
-    using CacheRef  = typename OrderList::iterator;
-    using Map       = std::unordered_map<K, typename OrderList::iterator>;
+    static constexpr size_t noSlot=std::numeric_limits<size_t>::max(); //<! Slot index of the entry of an inactive cache
+
+    /**
+      Reference to an entry of the cache, as returned by GetEntry() and
+      SetEntry(). The reference gets invalid, if the entry is evicted, the cache
+      is flushed or resized. IsValid() detects this, as long as the cache
+      itself still exists.
+      */
+    class CacheRef
+    {
+      friend class Cache;
+
+    private:
+      const Cache* cache=nullptr;   //<! Cache the entry belongs to
+      CacheEntry*  entry=nullptr;   //<! The referenced entry
+      size_t       slotIndex=noSlot;//<! Slot of the entry
+      uint64_t     stamp=0;         //<! Stamp of the slot at the time the reference was created
+
+    private:
+      CacheRef(const Cache* cache,
+               CacheEntry* entry,
+               size_t slotIndex,
+               uint64_t stamp)
+      : cache(cache),
+        entry(entry),
+        slotIndex(slotIndex),
+        stamp(stamp)
+      {
+        // no code
+      }
+
+    public:
+      CacheRef() = default;
+
+      /**
+        Returns true, if the reference still points to the entry it was created for
+        */
+      bool IsValid() const
+      {
+        return entry!=nullptr &&
+               cache->IsValidReference(slotIndex,
+                                       stamp);
+      }
+
+      CacheEntry* operator->() const
+      {
+        assert(IsValid());
+
+        return entry;
+      }
+
+      CacheEntry& operator*() const
+      {
+        assert(IsValid());
+
+        return *entry;
+      }
+    };
+
+    using ValueSizerRef = std::shared_ptr<const ValueSizer>;
+
+  private:
+    static constexpr uint8_t maxUsage=3;           //<! Maximum usage count of a slot
+    static constexpr size_t  emptyBucket=0;        //<! Marker for an empty bucket in the hash table
+
+    /**
+      A slot of the cache, holding one (possibly unused) entry
+      */
+    struct Slot
+    {
+      CacheEntry entry;
+      size_t     memory=0;   //<! Memory of the value as reported by the ValueSizer
+      uint64_t   stamp=0;    //<! Unique stamp of the current entry, 0 if unused
+      uint8_t    usage=0;    //<! Usage count for CLOCK eviction
+      bool       used=false; //<! Slot holds a valid entry
+    };
 
   private:
-    size_t    size=0;        //<! Current size fo the cache
-    size_t    maxSize;       //<! Maximum size of the cache
-    OrderList order;         //<! Order list (by cache access) of cache entries for least recently used cache flush
-    Map       map;           //<! Key=>Value map
-    CacheRef  previousEntry; //<! Reference to the last access cache entry
+    size_t              size=0;          //<! Current size fo the cache
+    size_t              maxSize;         //<! Maximum size of the cache
+    std::vector<Slot>   slots;           //<! Preallocated slots, never grows beyond maxSize
+    std::vector<size_t> freeSlots;       //<! Indexes of unused slots below slots.size()
+    std::vector<size_t> buckets;         //<! Hash table, slot index+1 or emptyBucket
+    size_t              bucketShift=64;  //<! Shift for reducing the hash value to a bucket index
+    size_t              hand=0;          //<! Current position of the CLOCK hand
+    CacheEntry          scratch;         //<! Entry returned by SetEntry(), if the cache is not active
+    uint64_t            scratchStamp=0;  //<! Stamp of the current scratch entry
+    uint64_t            nextStamp=1;     //<! Next stamp for a new entry, never reused
+
+    ValueSizerRef       sizer;           //<! Optional sizer for enforcing the memory budget
+    size_t              maxMemory=0;     //<! Maximum memory of all values, 0 for no limit
+    size_t              memory=0;        //<! Current memory of all values
 
   private:
+    size_t GetBucket(const K& key) const
+    {
+      // Fibonacci hashing, spreads sequential keys over the whole table
+      uint64_t hash=std::hash<K>()(key);
+
+      return (size_t)((hash*11400714819323198485ull) >> bucketShift);
+    }
+
+    size_t GetBucketMask() const
+    {
+      return buckets.size()-1;
+    }
 
-    IK KeyToInternalKey(K key)
+    /**
+      Returns the bucket holding the given key or the empty bucket,
+      where the key would be inserted.
+      */
+    size_t FindBucket(const K& key) const
     {
-      return key - std::numeric_limits<K>::min();
+      size_t mask=GetBucketMask();
+      size_t bucket=GetBucket(key);
+
+      while (buckets[bucket]!=emptyBucket &&
+             slots[buckets[bucket]-1].entry.key!=key) {
+        bucket=(bucket+1) & mask;
+      }
+
+      return bucket;
     }
 
     /**
-      Clear the cache deleting the oldest cache entries
-      until it has the given max size.
+      Remove the given bucket from the hash table, shifting following
+      buckets of the same probe sequence backwards.
       */
-    void StripCache()
+    void EraseBucket(size_t bucket)
     {
-      while (size>maxSize) {
-        // Remove oldest entry from cache...
+      size_t mask=GetBucketMask();
+      size_t next=(bucket+1) & mask;
+
+      while (buckets[next]!=emptyBucket) {
+        size_t ideal=GetBucket(slots[buckets[next]-1].entry.key);
+
+        if (((next-ideal) & mask)>=((next-bucket) & mask)) {
+          buckets[bucket]=buckets[next];
+          bucket=next;
+        }
+
+        next=(next+1) & mask;
+      }
+
+      buckets[bucket]=emptyBucket;
+    }
+
+    void Allocate()
+    {
+      slots.clear();
+      slots.reserve(maxSize);
+      freeSlots.clear();
+      buckets.clear();
+      bucketShift=64;
+      hand=0;
+      size=0;
+      memory=0;
+
+      if (maxSize==0) {
+        return;
+      }
+
+      // Keep the load factor of the hash table at or below 50%
+      size_t bucketCount=2;
+      bucketShift=63;
+      while (bucketCount<2*maxSize) {
+        bucketCount*=2;
+        bucketShift--;
+      }
+
+      buckets.resize(bucketCount,emptyBucket);
+    }
+
+    /**
+      Remove the entry in the given slot from the cache
+      */
+    void Evict(size_t slotIndex)
+    {
+      Slot& slot=slots[slotIndex];
+
+      EraseBucket(FindBucket(slot.entry.key));
 
-        // Get oldest entry an dremove it from the map
-        map.erase(map.find(order.back().key));
+      slot.entry.value=V();
+      slot.used=false;
+      slot.stamp=0;
+      memory-=slot.memory;
+      slot.memory=0;
+      size--;
 
-        // Remove it from order list
-        order.pop_back();
+      freeSlots.push_back(slotIndex);
+    }
 
-        previousEntry=order.end();
+    /**
+      Move the CLOCK hand forward until an entry with zero usage count
+      is found and evict it. Usage counts of skipped entries are decremented.
+      The entry in the slot keepSlot is never evicted.
+      */
+    void EvictNext(size_t keepSlot=std::numeric_limits<size_t>::max())
+    {
+      while (true) {
+        if (hand>=slots.size()) {
+          hand=0;
+        }
+
+        Slot& slot=slots[hand];
+
+        if (!slot.used ||
+            hand==keepSlot) {
+          hand++;
+          continue;
+        }
+
+        if (slot.usage>0) {
+          slot.usage--;
+          hand++;
+          continue;
+        }
+
+        Evict(hand++);
+        return;
+      }
+    }
 
-        size--;
+    /**
+      Evict entries until the memory budget is met. The entry in the
+      given slot (usually the just inserted one) is never evicted.
+      */
+    void StripMemory(size_t keepSlot=std::numeric_limits<size_t>::max())
+    {
+      while (maxMemory>0 &&
+             memory>maxMemory &&
+             size>1) {
+        EvictNext(keepSlot);
       }
     }
 
+    size_t GetValueMemory(const V& value) const
+    {
+      return sizer ? sizer->GetSize(value) : 0;
+    }
+
+    bool IsValidReference(size_t slotIndex,
+                          uint64_t stamp) const
+    {
+      if (slotIndex==noSlot) {
+        return stamp==scratchStamp;
+      }
+
+      return slotIndex<slots.size() &&
+             slots[slotIndex].used &&
+             slots[slotIndex].stamp==stamp;
+    }
+
+    CacheRef MakeReference(size_t slotIndex)
+    {
+      Slot& slot=slots[slotIndex];
+
+      return CacheRef(this,
+                      &slot.entry,
+                      slotIndex,
+                      slot.stamp);
+    }
+
   public:
     /**
      Create a new cache object with the given max size.
@@ -140,8 +376,7 @@ namespace osmscout {
     explicit Cache(size_t maxSize)
      : maxSize(maxSize)
     {
-      map.reserve(maxSize);
-      previousEntry=order.end();
+      Allocate();
     }
 
     /**
@@ -159,8 +394,8 @@ namespace osmscout {
       returned and the reference will be untouched.
 
       If there is a value with the given key, reference will return
-      a reference to the value and the value will moved to the
-      front position of the cache to assure FIFO behaviour.
+      a reference to the value and the usage count of the entry is increased,
+      protecting it from eviction.
       */
     bool GetEntry(const K& key,
                   CacheRef& reference)
@@ -169,85 +404,139 @@ namespace osmscout {
         return false;
       }
 
-      // Cached cache access
-      if (previousEntry!=order.end() &&
-          previousEntry->key==key) {
-        reference=previousEntry;
-        return true;
-      }
-
-      typename Map::iterator iter=map.find(key);
-
-      if (iter!=map.end()) {
-        // Move key/value to the start of the order list
-        order.splice(order.begin(),order,iter->second);
+      size_t bucket=FindBucket(key);
 
-        // Update the map with the new iterator into the order list
-        iter->second=order.begin();
+      if (buckets[bucket]==emptyBucket) {
+        return false;
+      }
 
-        reference=order.begin();
-        previousEntry=reference;
+      size_t slotIndex=buckets[bucket]-1;
+      Slot&  slot=slots[slotIndex];
 
-        return true;
+      if (slot.usage<maxUsage) {
+        slot.usage++;
       }
 
-      return false;
+      reference=MakeReference(slotIndex);
+
+      return true;
     }
 
     /**
       Set or update the cache with the given value for the given key.
 
       If the key is not available in the cache the value will be added
-      to the front of the cache (FIFO semantic) else the value will be updated
-      (also moving it to the front of the cache (FIFO again).
+      to the cache, possibly evicting another entry, else the value will be updated.
       */
     typename Cache::CacheRef SetEntry(const CacheEntry& entry)
     {
       if (!IsActive()) {
-        order.clear();
-
-        order.push_front(entry);
+        scratch=entry;
+        scratchStamp=nextStamp++;
 
-        previousEntry=order.begin();
-        return order.begin();
+        return CacheRef(this,
+                        &scratch,
+                        noSlot,
+                        scratchStamp);
       }
 
-      typename Map::iterator iter=map.find(entry.key);
+      size_t bucket=FindBucket(entry.key);
+
+      if (buckets[bucket]!=emptyBucket) {
+        size_t slotIndex=buckets[bucket]-1;
+        Slot&  slot=slots[slotIndex];
+
+        slot.entry.value=entry.value;
+
+        if (slot.usage<maxUsage) {
+          slot.usage++;
+        }
 
-      if (iter!=map.end()) {
-        // Move key/value to the start of the order list
-        order.splice(order.begin(),order,iter->second);
+        if (sizer) {
+          memory-=slot.memory;
+          slot.memory=GetValueMemory(slot.entry.value);
+          memory+=slot.memory;
 
-        // Update the map with the new iterator into the order list
-        iter->second=order.begin();
+          StripMemory(slotIndex);
+        }
 
-        order.front().value=entry.value;
+        return MakeReference(slotIndex);
+      }
+
+      if (size>=maxSize) {
+        EvictNext();
+        // Eviction might have moved the entries of the probe sequence
+        bucket=FindBucket(entry.key);
+      }
+
+      size_t slotIndex;
+
+      if (!freeSlots.empty()) {
+        slotIndex=freeSlots.back();
+        freeSlots.pop_back();
       }
       else {
-        // Place key/value to the start of the order list
-        order.push_front(entry);
-        size++;
-        // Update the map with the new iterator into the order list
-        map[entry.key]=order.begin();
+        assert(slots.size()<maxSize);
+        slotIndex=slots.size();
+        slots.emplace_back();
+      }
+
+      Slot& slot=slots[slotIndex];
+
+      slot.entry=entry;
+      slot.usage=1;
+      slot.used=true;
+      slot.stamp=nextStamp++;
+      slot.memory=GetValueMemory(slot.entry.value);
 
-        StripCache();
+      memory+=slot.memory;
+      size++;
+
+      buckets[bucket]=slotIndex+1;
+
+      if (sizer) {
+        StripMemory(slotIndex);
       }
 
-      previousEntry=order.begin();
-      return order.begin();
+      return MakeReference(slotIndex);
     }
 
     /**
-      Set a new cache max size, possible striping the oldest entries
-      from cache if the new size is smaller than the old one.
+      Set a new cache max size, possible striping entries from the cache if
+      the new size is smaller than the old one. Usage counts of the kept
+      entries are preserved.
+
+      All references into the cache get invalid.
       */
     void SetMaxSize(size_t maxSize)
     {
+      std::vector<std::pair<CacheEntry,uint8_t>> entries;
+
+      // Keep entries with the highest usage, if the cache shrinks
+      for (uint8_t usage=maxUsage+1; usage>0; usage--) {
+        for (const auto& slot : slots) {
+          if (slot.used &&
+              slot.usage==usage-1 &&
+              entries.size()<maxSize) {
+            entries.emplace_back(slot.entry,slot.usage);
+          }
+        }
+      }
+
       this->maxSize=maxSize;
 
-      StripCache();
+      Allocate();
+
+      for (const auto& [entry,usage] : entries) {
+        SetEntry(entry);
 
-      map.reserve(maxSize);
+        size_t bucket=FindBucket(entry.key);
+
+        // The entry might have been evicted again, because of the memory budget
+        if (buckets[bucket]!=emptyBucket) {
+          slots[buckets[bucket]-1].usage=usage;
+        }
+      }
     }
 
     /**
@@ -258,15 +547,42 @@ namespace osmscout {
       return maxSize;
     }
 
+    /**
+      Limit the cache by the memory of its values as returned by the given
+      sizer. The memory of a value is calculated, when the value is passed
+      to SetEntry(). Changes to a value via a cache reference are not accounted.
+
+      Passing 0 as maxMemory disables the memory limit.
+      */
+    void SetMemoryBudget(const ValueSizerRef& sizer,
+                         size_t maxMemory)
+    {
+      this->sizer=sizer;
+      this->maxMemory=maxMemory;
+
+      memory=0;
+      for (auto& slot : slots) {
+        slot.memory=slot.used ? GetValueMemory(slot.entry.value) : 0;
+        memory+=slot.memory;
+      }
+
+      StripMemory();
+    }
+
+    /**
+     * Returns the memory budget of the cache, 0 if there is no limit
+     */
+    size_t GetMemoryBudget() const
+    {
+      return maxMemory;
+    }
+
     /**
       Completely flush the cache removing all entries from it.
       */
     void Flush()
     {
-      order.clear();
-      map.clear();
-      size=0;
-      previousEntry=order.end();
+      Allocate();
     }
 
     /**
@@ -281,16 +597,16 @@ namespace osmscout {
     {
       size_t memory=0;
 
-      // Size of map
-      memory+=map.size()*sizeof(CacheRef);
+      // Size of hash table
+      memory+=buckets.size()*sizeof(size_t);
 
-      // Size of list
-      memory+=size*sizeof(CacheEntry);
+      // Size of slots
+      memory+=slots.capacity()*sizeof(Slot);
 
-      for (typename std::list<CacheEntry>::const_iterator entry=order.begin();
-           entry!=order.end();
-           ++entry) {
-        memory+=sizer.GetSize(entry->value);
+      for (const auto& slot : slots) {
+        if (slot.used) {
+          memory+=sizer.GetSize(slot.entry.value);
+        }
       }
 
       return memory;
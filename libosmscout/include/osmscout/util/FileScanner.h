@@ -61,6 +61,8 @@ namespace osmscout {
     */
   class OSMSCOUT_API FileScanner CLASS_FINAL
   {
+    friend class MemoryScanner;
+
   public:
     enum Mode
     {
@@ -77,6 +79,7 @@ namespace osmscout {
 
     // For mmap usage
     char         *mmap=nullptr;       //!< Pointer to the file memory
+    bool         sharedMmap=false;    //!< The file memory is owned by another FileScanner
     FileOffset   size=0;              //!< Size of the memory/file
     FileOffset   offset=0;            //!< Current offset into the file memory
 
@@ -188,6 +191,8 @@ namespace osmscout {
     void Open(const std::string& filename,
               Mode mode,
               bool useMmap);
+    void Open(const FileScanner& mappedScanner,
+              Mode mode);
     void Close();
     void CloseFailsafe();
 
@@ -209,6 +214,9 @@ namespace osmscout {
     void SetPos(FileOffset pos);
     FileOffset GetPos() const;
 
+    void Prefetch(FileOffset start,
+                  FileOffset length);
+
     void Read(char* buffer, size_t bytes);
 
     std::string ReadString();
@@ -60,6 +60,9 @@ namespace osmscout {
     void GetMaxValue(double& vmUsage,
                      double& residentSet);
 
+    static void GetCurrentValue(double& vmUsage,
+                                double& residentSet);
+
     void Reset();
   };
 
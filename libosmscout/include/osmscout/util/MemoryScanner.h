@@ -0,0 +1,444 @@
+#ifndef OSMSCOUT_MEMORYSCANNER_H
+#define OSMSCOUT_MEMORYSCANNER_H
+
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2026  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+#include <osmscout/system/Assert.h>
+
+#include <osmscout/GeoCoord.h>
+#include <osmscout/OSMScoutTypes.h>
+#include <osmscout/Point.h>
+
+#include <osmscout/util/Exception.h>
+#include <osmscout/util/FileScanner.h>
+#include <osmscout/util/GeoBox.h>
+#include <osmscout/util/Geometry.h>
+
+namespace osmscout {
+
+  /**
+    \ingroup File
+
+    MemoryScanner decodes data directly from the memory of a memory mapped
+    FileScanner using a simple cursor. All methods are inline and there is no
+    check for file errors or fallback to buffered IO on each call.
+
+    Reading of variable length numbers is only bounds checked per byte, if the
+    cursor is near the end of the file. Coordinate arrays are bounds checked
+    once for the complete array.
+
+    MemoryScanner implements the subset of the FileScanner interface needed for
+    reading data objects (see Node::Read(), Way::Read(), Area::Read()). Data
+    that can only be read via FileScanner (like feature values) can be read
+    via ReadVia(), which temporarily synchronizes the position of the
+    underlying FileScanner.
+
+    The position of the underlying FileScanner is updated on destruction.
+
+    A detached MemoryScanner (see MemoryScanner(const FileScanner&,FileOffset))
+    does not touch the position or error state of the FileScanner at all, so
+    multiple threads can read from the same FileScanner in parallel, each
+    using its own detached MemoryScanner.
+    */
+  class MemoryScanner CLASS_FINAL
+  {
+  private:
+    const FileScanner&   scanner;     //!< Underlying memory mapped FileScanner
+    FileScanner*         syncScanner; //!< FileScanner to synchronize position and error state with, nullptr if detached
+    const unsigned char* begin;       //!< Start of the file memory
+    const unsigned char* current;     //!< Current position in the file memory
+    const unsigned char* end;         //!< End of the file memory
+
+  private:
+    void MarkError() const
+    {
+      if (syncScanner!=nullptr) {
+        syncScanner->hasError=true;
+      }
+    }
+
+    [[noreturn]] void ThrowEndOfFile(const std::string& action) const
+    {
+      MarkError();
+      throw IOException(scanner.GetFilename(),action,"Cannot read beyond end of file");
+    }
+
+    void AssureAvailable(size_t bytes,
+                         const char* action) const
+    {
+      if ((size_t)(end-current)<bytes) {
+        ThrowEndOfFile(action);
+      }
+    }
+
+    [[noreturn]] void ThrowNumberTooLong(const std::string& action) const
+    {
+      MarkError();
+      throw IOException(scanner.GetFilename(),action,"Encoded number exceeds the size of its type");
+    }
+
+    template<typename N>
+    N ReadNumber(const char* action)
+    {
+      // Maximum number of bytes of an encoded number of type N, 5 for 32 bit and 10 for 64 bit
+      constexpr size_t maxBytes=(sizeof(N)*8+6)/7;
+
+      N            number=0;
+      unsigned int shift=0;
+
+      // Fast path: no bounds check, if the longest encoding of N fits
+      if ((size_t)(end-current)>=maxBytes) {
+        for (size_t i=0; i<maxBytes; i++) {
+          unsigned char byte=*current++;
+
+          number|=static_cast<N>(byte & 0x7fu) << shift;
+
+          if ((byte & 0x80u)==0) {
+            return number;
+          }
+
+          shift+=7;
+        }
+
+        ThrowNumberTooLong(action);
+      }
+
+      for (size_t i=0; i<maxBytes && current<end; i++) {
+        unsigned char byte=*current++;
+
+        number|=static_cast<N>(byte & 0x7fu) << shift;
+
+        if ((byte & 0x80u)==0) {
+          return number;
+        }
+
+        shift+=7;
+      }
+
+      if (shift>=sizeof(N)*8) {
+        ThrowNumberTooLong(action);
+      }
+
+      ThrowEndOfFile(action);
+    }
+
+    GeoCoord CreateCoord(uint32_t latDat,
+                         uint32_t lonDat) const
+    {
+#ifndef NDEBUG
+      if (latDat > maxRawCoordValue ||
+          lonDat > maxRawCoordValue){
+        MarkError();
+        throw IOException(scanner.GetFilename(),"Cannot read coordinate","Coordinate is not normalised");
+      }
+#endif
+
+      return {latDat/latConversionFactor-90.0,
+              lonDat/lonConversionFactor-180.0};
+    }
+
+    static int32_t SignExtend16(uint32_t value)
+    {
+      return (int32_t)((value & 0x8000u)!=0 ? (value | 0xffff0000u) : value);
+    }
+
+    static int32_t SignExtend24(uint32_t value)
+    {
+      return (int32_t)((value & 0x800000u)!=0 ? (value | 0xff000000u) : value);
+    }
+
+  public:
+    /**
+     * Returns true, if the given scanner can be read via a MemoryScanner
+     */
+    static bool CanScan(const FileScanner& scanner)
+    {
+      return scanner.IsOpen() &&
+             !scanner.HasError() &&
+             scanner.mmap!=nullptr;
+    }
+
+    /**
+     * Create a MemoryScanner starting at the current position of the given
+     * FileScanner. CanScan() must be true for the scanner.
+     */
+    explicit MemoryScanner(FileScanner& scanner)
+    : scanner(scanner),
+      syncScanner(&scanner),
+      begin((const unsigned char*)scanner.mmap),
+      current(begin+scanner.offset),
+      end(begin+scanner.size)
+    {
+      assert(CanScan(scanner));
+    }
+
+    /**
+     * Create a detached MemoryScanner starting at the given offset. CanScan() must
+     * be true for the scanner.
+     *
+     * @throws IOException if the offset is beyond the end of the file
+     */
+    MemoryScanner(const FileScanner& scanner,
+                  FileOffset offset)
+    : scanner(scanner),
+      syncScanner(nullptr),
+      begin((const unsigned char*)scanner.mmap),
+      current(begin),
+      end(begin+scanner.size)
+    {
+      // Only the mapping is checked, the error state of the scanner may be changed
+      // concurrently by other threads and is not used by detached scanners
+      assert(scanner.mmap!=nullptr);
+
+      SetPos(offset);
+    }
+
+    MemoryScanner(const MemoryScanner&) = delete;
+    MemoryScanner(MemoryScanner&&) = delete;
+    MemoryScanner& operator=(const MemoryScanner&) = delete;
+    MemoryScanner& operator=(MemoryScanner&&) = delete;
+
+    ~MemoryScanner()
+    {
+      if (syncScanner!=nullptr) {
+        syncScanner->offset=(FileOffset)(current-begin);
+      }
+    }
+
+    FileOffset GetPos() const
+    {
+      return (FileOffset)(current-begin);
+    }
+
+    void SetPos(FileOffset pos)
+    {
+      if (pos>=(FileOffset)(end-begin)) {
+        MarkError();
+        throw IOException(scanner.GetFilename(),"Cannot set position in file to "+std::to_string(pos),"Position beyond file end");
+      }
+
+      current=begin+pos;
+    }
+
+    /**
+     * Read data via the FileScanner based Read(FileScanner&) method of the given object.
+     * Not supported by detached MemoryScanners.
+     */
+    template<typename R>
+    void ReadVia(R& readable)
+    {
+      assert(syncScanner!=nullptr);
+
+      syncScanner->offset=GetPos();
+      readable.Read(*syncScanner);
+      current=begin+syncScanner->offset;
+    }
+
+    uint8_t ReadUInt8()
+    {
+      AssureAvailable(1,"Cannot read uint8_t");
+
+      return *current++;
+    }
+
+    uint32_t ReadUInt32Number()
+    {
+      return ReadNumber<uint32_t>("Cannot read uint32_t number");
+    }
+
+    uint64_t ReadUInt64Number()
+    {
+      return ReadNumber<uint64_t>("Cannot read uint64_t number");
+    }
+
+    TypeId ReadTypeId(uint8_t maxBytes)
+    {
+      assert(maxBytes==1 || maxBytes==2);
+
+      AssureAvailable(maxBytes,"Cannot read type id");
+
+      if (maxBytes==1) {
+        return *current++;
+      }
+
+      TypeId id=current[0]*256+current[1];
+
+      current+=2;
+
+      return id;
+    }
+
+    GeoCoord ReadCoord()
+    {
+      AssureAvailable(coordByteSize,"Cannot read coordinate");
+
+      const unsigned char* dataPtr=current;
+
+      uint32_t latDat=  (dataPtr[0] <<  0)
+                      | (dataPtr[1] <<  8)
+                      | (dataPtr[2] << 16)
+                      | ((dataPtr[6] & 0x0fu) << 24);
+
+      uint32_t lonDat=  (dataPtr[3] <<  0)
+                      | (dataPtr[4] <<  8)
+                      | (dataPtr[5] << 16)
+                      | ((dataPtr[6] & 0xf0u) << 20);
+
+      current+=coordByteSize;
+
+      return CreateCoord(latDat,lonDat);
+    }
+
+    /**
+     * Reads vector of Point and pre-compute segments and bounding box for it.
+     * Format is identical to FileScanner::Read(std::vector<Point>&,...).
+     */
+    void Read(std::vector<Point>& nodes,
+              std::vector<SegmentGeoBox>& segments,
+              GeoBox& bbox,
+              bool readIds)
+    {
+      uint8_t sizeByte=ReadUInt8();
+
+      // Fast exit for empty arrays
+      if (sizeByte==0) {
+        return;
+      }
+
+      size_t coordBitSize;
+
+      if ((sizeByte & 0x03u) == 0) {
+        coordBitSize=16;
+      }
+      else if ((sizeByte & 0x03u) == 1) {
+        coordBitSize=32;
+      }
+      else {
+        coordBitSize=48;
+      }
+
+      bool   hasNodes=readIds && (sizeByte & 0x04u)!=0;
+      size_t nodeCount;
+      size_t shift;
+
+      if (readIds) {
+        nodeCount=(sizeByte & 0x78u) >> 3;
+        shift=4;
+      }
+      else {
+        nodeCount=(sizeByte & 0x7cu) >> 2;
+        shift=5;
+      }
+
+      for (size_t i=0; i<3 && (sizeByte & 0x80u)!=0; i++) {
+        sizeByte=ReadUInt8();
+
+        // The last byte contributes all 8 bits
+        nodeCount|=(size_t)(i<2 ? (sizeByte & 0x7fu) : sizeByte) << shift;
+        shift+=7;
+      }
+
+      size_t byteBufferSize=(nodeCount-1)*coordBitSize/8;
+
+      // One bounds check for the complete coordinate array
+      AssureAvailable(coordByteSize+byteBufferSize,"Cannot read coordinates");
+
+      nodes.resize(nodeCount);
+
+      GeoCoord firstCoord=ReadCoord();
+
+      auto latValue=(uint32_t)round((firstCoord.GetLat()+90.0)*latConversionFactor);
+      auto lonValue=(uint32_t)round((firstCoord.GetLon()+180.0)*lonConversionFactor);
+
+      nodes[0].SetCoord(firstCoord);
+
+      const unsigned char* buffer=current;
+      Point*               node=nodes.data()+1;
+
+      if (coordBitSize==16) {
+        for (size_t i=0; i<byteBufferSize; i+=2) {
+          latValue+=(int8_t)buffer[i];
+          lonValue+=(int8_t)buffer[i+1];
+
+          (node++)->SetCoord(CreateCoord(latValue,lonValue));
+        }
+      }
+      else if (coordBitSize==32) {
+        for (size_t i=0; i<byteBufferSize; i+=4) {
+          latValue+=SignExtend16(buffer[i+0] | (buffer[i+1] << 8));
+          lonValue+=SignExtend16(buffer[i+2] | (buffer[i+3] << 8));
+
+          (node++)->SetCoord(CreateCoord(latValue,lonValue));
+        }
+      }
+      else {
+        for (size_t i=0; i<byteBufferSize; i+=6) {
+          latValue+=SignExtend24(buffer[i+0] | (buffer[i+1] << 8) | (buffer[i+2] << 16));
+          lonValue+=SignExtend24(buffer[i+3] | (buffer[i+4] << 8) | (buffer[i+5] << 16));
+
+          (node++)->SetCoord(CreateCoord(latValue,lonValue));
+        }
+      }
+
+      current+=byteBufferSize;
+
+      GetBoundingBox(nodes, bbox);
+
+      // we will prepare segment bounding boxes just for long point vectors
+      if (nodeCount > 1024) {
+        size_t segmentCount = ((nodeCount - 1) / 1024) + 1;
+        segments.reserve(segmentCount);
+        Point *pd = nodes.data();
+        for (size_t i = 0; i < segmentCount; i++) {
+          SegmentGeoBox s;
+          s.from = i * 1024;
+          s.to = std::min(nodeCount, s.from + 1024); // exclusive
+          GetBoundingBox(pd+s.from, pd+s.to, s.bbox);
+          segments.emplace_back(std::move(s));
+        }
+      }
+
+      if (hasNodes) {
+        size_t idCurrent=0;
+
+        while (idCurrent<nodeCount) {
+          uint8_t bitset=ReadUInt8();
+          size_t  bitmask=1;
+
+          for (size_t i=0; i<8 && idCurrent<nodeCount; i++) {
+            if ((bitset & bitmask)!=0) {
+              nodes[idCurrent].SetSerial(ReadUInt8());
+            }
+
+            bitmask*=2;
+            idCurrent++;
+          }
+        }
+      }
+    }
+  };
+}
+
+#endif
@@ -0,0 +1,147 @@
+#ifndef OSMSCOUT_UTIL_OBJECTARENA_H
+#define OSMSCOUT_UTIL_OBJECTARENA_H
+
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2026  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <osmscout/CoreImportExport.h>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include <osmscout/system/Compiler.h>
+
+namespace osmscout {
+
+  /**
+   * \ingroup Util
+   *
+   * Region of memory for objects with a common lifetime (for example all objects
+   * loaded for one tile). Memory is handed out by increasing a pointer in the
+   * current chunk and is never freed individually. All chunks are released at
+   * once, if the arena is destroyed.
+   *
+   * Allocation is thread-safe.
+   */
+  class OSMSCOUT_API ObjectArena CLASS_FINAL
+  {
+  public:
+    static constexpr size_t defaultChunkSize=64*1024;
+
+  private:
+    mutable std::mutex                   mutex;
+    std::vector<std::unique_ptr<char[]>> chunks;
+    size_t                               chunkSize;
+    char*                                current=nullptr;   //!< Next free byte in the current chunk
+    size_t                               available=0;       //!< Free bytes in the current chunk
+    size_t                               memory=0;          //!< Sum of the size of all chunks
+
+  public:
+    explicit ObjectArena(size_t chunkSize=defaultChunkSize);
+
+    // disable copy and move
+    ObjectArena(const ObjectArena&) = delete;
+    ObjectArena(ObjectArena&&) = delete;
+    ObjectArena& operator=(const ObjectArena&) = delete;
+    ObjectArena& operator=(ObjectArena&&) = delete;
+
+    void* Allocate(size_t size,
+                   size_t alignment);
+
+    size_t GetMemory() const;
+  };
+
+  using ObjectArenaRef = std::shared_ptr<ObjectArena>;
+
+  /**
+   * \ingroup Util
+   *
+   * Standard allocator handing out memory of an ObjectArena. Deallocation
+   * is a no-op. Each allocator holds a reference to the arena, so that the arena
+   * stays alive as long as there are containers or shared pointers (created using
+   * std::allocate_shared()) referencing memory of it.
+   */
+  template<typename T>
+  class ArenaAllocator
+  {
+  private:
+    ObjectArenaRef arena;
+
+    template<typename U>
+    friend class ArenaAllocator;
+
+  public:
+    using value_type = T;
+
+    explicit ArenaAllocator(const ObjectArenaRef& arena)
+    : arena(arena)
+    {
+      // no code
+    }
+
+    template<typename U>
+    ArenaAllocator(const ArenaAllocator<U>& other) // NOLINT(google-explicit-constructor)
+    : arena(other.arena)
+    {
+      // no code
+    }
+
+    T* allocate(size_t n)
+    {
+      return static_cast<T*>(arena->Allocate(n*sizeof(T),
+                                              alignof(T)));
+    }
+
+    void deallocate(T* /*p*/,
+                    size_t /*n*/) noexcept
+    {
+      // no code, memory is released with the arena
+    }
+
+    template<typename U>
+    bool operator==(const ArenaAllocator<U>& other) const
+    {
+      return arena==other.arena;
+    }
+
+    template<typename U>
+    bool operator!=(const ArenaAllocator<U>& other) const
+    {
+      return arena!=other.arena;
+    }
+  };
+
+  /**
+   * Create a new object, either on the heap (if no arena is given) or
+   * in the given arena.
+   */
+  template<typename T>
+  std::shared_ptr<T> MakeShared(const ObjectArenaRef& arena)
+  {
+    if (arena) {
+      return std::allocate_shared<T>(ArenaAllocator<T>(arena));
+    }
+
+    return std::make_shared<T>();
+  }
+}
+
+#endif
@@ -25,6 +25,7 @@
 #include <vector>
 #include <memory>
 #include <mutex>
+#include <condition_variable>
 #include <functional>
 
 namespace osmscout {
@@ -34,15 +35,26 @@ namespace osmscout {
   private:
     std::vector<T*> pool;
     size_t maxSize;
+    size_t borrowedCount=0; //!< Number of objects currently borrowed
+    bool closed=false;      //!< Pool is closed, Borrow() fails
     std::mutex mutex;
+    std::condition_variable returnedCondition;
 
   private:
     void Return(T* o){
-      std::scoped_lock<std::mutex> guard(mutex);
-      if (!IsValid(o) || pool.size()==maxSize){
+      bool valid=IsValid(o);
+      {
+        std::scoped_lock<std::mutex> guard(mutex);
+        borrowedCount--;
+        if (valid && !closed && pool.size()<maxSize) {
+          pool.push_back(o);
+          o=nullptr;
+        }
+      }
+      returnedCondition.notify_all();
+      if (o!=nullptr) {
+        // destroy outside of the lock, it may be expensive (like closing a file)
         Destroy(o);
-      } else {
-        pool.push_back(o);
       }
     }
 
@@ -77,14 +89,28 @@ namespace osmscout {
 
     virtual Ptr Borrow()
     {
-      std::scoped_lock<std::mutex> guard(mutex);
-      T* o;
-      if (!pool.empty()){
-        o=pool.back();
-        pool.pop_back();
-      } else {
+      T* o=nullptr;
+      {
+        std::scoped_lock<std::mutex> guard(mutex);
+        if (closed){
+          return std::unique_ptr<T>(nullptr);
+        }
+        if (!pool.empty()){
+          o=pool.back();
+          pool.pop_back();
+        }
+        borrowedCount++;
+      }
+      if (o == nullptr){
+        // create outside of the lock, it may be expensive (like opening a file)
+        // and should not block other threads borrowing pooled objects
         o=MakeNew();
         if (o == nullptr){
+          {
+            std::scoped_lock<std::mutex> guard(mutex);
+            borrowedCount--;
+          }
+          returnedCondition.notify_all();
           return std::unique_ptr<T>(nullptr);
         }
       }
@@ -97,6 +123,36 @@ namespace osmscout {
       return pool.size();
     }
 
+    /**
+     * Reopen a pool closed by Close(), so that objects can be borrowed again.
+     */
+    void Open()
+    {
+      std::scoped_lock<std::mutex> guard(mutex);
+      closed=false;
+    }
+
+    /**
+     * Close the pool. Following calls to Borrow() fail. Waits until all
+     * borrowed objects are returned and destroys all objects of the pool
+     * afterwards.
+     *
+     * Must not be called by a thread still holding a borrowed object.
+     */
+    void Close()
+    {
+      std::vector<T*> objects;
+      {
+        std::unique_lock<std::mutex> guard(mutex);
+        closed=true;
+        returnedCondition.wait(guard,[this]{ return borrowedCount==0; });
+        objects.swap(pool);
+      }
+      for (T* o:objects){
+        Destroy(o);
+      }
+    }
+
     void Clear()
     {
       std::scoped_lock<std::mutex> guard(mutex);
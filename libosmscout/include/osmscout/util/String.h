@@ -477,6 +477,19 @@ namespace osmscout {
    */
   extern OSMSCOUT_API std::string UTF8StringToUpper(const std::string& text);
 
+  /**
+   * Same as UTF8StringToUpper(const std::string&), but writes the converted text
+   * into the given result, reusing its memory. Use it for converting many strings
+   * without allocating memory for each of them.
+   *
+   * @param text
+   *    Text to get converted
+   * @param result
+   *    Converted text
+   */
+  extern OSMSCOUT_API void UTF8StringToUpper(const std::string& text,
+                                             std::string& result);
+
   /**
    * Convert the given std::string containing a UTF8 character sequence to lower case using
    * the translation table implementation.
@@ -518,6 +531,18 @@ namespace osmscout {
    */
   extern OSMSCOUT_API std::string UTF8Transliterate(const std::string& text);
 
+  /**
+   * Same as UTF8Transliterate(const std::string&), but writes the converted text
+   * into the given result, reusing its memory.
+   *
+   * @param text
+   *    Text to get converted
+   * @param result
+   *    Converted text
+   */
+  extern OSMSCOUT_API void UTF8Transliterate(const std::string& text,
+                                             std::string& result);
+
   /**
    * Parse time string in ISO 8601 format "2017-11-26T13:46:12.124Z" (UTC timezone)
    * to Timestamp (std::chrono::time_point with millisecond accuracy).
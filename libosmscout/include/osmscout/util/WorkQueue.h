@@ -42,6 +42,7 @@ namespace osmscout {
     std::condition_variable pushCondition;
     std::condition_variable popCondition;
     std::deque<Task>        tasks;
+    std::deque<Task>        lowPriorityTasks;
     size_t                  queueLimit=std::numeric_limits<size_t>::max();
     bool                    running=true;
 
@@ -52,6 +53,7 @@ namespace osmscout {
     ~WorkQueue();
 
     void PushTask(Task& task);
+    void PushLowPriorityTask(Task& task);
     bool PopTask(Task& task);
 
     void Stop();
@@ -82,22 +84,44 @@ namespace osmscout {
     popCondition.notify_one();
   }
 
+  /**
+   * Push a task, that is only popped if there are no other tasks queued
+   */
+  template<class R>
+  void WorkQueue<R>::PushLowPriorityTask(Task& task)
+  {
+    std::unique_lock lock(mutex);
+
+    pushCondition.wait(lock,[this]{return lowPriorityTasks.size()<=queueLimit;});
+
+    lowPriorityTasks.push_back(std::move(task));
+
+    popCondition.notify_one();
+  }
+
   template<class R>
   bool WorkQueue<R>::PopTask(Task& task)
   {
     std::unique_lock lock(mutex);
 
-    popCondition.wait(lock,[this]{return !tasks.empty() || !running;});
+    popCondition.wait(lock,[this]{return !tasks.empty() || !lowPriorityTasks.empty() || !running;});
 
     if (tasks.empty() &&
+        lowPriorityTasks.empty() &&
         !running) {
       return false;
     }
 
-    task=std::move(tasks.front());
-    tasks.pop_front();
+    if (!tasks.empty()) {
+      task=std::move(tasks.front());
+      tasks.pop_front();
+    }
+    else {
+      task=std::move(lowPriorityTasks.front());
+      lowPriorityTasks.pop_front();
+    }
 
-    pushCondition.notify_one();
+    pushCondition.notify_all();
 
     return true;
   }
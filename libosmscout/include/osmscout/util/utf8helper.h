@@ -55,6 +55,13 @@ extern codepoint TransformCapitalize(const character*, int);
 extern codepoint TransformNormalize(const character*, int);
 extern codepoint TransformTransliterate(const character*, int);
 
+/**
+ * @brief Transform the text into the given result string, reusing its memory.
+ * Produces the same result as UTF8String(text, func).ToStdString(), but without
+ * allocating memory, if the result string is large enough.
+ */
+extern void UTF8Transform(const std::string& text, Transform func, std::string& result);
+
 /**
  * @brief Parse and transform an UTF8 string
  *
@@ -19,6 +19,7 @@
 
 #include <osmscout/Area.h>
 
+#include <osmscout/util/MemoryScanner.h>
 #include <osmscout/util/String.h>
 
 #include <osmscout/system/Math.h>
@@ -216,8 +217,9 @@ namespace osmscout {
    *
    * @throws IOException
    */
+  template<typename S>
   void Area::Read(const TypeConfig& typeConfig,
-                  FileScanner& scanner)
+                  S& scanner)
   {
     TypeId             ringType;
     bool               multipleRings;
@@ -290,6 +292,16 @@ namespace osmscout {
     nextFileOffset=scanner.GetPos();
   }
 
+  template OSMSCOUT_API void Area::Read<MemoryScanner>(const TypeConfig& typeConfig,
+                                                       MemoryScanner& scanner);
+
+  void Area::Read(const TypeConfig& typeConfig,
+                  FileScanner& scanner)
+  {
+    Read<FileScanner>(typeConfig,
+                      scanner);
+  }
+
   /**
    * Reads data from the given FileScanner. All data available will be read.
    *
@@ -325,7 +337,7 @@ namespace osmscout {
     rings.clear();
     rings.resize(ringCount);
 
-    rings[0].featureValueBuffer=featureValueBuffer;
+    rings[0].featureValueBuffer=std::move(featureValueBuffer);
 
     if (hasMaster) {
       rings[0].MarkAsMasterRing();
@@ -398,7 +410,7 @@ namespace osmscout {
     rings.clear();
     rings.resize(ringCount);
 
-    rings[0].featureValueBuffer=featureValueBuffer;
+    rings[0].featureValueBuffer=std::move(featureValueBuffer);
 
     if (hasMaster) {
       rings[0].MarkAsMasterRing();
@@ -20,9 +20,14 @@
 #include <osmscout/AreaAreaIndex.h>
 
 #include <algorithm>
+#include <atomic>
+#include <future>
+#include <limits>
+#include <thread>
 
 #include <osmscout/util/File.h>
 #include <osmscout/util/Logger.h>
+#include <osmscout/util/MemoryScanner.h>
 #include <osmscout/util/StopClock.h>
 
 #include <osmscout/system/Math.h>
@@ -33,10 +38,96 @@ namespace osmscout {
 
   const char* const AreaAreaIndex::AREA_AREA_IDX="areaarea.idx";
 
+  /**
+   * Number of helper threads currently expanding index levels, shared by all
+   * AreaAreaIndex instances and queries. Limits the number of additional
+   * threads to the number of cores, even if many queries run in parallel.
+   */
+  static std::atomic<size_t> activeHelperThreads(0);
+
+  /**
+   * Reservation of up to the requested number of helper threads from the global budget
+   * (possibly none). The threads are returned to the budget on destruction.
+   */
+  class HelperThreadReservation CLASS_FINAL
+  {
+  private:
+    size_t count=0;
+
+  public:
+    explicit HelperThreadReservation(size_t requested)
+    {
+      size_t maxHelperThreads=std::max(1u,std::thread::hardware_concurrency())-1;
+      size_t active=activeHelperThreads.load();
+
+      do {
+        if (active>=maxHelperThreads) {
+          count=0;
+          return;
+        }
+
+        count=std::min(requested,maxHelperThreads-active);
+      } while (!activeHelperThreads.compare_exchange_weak(active,active+count));
+    }
+
+    HelperThreadReservation(const HelperThreadReservation&) = delete;
+    HelperThreadReservation& operator=(const HelperThreadReservation&) = delete;
+
+    ~HelperThreadReservation()
+    {
+      activeHelperThreads-=count;
+    }
+
+    size_t GetCount() const
+    {
+      return count;
+    }
+  };
+
+  /**
+   * Read the index cell data (the areas by type) at the current position of the scanner
+   * and append spans for all requested types.
+   */
+  template<typename S>
+  static void ReadCellSpans(const TypeConfig& typeConfig,
+                            const TypeInfoSet& types,
+                            S& scanner,
+                            std::vector<DataBlockSpan>& spans)
+  {
+    uint32_t   typeCount=scanner.ReadUInt32Number();
+    FileOffset prevDataFileOffset=0;
+
+    for (uint32_t t=0; t<typeCount; t++) {
+      TypeId     typeId=scanner.ReadTypeId(typeConfig.GetAreaTypeIdBytes());
+      uint32_t   dataCount=scanner.ReadUInt32Number();
+      FileOffset dataFileOffset=scanner.ReadUInt64Number();
+
+      dataFileOffset+=prevDataFileOffset;
+      prevDataFileOffset=dataFileOffset;
+
+      if (dataFileOffset==0) {
+        continue;
+      }
+
+      TypeInfoRef type=typeConfig.GetAreaTypeInfo(typeId);
+
+      if (types.IsSet(type)) {
+        DataBlockSpan span;
+
+        span.startOffset=dataFileOffset;
+        span.count=dataCount;
+
+        spans.push_back(span);
+      }
+    }
+  }
+
   AreaAreaIndex::AreaAreaIndex(size_t cacheSize)
   : maxLevel(0),
     topLevelOffset(0),
-    indexCache(cacheSize)
+    indexCache(cacheSize),
+    parallelCellThreshold(std::thread::hardware_concurrency()>1 ? defaultParallelCellThreshold
+                                                                : std::numeric_limits<size_t>::max())
   {
     // no code
   }
@@ -49,6 +140,7 @@ namespace osmscout {
   void AreaAreaIndex::Close()
   {
     indexCache.Flush();
+    memoryMapped=false;
     try {
       if (scanner.IsOpen()) {
         scanner.Close();
@@ -124,32 +216,10 @@ namespace osmscout {
 
     scanner.SetPos(dataOffset);
 
-    uint32_t   typeCount=scanner.ReadUInt32Number();
-    FileOffset prevDataFileOffset=0;
-
-    for (uint32_t t=0; t<typeCount; t++) {
-      TypeId     typeId=scanner.ReadTypeId(typeConfig.GetAreaTypeIdBytes());
-      uint32_t   dataCount=scanner.ReadUInt32Number();
-      FileOffset dataFileOffset=scanner.ReadUInt64Number();
-
-      dataFileOffset+=prevDataFileOffset;
-      prevDataFileOffset=dataFileOffset;
-
-      if (dataFileOffset==0) {
-        continue;
-      }
-
-      TypeInfoRef type=typeConfig.GetAreaTypeInfo(typeId);
-
-      if (types.IsSet(type)) {
-        DataBlockSpan span;
-
-        span.startOffset=dataFileOffset;
-        span.count=dataCount;
-
-        spans.push_back(span);
-      }
-    }
+    ReadCellSpans(typeConfig,
+                  types,
+                  scanner,
+                  spans);
 
     return true;
   }
@@ -217,6 +287,142 @@ namespace osmscout {
     }
   }
 
+  /**
+   * Expand the given range of cells of the given level. Cells are read directly from the
+   * memory mapped index file using a detached MemoryScanner, bypassing the index cache,
+   * so this method can be called by multiple threads in parallel.
+   *
+   * @throws IOException
+   */
+  void AreaAreaIndex::ExpandCells(const TypeConfig& typeConfig,
+                                  const TypeInfoSet& types,
+                                  uint32_t level,
+                                  double minlon,
+                                  double minlat,
+                                  double maxlon,
+                                  double maxlat,
+                                  std::vector<CellRef>::const_iterator begin,
+                                  std::vector<CellRef>::const_iterator end,
+                                  LevelResult& result) const
+  {
+    for (auto cellRef=begin; cellRef!=end; ++cellRef) {
+      MemoryScanner cellScanner(scanner,
+                                cellRef->offset);
+      IndexCell     cellIndexData;
+
+      if (level<this->maxLevel) {
+        for (FileOffset& c : cellIndexData.children) {
+          FileOffset childOffset=cellScanner.ReadUInt64Number();
+
+          if (childOffset==0) {
+            c=0;
+          }
+          else {
+            c=cellRef->offset-childOffset;
+          }
+        }
+      }
+      else {
+        cellIndexData.children.fill(0);
+      }
+
+      ReadCellSpans(typeConfig,
+                    types,
+                    cellScanner,
+                    result.spans);
+
+      if (level<this->maxLevel) {
+        PushCellsForNextLevel(minlon,
+                              minlat,
+                              maxlon,
+                              maxlat,
+                              cellIndexData,
+                              cellDimension[level+1],
+                              cellRef->x*2,
+                              cellRef->y*2,
+                              result.nextCellRefs);
+      }
+    }
+  }
+
+  /**
+   * Expand all cells of the given level by splitting them into ranges, which are expanded
+   * in parallel. Results are appended in the order of the cells, so the result is identical
+   * to the sequential expansion.
+   *
+   * The number of helper threads is limited by a budget shared by all queries, so parallel
+   * queries do not oversubscribe the CPU. If the budget is exhausted the calling thread
+   * expands all cells on its own.
+   *
+   * @throws IOException
+   */
+  void AreaAreaIndex::ExpandLevelParallel(const TypeConfig& typeConfig,
+                                          const TypeInfoSet& types,
+                                          uint32_t level,
+                                          double minlon,
+                                          double minlat,
+                                          double maxlon,
+                                          double maxlat,
+                                          const std::vector<CellRef>& cellRefs,
+                                          std::vector<DataBlockSpan>& spans,
+                                          std::vector<CellRef>& nextCellRefs) const
+  {
+    // Destroyed after the futures, so helper threads are returned to the budget
+    // after they have finished (also in case of an exception)
+    HelperThreadReservation helperThreads(std::max((size_t)1,cellRefs.size()/minCellsPerThread)-1);
+    size_t                  threadCount=helperThreads.GetCount()+1;
+    size_t                  cellsPerThread=(cellRefs.size()+threadCount-1)/threadCount;
+
+    std::vector<LevelResult>       results(threadCount);
+    std::vector<std::future<void>> futures;
+
+    futures.reserve(threadCount);
+
+    for (size_t t=1; t<threadCount; t++) {
+      auto begin=cellRefs.begin()+std::min(cellRefs.size(),t*cellsPerThread);
+      auto end=cellRefs.begin()+std::min(cellRefs.size(),(t+1)*cellsPerThread);
+
+      futures.push_back(std::async(std::launch::async,[&,t,begin,end]() {
+        ExpandCells(typeConfig,types,level,minlon,minlat,maxlon,maxlat,begin,end,results[t]);
+      }));
+    }
+
+    // The current thread expands the first range
+    ExpandCells(typeConfig,
+                types,
+                level,
+                minlon,
+                minlat,
+                maxlon,
+                maxlat,
+                cellRefs.begin(),
+                cellRefs.begin()+std::min(cellRefs.size(),cellsPerThread),
+                results[0]);
+
+    // Rethrows exceptions of the worker threads
+    for (auto& future : futures) {
+      future.get();
+    }
+
+    for (auto& result : results) {
+      spans.insert(spans.end(),result.spans.begin(),result.spans.end());
+      nextCellRefs.insert(nextCellRefs.end(),result.nextCellRefs.begin(),result.nextCellRefs.end());
+    }
+  }
+
+  /**
+   * Set the minimum number of cells of a level, which are expanded in parallel
+   * (if the index file is memory mapped). The default is 512 cells on systems
+   * with multiple cores, else parallel expansion is disabled. Passing
+   * std::numeric_limits<size_t>::max() disables parallel expansion.
+   *
+   * Method is NOT thread-safe.
+   */
+  void AreaAreaIndex::SetParallelCellThreshold(size_t threshold)
+  {
+    parallelCellThreshold=std::max((size_t)1,threshold);
+  }
+
   bool AreaAreaIndex::Open(const std::string& path, bool memoryMappedData)
   {
     datafilename=AppendFileToDir(path,AREA_AREA_IDX);
@@ -227,6 +433,10 @@ namespace osmscout {
       maxLevel=scanner.ReadUInt32Number();
       topLevelOffset=scanner.ReadFileOffset();
 
+      // Evaluated once, as the state of the scanner may only be accessed
+      // under lookupMutex later on
+      memoryMapped=MemoryScanner::CanScan(scanner);
+
       return !scanner.HasError();
     }
     catch (const IOException& e) {
@@ -294,6 +504,23 @@ namespace osmscout {
            level++) {
         nextCellRefs.clear();
 
+        if (cellRefs.size()>=parallelCellThreshold &&
+            memoryMapped) {
+          ExpandLevelParallel(typeConfig,
+                              types,
+                              level,
+                              minlon,
+                              minlat,
+                              maxlon,
+                              maxlat,
+                              cellRefs,
+                              spans,
+                              nextCellRefs);
+
+          std::swap(cellRefs,nextCellRefs);
+          continue;
+        }
+
         for (const auto& cellRef : cellRefs) {
           IndexCell  cellIndexData;
           FileOffset cellDataOffset;
@@ -741,7 +741,8 @@ namespace osmscout {
 
   bool Database::GetNodesByOffset(const std::vector<FileOffset>& offsets,
                                   const GeoBox& boundingBox,
-                                  std::vector<NodeRef>& nodes) const
+                                  std::vector<NodeRef>& nodes,
+                                  const ObjectArenaRef& arena) const
   {
     NodeDataFileRef nodeDataFile=GetNodeDataFile();
 
@@ -755,7 +756,8 @@ namespace osmscout {
                                           offsets.end(),
                                           offsets.size(),
                                           boundingBox,
-                                          nodes);
+                                          nodes,
+                                          arena);
 
     time.Stop();
 
@@ -870,7 +872,8 @@ namespace osmscout {
   }
 
   bool Database::GetAreasByBlockSpans(const std::vector<DataBlockSpan>& spans,
-                                      std::vector<AreaRef>& areas) const
+                                      std::vector<AreaRef>& areas,
+                                      const ObjectArenaRef& arena) const
   {
     AreaDataFileRef areaDataFile=GetAreaDataFile();
 
@@ -880,7 +883,8 @@ namespace osmscout {
 
     return areaDataFile->GetByBlockSpans(spans.begin(),
                                          spans.end(),
-                                         areas);
+                                         areas,
+                                         arena);
   }
 
   bool Database::GetWayByOffset(const FileOffset& offset,
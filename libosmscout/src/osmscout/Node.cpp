@@ -19,6 +19,8 @@
 
 #include <osmscout/Node.h>
 
+#include <osmscout/util/MemoryScanner.h>
+
 namespace osmscout {
 
   void Node::SetType(const TypeInfoRef& type)
@@ -41,8 +43,9 @@ namespace osmscout {
    *
    * @throws IOException
    */
+  template<typename S>
   void Node::Read(const TypeConfig& typeConfig,
-                  FileScanner& scanner)
+                  S& scanner)
   {
     fileOffset=scanner.GetPos();
 
@@ -56,6 +59,16 @@ namespace osmscout {
     nextFileOffset=scanner.GetPos();
   }
 
+  template OSMSCOUT_API void Node::Read<MemoryScanner>(const TypeConfig& typeConfig,
+                                                       MemoryScanner& scanner);
+
+  void Node::Read(const TypeConfig& typeConfig,
+                  FileScanner& scanner)
+  {
+    Read<FileScanner>(typeConfig,
+                      scanner);
+  }
+
   /**
    * Write the node data to the given FileWriter.
    *
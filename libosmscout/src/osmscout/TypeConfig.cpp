@@ -1173,8 +1173,9 @@ namespace osmscout {
 
       uint32_t fileFormatVersion=scanner.ReadUInt32();
 
-      if (fileFormatVersion!=FILE_FORMAT_VERSION) {
-        log.Error() << "File '" << scanner.GetFilename() << "' does not have the expected format version! Actual " << fileFormatVersion << ", expected: " << FILE_FORMAT_VERSION;
+      if (fileFormatVersion<MIN_FORMAT_VERSION ||
+          fileFormatVersion>MAX_FORMAT_VERSION) {
+        log.Error() << "File '" << scanner.GetFilename() << "' does not have the expected format version! Actual " << fileFormatVersion << ", expected: " << MIN_FORMAT_VERSION << "-" << MAX_FORMAT_VERSION;
         return false;
       }
 
@@ -21,6 +21,7 @@
 
 #include <limits>
 
+#include <osmscout/util/MemoryScanner.h>
 #include <osmscout/util/String.h>
 
 #include <osmscout/system/Assert.h>
@@ -71,8 +72,9 @@ namespace osmscout {
    *
    * @throws IOException
    */
+  template<typename S>
   void Way::Read(const TypeConfig& typeConfig,
-                 FileScanner& scanner)
+                 S& scanner)
   {
     nodes.clear();
     fileOffset=scanner.GetPos();
@@ -93,6 +95,16 @@ namespace osmscout {
     nextFileOffset=scanner.GetPos();
   }
 
+  template OSMSCOUT_API void Way::Read<MemoryScanner>(const TypeConfig& typeConfig,
+                                                      MemoryScanner& scanner);
+
+  void Way::Read(const TypeConfig& typeConfig,
+                 FileScanner& scanner)
+  {
+    Read<FileScanner>(typeConfig,
+                      scanner);
+  }
+
   /**
    * Read the data from the given FileScanner. Node Ids are not read.
    *
@@ -32,18 +32,51 @@
 #include <osmscout/util/Logger.h>
 #include <osmscout/util/StopClock.h>
 
+#include <atomic>
+#include <future>
 #include <iomanip>
 #include <iostream>
 #include <limits>
+#include <thread>
 
 //#define DEBUG_ROUTING
 
 namespace osmscout {
 
+  /**
+   * Return the length of the given way between the two given node indexes
+   * (in any order), measured the same way as the distance of route node paths.
+   */
+  static Distance GetWayDistance(const Way& way,
+                                 size_t fromIndex,
+                                 size_t toIndex)
+  {
+    Distance distance;
+
+    for (size_t i=std::min(fromIndex,toIndex); i<std::max(fromIndex,toIndex); i++) {
+      distance+=GetSphericalDistance(way.nodes[i].GetCoord(),
+                                     way.nodes[i+1].GetCoord());
+    }
+
+    return distance;
+  }
+
   RoutingResult::RoutingResult()
   {
   }
 
+  RoutingMatrixResult::RoutingMatrixResult() = default;
+
+  RoutingMatrixResult::RoutingMatrixResult(size_t sourceCount,
+                                           size_t targetCount)
+  : sourceCount(sourceCount),
+    targetCount(targetCount),
+    costs(sourceCount*targetCount,std::numeric_limits<double>::infinity()),
+    distances(sourceCount*targetCount)
+  {
+    // no code
+  }
+
   RoutePoints::RoutePoints(const std::list<Point>& points)
   : points(points.begin(),points.end())
   {
@@ -99,12 +132,12 @@ namespace osmscout {
                                                                      const ClosedSet& closedRestrictedSet,
                                                                      std::list<VNode>& nodes)
   {
-    bool restricted=false;
-    auto current=closedSet.find(VNode(finalRouteNode));
+    bool         restricted=false;
+    const VNode* current=closedSet.Find(finalRouteNode);
 
-    if (current==closedSet.end()){
-      current=closedRestrictedSet.find(VNode(finalRouteNode));
-      assert(current!=closedSet.end());
+    if (current==nullptr){
+      current=closedRestrictedSet.Find(finalRouteNode);
+      assert(current!=nullptr);
       restricted=true;
     }
 
@@ -112,19 +145,19 @@ namespace osmscout {
 #if defined(DEBUG_ROUTING)
       std::cout << "Chain item " << current->currentNode << " -> " << current->previousNode << std::endl;
 #endif
-      ClosedSet::const_iterator prev;
+      const VNode* prev;
       if (!restricted){
-        prev=closedSet.find(VNode(current->previousNode));
-        if (prev==closedSet.end()){
-          prev=closedRestrictedSet.find(VNode(current->previousNode));
-          assert(prev!=closedRestrictedSet.end());
+        prev=closedSet.Find(current->previousNode);
+        if (prev==nullptr){
+          prev=closedRestrictedSet.Find(current->previousNode);
+          assert(prev!=nullptr);
           restricted=true;
         }
       }else{
-        prev=closedRestrictedSet.find(VNode(current->previousNode));
-        if (prev==closedRestrictedSet.end()){
-          prev=closedSet.find(VNode(current->previousNode));
-          assert(prev!=closedSet.end());
+        prev=closedRestrictedSet.Find(current->previousNode);
+        if (prev==nullptr){
+          prev=closedSet.Find(current->previousNode);
+          assert(prev!=nullptr);
           restricted=false;
         }
       }
@@ -271,12 +304,16 @@ namespace osmscout {
                                                       const RouteNodeRef& routeNode,
                                                       const GeoCoord& startCoord,
                                                       const GeoCoord& targetCoord,
+                                                      RNodePool& nodePool,
                                                       RNodeRef& node)
   {
-    node=std::make_shared<RNode>(DBId(position.GetDatabaseId(),routeNode->GetId()),
-                                 routeNode,
-                                 position.GetObjectFileRef());
+    node=nodePool.Create(DBId(position.GetDatabaseId(),routeNode->GetId()),
+                         routeNode,
+                         position.GetObjectFileRef());
 
+    node->distance=GetWayDistance(*way,
+                                  position.GetNodeIndex(),
+                                  routeNodeIndex);
     node->currentCost=GetCosts(state,
                                position.GetDatabaseId(),
                                way,
@@ -309,6 +346,8 @@ namespace osmscout {
    *    Optional route node in the forward direction
    * @param backwardRouteNode
    *    Optional route node in the backward direction
+   * @param nodePool
+   *    Pool to allocate the routing nodes from
    * @param forwardRNode
    *    Optional prefilled routing node for the forward direction to be used as part of the routing process
    * @param backwardRNode
@@ -323,6 +362,7 @@ namespace osmscout {
                                                               const GeoCoord& targetCoord,
                                                               RouteNodeRef& forwardRouteNode,
                                                               RouteNodeRef& backwardRouteNode,
+                                                              RNodePool& nodePool,
                                                               RNodeRef& forwardRNode,
                                                               RNodeRef& backwardRNode)
   {
@@ -384,6 +424,7 @@ namespace osmscout {
                   forwardRouteNode,
                   startCoord,
                   targetCoord,
+                  nodePool,
                   forwardRNode)) {
       return false;
     }
@@ -396,6 +437,7 @@ namespace osmscout {
                   backwardRouteNode,
                   startCoord,
                   targetCoord,
+                  nodePool,
                   backwardRNode)) {
       return false;
     }
@@ -420,6 +462,8 @@ namespace osmscout {
    *    Optional route node in the forward direction
    * @param backwardRouteNode
    *    Optional route node in the backward direction
+   * @param nodePool
+   *    Pool to allocate the routing nodes from
    * @param forwardRNode
    *    Optional prefilled routing node for the forward direction to be used as part of the routing process
    * @param backwardRNode
@@ -434,6 +478,7 @@ namespace osmscout {
                                                            const GeoCoord& targetCoord,
                                                            RouteNodeRef& forwardRouteNode,
                                                            RouteNodeRef& backwardRouteNode,
+                                                           RNodePool& nodePool,
                                                            RNodeRef& forwardRNode,
                                                            RNodeRef& backwardRNode)
   {
@@ -444,6 +489,7 @@ namespace osmscout {
                               targetCoord,
                               forwardRouteNode,
                               backwardRouteNode,
+                              nodePool,
                               forwardRNode,
                               backwardRNode);
     }
@@ -568,6 +614,7 @@ namespace osmscout {
                                                                   RouteNodeRef &currentRouteNode,
                                                                   OpenList &openList,
                                                                   OpenMap &openMap,
+                                                                  RNodePool &nodePool,
                                                                   const ClosedSet &closedSet,
                                                                   const ClosedSet &closedRestrictedSet)
   {
@@ -577,19 +624,19 @@ namespace osmscout {
                                          currentRouteNode->GetId());
     for (const auto& twin : twins) {
       if ((current->access &&
-           closedSet.find(VNode(twin))!=closedSet.end()) ||
+           closedSet.Find(twin)!=nullptr) ||
           (!current->access &&
-            closedRestrictedSet.find(VNode(twin))!=closedRestrictedSet.end())){
+            closedRestrictedSet.Find(twin)!=nullptr)){
 #if defined(DEBUG_ROUTING)
         std::cout << "Twin node " << twin << " is closed already, ignore it" << std::endl;
 #endif
         continue;
       }
 
-      auto twinIt=openMap.find(twin);
+      RNodeRef* twinEntry=openMap.Find(twin);
 
-      if (twinIt!=openMap.end()){
-        RNodeRef rn=(*twinIt->second);
+      if (twinEntry!=nullptr){
+        RNodeRef rn=*twinEntry;
         if (rn->currentCost > current->currentCost) {
           // this is cheaper path to twin
 
@@ -599,12 +646,10 @@ namespace osmscout {
           rn->currentCost=current->currentCost;
           rn->estimateCost=current->estimateCost;
           rn->overallCost=current->overallCost;
+          rn->distance=current->distance;
           rn->access=current->access;
 
-          openList.erase(twinIt->second);
-
-          std::pair<OpenListRef,bool> insertResult=openList.insert(rn);
-          twinIt->second=insertResult.first;
+          openList.Update(rn);
 
 #if defined(DEBUG_ROUTING)
           std::cout << "Better transition from " << rn->prev << " to " << rn->id << std::endl;
@@ -616,19 +661,20 @@ namespace osmscout {
         if (!GetRouteNode(twin,node)){
           return false;
         }
-        RNodeRef rn=std::make_shared<RNode>(twin,
-                                            node,
-                                            //node->objects.begin()->object, /*TODO: how to find correct way from other DB?*/
-                                            ObjectFileRef(), // TODO: have to be valid Object here?
-                                            /*prev*/current->id);
+        RNodeRef rn=nodePool.Create(twin,
+                                    node,
+                                    //node->objects.begin()->object, /*TODO: how to find correct way from other DB?*/
+                                    ObjectFileRef(), // TODO: have to be valid Object here?
+                                    /*prev*/current->id);
 
         rn->currentCost=current->currentCost;
         rn->estimateCost=current->estimateCost;
         rn->overallCost=current->overallCost;
+        rn->distance=current->distance;
         rn->access=current->access;
 
-        std::pair<OpenListRef,bool> insertResult=openList.insert(rn);
-        openMap[rn->id]=insertResult.first;
+        openList.Push(rn);
+        openMap.Insert(rn);
 
 #if defined(DEBUG_ROUTING)
         std::cout << "Transition from " << rn->prev << " to " << rn->id << std::endl;
@@ -644,6 +690,7 @@ namespace osmscout {
                                                        RouteNodeRef &currentRouteNode,
                                                        OpenList &openList,
                                                        OpenMap &openMap,
+                                                       RNodePool &nodePool,
                                                        ClosedSet &closedSet,
                                                        ClosedSet &closedRestrictedSet,
                                                        RoutingResult &result,
@@ -719,9 +766,9 @@ namespace osmscout {
       }
 
       if ((current->access &&
-           closedSet.find(VNode(DBId(dbId,path.id)))!=closedSet.end()) ||
+           closedSet.Find(DBId(dbId,path.id))!=nullptr) ||
           (!current->access &&
-           closedRestrictedSet.find(VNode(DBId(dbId,path.id)))!=closedRestrictedSet.end())) {
+           closedRestrictedSet.Find(DBId(dbId,path.id))!=nullptr)) {
 #if defined(DEBUG_ROUTING)
         std::cout << "  Skipping route";
         std::cout << " to " << dbId << " / " << path.id;
@@ -764,18 +811,18 @@ namespace osmscout {
                                                        inPathValid ? inPathIndex : i,
                                                        i);
 
-      auto openEntry=openMap.find(DBId(current->id.database,
-                                       path.id));
+      RNodeRef* openEntry=openMap.Find(DBId(current->id.database,
+                                            path.id));
 
       // Check, if we already have a cheaper path to the new node. If yes, do not put the new path
       // into the open list
-      if (openEntry!=openMap.end() &&
-          (*openEntry->second)->currentCost<=currentCost) {
+      if (openEntry!=nullptr &&
+          (*openEntry)->currentCost<=currentCost) {
 #if defined(DEBUG_ROUTING)
         std::cout << "  Skipping route";
         std::cout << " to " << dbId << " / " << path.id;
         std::cout << " (" << currentRouteNode->objects[path.objectIndex].object.GetName() << ")";
-        std::cout << " => cheaper route exists " << currentCost << "<=>" << (*openEntry->second)->object.GetName() << " " << (*openEntry->second)->node->GetId() << " " << (*openEntry->second)->currentCost << std::endl;
+        std::cout << " => cheaper route exists " << currentCost << "<=>" << (*openEntry)->object.GetName() << " " << (*openEntry)->node->GetId() << " " << (*openEntry)->currentCost << std::endl;
 #endif
         i++;
 
@@ -784,8 +831,8 @@ namespace osmscout {
 
       RouteNodeRef nextNode;
 
-      if (openEntry!=openMap.end()) {
-        nextNode=(*openEntry->second)->node;
+      if (openEntry!=nullptr) {
+        nextNode=(*openEntry)->node;
       }
       else if (!GetRouteNode(DBId(current->id.database,
                                   path.id),
@@ -824,8 +871,8 @@ namespace osmscout {
 
       // If we already have the node in the open list, but the new path is cheaper (as tested above),
       // update the existing entry
-      if (openEntry!=openMap.end()) {
-        RNodeRef node=*openEntry->second;
+      if (openEntry!=nullptr) {
+        RNodeRef node=*openEntry;
 
         node->prev=current->id;
         node->object=currentRouteNode->objects[path.objectIndex].object;
@@ -833,26 +880,25 @@ namespace osmscout {
         node->currentCost=currentCost;
         node->estimateCost=estimateCost;
         node->overallCost=overallCost;
+        node->distance=current->distance+path.distance;
         node->access=!currentRouteNode->paths[i].IsRestricted(vehicle);
 
 #if defined(DEBUG_ROUTING)
         std::cout << "  Updating route " << current->id << " via " << node->object.GetTypeName() << " " << node->object.GetFileOffset() << " " << currentCost << " " << estimateCost << " " << overallCost << " " << currentRouteNode->GetId() << std::endl;
 #endif
 
-        openList.erase(openEntry->second);
-
-        std::pair<OpenListRef,bool> insertResult=openList.insert(node);
-        openEntry->second=insertResult.first;
+        openList.Update(node);
       }
       else {
-        RNodeRef node=std::make_shared<RNode>(DBId(dbId,path.id),
-                                              nextNode,
-                                              currentRouteNode->objects[path.objectIndex].object,
-                                              current->id);
+        RNodeRef node=nodePool.Create(DBId(dbId,path.id),
+                                      nextNode,
+                                      currentRouteNode->objects[path.objectIndex].object,
+                                      current->id);
 
         node->currentCost=currentCost;
         node->estimateCost=estimateCost;
         node->overallCost=overallCost;
+        node->distance=current->distance+path.distance;
         node->access=!path.IsRestricted(vehicle);
 
 #if defined(DEBUG_ROUTING)
@@ -861,8 +907,8 @@ namespace osmscout {
         std::cout << " " << currentCost << " " << estimateCost << " " << overallCost << " " << currentRouteNode->GetId() << std::endl;
 #endif
 
-        std::pair<OpenListRef,bool> insertResult=openList.insert(node);
-        openMap[node->id]=insertResult.first;
+        openList.Push(node);
+        openMap.Insert(node);
       }
 
       i++;
@@ -871,6 +917,37 @@ namespace osmscout {
     return true;
   }
 
+  /**
+   * Hook for calculating the chain of route nodes from the start to the target
+   * without the A* search of CalculateRoute(), for example by using a
+   * precalculated contraction hierarchy. The first node of the chain must be
+   * one of the given start nodes (with its object), the last node one of the
+   * target route nodes.
+   *
+   * Implementations must not return routes more expensive than the
+   * given cost limit and should check the breaker of the parameter.
+   *
+   * The default implementation does nothing and returns false.
+   *
+   * @return
+   *    True, if the chain was calculated, false if CalculateRoute() should
+   *    fall back to the A* search
+   */
+  template <class RoutingState>
+  bool AbstractRoutingService<RoutingState>::CalculateRouteNodeChain(const RoutingState& /*state*/,
+                                                                     const RoutePosition& /*start*/,
+                                                                     const RoutePosition& /*target*/,
+                                                                     const RNodeRef& /*startForwardNode*/,
+                                                                     const RNodeRef& /*startBackwardNode*/,
+                                                                     const RouteNodeRef& /*targetForwardRouteNode*/,
+                                                                     const RouteNodeRef& /*targetBackwardRouteNode*/,
+                                                                     const RoutingParameter& /*parameter*/,
+                                                                     double /*costLimit*/,
+                                                                     std::list<VNode>& /*nodes*/)
+  {
+    return false;
+  }
+
   /**
    * Calculate a route
    *
@@ -897,8 +974,8 @@ namespace osmscout {
     Vehicle                  vehicle=GetVehicle(state);
     RouteNodeRef             startForwardRouteNode;
     RouteNodeRef             startBackwardRouteNode;
-    RNodeRef                 startForwardNode;
-    RNodeRef                 startBackwardNode;
+    RNodeRef                 startForwardNode=nullptr;
+    RNodeRef                 startBackwardNode=nullptr;
 
     GeoCoord                 startCoord;
     GeoCoord                 targetCoord;
@@ -906,26 +983,30 @@ namespace osmscout {
     RouteNodeRef             targetForwardRouteNode;
     RouteNodeRef             targetBackwardRouteNode;
 
-    // Sorted list (smallest cost first) of ways to check (we are using a std::set)
-    OpenList                 openList;
+    // Recycled data structures of a previous search, all RNodes are allocated from its pool
+    RoutingSearchSpaceRef    searchSpace=AcquireSearchSpace();
+    RNodePool&               nodePool=searchSpace->nodePool;
+    // Heap (smallest cost first) of ways to check
+    OpenList&                openList=searchSpace->openList;
     // Map routing nodes by id
-    OpenMap                  openMap;
+    OpenMap&                 openMap=searchSpace->openMap;
 
     // Restricted way (access=destination) is a way that may be used just
     // in case when target is on this way. Some routing nodes may be accessed
     // from two different ways - one without any access restriction (closedSet)
     // and second with restriction (closedRestrictedSet)
-    ClosedSet                closedSet;
-    ClosedSet                closedRestrictedSet;
+    ClosedSet&               closedSet=searchSpace->closedSet;
+    ClosedSet&               closedRestrictedSet=searchSpace->closedRestrictedSet;
 
     size_t                   nodesLoadedCount=0;
     size_t                   nodesIgnoredCount=0;
     size_t                   maxOpenList=0;
     size_t                   maxClosedSet=0;
 
-    openMap.reserve(10000);
-    closedSet.reserve(300000);
-    closedRestrictedSet.reserve(10000);
+    openList.Reserve(10000);
+    openMap.Reserve(10000);
+    closedSet.Reserve(10000);
+    closedRestrictedSet.Reserve(10000);
 
     if (!GetTargetNodes(state,
                         target,
@@ -941,6 +1022,7 @@ namespace osmscout {
                        targetCoord,
                        startForwardRouteNode,
                        startBackwardRouteNode,
+                       nodePool,
                        startForwardNode,
                        startBackwardNode)) {
       return result;
@@ -971,15 +1053,13 @@ namespace osmscout {
     }
 
     if (startForwardNode) {
-      std::pair<OpenListRef,bool> insertResult=openList.insert(startForwardNode);
-
-      openMap[startForwardNode->id]=insertResult.first;
+      openList.Push(startForwardNode);
+      openMap.Insert(startForwardNode);
     }
 
     if (startBackwardNode) {
-      std::pair<OpenListRef,bool> insertResult=openList.insert(startBackwardNode);
-
-      openMap[startBackwardNode->id]=insertResult.first;
+      openList.Push(startBackwardNode);
+      openMap.Insert(startBackwardNode);
     }
 
 
@@ -992,14 +1072,46 @@ namespace osmscout {
     result.SetOverallDistance(overallDistance);
     result.SetCurrentMaxDistance(currentMaxDistance);
 
-    StopClock    clock;
-    RNodeRef     current;
+    StopClock        clock;
+    std::list<VNode> chain;
+
+    if (CalculateRouteNodeChain(state,
+                                start,
+                                target,
+                                startForwardNode,
+                                startBackwardNode,
+                                targetForwardRouteNode,
+                                targetBackwardRouteNode,
+                                parameter,
+                                costLimit,
+                                chain)) {
+      clock.Stop();
+
+      if (debugPerformance) {
+        std::cout << "Time (hierarchy):    " << clock << std::endl;
+        std::cout << "Route nodes:         " << chain.size() << std::endl;
+      }
+
+      if (!ResolveRNodesToRouteData(state,
+                                    chain,
+                                    start,
+                                    target,
+                                    result.GetRoute())) {
+        return result;
+      }
+
+      ResolveRouteDataJunctions(result.GetRoute());
+
+      return result;
+    }
+
+    RNodeRef     current=nullptr;
     RouteNodeRef currentRouteNode;
     DatabaseId   dbId;
     bool         targetForwardFound=targetForwardRouteNode ? false : true;
     bool         targetBackwardFound=targetBackwardRouteNode ? false : true;
-    RNodeRef     targetForwardFinalNode;
-    RNodeRef     targetBackwardFinalNode;
+    RNodeRef     targetForwardFinalNode=nullptr;
+    RNodeRef     targetBackwardFinalNode=nullptr;
 
     do {
       //
@@ -1011,10 +1123,10 @@ namespace osmscout {
         return result;
       }
 
-      current=*openList.begin();
+      current=openList.Top();
 
-      openMap.erase(current->id);
-      openList.erase(openList.begin());
+      openMap.Erase(current->id);
+      openList.Pop();
 
       currentRouteNode=current->node;
       dbId=current->id.database;
@@ -1034,6 +1146,7 @@ namespace osmscout {
                      currentRouteNode,
                      openList,
                      openMap,
+                     nodePool,
                      closedSet,
                      closedRestrictedSet,
                      result,
@@ -1059,6 +1172,7 @@ namespace osmscout {
                                 currentRouteNode,
                                 openList,
                                 openMap,
+                                nodePool,
                                 closedSet,
                                 closedRestrictedSet)) {
         log.Error() << "Failed to walk to other databases from " << dbId << " / " << currentRouteNode->GetFileOffset();
@@ -1073,23 +1187,23 @@ namespace osmscout {
         std::cout << "Closing " << current->id << " (previous " << current->prev << ")" << std::endl;
 #endif
       if (current->access) {
-        closedSet.insert(VNode(current->id,
+        closedSet.Insert(VNode(current->id,
                                current->object,
                                current->prev));
       }
       else {
-        closedRestrictedSet.insert(VNode(current->id,
+        closedRestrictedSet.Insert(VNode(current->id,
                                          current->object,
                                          current->prev));
       }
 
       current->node=nullptr;
 
-      maxOpenList=std::max(maxOpenList,openMap.size());
-      maxClosedSet=std::max(maxClosedSet,closedSet.size()+closedRestrictedSet.size());
+      maxOpenList=std::max(maxOpenList,openMap.Size());
+      maxClosedSet=std::max(maxClosedSet,closedSet.Size()+closedRestrictedSet.Size());
 
 #if defined(DEBUG_ROUTING)
-      if (openList.empty()) {
+      if (openList.Empty()) {
         std::cout << "No more alternatives, stopping" << std::endl;
       }
 
@@ -1122,16 +1236,16 @@ namespace osmscout {
         }
       }
 
-    } while (!openList.empty() && !(targetForwardFound && targetBackwardFound));
+    } while (!openList.Empty() && !(targetForwardFound && targetBackwardFound));
 
     // If we have keep the last node open because of access violations, add it
     // after routing is done
-    if (closedSet.find(VNode(current->id))==closedSet.end()) {
-      closedSet.insert(VNode(current->id,
+    if (closedSet.Find(current->id)==nullptr) {
+      closedSet.Insert(VNode(current->id,
                              current->object,
                              current->prev));
     }
-    RNodeRef  targetFinalNode;
+    RNodeRef  targetFinalNode=nullptr;
 
     if (targetBackwardFinalNode && targetForwardFinalNode) {
       if (targetForwardFinalNode->currentCost<=targetBackwardFinalNode->currentCost) {
@@ -1247,6 +1361,736 @@ namespace osmscout {
     return result;
   }
 
+  /**
+   * Collect the route nodes next to the given target positions of a matrix
+   * calculation, together with the costs and the distance from the route
+   * node to the target position. Targets without usable route node are
+   * skipped and thus stay unreachable.
+   *
+   * @return
+   *    False in case of technical errors, else true
+   */
+  template <class RoutingState>
+  bool AbstractRoutingService<RoutingState>::GetMatrixTargets(const RoutingState& state,
+                                                              const std::vector<RoutePosition>& targets,
+                                                              MatrixTargetMap& targetMap)
+  {
+    for (size_t t=0; t<targets.size(); t++) {
+      const RoutePosition& target=targets[t];
+
+      if (target.GetObjectFileRef().GetType()!=refWay) {
+        log.Error() << "Unsupported object type '" << target.GetObjectFileRef().GetTypeName() << "' for target!";
+        continue;
+      }
+
+      WayRef way;
+
+      if (!GetWayByOffset(DBFileOffset(target.GetDatabaseId(),
+                                       target.GetObjectFileRef().GetFileOffset()),
+                          way)) {
+        log.Error() << "Cannot get end way!";
+        return false;
+      }
+
+      if (target.GetNodeIndex()>=way->nodes.size()) {
+        log.Error() << "Given target node index " << target.GetNodeIndex() << " is not within valid range [0," << way->nodes.size()-1;
+        continue;
+      }
+
+      RouteNodeRef forwardNode;
+      RouteNodeRef backwardNode;
+
+      // Check, if the current node is already the route node
+      GetRouteNode(DBId(target.GetDatabaseId(),
+                        way->GetId(target.GetNodeIndex())),
+                   forwardNode);
+
+      if (!forwardNode) {
+        GetTargetForwardRouteNode(state,
+                                  target.GetDatabaseId(),
+                                  way,
+                                  target.GetNodeIndex(),
+                                  forwardNode);
+        GetTargetBackwardRouteNode(state,
+                                   target.GetDatabaseId(),
+                                   way,
+                                   target.GetNodeIndex(),
+                                   backwardNode);
+      }
+
+      if (forwardNode) {
+        // The closest route node in front of the target (or the target itself)
+        size_t routeNodeIndex=target.GetNodeIndex();
+
+        while (way->GetId(routeNodeIndex)!=forwardNode->GetId()) {
+          routeNodeIndex--;
+        }
+
+        Distance distance=GetWayDistance(*way,
+                                         routeNodeIndex,
+                                         target.GetNodeIndex());
+
+        targetMap[DBId(target.GetDatabaseId(),forwardNode->GetId())].push_back(MatrixTarget{t,
+                                                                                            GetCosts(state,
+                                                                                                     target.GetDatabaseId(),
+                                                                                                     way,
+                                                                                                     distance),
+                                                                                            distance,
+                                                                                            way->nodes[target.GetNodeIndex()].GetCoord()});
+      }
+
+      if (backwardNode) {
+        // The closest route node behind the target
+        size_t routeNodeIndex=target.GetNodeIndex();
+
+        while (way->GetId(routeNodeIndex)!=backwardNode->GetId()) {
+          routeNodeIndex++;
+        }
+
+        Distance distance=GetWayDistance(*way,
+                                         target.GetNodeIndex(),
+                                         routeNodeIndex);
+
+        targetMap[DBId(target.GetDatabaseId(),backwardNode->GetId())].push_back(MatrixTarget{t,
+                                                                                             GetCosts(state,
+                                                                                                      target.GetDatabaseId(),
+                                                                                                      way,
+                                                                                                      distance),
+                                                                                             distance,
+                                                                                             way->nodes[target.GetNodeIndex()].GetCoord()});
+      }
+    }
+
+    return true;
+  }
+
+  /**
+   * Return the route node with the given id, loading it only once per batch.
+   */
+  template <class RoutingState>
+  bool AbstractRoutingService<RoutingState>::GetBatchRouteNode(RouteNodeBatch& batch,
+                                                               const DBId& id,
+                                                               RouteNodeRef& node)
+  {
+    node=batch.Find(id);
+
+    if (node) {
+      return true;
+    }
+
+    if (!GetRouteNode(id,
+                      node)) {
+      return false;
+    }
+
+    batch.Insert(id,
+                 node);
+
+    return true;
+  }
+
+  /**
+   * Expand the given (just settled) node of a search without estimate, like
+   * WalkPaths() does for the A* search of CalculateRoute(). Access
+   * restrictions and turn restrictions are handled the same way.
+   *
+   * The visitor is called for each usable path with the route node the path
+   * leads to and the costs of the route up to this route node, even if there
+   * is already a cheaper route to it.
+   *
+   * @return
+   *    False in case of technical errors, else true
+   */
+  template <class RoutingState>
+  template <typename PathVisitor>
+  bool AbstractRoutingService<RoutingState>::ExpandRouteNode(const RoutingState& state,
+                                                             Vehicle vehicle,
+                                                             const RNodeRef& current,
+                                                             RoutingSearchSpace& searchSpace,
+                                                             RouteNodeBatch& batch,
+                                                             PathVisitor&& visitor)
+  {
+    const RouteNodeRef& currentRouteNode=current->node;
+    DatabaseId          dbId=current->id.database;
+
+    // find incoming path (its index) to current node
+    size_t inPathIndex=currentRouteNode->paths.size();
+
+    if (current->prev.IsValid() &&
+        dbId==current->prev.database) {
+      for (size_t i=0; i<currentRouteNode->paths.size(); i++) {
+        const auto& path=currentRouteNode->paths[i];
+
+        if (path.id==current->prev.id &&
+            currentRouteNode->objects[path.objectIndex].object==current->object) {
+          inPathIndex=i;
+          break;
+        }
+      }
+    }
+
+    for (size_t i=0; i<currentRouteNode->paths.size(); i++) {
+      const auto&          path=currentRouteNode->paths[i];
+      const ObjectFileRef& pathObject=currentRouteNode->objects[path.objectIndex].object;
+      DBId                 pathId(dbId,path.id);
+
+      if (path.id==current->prev.id ||
+          (!current->access && !path.IsRestricted(vehicle)) ||
+          !CanUse(state,dbId,*currentRouteNode,i)) {
+        continue;
+      }
+
+      if ((current->access &&
+           searchSpace.closedSet.Find(pathId)!=nullptr) ||
+          (!current->access &&
+           searchSpace.closedRestrictedSet.Find(pathId)!=nullptr)) {
+        continue;
+      }
+
+      if (std::any_of(currentRouteNode->excludes.begin(),
+                      currentRouteNode->excludes.end(),
+                      [&current,&currentRouteNode,&pathObject](const RouteNode::Exclude& exclude) {
+                        return exclude.source==current->object &&
+                               currentRouteNode->objects[exclude.targetIndex].object==pathObject;
+                      })) {
+        continue;
+      }
+
+      double    currentCost=current->currentCost+GetCosts(state,
+                                                          dbId,
+                                                          *currentRouteNode,
+                                                          inPathIndex<currentRouteNode->paths.size() ? inPathIndex : i,
+                                                          i);
+      RNodeRef* openEntry=searchSpace.openMap.Find(pathId);
+
+      if (openEntry!=nullptr) {
+        visitor((*openEntry)->node,
+                currentCost);
+
+        if ((*openEntry)->currentCost<=currentCost) {
+          continue;
+        }
+      }
+
+      RNodeRef node;
+
+      if (openEntry!=nullptr) {
+        node=*openEntry;
+        node->prev=current->id;
+        node->object=pathObject;
+      }
+      else {
+        RouteNodeRef nextNode;
+
+        if (!GetBatchRouteNode(batch,
+                               pathId,
+                               nextNode)) {
+          log.Error() << "Cannot load route node with id " << path.id;
+          return false;
+        }
+
+        visitor(nextNode,
+                currentCost);
+
+        node=searchSpace.nodePool.Create(pathId,
+                                         nextNode,
+                                         pathObject,
+                                         current->id);
+      }
+
+      node->currentCost=currentCost;
+      node->overallCost=currentCost;
+      node->distance=current->distance+path.distance;
+      node->access=!path.IsRestricted(vehicle);
+
+      if (openEntry!=nullptr) {
+        searchSpace.openList.Update(node);
+      }
+      else {
+        searchSpace.openList.Push(node);
+        searchSpace.openMap.Insert(node);
+      }
+    }
+
+    return true;
+  }
+
+  /**
+   * Close the given node of a search without estimate after it has been
+   * expanded.
+   */
+  template <class RoutingState>
+  bool AbstractRoutingService<RoutingState>::CloseRouteNode(const RoutingState& state,
+                                                            RNodeRef& current,
+                                                            RoutingSearchSpace& searchSpace)
+  {
+    RouteNodeRef currentRouteNode=current->node;
+
+    if (!WalkToOtherDatabases(state,
+                              current,
+                              currentRouteNode,
+                              searchSpace.openList,
+                              searchSpace.openMap,
+                              searchSpace.nodePool,
+                              searchSpace.closedSet,
+                              searchSpace.closedRestrictedSet)) {
+      log.Error() << "Failed to walk to other databases from " << current->id.database << " / " << currentRouteNode->GetFileOffset();
+      return false;
+    }
+
+    if (current->access) {
+      searchSpace.closedSet.Insert(VNode(current->id,
+                                         current->object,
+                                         current->prev));
+    }
+    else {
+      searchSpace.closedRestrictedSet.Insert(VNode(current->id,
+                                                   current->object,
+                                                   current->prev));
+    }
+
+    current->node=nullptr;
+
+    return true;
+  }
+
+  /**
+   * Call the given function for each index in [0,count[, distributing the
+   * calls over hardware_concurrency() threads (including the current one).
+   * Processing stops early, if one call returns false.
+   *
+   * @return
+   *    The number of threads used
+   */
+  static size_t ProcessInParallel(size_t count,
+                                  std::atomic<bool>& success,
+                                  const std::function<bool(size_t)>& process)
+  {
+    std::atomic<size_t> nextIndex(0);
+
+    auto worker=[&]() {
+      size_t index;
+
+      while (success &&
+             (index=nextIndex++)<count) {
+        if (!process(index)) {
+          success=false;
+        }
+      }
+    };
+
+    size_t                         threadCount=std::min((size_t)std::max(1u,std::thread::hardware_concurrency()),
+                                                        count);
+    std::vector<std::future<void>> futures;
+
+    futures.reserve(threadCount);
+
+    for (size_t t=1; t<threadCount; t++) {
+      futures.push_back(std::async(std::launch::async,worker));
+    }
+
+    worker();
+
+    // Rethrows exceptions of the worker threads
+    for (auto& future : futures) {
+      future.get();
+    }
+
+    return threadCount;
+  }
+
+  /**
+   * Calculate the costs and distances from the given source to all targets of
+   * a matrix calculation and store them in the row of the source.
+   *
+   * In contrast to CalculateRoute() this is a Dijkstra search without
+   * estimate, which stops as soon as the route nodes of all targets are
+   * settled. Like CalculateRoute() the search is limited by GetCostLimit()
+   * for the spherical distance to each target, targets that cannot be
+   * reached within their limit stay unreachable.
+   *
+   * @return
+   *    False in case of technical errors or if the calculation was aborted,
+   *    else true
+   */
+  template <class RoutingState>
+  bool AbstractRoutingService<RoutingState>::CalculateMatrixRow(const RoutingState& state,
+                                                                size_t sourceIndex,
+                                                                const RoutePosition& source,
+                                                                const std::vector<RoutePosition>& targets,
+                                                                const MatrixTargetMap& targetMap,
+                                                                const RoutingParameter& parameter,
+                                                                RouteNodeBatch& batch,
+                                                                RoutingMatrixResult& result)
+  {
+    Vehicle                  vehicle=GetVehicle(state);
+    RoutingSearchSpaceRef    searchSpace=AcquireSearchSpace();
+    GeoCoord                 startCoord;
+    RouteNodeRef             startForwardRouteNode;
+    RouteNodeRef             startBackwardRouteNode;
+    RNodeRef                 startForwardNode=nullptr;
+    RNodeRef                 startBackwardNode=nullptr;
+    std::unordered_set<DBId> reachedTargetNodes;
+    std::vector<double>      costLimits(targets.size(),0.0);
+    double                   rowCostLimit=0.0;
+
+    for (size_t t=0; t<targets.size(); t++) {
+      if (targets[t].GetDatabaseId()==source.GetDatabaseId() &&
+          targets[t].GetObjectFileRef()==source.GetObjectFileRef() &&
+          targets[t].GetNodeIndex()==source.GetNodeIndex()) {
+        result.SetRoute(sourceIndex,
+                        t,
+                        0.0,
+                        Distance());
+      }
+    }
+
+    if (!GetStartNodes(state,
+                       source,
+                       startCoord,
+                       GeoCoord(),
+                       startForwardRouteNode,
+                       startBackwardRouteNode,
+                       searchSpace->nodePool,
+                       startForwardNode,
+                       startBackwardNode)) {
+      // No route from this source, but no reason to stop the other rows
+      return true;
+    }
+
+    for (const auto& targetEntry : targetMap) {
+      for (const auto& target : targetEntry.second) {
+        costLimits[target.targetIndex]=GetCostLimit(state,
+                                                    source.GetDatabaseId(),
+                                                    GetSphericalDistance(startCoord,
+                                                                         target.coord));
+        rowCostLimit=std::max(rowCostLimit,
+                              costLimits[target.targetIndex]);
+      }
+    }
+
+    for (const auto& startNode : {startForwardNode, startBackwardNode}) {
+      if (startNode!=nullptr) {
+        // There is no single target to estimate the remaining costs for
+        startNode->estimateCost=0.0;
+        startNode->overallCost=startNode->currentCost;
+
+        searchSpace->openList.Push(startNode);
+        searchSpace->openMap.Insert(startNode);
+      }
+    }
+
+    while (!searchSpace->openList.Empty() &&
+           reachedTargetNodes.size()<targetMap.size()) {
+      if (parameter.GetBreaker() &&
+          parameter.GetBreaker()->IsAborted()) {
+        return false;
+      }
+
+      RNodeRef current=searchSpace->openList.Top();
+
+      if (current->currentCost>rowCostLimit) {
+        // All remaining targets are beyond their cost limit
+        break;
+      }
+
+      searchSpace->openMap.Erase(current->id);
+      searchSpace->openList.Pop();
+
+      auto targetEntry=targetMap.find(current->id);
+
+      if (targetEntry!=targetMap.end() &&
+          reachedTargetNodes.insert(current->id).second) {
+        for (const auto& target : targetEntry->second) {
+          double cost=current->currentCost+target.cost;
+
+          if (cost<=costLimits[target.targetIndex] &&
+              cost<result.GetCost(sourceIndex,target.targetIndex)) {
+            result.SetRoute(sourceIndex,
+                            target.targetIndex,
+                            cost,
+                            current->distance+target.distance);
+          }
+        }
+      }
+
+      if (!ExpandRouteNode(state,
+                           vehicle,
+                           current,
+                           *searchSpace,
+                           batch,
+                           [](const RouteNodeRef& /*routeNode*/, double /*cost*/) {}) ||
+          !CloseRouteNode(state,
+                          current,
+                          *searchSpace)) {
+        return false;
+      }
+    }
+
+    return true;
+  }
+
+  /**
+   * Calculate the costs and the distances of the cheapest routes from each of
+   * the given sources to each of the given targets.
+   *
+   * One Dijkstra search is run per source, the searches are distributed over
+   * multiple threads and share the route nodes loaded. No RouteData or
+   * RouteDescription is built, so this is much cheaper than calling
+   * CalculateRoute() for each pair. Since all threads share the given state,
+   * the router must not modify it.
+   *
+   * @param state
+   *    State to use
+   * @param sources
+   *    Start positions, one row of the result for each of them
+   * @param targets
+   *    Target positions, one column of the result for each of them
+   * @param parameter
+   *    Breaker of the parameter is checked, progress is not reported
+   * @return
+   *    Costs and distances for each pair of source and target
+   */
+  template <class RoutingState>
+  RoutingMatrixResult AbstractRoutingService<RoutingState>::CalculateMatrix(RoutingState& state,
+                                                                            const std::vector<RoutePosition>& sources,
+                                                                            const std::vector<RoutePosition>& targets,
+                                                                            const RoutingParameter& parameter)
+  {
+    RoutingMatrixResult result(sources.size(),
+                               targets.size());
+    MatrixTargetMap     targetMap;
+    RouteNodeBatch      batch;
+    std::atomic<bool>   success(true);
+    StopClock           clock;
+
+    if (!GetMatrixTargets(state,
+                          targets,
+                          targetMap)) {
+      return result;
+    }
+
+    size_t threadCount=ProcessInParallel(sources.size(),
+                                         success,
+                                         [&](size_t sourceIndex) {
+                                           return CalculateMatrixRow(state,
+                                                                     sourceIndex,
+                                                                     sources[sourceIndex],
+                                                                     targets,
+                                                                     targetMap,
+                                                                     parameter,
+                                                                     batch,
+                                                                     result);
+                                         });
+
+    clock.Stop();
+
+    if (debugPerformance) {
+      std::cout << "Matrix:              " << sources.size() << "x" << targets.size() << std::endl;
+      std::cout << "Threads:             " << threadCount << std::endl;
+      std::cout << "Time:                " << clock << std::endl;
+    }
+
+    result.SetSuccess(success);
+
+    return result;
+  }
+
+  /**
+   * Calculate all route nodes reachable from the given center within the
+   * maximum cost of the given result, using a Dijkstra search that stops
+   * at the first node with larger costs.
+   *
+   * @return
+   *    False in case of technical errors or if the calculation was aborted,
+   *    else true
+   */
+  template <class RoutingState>
+  bool AbstractRoutingService<RoutingState>::CalculateReachabilityFrom(const RoutingState& state,
+                                                                       const RoutePosition& center,
+                                                                       const RoutingParameter& parameter,
+                                                                       RouteNodeBatch& batch,
+                                                                       ReachabilityResult& result)
+  {
+    Vehicle                          vehicle=GetVehicle(state);
+    RoutingSearchSpaceRef            searchSpace=AcquireSearchSpace();
+    GeoCoord                         centerCoord;
+    RouteNodeRef                     startForwardRouteNode;
+    RouteNodeRef                     startBackwardRouteNode;
+    RNodeRef                         startForwardNode=nullptr;
+    RNodeRef                         startBackwardNode=nullptr;
+    std::unordered_map<DBId,size_t>  nodeIndexes;
+
+    if (!GetStartNodes(state,
+                       center,
+                       centerCoord,
+                       GeoCoord(),
+                       startForwardRouteNode,
+                       startBackwardRouteNode,
+                       searchSpace->nodePool,
+                       startForwardNode,
+                       startBackwardNode)) {
+      // Nothing reachable from this center, but no reason to stop the other centers
+      return true;
+    }
+
+    size_t centerIndex=result.AddNode(DBId(),
+                                      centerCoord,
+                                      0.0,
+                                      Distance());
+
+    for (const auto& startNode : {startForwardNode, startBackwardNode}) {
+      if (startNode!=nullptr) {
+        startNode->estimateCost=0.0;
+        startNode->overallCost=startNode->currentCost;
+
+        result.AddEdge(centerIndex,
+                       startNode->node->GetCoord(),
+                       startNode->currentCost);
+
+        searchSpace->openList.Push(startNode);
+        searchSpace->openMap.Insert(startNode);
+      }
+    }
+
+    while (!searchSpace->openList.Empty() &&
+           searchSpace->openList.Top()->currentCost<=result.GetMaxCost()) {
+      if (parameter.GetBreaker() &&
+          parameter.GetBreaker()->IsAborted()) {
+        return false;
+      }
+
+      RNodeRef current=searchSpace->openList.Top();
+
+      searchSpace->openMap.Erase(current->id);
+      searchSpace->openList.Pop();
+
+      // A node may be reached with and without access restriction, keep the cheaper one
+      auto   nodeIndex=nodeIndexes.find(current->id);
+      size_t currentIndex;
+
+      if (nodeIndex!=nodeIndexes.end()) {
+        currentIndex=nodeIndex->second;
+      }
+      else {
+        currentIndex=result.AddNode(current->id,
+                                    current->node->GetCoord(),
+                                    current->currentCost,
+                                    current->distance);
+        nodeIndexes.emplace(current->id,currentIndex);
+      }
+
+      double currentCost=current->currentCost;
+
+      if (!ExpandRouteNode(state,
+                           vehicle,
+                           current,
+                           *searchSpace,
+                           batch,
+                           [&result,currentIndex,currentCost](const RouteNodeRef& routeNode, double cost) {
+                             result.AddEdge(currentIndex,
+                                            routeNode->GetCoord(),
+                                            cost-currentCost);
+                           }) ||
+          !CloseRouteNode(state,
+                          current,
+                          *searchSpace)) {
+        return false;
+      }
+    }
+
+    result.SetSuccess(true);
+
+    return true;
+  }
+
+  /**
+   * Calculate all route nodes reachable from the given center within the
+   * given maximum cost ("one to all"). The result can be turned into
+   * isochrone polygons for any cost up to the maximum cost.
+   *
+   * @param state
+   *    State to use
+   * @param center
+   *    Start position
+   * @param maxCost
+   *    Maximum cost, in the unit of the routing profile
+   * @param parameter
+   *    Breaker of the parameter is checked, progress is not reported
+   * @return
+   *    The reachable route nodes, not successful if there is no route node
+   *    next to the center or the calculation was aborted
+   */
+  template <class RoutingState>
+  ReachabilityResult AbstractRoutingService<RoutingState>::CalculateReachability(RoutingState& state,
+                                                                                 const RoutePosition& center,
+                                                                                 double maxCost,
+                                                                                 const RoutingParameter& parameter)
+  {
+    RouteNodeBatch     batch;
+    ReachabilityResult result(maxCost);
+
+    if (!CalculateReachabilityFrom(state,
+                                   center,
+                                   parameter,
+                                   batch,
+                                   result)) {
+      result.SetSuccess(false);
+    }
+
+    return result;
+  }
+
+  /**
+   * Calculate all route nodes reachable from each of the given centers
+   * within the given maximum cost, see the single center version.
+   *
+   * The centers are distributed over multiple threads, which share the
+   * route nodes loaded. Since all threads share the given state, the router
+   * must not modify it.
+   *
+   * @return
+   *    One result for each center
+   */
+  template <class RoutingState>
+  std::vector<ReachabilityResult> AbstractRoutingService<RoutingState>::CalculateReachability(RoutingState& state,
+                                                                                              const std::vector<RoutePosition>& centers,
+                                                                                              double maxCost,
+                                                                                              const RoutingParameter& parameter)
+  {
+    std::vector<ReachabilityResult> results(centers.size(),
+                                            ReachabilityResult(maxCost));
+    RouteNodeBatch                  batch;
+    std::atomic<bool>               success(true);
+    StopClock                       clock;
+
+    size_t threadCount=ProcessInParallel(centers.size(),
+                                         success,
+                                         [&](size_t centerIndex) {
+                                           return CalculateReachabilityFrom(state,
+                                                                            centers[centerIndex],
+                                                                            parameter,
+                                                                            batch,
+                                                                            results[centerIndex]);
+                                         });
+
+    clock.Stop();
+
+    if (debugPerformance) {
+      std::cout << "Reachability:        " << centers.size() << " centers" << std::endl;
+      std::cout << "Threads:             " << threadCount << std::endl;
+      std::cout << "Time:                " << clock << std::endl;
+    }
+
+    if (!success) {
+      for (auto& result : results) {
+        result.SetSuccess(false);
+      }
+    }
+
+    return results;
+  }
+
   template <class RoutingState>
   void AbstractRoutingService<RoutingState>::AddNodes(RouteData& route,
                                                       DatabaseId database,
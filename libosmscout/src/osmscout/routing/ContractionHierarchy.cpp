@@ -0,0 +1,474 @@
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2026  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <osmscout/routing/ContractionHierarchy.h>
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+#include <unordered_map>
+
+#include <osmscout/util/FileScanner.h>
+#include <osmscout/util/Logger.h>
+
+namespace osmscout {
+
+  /**
+   * Load the contraction hierarchy from the given file.
+   *
+   * @param filename
+   *    Name of the file as generated by the importer
+   * @param vehicle
+   *    The vehicle the hierarchy was generated for
+   * @return
+   *    True on success, else false
+   */
+  bool ContractionHierarchy::Load(const std::string& filename,
+                                  Vehicle vehicle)
+  {
+    FileScanner scanner;
+
+    this->vehicle=vehicle;
+
+    ids.clear();
+    idRanks.clear();
+    edgeOffsets.clear();
+    edgeTargets.clear();
+    arcOffsets.clear();
+    arcs.clear();
+
+    try {
+      scanner.Open(filename,
+                   FileScanner::Sequential,
+                   true);
+
+      uint32_t nodeCount=scanner.ReadUInt32();
+
+      ids.resize(nodeCount);
+      idRanks.resize(nodeCount);
+
+      for (uint32_t rank=0; rank<nodeCount; rank++) {
+        ids[rank]=scanner.ReadUInt64Number();
+        idRanks[rank]=std::make_pair(ids[rank],rank);
+      }
+
+      std::sort(idRanks.begin(),idRanks.end());
+
+      edgeOffsets.resize(nodeCount+1);
+
+      for (uint32_t rank=0; rank<nodeCount; rank++) {
+        uint32_t edgeCount=scanner.ReadUInt32Number();
+        uint32_t target=rank;
+
+        edgeOffsets[rank]=(uint32_t)edgeTargets.size();
+
+        for (uint32_t e=0; e<edgeCount; e++) {
+          target+=scanner.ReadUInt32Number();
+
+          if (target>=nodeCount) {
+            throw IOException(filename,"Cannot load contraction hierarchy","Edge target out of range");
+          }
+
+          edgeTargets.push_back(target);
+        }
+      }
+
+      edgeOffsets[nodeCount]=(uint32_t)edgeTargets.size();
+
+      arcOffsets.resize(edgeTargets.size()+1);
+
+      for (size_t e=0; e<edgeTargets.size(); e++) {
+        uint32_t arcCount=scanner.ReadUInt32Number();
+
+        arcOffsets[e]=(uint32_t)arcs.size();
+
+        for (uint32_t a=0; a<arcCount; a++) {
+          Arc arc;
+
+          arc.upward=scanner.ReadUInt8()!=0;
+          arc.object=scanner.ReadObjectFileRef();
+          arc.objectVariantIndex=scanner.ReadUInt16Number();
+          arc.flags=scanner.ReadUInt8();
+          arc.distance=Distance::Of<Kilometer>(scanner.ReadUInt32Number()/(1000.0*100.0));
+
+          arcs.push_back(arc);
+        }
+      }
+
+      arcOffsets[edgeTargets.size()]=(uint32_t)arcs.size();
+
+      scanner.Close();
+    }
+    catch (const IOException& e) {
+      log.Error() << e.GetDescription();
+      scanner.CloseFailsafe();
+
+      ids.clear();
+      idRanks.clear();
+
+      return false;
+    }
+
+    return true;
+  }
+
+  /**
+   * Return the rank of the route node with the given id or noRank, if the
+   * route node is not part of the hierarchy.
+   */
+  uint32_t ContractionHierarchy::GetRank(Id id) const
+  {
+    auto entry=std::lower_bound(idRanks.begin(),
+                                idRanks.end(),
+                                std::make_pair(id,(uint32_t)0));
+
+    if (entry==idRanks.end() ||
+        entry->first!=id) {
+      return noRank;
+    }
+
+    return entry->second;
+  }
+
+  /**
+   * Return the index of the edge between the two given nodes or
+   * GetEdgeCount(), if there is no such edge.
+   */
+  size_t ContractionHierarchy::FindEdge(uint32_t lower,
+                                        uint32_t higher) const
+  {
+    auto begin=edgeTargets.begin()+edgeOffsets[lower];
+    auto end=edgeTargets.begin()+edgeOffsets[lower+1];
+    auto edge=std::lower_bound(begin,end,higher);
+
+    if (edge==end ||
+        *edge!=higher) {
+      return edgeTargets.size();
+    }
+
+    return edge-edgeTargets.begin();
+  }
+
+  /**
+   * Calculate the costs of all edges of the hierarchy for the given profile.
+   *
+   * Original paths get their costs from the profile (without junction
+   * penalties, since the hierarchy does not know the incoming path), shortcuts
+   * are then resolved bottom up: each lower triangle (l,h1,h2) of an edge
+   * (h1,h2) is a potential detour via the lower ranked node l.
+   */
+  ContractionHierarchy::MetricRef ContractionHierarchy::Customize(const RoutingProfile& profile,
+                                                                  const std::vector<ObjectVariantData>& objectVariantData) const
+  {
+    auto      metric=std::make_shared<Metric>();
+    size_t    edgeCount=edgeTargets.size();
+    double    infinity=std::numeric_limits<double>::infinity();
+    RouteNode node;
+
+    metric->upCosts.assign(edgeCount,infinity);
+    metric->downCosts.assign(edgeCount,infinity);
+    metric->upVias.assign(edgeCount,noRank);
+    metric->downVias.assign(edgeCount,noRank);
+    metric->upArcs.assign(edgeCount,noRank);
+    metric->downArcs.assign(edgeCount,noRank);
+
+    node.objects.resize(1);
+    node.paths.resize(1);
+    node.paths[0].id=0;
+    node.paths[0].objectIndex=0;
+
+    for (size_t e=0; e<edgeCount; e++) {
+      for (uint32_t a=arcOffsets[e]; a<arcOffsets[e+1]; a++) {
+        const Arc& arc=arcs[a];
+
+        if (arc.objectVariantIndex>=objectVariantData.size()) {
+          continue;
+        }
+
+        node.objects[0].object=arc.object;
+        node.objects[0].objectVariantIndex=arc.objectVariantIndex;
+        node.paths[0].distance=arc.distance;
+        node.paths[0].flags=arc.flags;
+
+        if (!profile.CanUse(node,objectVariantData,0)) {
+          continue;
+        }
+
+        double cost=profile.GetCosts(node,objectVariantData,0,0);
+
+        if (arc.upward) {
+          if (cost<metric->upCosts[e]) {
+            metric->upCosts[e]=cost;
+            metric->upArcs[e]=a;
+          }
+        }
+        else if (cost<metric->downCosts[e]) {
+          metric->downCosts[e]=cost;
+          metric->downArcs[e]=a;
+        }
+      }
+    }
+
+    for (uint32_t lower=0; lower<ids.size(); lower++) {
+      for (uint32_t i=edgeOffsets[lower]; i<edgeOffsets[lower+1]; i++) {
+        uint32_t h1=edgeTargets[i];
+        uint32_t candidate=edgeOffsets[h1];
+
+        for (uint32_t j=i+1; j<edgeOffsets[lower+1]; j++) {
+          uint32_t h2=edgeTargets[j];
+
+          // Both lists are sorted, so we can merge instead of searching
+          while (candidate<edgeOffsets[h1+1] &&
+                 edgeTargets[candidate]<h2) {
+            candidate++;
+          }
+
+          if (candidate==edgeOffsets[h1+1] ||
+              edgeTargets[candidate]!=h2) {
+            // Cannot happen for a hierarchy generated by the importer
+            continue;
+          }
+
+          double up=metric->downCosts[i]+metric->upCosts[j];
+          double down=metric->downCosts[j]+metric->upCosts[i];
+
+          if (up<metric->upCosts[candidate]) {
+            metric->upCosts[candidate]=up;
+            metric->upVias[candidate]=lower;
+          }
+
+          if (down<metric->downCosts[candidate]) {
+            metric->downCosts[candidate]=down;
+            metric->downVias[candidate]=lower;
+          }
+        }
+      }
+    }
+
+    return metric;
+  }
+
+  /**
+   * Find the cheapest route from one of the sources (with their initial
+   * costs) to one of the targets using a bidirectional upward search and
+   * unpack it to the original route nodes.
+   *
+   * @param metric
+   *    Costs of the edges as returned by Customize()
+   * @param sources
+   *    Ids of the start route nodes and the costs to reach them
+   * @param targets
+   *    Ids of the target route nodes
+   * @param maxCost
+   *    Routes with higher costs are not searched for
+   * @param breaker
+   *    Optional breaker, checked while searching
+   * @param source
+   *    The source route node the route starts with
+   * @param route
+   *    The route nodes following the source route node
+   * @return
+   *    True, if a route was found, else false (also if the search was aborted)
+   */
+  bool ContractionHierarchy::FindRoute(const Metric& metric,
+                                       const std::vector<std::pair<Id,double>>& sources,
+                                       const std::vector<Id>& targets,
+                                       double maxCost,
+                                       const BreakerRef& breaker,
+                                       Id& source,
+                                       std::vector<RouteStep>& route) const
+  {
+    struct Label
+    {
+      double   cost;
+      uint32_t parent;
+      bool     settled;
+    };
+
+    using QueueEntry = std::pair<double,uint32_t>;
+    using Queue      = std::priority_queue<QueueEntry,std::vector<QueueEntry>,std::greater<>>;
+
+    std::unordered_map<uint32_t,Label> labels[2];
+    Queue                              queues[2];
+    double                             best=maxCost;
+    uint32_t                           meeting=noRank;
+    size_t                             settledCount=0;
+
+    route.clear();
+
+    labels[0].reserve(1000);
+    labels[1].reserve(1000);
+
+    for (const auto& entry : sources) {
+      uint32_t rank=GetRank(entry.first);
+
+      if (rank==noRank) {
+        continue;
+      }
+
+      auto label=labels[0].find(rank);
+
+      if (label==labels[0].end() ||
+          entry.second<label->second.cost) {
+        labels[0][rank]=Label{entry.second,noRank,false};
+        queues[0].emplace(entry.second,rank);
+      }
+    }
+
+    for (const auto& id : targets) {
+      uint32_t rank=GetRank(id);
+
+      if (rank==noRank) {
+        continue;
+      }
+
+      labels[1][rank]=Label{0.0,noRank,false};
+      queues[1].emplace(0.0,rank);
+    }
+
+    size_t direction=1;
+
+    while (!queues[0].empty() || !queues[1].empty()) {
+      if (queues[1-direction].empty()) {
+        // continue with the current direction
+      }
+      else if (queues[direction].empty() ||
+               queues[1-direction].top().first<queues[direction].top().first) {
+        direction=1-direction;
+      }
+
+      Queue&                              queue=queues[direction];
+      std::unordered_map<uint32_t,Label>& own=labels[direction];
+      std::unordered_map<uint32_t,Label>& other=labels[1-direction];
+      QueueEntry                          current=queue.top();
+
+      queue.pop();
+
+      if (current.first>=best) {
+        // The cheaper direction cannot improve the route anymore
+        break;
+      }
+
+      Label& label=own[current.second];
+
+      if (label.settled ||
+          label.cost<current.first) {
+        continue;
+      }
+
+      label.settled=true;
+
+      if (breaker &&
+          ++settledCount%1000==0 &&
+          breaker->IsAborted()) {
+        return false;
+      }
+
+      auto meet=other.find(current.second);
+
+      if (meet!=other.end() &&
+          label.cost+meet->second.cost<best) {
+        best=label.cost+meet->second.cost;
+        meeting=current.second;
+      }
+
+      const std::vector<double>& costs=direction==0 ? metric.upCosts : metric.downCosts;
+
+      for (uint32_t e=edgeOffsets[current.second]; e<edgeOffsets[current.second+1]; e++) {
+        double cost=current.first+costs[e];
+
+        if (cost>=best) {
+          continue;
+        }
+
+        uint32_t target=edgeTargets[e];
+        auto     entry=own.find(target);
+
+        if (entry==own.end()) {
+          own.emplace(target,Label{cost,current.second,false});
+          queue.emplace(cost,target);
+        }
+        else if (!entry->second.settled &&
+                 cost<entry->second.cost) {
+          entry->second.cost=cost;
+          entry->second.parent=current.second;
+          queue.emplace(cost,target);
+        }
+      }
+    }
+
+    if (meeting==noRank) {
+      return false;
+    }
+
+    // Sequence of hierarchy nodes from the source via the meeting node to the target
+    std::vector<uint32_t> path;
+
+    for (uint32_t rank=meeting; rank!=noRank; rank=labels[0][rank].parent) {
+      path.push_back(rank);
+    }
+
+    std::reverse(path.begin(),path.end());
+
+    for (uint32_t rank=labels[1][meeting].parent; rank!=noRank; rank=labels[1][rank].parent) {
+      path.push_back(rank);
+    }
+
+    source=ids[path.front()];
+
+    // Recursively replace shortcuts by the two edges they bypass
+    std::vector<std::pair<uint32_t,uint32_t>> stack;
+
+    for (size_t i=path.size()-1; i>0; i--) {
+      stack.emplace_back(path[i-1],path[i]);
+    }
+
+    while (!stack.empty()) {
+      auto [from,to]=stack.back();
+      bool upward=from<to;
+      size_t edge=upward ? FindEdge(from,to) : FindEdge(to,from);
+
+      stack.pop_back();
+
+      if (edge==edgeTargets.size()) {
+        log.Error() << "Cannot unpack contraction hierarchy edge " << ids[from] << " => " << ids[to];
+        return false;
+      }
+
+      uint32_t via=upward ? metric.upVias[edge] : metric.downVias[edge];
+
+      if (via!=noRank) {
+        stack.emplace_back(via,to);
+        stack.emplace_back(from,via);
+        continue;
+      }
+
+      uint32_t arc=upward ? metric.upArcs[edge] : metric.downArcs[edge];
+
+      if (arc==noRank) {
+        log.Error() << "Cannot unpack contraction hierarchy edge " << ids[from] << " => " << ids[to];
+        return false;
+      }
+
+      route.push_back(RouteStep{ids[to],arcs[arc].object});
+    }
+
+    return true;
+  }
+}
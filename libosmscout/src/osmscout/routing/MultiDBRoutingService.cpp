@@ -40,7 +40,8 @@ namespace osmscout {
 
   MultiDBRoutingService::MultiDBRoutingService(const RouterParameter& parameter,
                                                const std::vector<DatabaseRef> &databases):
-    AbstractRoutingService<MultiDBRoutingState>(parameter)
+    AbstractRoutingService<MultiDBRoutingState>(parameter),
+    useContractionHierarchy(parameter.IsContractionHierarchy())
   {
     this->handles.resize(databases.size());
 
@@ -66,6 +67,7 @@ namespace osmscout {
 
     RouterParameter routerParameter;
     routerParameter.SetDebugPerformance(debugPerformance);
+    routerParameter.SetContractionHierarchy(useContractionHierarchy);
 
     isOpen=true;
     for (auto& handle : handles) {
@@ -81,6 +83,13 @@ namespace osmscout {
       handle.router=router;
       handle.profile=profileBuilder(handle.database);
 
+      // Contraction hierarchies do not span databases
+      if (useContractionHierarchy &&
+          handles.size()==1 &&
+          handle.profile) {
+        router->PrepareContractionHierarchy(handle.profile);
+      }
+
       RoutingDatabaseRef routingDatabase=std::make_shared<RoutingDatabase>();
       if (!routingDatabase->Open(handle.database)) {
         Close();
@@ -355,6 +364,34 @@ namespace osmscout {
     return twins;
   }
 
+  bool MultiDBRoutingService::CalculateRouteNodeChain(const MultiDBRoutingState& /*state*/,
+                                                      const RoutePosition& start,
+                                                      const RoutePosition& target,
+                                                      const RNodeRef& startForwardNode,
+                                                      const RNodeRef& startBackwardNode,
+                                                      const RouteNodeRef& targetForwardRouteNode,
+                                                      const RouteNodeRef& targetBackwardRouteNode,
+                                                      const RoutingParameter& parameter,
+                                                      double costLimit,
+                                                      std::list<VNode>& nodes)
+  {
+    if (handles.size()!=1 ||
+        start.GetDatabaseId()!=target.GetDatabaseId()) {
+      return false;
+    }
+
+    const DatabaseHandle& handle=handles[start.GetDatabaseId()];
+
+    return handle.router->CalculateContractionHierarchyRoute(*handle.profile,
+                                                             startForwardNode,
+                                                             startBackwardNode,
+                                                             targetForwardRouteNode,
+                                                             targetBackwardRouteNode,
+                                                             parameter,
+                                                             costLimit,
+                                                             nodes);
+  }
+
   RoutingResult MultiDBRoutingService::CalculateRoute(const RoutePosition &start,
                                                       const RoutePosition &target,
                                                       const RoutingParameter &parameter)
@@ -397,6 +434,136 @@ namespace osmscout {
                                                                        parameter);
   }
 
+  /**
+   * Add the databases of the given positions to the given set
+   *
+   * @return
+   *    False, if one of the databases is unknown, else true
+   */
+  bool MultiDBRoutingService::GetPositionDatabases(const std::vector<RoutePosition>& positions,
+                                                   std::set<DatabaseId>& databases) const
+  {
+    for (const auto& position : positions) {
+      DatabaseId dbId=position.GetDatabaseId();
+
+      if (dbId>=handles.size() ||
+          !handles[dbId].database) {
+        log.Error() << "Can't find database " << dbId;
+        return false;
+      }
+
+      databases.insert(dbId);
+    }
+
+    return true;
+  }
+
+  /**
+   * Calculate the costs and the distances of the cheapest routes from each of
+   * the given sources to each of the given targets, see
+   * AbstractRoutingService::CalculateMatrix().
+   *
+   * @param sources
+   *    Start positions, one row of the result for each of them
+   * @param targets
+   *    Target positions, one column of the result for each of them
+   * @param parameter
+   *    A RoutingParamater object
+   * @return
+   *    A RoutingMatrixResult object
+   */
+  RoutingMatrixResult MultiDBRoutingService::CalculateMatrix(const std::vector<RoutePosition>& sources,
+                                                             const std::vector<RoutePosition>& targets,
+                                                             const RoutingParameter& parameter)
+  {
+    std::set<DatabaseId> databases;
+
+    if (!GetPositionDatabases(sources,databases) ||
+        !GetPositionDatabases(targets,databases)) {
+      return RoutingMatrixResult(sources.size(),
+                                 targets.size());
+    }
+
+    // All positions are in the same database, no need to look for common route nodes
+    if (databases.size()==1) {
+      const DatabaseHandle& handle=handles[*databases.begin()];
+
+      return handle.router->CalculateMatrix(*handle.profile,
+                                            sources,
+                                            targets,
+                                            parameter);
+    }
+
+    MultiDBRoutingState state;
+    return AbstractRoutingService<MultiDBRoutingState>::CalculateMatrix(state,
+                                                                        sources,
+                                                                        targets,
+                                                                        parameter);
+  }
+
+  /**
+   * Calculate all route nodes reachable from the given center within the
+   * given maximum cost, see AbstractRoutingService::CalculateReachability().
+   *
+   * @param center
+   *    Start position
+   * @param maxCost
+   *    Maximum cost, in the unit of the routing profile
+   * @param parameter
+   *    A RoutingParamater object
+   * @return
+   *    A ReachabilityResult object
+   */
+  ReachabilityResult MultiDBRoutingService::CalculateReachability(const RoutePosition& center,
+                                                                  double maxCost,
+                                                                  const RoutingParameter& parameter)
+  {
+    return CalculateReachability(std::vector<RoutePosition>{center},
+                                 maxCost,
+                                 parameter).front();
+  }
+
+  /**
+   * Calculate all route nodes reachable from each of the given centers within
+   * the given maximum cost, see AbstractRoutingService::CalculateReachability().
+   *
+   * @param centers
+   *    Start positions, one result for each of them
+   * @param maxCost
+   *    Maximum cost, in the unit of the routing profile
+   * @param parameter
+   *    A RoutingParamater object
+   * @return
+   *    A ReachabilityResult object for each center
+   */
+  std::vector<ReachabilityResult> MultiDBRoutingService::CalculateReachability(const std::vector<RoutePosition>& centers,
+                                                                               double maxCost,
+                                                                               const RoutingParameter& parameter)
+  {
+    std::set<DatabaseId> databases;
+
+    if (!GetPositionDatabases(centers,databases)) {
+      return std::vector<ReachabilityResult>(centers.size(),
+                                             ReachabilityResult(maxCost));
+    }
+
+    // All centers are in the same database, no need to look for common route nodes
+    if (databases.size()==1) {
+      const DatabaseHandle& handle=handles[*databases.begin()];
+
+      return handle.router->CalculateReachability(*handle.profile,
+                                                  centers,
+                                                  maxCost,
+                                                  parameter);
+    }
+
+    MultiDBRoutingState state;
+    return AbstractRoutingService<MultiDBRoutingState>::CalculateReachability(state,
+                                                                              centers,
+                                                                              maxCost,
+                                                                              parameter);
+  }
+
     /**
      * Calculate a route going through all the via points
      *
@@ -0,0 +1,344 @@
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2026  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <osmscout/routing/Reachability.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+
+#include <osmscout/util/Geometry.h>
+
+namespace osmscout {
+
+  //! Length of one degree of latitude in meter
+  static constexpr double metersPerDegree=111320.0;
+
+  //! Maximum number of cells of the raster used for calculating an isochrone
+  static constexpr size_t maxIsochroneCells=16*1024*1024;
+
+  Isochrone::Isochrone(double cost,
+                       const std::vector<Ring>& rings)
+  : cost(cost),
+    rings(rings)
+  {
+    // no code
+  }
+
+  ReachabilityResult::ReachabilityResult(double maxCost)
+  : maxCost(maxCost)
+  {
+    // no code
+  }
+
+  /**
+   * Trace the outlines of the filled cells of the given raster. Each boundary
+   * side of a filled cell becomes a directed edge between two cell corners
+   * with the filled cell on its left side, chaining these edges results in
+   * counterclockwise outer rings and clockwise holes.
+   */
+  static std::vector<std::vector<std::pair<size_t,size_t>>> TraceRasterOutlines(const std::vector<bool>& raster,
+                                                                                 size_t width,
+                                                                                 size_t height)
+  {
+    // Directions: east, north, west, south
+    static const long dx[]={1,0,-1,0};
+    static const long dy[]={0,1,0,-1};
+
+    auto isFilled=[&raster,width,height](long x, long y) {
+      return x>=0 && y>=0 && x<(long)width && y<(long)height && raster[y*width+x];
+    };
+
+    size_t               cornerWidth=width+1;
+    std::vector<uint8_t> outgoing(cornerWidth*(height+1),0);
+
+    for (size_t y=0; y<height; y++) {
+      for (size_t x=0; x<width; x++) {
+        if (!raster[y*width+x]) {
+          continue;
+        }
+
+        if (!isFilled((long)x,(long)y-1)) {
+          outgoing[y*cornerWidth+x]|=1 << 0;
+        }
+
+        if (!isFilled((long)x+1,(long)y)) {
+          outgoing[y*cornerWidth+x+1]|=1 << 1;
+        }
+
+        if (!isFilled((long)x,(long)y+1)) {
+          outgoing[(y+1)*cornerWidth+x+1]|=1 << 2;
+        }
+
+        if (!isFilled((long)x-1,(long)y)) {
+          outgoing[(y+1)*cornerWidth+x]|=1 << 3;
+        }
+      }
+    }
+
+    std::vector<std::vector<std::pair<size_t,size_t>>> outlines;
+
+    for (size_t start=0; start<outgoing.size(); start++) {
+      while (outgoing[start]!=0) {
+        std::vector<std::pair<size_t,size_t>> outline;
+        size_t                                startX=start%cornerWidth;
+        size_t                                startY=start/cornerWidth;
+        size_t                                x=startX;
+        size_t                                y=startY;
+        size_t                                direction=0;
+
+        while ((outgoing[start] & (1 << direction))==0) {
+          direction++;
+        }
+
+        outgoing[start]&=~(1 << direction);
+        outline.emplace_back(x,y);
+
+        while (true) {
+          x+=dx[direction];
+          y+=dy[direction];
+
+          if (x==startX &&
+              y==startY) {
+            break;
+          }
+
+          uint8_t& corner=outgoing[y*cornerWidth+x];
+          size_t   next=4;
+
+          // Prefer turning left, so that cells only touching at a corner get separate outlines
+          for (size_t candidate : {(direction+1)%4, direction, (direction+3)%4}) {
+            if ((corner & (1 << candidate))!=0) {
+              next=candidate;
+              break;
+            }
+          }
+
+          if (next==4) {
+            break;
+          }
+
+          corner&=~(1 << next);
+
+          if (next!=direction) {
+            outline.emplace_back(x,y);
+          }
+
+          direction=next;
+        }
+
+        if (outline.size()>=3) {
+          outlines.push_back(std::move(outline));
+        }
+      }
+    }
+
+    return outlines;
+  }
+
+  /**
+   * Returns true, if the given point (in corner coordinates of the raster)
+   * lies within the given outline. The point must not lie on a raster line.
+   */
+  static bool IsPointInOutline(double x,
+                               double y,
+                               const std::vector<std::pair<size_t,size_t>>& outline)
+  {
+    bool inside=false;
+
+    for (size_t i=0, j=outline.size()-1; i<outline.size(); j=i++) {
+      auto xi=(double)outline[i].first;
+      auto yi=(double)outline[i].second;
+      auto xj=(double)outline[j].first;
+      auto yj=(double)outline[j].second;
+
+      if ((yi>y)!=(yj>y) &&
+          x<(xj-xi)*(y-yi)/(yj-yi)+xi) {
+        inside=!inside;
+      }
+    }
+
+    return inside;
+  }
+
+  /**
+   * Calculate the polygons covering the area reachable within the given cost.
+   *
+   * The reachable part of the road network (the nodes and the part of each
+   * path that can be traveled within the remaining cost) is drawn into a
+   * raster of the given resolution and widened by one cell in each direction.
+   * The outlines of the raster are returned as rings. For large areas the
+   * resolution is reduced, to limit the size of the raster.
+   *
+   * @param cost
+   *    Maximum cost, should not be larger than the maximum cost of the
+   *    reachability calculation
+   * @param resolution
+   *    Size of the raster cells
+   * @return
+   *    The isochrone, empty if no route node is reachable within the cost
+   */
+  Isochrone ReachabilityResult::GetIsochrone(double cost,
+                                             const Distance& resolution) const
+  {
+    std::vector<std::pair<GeoCoord,GeoCoord>> segments;
+
+    for (const auto& node : nodes) {
+      if (node.cost<=cost) {
+        segments.emplace_back(node.coord,node.coord);
+      }
+    }
+
+    for (const auto& edge : edges) {
+      const Node& from=nodes[edge.from];
+
+      if (from.cost>cost) {
+        continue;
+      }
+
+      double fraction=edge.cost>0.0 ? std::min(1.0,(cost-from.cost)/edge.cost) : 1.0;
+
+      segments.emplace_back(from.coord,
+                            GeoCoord(from.coord.GetLat()+(edge.to.GetLat()-from.coord.GetLat())*fraction,
+                                     from.coord.GetLon()+(edge.to.GetLon()-from.coord.GetLon())*fraction));
+    }
+
+    if (segments.empty()) {
+      return Isochrone(cost,{});
+    }
+
+    GeoBox boundingBox;
+
+    for (const auto& segment : segments) {
+      boundingBox.Include(segment.first);
+      boundingBox.Include(segment.second);
+    }
+
+    double cellLat=std::max(resolution.As<Meter>(),1.0)/metersPerDegree;
+    double cellLon=cellLat/std::max(0.01,std::cos(DegToRad(boundingBox.GetCenter().GetLat())));
+    double cellCount=(boundingBox.GetHeight()/cellLat+3)*(boundingBox.GetWidth()/cellLon+3);
+
+    if (cellCount>maxIsochroneCells) {
+      double factor=std::sqrt(cellCount/maxIsochroneCells);
+
+      cellLat*=factor;
+      cellLon*=factor;
+    }
+
+    // One cell of margin on each side for widening the network
+    double originLat=boundingBox.GetMinLat()-cellLat;
+    double originLon=boundingBox.GetMinLon()-cellLon;
+    size_t width=(size_t)(boundingBox.GetWidth()/cellLon)+3;
+    size_t height=(size_t)(boundingBox.GetHeight()/cellLat)+3;
+
+    std::vector<bool> network(width*height,false);
+
+    auto mark=[&](double lat, double lon) {
+      size_t x=std::clamp((size_t)((lon-originLon)/cellLon),(size_t)1,width-2);
+      size_t y=std::clamp((size_t)((lat-originLat)/cellLat),(size_t)1,height-2);
+
+      network[y*width+x]=true;
+    };
+
+    for (const auto& segment : segments) {
+      double latDelta=segment.second.GetLat()-segment.first.GetLat();
+      double lonDelta=segment.second.GetLon()-segment.first.GetLon();
+      size_t steps=(size_t)std::ceil(2*std::max(std::abs(latDelta)/cellLat,
+                                                std::abs(lonDelta)/cellLon));
+
+      for (size_t step=0; step<=steps; step++) {
+        double fraction=steps>0 ? (double)step/(double)steps : 0.0;
+
+        mark(segment.first.GetLat()+latDelta*fraction,
+             segment.first.GetLon()+lonDelta*fraction);
+      }
+    }
+
+    std::vector<bool> raster(width*height,false);
+
+    for (size_t y=1; y+1<height; y++) {
+      for (size_t x=1; x+1<width; x++) {
+        if (network[y*width+x]) {
+          for (size_t ry=y-1; ry<=y+1; ry++) {
+            for (size_t rx=x-1; rx<=x+1; rx++) {
+              raster[ry*width+rx]=true;
+            }
+          }
+        }
+      }
+    }
+
+    std::vector<Isochrone::Ring>                       rings;
+    std::vector<double>                                areas;
+    std::vector<std::vector<std::pair<size_t,size_t>>> outlines=TraceRasterOutlines(raster,width,height);
+
+    for (const auto& outline : outlines) {
+      Isochrone::Ring ring;
+      double          area=0.0;
+
+      ring.coords.reserve(outline.size());
+
+      for (size_t i=0; i<outline.size(); i++) {
+        const auto& current=outline[i];
+        const auto& next=outline[(i+1)%outline.size()];
+
+        area+=(double)current.first*(double)next.second-(double)next.first*(double)current.second;
+
+        ring.coords.emplace_back(originLat+current.second*cellLat,
+                                 originLon+current.first*cellLon);
+      }
+
+      ring.outer=area>0.0;
+      ring.outerRing=rings.size();
+
+      areas.push_back(std::abs(area));
+      rings.push_back(std::move(ring));
+    }
+
+    // Each hole belongs to the smallest outer ring containing the filled cell
+    // left of its first edge (islands within holes have their own outer rings)
+    for (size_t hole=0; hole<rings.size(); hole++) {
+      if (rings[hole].outer) {
+        continue;
+      }
+
+      const auto& first=outlines[hole][0];
+      const auto& second=outlines[hole][1];
+      double      dirX=second.first>first.first ? 1.0 : (second.first<first.first ? -1.0 : 0.0);
+      double      dirY=second.second>first.second ? 1.0 : (second.second<first.second ? -1.0 : 0.0);
+      double      cellX=first.first+0.5*dirX-0.5*dirY;
+      double      cellY=first.second+0.5*dirY+0.5*dirX;
+      double      smallestArea=std::numeric_limits<double>::max();
+
+      for (size_t outer=0; outer<rings.size(); outer++) {
+        if (rings[outer].outer &&
+            areas[outer]<smallestArea &&
+            IsPointInOutline(cellX,
+                             cellY,
+                             outlines[outer])) {
+          rings[hole].outerRing=outer;
+          smallestArea=areas[outer];
+        }
+      }
+    }
+
+    return Isochrone(cost,rings);
+  }
+}
@@ -136,6 +136,9 @@ namespace osmscout {
     return true;
   }
 
+  /**
+   * Method is NOT thread-safe, accessMutex must be locked by the caller.
+   */
   bool RouteNodeDataFile::LoadIndexPage(const osmscout::Pixel& tile,
                                         ValueCache::CacheRef& cacheRef) const
   {
@@ -157,6 +160,9 @@ namespace osmscout {
     return true;
   }
 
+  /**
+   * Method is NOT thread-safe, accessMutex must be locked by the caller.
+   */
   bool RouteNodeDataFile::GetIndexPage(const osmscout::Pixel& tile,
                                        ValueCache::CacheRef& cacheRef) const
   {
@@ -172,9 +178,16 @@ namespace osmscout {
     return true;
   }
 
+  /**
+   * Return the route node with the given id.
+   *
+   * Method is thread-safe.
+   */
   bool RouteNodeDataFile::Get(Id id,
                               RouteNodeRef& node) const
   {
+    std::scoped_lock<std::mutex> lock(accessMutex);
+
     //std::cout << "Loading RouteNode " << id << "..." << std::endl;
     ValueCache::CacheRef cacheRef;
 
@@ -63,11 +63,15 @@ namespace osmscout {
       vehicleRouteNodeBit=RouteNode::usableByCar;
       break;
     }
+
+    Changed();
   }
 
   void AbstractRoutingProfile::SetVehicleMaxSpeed(double maxSpeed)
   {
     vehicleMaxSpeed=maxSpeed;
+
+    Changed();
   }
 
   /**
@@ -79,6 +83,8 @@ namespace osmscout {
   void AbstractRoutingProfile::SetCostLimitDistance(const Distance &costLimitDistance)
   {
     this->costLimitDistance=costLimitDistance;
+
+    Changed();
   }
 
   /**
@@ -107,6 +113,8 @@ namespace osmscout {
   void AbstractRoutingProfile::SetCostLimitFactor(double costLimitFactor)
   {
     this->costLimitFactor=costLimitFactor;
+
+    Changed();
   }
 
   void AbstractRoutingProfile::ParametrizeForFoot(const TypeConfig& typeConfig,
@@ -189,6 +197,8 @@ namespace osmscout {
     }
 
     speeds[type->GetIndex()]=speed;
+
+    Changed();
   }
 
   void AbstractRoutingProfile::AddType(const TypeInfoRef &type,
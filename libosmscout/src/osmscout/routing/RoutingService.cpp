@@ -51,7 +51,8 @@ namespace osmscout {
   }
 
   RouterParameter::RouterParameter()
-  : debugPerformance(false)
+  : debugPerformance(false),
+    contractionHierarchy(false)
   {
     // no code
   }
@@ -66,6 +67,25 @@ namespace osmscout {
     return debugPerformance;
   }
 
+  /**
+   * If set, the router loads the contraction hierarchies generated by the
+   * importer (if available) and uses them for routing with each profile the
+   * hierarchy was prepared for. Default is false.
+   *
+   * The hierarchy neither models junction penalties nor access restrictions
+   * beside the start and target, so routes may differ from the A* search.
+   * Profiles with junction penalties always use the A* search.
+   */
+  void RouterParameter::SetContractionHierarchy(bool contractionHierarchy)
+  {
+    this->contractionHierarchy=contractionHierarchy;
+  }
+
+  bool RouterParameter::IsContractionHierarchy() const
+  {
+    return contractionHierarchy;
+  }
+
   void RoutingParameter::SetBreaker(const BreakerRef& breaker)
   {
     this->breaker=breaker;
@@ -91,6 +111,21 @@ namespace osmscout {
     return filenamebase+".idx";
   }
 
+  std::string RoutingService::GetContractionHierarchyFilename(const std::string& filenamebase,
+                                                              Vehicle vehicle)
+  {
+    switch (vehicle) {
+    case vehicleFoot:
+      return filenamebase+"-ch-foot.dat";
+    case vehicleBicycle:
+      return filenamebase+"-ch-bicycle.dat";
+    case vehicleCar:
+      return filenamebase+"-ch-car.dat";
+    }
+
+    return filenamebase+"-ch.dat";
+  }
+
   const char* const RoutingService::FILENAME_INTERSECTIONS_DAT   = "intersections.dat";
   const char* const RoutingService::FILENAME_INTERSECTIONS_IDX   = "intersections.idx";
 
@@ -103,4 +138,50 @@ namespace osmscout {
   RoutingService::~RoutingService()
   {
   }
+
+  void RoutingService::RoutingSearchSpace::Clear()
+  {
+    openList.Clear();
+    openMap.Clear();
+    closedSet.Clear();
+    closedRestrictedSet.Clear();
+    nodePool.Clear();
+  }
+
+  /**
+   * Return an empty search space for a new route search. On destruction of the
+   * returned reference the search space is cleared and kept for following searches
+   * (unless it grew too large, see RoutingSearchSpace::maxPooledNodes).
+   */
+  RoutingService::RoutingSearchSpaceRef RoutingService::AcquireSearchSpace()
+  {
+    std::unique_ptr<RoutingSearchSpace> searchSpace;
+
+    {
+      std::lock_guard<std::mutex> lock(searchSpaceMutex);
+
+      if (!searchSpaces.empty()) {
+        searchSpace=std::move(searchSpaces.back());
+        searchSpaces.pop_back();
+      }
+    }
+
+    if (!searchSpace) {
+      searchSpace=std::make_unique<RoutingSearchSpace>();
+    }
+
+    return RoutingSearchSpaceRef(searchSpace.release(),
+                                 [this](RoutingSearchSpace* space) {
+                                   if (space->nodePool.Capacity()>RoutingSearchSpace::maxPooledNodes) {
+                                     delete space;
+                                     return;
+                                   }
+
+                                   space->Clear();
+
+                                   std::lock_guard<std::mutex> lock(searchSpaceMutex);
+
+                                   searchSpaces.emplace_back(space);
+                                 });
+  }
 }
@@ -23,6 +23,7 @@
 
 #include <osmscout/system/Assert.h>
 
+#include <osmscout/util/File.h>
 #include <osmscout/util/Geometry.h>
 #include <osmscout/util/Logger.h>
 #include <osmscout/util/StopClock.h>
@@ -37,6 +38,28 @@
 
 namespace osmscout {
 
+  /**
+   * Returns the generation of the given profile or 0, if the profile does
+   * not track changes
+   */
+  static size_t GetProfileGeneration(const RoutingProfile& profile)
+  {
+    const auto* abstractProfile=dynamic_cast<const AbstractRoutingProfile*>(&profile);
+
+    return abstractProfile!=nullptr ? abstractProfile->GetGeneration() : 0;
+  }
+
+  /**
+   * Returns true, if the costs of the given profile depend on the turns at
+   * junctions, which are not modelled by the contraction hierarchy
+   */
+  static bool HasJunctionPenalty(const RoutingProfile& profile)
+  {
+    const auto* fastestProfile=dynamic_cast<const FastestPathRoutingProfile*>(&profile);
+
+    return fastestProfile!=nullptr && fastestProfile->HasJunctionPenalty();
+  }
+
   /**
    * Create a new instance of the routing service.
    *
@@ -52,7 +75,8 @@ namespace osmscout {
      database(database),
      filenamebase(filenamebase),
      accessReader(*database->GetTypeConfig()),
-     isOpen(false)
+     isOpen(false),
+     useContractionHierarchy(parameter.IsContractionHierarchy())
   {
     assert(database);
   }
@@ -316,6 +340,27 @@ namespace osmscout {
     return result;
   }
 
+  bool SimpleRoutingService::CalculateRouteNodeChain(const RoutingProfile& profile,
+                                                     const RoutePosition& /*start*/,
+                                                     const RoutePosition& /*target*/,
+                                                     const RNodeRef& startForwardNode,
+                                                     const RNodeRef& startBackwardNode,
+                                                     const RouteNodeRef& targetForwardRouteNode,
+                                                     const RouteNodeRef& targetBackwardRouteNode,
+                                                     const RoutingParameter& parameter,
+                                                     double costLimit,
+                                                     std::list<VNode>& nodes)
+  {
+    return CalculateContractionHierarchyRoute(profile,
+                                              startForwardNode,
+                                              startBackwardNode,
+                                              targetForwardRouteNode,
+                                              targetBackwardRouteNode,
+                                              parameter,
+                                              costLimit,
+                                              nodes);
+  }
+
   /**
    * Opens the routing service. This loads the routing graph for the given vehicle
    *
@@ -332,6 +377,28 @@ namespace osmscout {
       return false;
     }
 
+    if (useContractionHierarchy) {
+      for (Vehicle vehicle : {vehicleFoot, vehicleBicycle, vehicleCar}) {
+        std::string filename=AppendFileToDir(path,
+                                             GetContractionHierarchyFilename(filenamebase,
+                                                                             vehicle));
+
+        if (!ExistsInFilesystem(filename)) {
+          continue;
+        }
+
+        auto hierarchy=std::make_shared<ContractionHierarchy>();
+
+        if (hierarchy->Load(filename,
+                            vehicle)) {
+          contractionHierarchies.push_back(hierarchy);
+        }
+        else {
+          log.Warn() << "Cannot load contraction hierarchy '" << filename << "', routing without it";
+        }
+      }
+    }
+
     isOpen=true;
 
     return true;
@@ -355,6 +422,14 @@ namespace osmscout {
   {
     routingDatabase.Close();
 
+    {
+      std::scoped_lock<std::mutex> lock(contractionHierarchyMutex);
+
+      contractionHierarchyMetrics.clear();
+    }
+
+    contractionHierarchies.clear();
+
     isOpen=false;
   }
 
@@ -369,6 +444,242 @@ namespace osmscout {
     return database->GetTypeConfig();
   }
 
+  /**
+   * Prepare the contraction hierarchy of the vehicle of the given profile (if
+   * one was generated by the importer) for routing with this profile.
+   *
+   * Afterwards CalculateRoute() uses the hierarchy instead of the A* search,
+   * if it is called with exactly this profile instance. The costs of the
+   * profile are evaluated once during preparation. If the parametrization of
+   * the profile changes afterwards, the A* search is used until the profile
+   * is prepared again (changes are only detected for profiles derived from
+   * AbstractRoutingProfile).
+   *
+   * The hierarchy does not model junction penalties, so profiles with
+   * junction penalties cannot be prepared.
+   *
+   * @param profile
+   *    The profile to prepare the hierarchy for
+   * @return
+   *    True, if there is a contraction hierarchy for the profile, else false
+   */
+  bool SimpleRoutingService::PrepareContractionHierarchy(const RoutingProfileRef& profile)
+  {
+    assert(profile);
+
+    if (HasJunctionPenalty(*profile)) {
+      return false;
+    }
+
+    ContractionHierarchyRef hierarchy;
+
+    for (const auto& candidate : contractionHierarchies) {
+      if (candidate->GetVehicle()==profile->GetVehicle()) {
+        hierarchy=candidate;
+        break;
+      }
+    }
+
+    if (!hierarchy) {
+      return false;
+    }
+
+    StopClock                       clock;
+    size_t                          generation=GetProfileGeneration(*profile);
+    ContractionHierarchy::MetricRef metric=hierarchy->Customize(*profile,
+                                                                routingDatabase.GetObjectVariantData());
+
+    clock.Stop();
+
+    if (debugPerformance) {
+      std::cout << "Contraction hierarchy with " << hierarchy->GetNodeCount() << " nodes and " << hierarchy->GetEdgeCount() << " edges prepared in " << clock << std::endl;
+    }
+
+    std::scoped_lock<std::mutex> lock(contractionHierarchyMutex);
+
+    for (auto& entry : contractionHierarchyMetrics) {
+      if (entry.profile==profile) {
+        entry.profileGeneration=generation;
+        entry.hierarchy=hierarchy;
+        entry.metric=metric;
+
+        return true;
+      }
+    }
+
+    contractionHierarchyMetrics.push_back(ContractionHierarchyMetric{profile,
+                                                                     generation,
+                                                                     hierarchy,
+                                                                     metric});
+
+    return true;
+  }
+
+  /**
+   * Calculate the chain of route nodes from one of the start nodes to one of
+   * the target route nodes using the contraction hierarchy prepared for the
+   * given profile.
+   *
+   * Routes with access restricted paths at the target and routes violating
+   * turn restrictions are rejected, since the hierarchy does not model them.
+   * The hierarchy is not used for profiles with junction penalties and for
+   * profiles changed since their preparation.
+   *
+   * @return
+   *    True, if a route was found, false if the A* search should be used
+   */
+  bool SimpleRoutingService::CalculateContractionHierarchyRoute(const RoutingProfile& profile,
+                                                                const RNodeRef& startForwardNode,
+                                                                const RNodeRef& startBackwardNode,
+                                                                const RouteNodeRef& targetForwardRouteNode,
+                                                                const RouteNodeRef& targetBackwardRouteNode,
+                                                                const RoutingParameter& parameter,
+                                                                double costLimit,
+                                                                std::list<VNode>& nodes)
+  {
+    ContractionHierarchyRef         hierarchy;
+    ContractionHierarchy::MetricRef metric;
+
+    if (HasJunctionPenalty(profile)) {
+      return false;
+    }
+
+    {
+      std::scoped_lock<std::mutex> lock(contractionHierarchyMutex);
+
+      for (auto entry=contractionHierarchyMetrics.begin();
+           entry!=contractionHierarchyMetrics.end();
+           ++entry) {
+        if (entry->profile.get()!=&profile) {
+          continue;
+        }
+
+        if (entry->profileGeneration!=GetProfileGeneration(profile)) {
+          log.Warn() << "Routing profile changed since preparation of the contraction hierarchy, using A* search";
+          contractionHierarchyMetrics.erase(entry);
+          break;
+        }
+
+        hierarchy=entry->hierarchy;
+        metric=entry->metric;
+        break;
+      }
+    }
+
+    if (!hierarchy) {
+      return false;
+    }
+
+    Vehicle                             vehicle=profile.GetVehicle();
+    std::vector<std::pair<Id,double>>   sources;
+    std::vector<Id>                     targets;
+    DatabaseId                          dbId=0;
+
+    for (const auto& startNode : {startForwardNode, startBackwardNode}) {
+      if (startNode!=nullptr) {
+        if (!startNode->access) {
+          return false;
+        }
+
+        sources.emplace_back(startNode->id.id,startNode->currentCost);
+        dbId=startNode->id.database;
+      }
+    }
+
+    for (const auto& targetNode : {targetForwardRouteNode, targetBackwardRouteNode}) {
+      if (targetNode) {
+        for (const auto& path : targetNode->paths) {
+          if (path.IsRestricted(vehicle)) {
+            return false;
+          }
+        }
+
+        targets.push_back(targetNode->GetId());
+      }
+    }
+
+    Id                                           source;
+    std::vector<ContractionHierarchy::RouteStep> route;
+
+    if (sources.empty() ||
+        targets.empty() ||
+        !hierarchy->FindRoute(*metric,
+                              sources,
+                              targets,
+                              costLimit,
+                              parameter.GetBreaker(),
+                              source,
+                              route)) {
+      return false;
+    }
+
+    RNodeRef startNode=nullptr;
+
+    for (const auto& candidate : {startForwardNode, startBackwardNode}) {
+      if (candidate!=nullptr &&
+          candidate->id.id==source &&
+          (startNode==nullptr ||
+           candidate->currentCost<startNode->currentCost)) {
+        startNode=candidate;
+      }
+    }
+
+    assert(startNode!=nullptr);
+
+    // Turn restrictions are not part of the hierarchy, check them on the route found
+    std::set<DBId>                        routeNodeIds;
+    std::unordered_map<DBId,RouteNodeRef> routeNodeMap;
+
+    routeNodeIds.insert(DBId(dbId,source));
+
+    for (size_t i=0; i+1<route.size(); i++) {
+      routeNodeIds.insert(DBId(dbId,route[i].id));
+    }
+
+    if (!GetRouteNodes(routeNodeIds,
+                       routeNodeMap)) {
+      log.Error() << "Cannot load route nodes";
+      return false;
+    }
+
+    Id            current=source;
+    ObjectFileRef object=startNode->object;
+
+    for (const auto& step : route) {
+      auto routeNode=routeNodeMap.find(DBId(dbId,current));
+
+      if (routeNode==routeNodeMap.end()) {
+        return false;
+      }
+
+      for (const auto& exclude : routeNode->second->excludes) {
+        if (exclude.source==object &&
+            routeNode->second->objects[exclude.targetIndex].object==step.object) {
+          return false;
+        }
+      }
+
+      current=step.id;
+      object=step.object;
+    }
+
+    nodes.clear();
+    nodes.emplace_back(DBId(dbId,source),
+                       startNode->object,
+                       DBId());
+
+    DBId previous(dbId,source);
+
+    for (const auto& step : route) {
+      nodes.emplace_back(DBId(dbId,step.id),
+                         step.object,
+                         previous);
+      previous=DBId(dbId,step.id);
+    }
+
+    return true;
+  }
+
   /**
    * Calculate a route going through all the via points
    *
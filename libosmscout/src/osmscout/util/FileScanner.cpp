@@ -25,6 +25,7 @@
 #include <cstdio>
 #include <cstring>
 
+#include <algorithm>
 #include <limits>
 
 #if defined(HAVE_MMAP)
@@ -77,6 +78,13 @@ namespace osmscout {
 
   void FileScanner::FreeBuffer()
   {
+    if (sharedMmap) {
+      // The memory is unmapped by its owner
+      mmap=nullptr;
+      sharedMmap=false;
+      return;
+    }
+
 #if defined(HAVE_MMAP)
     if (mmap!=nullptr) {
       if (munmap(mmap,size)!=0) {
@@ -254,6 +262,30 @@ namespace osmscout {
     hasError=false;
   }
 
+  /**
+   * Opens the file of the given scanner. If the given scanner has mapped the file
+   * into memory, the mapping is shared instead of mapping the file again, so
+   * many scanners for the same file do not cost additional address space.
+   *
+   * The given scanner must not be closed before this scanner is closed.
+   *
+   * If opening the file fails, an exception is thrown.
+   */
+  void FileScanner::Open(const FileScanner& mappedScanner,
+                         Mode mode)
+  {
+    Open(mappedScanner.GetFilename(),
+         mode,
+         false);
+
+    if (mappedScanner.mmap!=nullptr) {
+      mmap=mappedScanner.mmap;
+      size=mappedScanner.size;
+      offset=0;
+      sharedMmap=true;
+    }
+  }
+
   /**
    * Closes the file.
    *
@@ -422,6 +454,47 @@ namespace osmscout {
 #endif
   }
 
+  /**
+   * Hint the operating system, that the given range of the file will be read soon,
+   * so that it can be read ahead in the background. The position of the reading
+   * cursor is not changed.
+   *
+   * Since this is only a hint, errors are ignored and the method does nothing on
+   * platforms not supporting it.
+   */
+  void FileScanner::Prefetch(FileOffset start,
+                             FileOffset length)
+  {
+    if (HasError() ||
+        start>=size ||
+        length==0) {
+      return;
+    }
+
+    length=std::min(length,size-start);
+
+#if defined(HAVE_MMAP) && defined(HAVE_POSIX_MADVISE)
+    if (mmap!=nullptr) {
+      static const auto pageSize=(FileOffset)sysconf(_SC_PAGESIZE);
+
+      // madvise requires a page aligned address
+      FileOffset alignedStart=start-start%pageSize;
+
+      posix_madvise(mmap+alignedStart,
+                    (size_t)(start+length-alignedStart),
+                    POSIX_MADV_WILLNEED);
+      return;
+    }
+#endif
+
+#if defined(HAVE_POSIX_FADVISE)
+    posix_fadvise(fileno(file),
+                  (off_t)start,
+                  (off_t)length,
+                  POSIX_FADV_WILLNEED);
+#endif
+  }
+
   char* FileScanner::ReadInternal(size_t bytes)
   {
     if (HasError()) {
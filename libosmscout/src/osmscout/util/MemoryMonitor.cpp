@@ -61,8 +61,25 @@ namespace osmscout {
 
   void MemoryMonitor::Measure()
   {
-    double currentVMUsage=0.0;
-    double currentResidentSet=0.0;
+    double currentVMUsage;
+    double currentResidentSet;
+
+    GetCurrentValue(currentVMUsage,
+                    currentResidentSet);
+
+    maxVMUsage=std::max(maxVMUsage,currentVMUsage);
+    maxResidentSet=std::max(maxResidentSet,currentResidentSet);
+  }
+
+  /**
+   * Return the current memory usage of the process. If there is no implementation
+   * for your OS, both values return are 0.0.
+   */
+  void MemoryMonitor::GetCurrentValue(double& vmUsage,
+                                      double& residentSet)
+  {
+    vmUsage=0.0;
+    residentSet=0.0;
 
 #ifdef __linux__
     double vsize=0;
@@ -80,12 +97,9 @@ namespace osmscout {
 
     long pageSizeInByte=sysconf(_SC_PAGE_SIZE);
 
-    currentVMUsage=vsize*double(pageSizeInByte);
-    currentResidentSet=rss*double(pageSizeInByte);
+    vmUsage=vsize*double(pageSizeInByte);
+    residentSet=rss*double(pageSizeInByte);
 #endif
-
-    maxVMUsage=std::max(maxVMUsage,currentVMUsage);
-    maxResidentSet=std::max(maxResidentSet,currentResidentSet);
   }
 
   /**
@@ -0,0 +1,90 @@
+/*
+  This source is part of the libosmscout library
+  Copyright (C) 2026  Tim Teulings
+
+  This library is free software; you can redistribute it and/or
+  modify it under the terms of the GNU Lesser General Public
+  License as published by the Free Software Foundation; either
+  version 2.1 of the License, or (at your option) any later version.
+
+  This library is distributed in the hope that it will be useful,
+  but WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  Lesser General Public License for more details.
+
+  You should have received a copy of the GNU Lesser General Public
+  License along with this library; if not, write to the Free Software
+  Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA 02111-1307  USA
+*/
+
+#include <osmscout/util/ObjectArena.h>
+
+#include <cstdint>
+
+#include <osmscout/system/Assert.h>
+
+namespace osmscout {
+
+  ObjectArena::ObjectArena(size_t chunkSize)
+  : chunkSize(chunkSize)
+  {
+    // no code
+  }
+
+  /**
+   * Return memory of the given size and alignment (which must be a power of two).
+   * Allocations larger than a quarter of the chunk size get a chunk of their own,
+   * to not waste the rest of the current chunk.
+   *
+   * Method is thread-safe.
+   */
+  void* ObjectArena::Allocate(size_t size,
+                              size_t alignment)
+  {
+    assert(alignment>0 && (alignment & (alignment-1))==0);
+
+    std::scoped_lock<std::mutex> lock(mutex);
+
+    size_t padding=(alignment-reinterpret_cast<uintptr_t>(current)%alignment)%alignment;
+
+    if (current!=nullptr &&
+        padding+size<=available) {
+      char* result=current+padding;
+
+      current+=padding+size;
+      available-=padding+size;
+
+      return result;
+    }
+
+    // new[] returns memory aligned for all fundamental types, larger alignments are not supported
+    assert(alignment<=alignof(std::max_align_t));
+
+    if (size>chunkSize/4) {
+      chunks.emplace_back(new char[size]);
+      memory+=size;
+
+      return chunks.back().get();
+    }
+
+    chunks.emplace_back(new char[chunkSize]);
+    memory+=chunkSize;
+
+    current=chunks.back().get()+size;
+    available=chunkSize-size;
+
+    return chunks.back().get();
+  }
+
+  /**
+   * Return the memory reserved by the arena in bytes
+   *
+   * Method is thread-safe.
+   */
+  size_t ObjectArena::GetMemory() const
+  {
+    std::scoped_lock<std::mutex> lock(mutex);
+
+    return memory;
+  }
+}
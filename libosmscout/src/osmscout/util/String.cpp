@@ -778,6 +778,12 @@ namespace osmscout {
     return utf8helper::UTF8ToUpper(text);
   }
 
+  void UTF8StringToUpper(const std::string& text,
+                         std::string& result)
+  {
+    utf8helper::UTF8Transform(text,utf8helper::TransformUpper,result);
+  }
+
   std::string UTF8StringToLower(const std::string& text)
   {
     return utf8helper::UTF8ToLower(text);
@@ -793,6 +799,12 @@ namespace osmscout {
     return utf8helper::UTF8Transliterate(text);
   }
 
+  void UTF8Transliterate(const std::string& text,
+                         std::string& result)
+  {
+    utf8helper::UTF8Transform(text,utf8helper::TransformTransliterate,result);
+  }
+
   /**
    * returns the utc timezone offset
    * (e.g. -8 hours for PST)
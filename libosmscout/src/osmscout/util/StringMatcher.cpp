@@ -22,9 +22,59 @@
 #include <osmscout/util/String.h>
 
 #include <algorithm>
+#include <string_view>
 
 namespace osmscout {
 
+  static bool IsASCII(const std::string& text)
+  {
+    unsigned char bits=0;
+
+    for (const char c : text) {
+      bits|=static_cast<unsigned char>(c);
+    }
+
+    return (bits & 0x80u)==0;
+  }
+
+  /**
+   * Convert the text to upper case like UTF8StringToUpper(), but reuse the memory
+   * of the result. ASCII text (the common case) is converted by a simple loop
+   * instead of the UTF8 parser.
+   */
+  static void ToUpper(const std::string& text,
+                      std::string& result)
+  {
+    if (!IsASCII(text)) {
+      UTF8StringToUpper(text,result);
+      return;
+    }
+
+    result.resize(text.length());
+
+    for (size_t i=0; i<text.length(); i++) {
+      char c=text[i];
+
+      result[i]=(c>='a' && c<='z') ? static_cast<char>(c-'a'+'A') : c;
+    }
+  }
+
+  static StringMatcher::Result MatchNormalized(std::string_view text,
+                                               std::string_view pattern)
+  {
+    auto pos=text.find(pattern);
+
+    if (pos==std::string_view::npos) {
+      return StringMatcher::noMatch;
+    }
+
+    if (pos==0 && pattern.length()==text.length()) {
+      return StringMatcher::match;
+    }
+
+    return StringMatcher::partialMatch;
+  }
+
   StringMatcherCI::StringMatcherCI(const std::string& pattern)
     : pattern(UTF8StringToUpper(pattern))
   {
@@ -33,18 +83,12 @@ namespace osmscout {
 
   StringMatcher::Result StringMatcherCI::Match(const std::string& text) const
   {
-    auto transformedText=UTF8StringToUpper(text);
-    auto pos            =transformedText.find(pattern);
-
-    if (pos==std::string::npos) {
-      return noMatch;
-    }
+    // Reused between calls, to not allocate memory for each candidate
+    thread_local std::string transformedText;
 
-    if (pos==0 && pattern.length()==transformedText.length()) {
-      return match;
-    }
+    ToUpper(text,transformedText);
 
-    return partialMatch;
+    return MatchNormalized(transformedText,pattern);
   }
 
   StringMatcherRef StringMatcherCIFactory::CreateMatcher(const std::string& pattern) const
@@ -60,32 +104,22 @@ namespace osmscout {
 
   StringMatcher::Result StringMatcherTransliterate::Match(const std::string& text) const
   {
-    auto transformedText=UTF8StringToUpper(text);
-    auto pos            =transformedText.find(pattern);
-
-    if (pos==std::string::npos) {
-      if (transliteratedPattern.empty()){
-        return noMatch;
-      }
+    // Reused between calls, to not allocate memory for each candidate
+    thread_local std::string transformedText;
+    thread_local std::string transliteratedText;
 
-      auto transliterated=UTF8Transliterate(transformedText);
-      pos=transliterated.find(transliteratedPattern);
+    ToUpper(text,transformedText);
 
-      if (pos==std::string::npos) {
-        return noMatch;
-      }
-      if (pos==0 && transliteratedPattern.length()==transliterated.length()) {
-        return match;
-      }
+    Result result=MatchNormalized(transformedText,pattern);
 
-      return partialMatch;
+    if (result!=noMatch ||
+        transliteratedPattern.empty()) {
+      return result;
     }
 
-    if (pos==0 && pattern.length()==transformedText.length()) {
-      return match;
-    }
+    UTF8Transliterate(transformedText,transliteratedText);
 
-    return partialMatch;
+    return MatchNormalized(transliteratedText,transliteratedPattern);
   }
 
   StringMatcherRef StringMatcherTransliterateFactory::CreateMatcher(const std::string& pattern) const
@@ -122,6 +122,17 @@ static inline int _u_size(codepoint u) {
   return 4;
 }
 
+void UTF8Transform(const std::string& text, Transform func, std::string& result) {
+  Parser p(func);
+  result.clear();
+  for (const char& cc : text) {
+    if (p.run(&p, static_cast<byte>(cc)) == Parser::Done) {
+      char buf[5];
+      result.append(buf, _u_string(buf, p.u) - buf);
+    }
+  }
+}
+
 UTF8String::UTF8String()
 : parser(utf8helper::TransformNop), rawSize(0) { }
 